@@ -1,5 +1,7 @@
 # main cpp
 list(APPEND of_main_cc ${PROJECT_SOURCE_DIR}/oneflow/core/job/oneflow_worker.cpp)
+# standalone tools, built as executables only and never linked into oneflow_internal
+list(APPEND of_tool_cc ${PROJECT_SOURCE_DIR}/oneflow/core/job/oneflow_plan_simulator.cpp)
 
 function(oneflow_add_executable)
   if (BUILD_CUDA)
@@ -126,7 +128,8 @@ foreach(oneflow_single_file ${oneflow_all_src})
     else()
       # not test file
       list(FIND of_main_cc ${oneflow_single_file} main_found)
-      if(${main_found} EQUAL -1) # not main entry
+      list(FIND of_tool_cc ${oneflow_single_file} tool_found)
+      if(${main_found} EQUAL -1 AND ${tool_found} EQUAL -1) # not main entry
         list(APPEND of_all_obj_cc ${oneflow_single_file})
       endif()
     endif()
@@ -343,6 +346,14 @@ foreach(cc ${of_main_cc})
   set_target_properties(${main_name} PROPERTIES RUNTIME_OUTPUT_DIRECTORY "${PROJECT_BINARY_DIR}/bin")
 endforeach()
 
+# build tools
+foreach(cc ${of_tool_cc})
+  get_filename_component(tool_name ${cc} NAME_WE)
+  oneflow_add_executable(${tool_name} ${cc})
+  target_link_libraries(${tool_name} ${of_libs} ${oneflow_third_party_libs})
+  set_target_properties(${tool_name} PROPERTIES RUNTIME_OUTPUT_DIRECTORY "${PROJECT_BINARY_DIR}/bin")
+endforeach()
+
 # build test
 if(BUILD_TESTING)
   if(NOT BUILD_CUDA)
@@ -59,6 +59,12 @@ void Actor::Init(const JobDesc* job_desc, const TaskProto& task_proto,
     ExecKernel ek;
     ek.kernel = ConstructKernel(job_desc_, node.kernel_conf(), device_ctx_.get());
     ek.bn_in_op2regst_desc_id = PbMap2HashMap(node.bn_in_op2regst_desc_id());
+    const Kernel* kernel = ek.kernel.get();
+    ek.blob_bindings.reset(new KernelBlobBindings(
+        ek.bn_in_op2regst_desc_id,
+        [kernel](const std::string& bn_in_op) -> const LogicalBlobId& {
+          return kernel->BnInOp2Lbi(bn_in_op);
+        }));
     exec_kernel_vec_.push_back(std::move(ek));
   }
 
@@ -70,6 +76,7 @@ void Actor::Init(const JobDesc* job_desc, const TaskProto& task_proto,
   remaining_eord_cnt_ = 0;
   msg_handler_ = nullptr;
   eord_regst_desc_ids_.clear();
+  is_eord_sent_ = false;
 
   for (const auto& pair : task_proto.produced_regst_desc()) {
     Global<RegstMgr>::Get()->NewRegsts(pair.second, [this](Regst* regst) {
@@ -420,7 +427,7 @@ void Actor::AsyncRetInplaceConsumedRegstIfNoConsumer() {
         return inplace_in_ids_with_no_out_consumed_.find(regst_desc_id)
                != inplace_in_ids_with_no_out_consumed_.end();
       },
-      [&](const std::deque<Regst*>& deq) {
+      [&](const RegstRing& deq) {
         if (!deq.empty()) {
           Regst* in_regst = deq.front();
           CHECK(in_regst);
@@ -450,7 +457,7 @@ void Actor::AsyncSendConsumedCtrlRegstMsgToProducer() {
   };
 
   tmp_regst_desc_id_vec_.clear();
-  naive_consumed_rs_.ForChosenRegstDeq(IsChosenRegstDescId, [&](const std::deque<Regst*>& reg_deq) {
+  naive_consumed_rs_.ForChosenRegstDeq(IsChosenRegstDescId, [&](const RegstRing& reg_deq) {
     CHECK(reg_deq.empty() == false);
     Regst* regst = reg_deq.front();
     CHECK(regst->regst_desc()->regst_desc_type().has_ctrl_regst_desc());
@@ -511,16 +518,19 @@ bool Actor::IsWriteReady() const {
 
 void Actor::AsyncLaunchKernel(const KernelCtx& kernel_ctx,
                               std::function<Regst*(int64_t)> Regst4RegstDescId) {
+  const std::function<Blob*(int64_t, const LogicalBlobId&)> Blob4RegstDescIdAndLbi =
+      [&](int64_t regst_desc_id, const LogicalBlobId& lbi) -> Blob* {
+    Regst* regst = GetNaiveOrInplaceCurWriteable(regst_desc_id);
+    if (regst == nullptr) { regst = GetNaiveOrInplaceCurReadable(regst_desc_id); }
+    if (regst == nullptr) { regst = Regst4RegstDescId(regst_desc_id); }
+    if (regst == nullptr) { return nullptr; }
+    return regst->GetBlobByLbi(lbi);
+  };
   for (const ExecKernel& ek : exec_kernel_vec_) {
+    KernelBlobBindings* blob_bindings = ek.blob_bindings.get();
+    blob_bindings->NewAct();
     ek.kernel->Launch(kernel_ctx, [&](const std::string& bn_in_op) -> Blob* {
-      auto regst_desc_id_it = ek.bn_in_op2regst_desc_id.find(bn_in_op);
-      if (regst_desc_id_it == ek.bn_in_op2regst_desc_id.end()) { return nullptr; }
-      Regst* regst = GetNaiveOrInplaceCurWriteable(regst_desc_id_it->second);
-      if (regst == nullptr) { regst = GetNaiveOrInplaceCurReadable(regst_desc_id_it->second); }
-      if (regst == nullptr) { regst = Regst4RegstDescId(regst_desc_id_it->second); }
-      if (regst == nullptr) { return nullptr; }
-      const LogicalBlobId& lbi = ek.kernel->BnInOp2Lbi(bn_in_op);
-      return regst->GetBlobByLbi(lbi);
+      return blob_bindings->Blob4BnInOp(bn_in_op, Blob4RegstDescIdAndLbi);
     });
   }
 }
@@ -605,6 +615,9 @@ void Actor::HandleConsumedNaiveDataRegstToProducer(std::function<bool(Regst*)> I
 }
 
 void Actor::AsyncSendEORDMsgForAllProducedRegstDesc() {
+  // the eord must not overtake the regst msgs to the same consumers
+  FlushSyncMsgOutbox();
+  is_eord_sent_ = true;
   for (auto& pair : produced_regsts_) {
     CHECK(!pair.second.empty());
     const RtRegstDesc* regst_desc = pair.second.front()->regst_desc();
@@ -663,15 +676,24 @@ int Actor::TryUpdtStateAsProducedRegst(Regst* regst) {
 }
 
 void Actor::EnqueueAsyncMsg(const ActorMsg& msg) {
+  // a regst msg to the consumers queued after the eord would reach them behind it
+  CHECK(!is_eord_sent_ || msg.msg_type() != ActorMsgType::kRegstMsg
+        || produced_regst2reading_cnt_.find(msg.regst()) == produced_regst2reading_cnt_.end());
   if (is_kernel_launch_synchronized_
       && GetGlobalWorkStreamId()
              == Global<IDMgr>::Get()->GlobalWorkStreamId4ActorId(msg.dst_actor_id())) {
-    Global<ActorMsgBus>::Get()->SendMsg(msg);
+    sync_msg_outbox_.push_back(msg);
   } else {
     async_msg_queue_.push_back(msg);
   }
 }
 
+void Actor::FlushSyncMsgOutbox() {
+  if (sync_msg_outbox_.empty()) { return; }
+  Global<ActorMsgBus>::Get()->SendMsgs(sync_msg_outbox_);
+  sync_msg_outbox_.clear();
+}
+
 int64_t Actor::GetGlobalWorkStreamId() const {
   return Global<IDMgr>::Get()->GlobalWorkStreamId4ActorId(actor_id_);
 }
@@ -709,11 +731,9 @@ std::unique_ptr<Actor> NewActor(const TaskProto& task_proto, const ThreadCtx& th
 
 void Actor::AsyncSendQueuedMsg() {
   if (!async_msg_queue_.empty()) {
-    std::deque<ActorMsg> msgs;
+    std::vector<ActorMsg> msgs;
     msgs.swap(async_msg_queue_);
-    device_ctx_->AddCallBack([msgs]() {
-      for (const ActorMsg& msg : msgs) { Global<ActorMsgBus>::Get()->SendMsg(msg); }
-    });
+    device_ctx_->AddCallBack([msgs]() { Global<ActorMsgBus>::Get()->SendMsgs(msgs); });
   }
 }
 
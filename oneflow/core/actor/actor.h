@@ -27,6 +27,7 @@ limitations under the License.
 #include "oneflow/core/register/register_manager.h"
 #include "oneflow/core/thread/thread_context.h"
 #include "oneflow/core/actor/register_slot.h"
+#include "oneflow/core/actor/kernel_blob_bindings.h"
 
 namespace oneflow {
 
@@ -46,7 +47,11 @@ class Actor {
 
   // 1: success, and actor finish
   // 0: success, and actor not finish
-  int ProcessMsg(const ActorMsg& msg) { return (this->*msg_handler_)(msg); }
+  int ProcessMsg(const ActorMsg& msg) {
+    int ret = (this->*msg_handler_)(msg);
+    FlushSyncMsgOutbox();
+    return ret;
+  }
 
   int64_t machine_id() const { return Global<IDMgr>::Get()->MachineId4ActorId(actor_id_); }
   int64_t thrd_id() const { return Global<IDMgr>::Get()->ThrdId4ActorId(actor_id_); }
@@ -56,6 +61,7 @@ class Actor {
   struct ExecKernel {
     std::unique_ptr<const Kernel> kernel;
     HashMap<std::string, int64_t> bn_in_op2regst_desc_id;
+    std::unique_ptr<KernelBlobBindings> blob_bindings;
   };
   using MsgHandler = int (Actor::*)(const ActorMsg&);
   enum class RegstNameType { kNaive = 0, kCustomized };
@@ -105,6 +111,7 @@ class Actor {
 
   // Util For Derived Actor to Send Msg
   void EnqueueAsyncMsg(const ActorMsg&);
+  void FlushSyncMsgOutbox();
   void HandleProducedNaiveDataRegstToConsumer(std::function<bool(Regst*)> RegstPreProcess,
                                               std::function<bool(int64_t)> IsAllowedActor);
   void HandleProducedNaiveDataRegstToConsumer(std::function<bool(Regst*)> RegstPreProcess);
@@ -159,7 +166,7 @@ class Actor {
   }
 
   // Process Msg
-  virtual void NormalProcessNaiveReadableDataRegstMsg(const std::deque<Regst*>&) {}
+  virtual void NormalProcessNaiveReadableDataRegstMsg(const RegstRing&) {}
   virtual bool NormalTryProcessReadableMsgFromOtherMachine(const ActorMsg&) { return false; }
   int TryUpdtStateAsProducedRegst(Regst* regst);
 
@@ -225,6 +232,7 @@ class Actor {
   std::unique_ptr<DeviceCtx> device_ctx_;
   HashSet<int64_t> eord_regst_desc_ids_;
   int64_t remaining_eord_cnt_;
+  bool is_eord_sent_;
 
   HashMap<int64_t, std::vector<std::unique_ptr<Regst>>> produced_regsts_;
   HashMap<int64_t, int64_t> produced_regst2expected_act_id_;
@@ -245,7 +253,9 @@ class Actor {
   HashMap<int64_t, int64_t> inplace_regst_desc_id_in2out_;
   HashMap<int64_t, int64_t> inplace_regst_desc_id_out2in_;
 
-  std::deque<ActorMsg> async_msg_queue_;
+  std::vector<ActorMsg> async_msg_queue_;
+  // msgs which need no device callback, delivered together when the handler returns
+  std::vector<ActorMsg> sync_msg_outbox_;
   bool is_kernel_launch_synchronized_;
   std::vector<int64_t> tmp_regst_desc_id_vec_;
 };
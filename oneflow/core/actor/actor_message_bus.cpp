@@ -37,4 +37,44 @@ void ActorMsgBus::SendMsgWithoutCommNet(const ActorMsg& msg) {
   Global<ThreadMgr>::Get()->GetThrd(thrd_id)->EnqueueActorMsg(msg);
 }
 
+void ActorMsgBus::SendMsgs(const std::vector<ActorMsg>& msgs) {
+  if (msgs.size() == 1) {
+    SendMsg(msgs.front());
+    return;
+  }
+  std::vector<ActorMsg> remote_msgs;
+  std::vector<std::pair<int64_t, std::vector<ActorMsg>>> thrd_id7msgs;
+  GroupActorMsgsByDst(msgs, &remote_msgs, &thrd_id7msgs);
+  for (const ActorMsg& msg : remote_msgs) {
+    int64_t dst_machine_id = Global<IDMgr>::Get()->MachineId4ActorId(msg.dst_actor_id());
+    Global<CommNet>::Get()->SendActorMsg(dst_machine_id, msg);
+  }
+  for (const auto& pair : thrd_id7msgs) {
+    Global<ThreadMgr>::Get()->GetThrd(pair.first)->EnqueueActorMsg(pair.second.cbegin(),
+                                                                   pair.second.cend());
+  }
+}
+
+void GroupActorMsgsByDst(const std::vector<ActorMsg>& msgs, std::vector<ActorMsg>* remote_msgs,
+                         std::vector<std::pair<int64_t, std::vector<ActorMsg>>>* thrd_id7msgs) {
+  const int64_t this_machine_id = Global<MachineCtx>::Get()->this_machine_id();
+  for (const ActorMsg& msg : msgs) {
+    if (Global<IDMgr>::Get()->MachineId4ActorId(msg.dst_actor_id()) != this_machine_id) {
+      remote_msgs->push_back(msg);
+      continue;
+    }
+    int64_t thrd_id = Global<IDMgr>::Get()->ThrdId4ActorId(msg.dst_actor_id());
+    // one sender rarely reaches more than a few threads, so a linear search beats hashing
+    auto it = std::find_if(thrd_id7msgs->begin(), thrd_id7msgs->end(),
+                           [thrd_id](const std::pair<int64_t, std::vector<ActorMsg>>& pair) {
+                             return pair.first == thrd_id;
+                           });
+    if (it == thrd_id7msgs->end()) {
+      thrd_id7msgs->emplace_back(thrd_id, std::vector<ActorMsg>());
+      it = thrd_id7msgs->end() - 1;
+    }
+    it->second.push_back(msg);
+  }
+}
+
 }  // namespace oneflow
@@ -28,12 +28,19 @@ class ActorMsgBus final {
 
   void SendMsg(const ActorMsg& msg);
   void SendMsgWithoutCommNet(const ActorMsg& msg);
+  // Messages to the same local thread are enqueued together and keep their order
+  void SendMsgs(const std::vector<ActorMsg>& msgs);
 
  private:
   friend class Global<ActorMsgBus>;
   ActorMsgBus() = default;
 };
 
+// Splits msgs into the ones for other machines and the ones for each local thread, keeping the
+// order of msgs within each part
+void GroupActorMsgsByDst(const std::vector<ActorMsg>& msgs, std::vector<ActorMsg>* remote_msgs,
+                         std::vector<std::pair<int64_t, std::vector<ActorMsg>>>* thrd_id7msgs);
+
 }  // namespace oneflow
 
 #endif  // ONEFLOW_CORE_ACTOR_ACTOR_MESSAGE_BUS_H_
@@ -0,0 +1,138 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "oneflow/core/actor/actor_message_bus.h"
+#include "oneflow/core/job/global_for.h"
+#include "oneflow/core/job/id_manager.h"
+#include "oneflow/core/job/machine_context.h"
+
+namespace oneflow {
+
+namespace test {
+
+namespace {
+
+const int64_t kMachineNum = 3;
+const int64_t kThrdNum = 4;
+
+class IDMgrTestEnv final {
+ public:
+  OF_DISALLOW_COPY_AND_MOVE(IDMgrTestEnv);
+  IDMgrTestEnv() {
+    EnvProto env_proto;
+    FOR_RANGE(int64_t, i, 0, kMachineNum) {
+      auto* machine = env_proto.add_machine();
+      machine->set_id(i);
+      machine->set_addr("192.168.1." + std::to_string(i));
+    }
+    env_proto.set_ctrl_port(9527);
+    Resource resource;
+    resource.set_machine_num(kMachineNum);
+    resource.set_gpu_device_num(0);
+    resource.set_cpu_device_num(kThrdNum);
+    Global<EnvDesc>::New(env_proto);
+    Global<ResourceDesc, ForSession>::New(resource);
+    Global<IDMgr>::New();
+    Global<MachineCtx>::New(0);
+  }
+  ~IDMgrTestEnv() {
+    Global<MachineCtx>::Delete();
+    Global<IDMgr>::Delete();
+    Global<ResourceDesc, ForSession>::Delete();
+    Global<EnvDesc>::Delete();
+  }
+};
+
+// Every actor gets msgs in a random interleaving, the eord regst desc id of a msg numbers it
+// among the msgs to its actor
+std::vector<ActorMsg> MakeInterleavedMsgs(const std::vector<int64_t>& actor_ids,
+                                          int64_t msg_num_per_actor) {
+  std::vector<int64_t> dst_actor_ids;
+  for (int64_t actor_id : actor_ids) {
+    dst_actor_ids.insert(dst_actor_ids.end(), msg_num_per_actor, actor_id);
+  }
+  std::mt19937 gen(actor_ids.size());
+  std::shuffle(dst_actor_ids.begin(), dst_actor_ids.end(), gen);
+  HashMap<int64_t, int64_t> actor_id2msg_cnt;
+  std::vector<ActorMsg> msgs;
+  for (int64_t actor_id : dst_actor_ids) {
+    msgs.push_back(ActorMsg::BuildEordMsg(actor_id, actor_id2msg_cnt[actor_id]++));
+  }
+  return msgs;
+}
+
+void CheckMsgOrder(const std::vector<ActorMsg>& msgs, HashMap<int64_t, int64_t>* actor_id2msg_cnt) {
+  for (const ActorMsg& msg : msgs) {
+    ASSERT_EQ(msg.eord_regst_desc_id(), (*actor_id2msg_cnt)[msg.dst_actor_id()]++);
+  }
+}
+
+}  // namespace
+
+TEST(ActorMsgBus, group_actor_msgs_by_dst) {
+  IDMgrTestEnv env;
+  IDMgr* id_mgr = Global<IDMgr>::Get();
+  // two actors on different streams of every local thread, and one actor on each remote machine
+  std::vector<int64_t> actor_ids;
+  FOR_RANGE(int64_t, thrd_id, 0, kThrdNum) {
+    actor_ids.push_back(id_mgr->NewTaskId(0, thrd_id, 0));
+    actor_ids.push_back(id_mgr->NewTaskId(0, thrd_id, 1));
+  }
+  FOR_RANGE(int64_t, machine_id, 1, kMachineNum) {
+    actor_ids.push_back(id_mgr->NewTaskId(machine_id, 0, 0));
+  }
+  const int64_t msg_num_per_actor = 16;
+  const std::vector<ActorMsg> msgs = MakeInterleavedMsgs(actor_ids, msg_num_per_actor);
+  std::vector<ActorMsg> remote_msgs;
+  std::vector<std::pair<int64_t, std::vector<ActorMsg>>> thrd_id7msgs;
+  GroupActorMsgsByDst(msgs, &remote_msgs, &thrd_id7msgs);
+
+  HashMap<int64_t, int64_t> actor_id2msg_cnt;
+  ASSERT_EQ(remote_msgs.size(), (kMachineNum - 1) * msg_num_per_actor);
+  for (const ActorMsg& msg : remote_msgs) {
+    ASSERT_NE(id_mgr->MachineId4ActorId(msg.dst_actor_id()), 0);
+  }
+  CheckMsgOrder(remote_msgs, &actor_id2msg_cnt);
+  ASSERT_EQ(thrd_id7msgs.size(), kThrdNum);
+  HashSet<int64_t> thrd_ids;
+  for (const auto& pair : thrd_id7msgs) {
+    ASSERT_TRUE(thrd_ids.insert(pair.first).second);
+    ASSERT_EQ(pair.second.size(), 2 * msg_num_per_actor);
+    for (const ActorMsg& msg : pair.second) {
+      ASSERT_EQ(id_mgr->MachineId4ActorId(msg.dst_actor_id()), 0);
+      ASSERT_EQ(id_mgr->ThrdId4ActorId(msg.dst_actor_id()), pair.first);
+    }
+    CheckMsgOrder(pair.second, &actor_id2msg_cnt);
+  }
+  ASSERT_EQ(actor_id2msg_cnt.size(), actor_ids.size());
+  for (const auto& pair : actor_id2msg_cnt) { ASSERT_EQ(pair.second, msg_num_per_actor); }
+}
+
+TEST(ActorMsgBus, group_only_remote_actor_msgs) {
+  IDMgrTestEnv env;
+  const int64_t remote_actor_id = Global<IDMgr>::Get()->NewTaskId(1, 0, 0);
+  const std::vector<ActorMsg> msgs = MakeInterleavedMsgs({remote_actor_id}, 3);
+  std::vector<ActorMsg> remote_msgs;
+  std::vector<std::pair<int64_t, std::vector<ActorMsg>>> thrd_id7msgs;
+  GroupActorMsgsByDst(msgs, &remote_msgs, &thrd_id7msgs);
+  ASSERT_TRUE(thrd_id7msgs.empty());
+  HashMap<int64_t, int64_t> actor_id2msg_cnt;
+  CheckMsgOrder(remote_msgs, &actor_id2msg_cnt);
+  ASSERT_EQ(actor_id2msg_cnt.at(remote_actor_id), 3);
+}
+
+}  // namespace test
+
+}  // namespace oneflow
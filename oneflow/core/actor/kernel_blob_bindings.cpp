@@ -0,0 +1,50 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "oneflow/core/actor/kernel_blob_bindings.h"
+
+namespace oneflow {
+
+KernelBlobBindings::KernelBlobBindings(
+    const HashMap<std::string, int64_t>& bn_in_op2regst_desc_id,
+    const std::function<const LogicalBlobId&(const std::string&)>& BnInOp2Lbi)
+    : act_cnt_(0) {
+  bn_in_op2index_.reserve(bn_in_op2regst_desc_id.size());
+  blob_bindings_.reserve(bn_in_op2regst_desc_id.size());
+  for (const auto& pair : bn_in_op2regst_desc_id) {
+    CHECK(bn_in_op2index_.emplace(pair.first, blob_bindings_.size()).second);
+    BlobBinding binding;
+    binding.regst_desc_id = pair.second;
+    binding.lbi = BnInOp2Lbi(pair.first);
+    binding.resolved_act_cnt = -1;
+    binding.blob = nullptr;
+    blob_bindings_.push_back(binding);
+  }
+}
+
+Blob* KernelBlobBindings::Blob4BnInOp(
+    const std::string& bn_in_op,
+    const std::function<Blob*(int64_t regst_desc_id, const LogicalBlobId&)>& Resolve) {
+  const auto it = bn_in_op2index_.find(bn_in_op);
+  if (it == bn_in_op2index_.end()) { return nullptr; }
+  BlobBinding* binding = &blob_bindings_.at(it->second);
+  if (binding->resolved_act_cnt != act_cnt_) {
+    binding->blob = Resolve(binding->regst_desc_id, binding->lbi);
+    binding->resolved_act_cnt = act_cnt_;
+  }
+  return binding->blob;
+}
+
+}  // namespace oneflow
@@ -0,0 +1,57 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#ifndef ONEFLOW_CORE_ACTOR_KERNEL_BLOB_BINDINGS_H_
+#define ONEFLOW_CORE_ACTOR_KERNEL_BLOB_BINDINGS_H_
+
+#include "oneflow/core/register/blob.h"
+#include "oneflow/core/register/logical_blob_id.pb.h"
+
+namespace oneflow {
+
+// Binds the blob names of one kernel to dense slots when the actor is initialized. During an act
+// a name costs a single lookup, and the blob of a slot is resolved only on its first access.
+class KernelBlobBindings final {
+ public:
+  OF_DISALLOW_COPY_AND_MOVE(KernelBlobBindings);
+  KernelBlobBindings(const HashMap<std::string, int64_t>& bn_in_op2regst_desc_id,
+                     const std::function<const LogicalBlobId&(const std::string&)>& BnInOp2Lbi);
+  ~KernelBlobBindings() = default;
+
+  size_t size() const { return blob_bindings_.size(); }
+
+  // forgets the blobs resolved in the previous act
+  void NewAct() { ++act_cnt_; }
+  // Resolve is only called for names bound to a regst, at most once per name and act
+  Blob* Blob4BnInOp(
+      const std::string& bn_in_op,
+      const std::function<Blob*(int64_t regst_desc_id, const LogicalBlobId&)>& Resolve);
+
+ private:
+  struct BlobBinding {
+    int64_t regst_desc_id;
+    LogicalBlobId lbi;
+    int64_t resolved_act_cnt;
+    Blob* blob;
+  };
+
+  HashMap<std::string, int64_t> bn_in_op2index_;
+  std::vector<BlobBinding> blob_bindings_;
+  int64_t act_cnt_;
+};
+
+}  // namespace oneflow
+
+#endif  // ONEFLOW_CORE_ACTOR_KERNEL_BLOB_BINDINGS_H_
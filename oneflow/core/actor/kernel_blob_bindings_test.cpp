@@ -0,0 +1,168 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "oneflow/core/actor/kernel_blob_bindings.h"
+#include "oneflow/core/common/protobuf.h"
+#include "oneflow/core/common/benchmark_test_util.h"
+#include <gtest/gtest.h>
+
+namespace oneflow {
+
+namespace test {
+
+namespace {
+
+LogicalBlobId MakeLbi(const std::string& op_name, const std::string& blob_name) {
+  LogicalBlobId lbi;
+  lbi.set_op_name(op_name);
+  lbi.set_blob_name(blob_name);
+  return lbi;
+}
+
+// Blobs are only compared by address, never dereferenced.
+Blob* FakeBlob(int64_t i) { return reinterpret_cast<Blob*>(0x1000 + i * 0x100); }
+
+struct FakeKernel {
+  HashMap<std::string, int64_t> bn_in_op2regst_desc_id;
+  HashMap<std::string, LogicalBlobId> bn_in_op2lbi;
+  std::vector<std::string> bns;
+};
+
+FakeKernel MakeFakeKernel(int64_t in_num, int64_t out_num) {
+  FakeKernel kernel;
+  FOR_RANGE(int64_t, i, 0, in_num + out_num) {
+    const bool is_in = i < in_num;
+    const std::string bn = is_in ? "in_" + std::to_string(i) : "out_" + std::to_string(i);
+    kernel.bns.push_back(bn);
+    // inputs come from one regst each, outputs share the single produced regst
+    kernel.bn_in_op2regst_desc_id.emplace(bn, is_in ? i : in_num);
+    kernel.bn_in_op2lbi.emplace(bn, MakeLbi(is_in ? "producer_" + std::to_string(i) : "op", bn));
+  }
+  return kernel;
+}
+
+// The regsts an actor holds in its slots, keyed like RegstSlot and Regst do.
+struct FakeRegsts {
+  std::vector<HashMap<int64_t, std::deque<int64_t>>> slots;
+  HashMap<int64_t, HashMap<LogicalBlobId, Blob*>> regst2lbi2blob;
+};
+
+FakeRegsts MakeFakeRegsts(const FakeKernel& kernel) {
+  FakeRegsts regsts;
+  // naive produced, inplace produced, naive consumed and inplace consumed
+  regsts.slots.resize(4);
+  int64_t blob_cnt = 0;
+  for (const std::string& bn : kernel.bns) {
+    const int64_t regst_desc_id = kernel.bn_in_op2regst_desc_id.at(bn);
+    const bool is_in = bn.compare(0, 3, "in_") == 0;
+    regsts.slots.at(is_in ? 2 : 0)[regst_desc_id] = {regst_desc_id};
+    regsts.regst2lbi2blob[regst_desc_id][kernel.bn_in_op2lbi.at(bn)] = FakeBlob(blob_cnt++);
+  }
+  return regsts;
+}
+
+Blob* FakeBlob4RegstDescIdAndLbi(const FakeRegsts& regsts, int64_t regst_desc_id,
+                                 const LogicalBlobId& lbi) {
+  for (const auto& slot : regsts.slots) {
+    const auto it = slot.find(regst_desc_id);
+    if (it == slot.end() || it->second.empty()) { continue; }
+    return regsts.regst2lbi2blob.at(it->second.front()).at(lbi);
+  }
+  return nullptr;
+}
+
+}  // namespace
+
+TEST(KernelBlobBindings, resolve_once_per_act) {
+  const FakeKernel kernel = MakeFakeKernel(2, 1);
+  KernelBlobBindings bindings(kernel.bn_in_op2regst_desc_id,
+                              [&](const std::string& bn) -> const LogicalBlobId& {
+                                return kernel.bn_in_op2lbi.at(bn);
+                              });
+  ASSERT_EQ(bindings.size(), 3);
+  int64_t resolve_cnt = 0;
+  Blob* in_0_blob = FakeBlob(7);
+  const auto Resolve = [&](int64_t regst_desc_id, const LogicalBlobId& lbi) -> Blob* {
+    ++resolve_cnt;
+    if (lbi == kernel.bn_in_op2lbi.at("in_0")) {
+      EXPECT_EQ(regst_desc_id, 0);
+      return in_0_blob;
+    }
+    return nullptr;
+  };
+  bindings.NewAct();
+  ASSERT_EQ(bindings.Blob4BnInOp("in_0", Resolve), in_0_blob);
+  ASSERT_EQ(bindings.Blob4BnInOp("in_0", Resolve), in_0_blob);
+  ASSERT_EQ(bindings.Blob4BnInOp("out_2", Resolve), nullptr);
+  ASSERT_EQ(bindings.Blob4BnInOp("out_2", Resolve), nullptr);
+  ASSERT_EQ(bindings.Blob4BnInOp("tmp_buf", Resolve), nullptr);
+  ASSERT_EQ(resolve_cnt, 2);
+  bindings.NewAct();
+  in_0_blob = FakeBlob(8);
+  ASSERT_EQ(bindings.Blob4BnInOp("in_0", Resolve), in_0_blob);
+  ASSERT_EQ(resolve_cnt, 3);
+}
+
+TEST(KernelBlobBindings, DISABLED_benchmark) {
+  // A kernel usually looks up every blob several times per act: header, shape, access checks and
+  // the body each ask for it again.
+  const int64_t access_per_act = 4;
+  const int64_t act_num = 100000;
+  for (const auto& in_out_num : std::vector<std::pair<int64_t, int64_t>>{{1, 1}, {2, 1}, {4, 2}}) {
+    const FakeKernel kernel = MakeFakeKernel(in_out_num.first, in_out_num.second);
+    const FakeRegsts regsts = MakeFakeRegsts(kernel);
+    const std::function<Blob*(int64_t, const LogicalBlobId&)> Resolve =
+        [&](int64_t regst_desc_id, const LogicalBlobId& lbi) {
+          return FakeBlob4RegstDescIdAndLbi(regsts, regst_desc_id, lbi);
+        };
+    // both loops run equally often, so the checksum cancels out iff they found the same blobs
+    int64_t checksum = 0;
+    const double chain_ms = BenchmarkMilliseconds([&]() {
+      FOR_RANGE(int64_t, act, 0, act_num) {
+        const std::function<Blob*(const std::string&)> BnInOp2Blob = [&](const std::string& bn) {
+          const auto it = kernel.bn_in_op2regst_desc_id.find(bn);
+          if (it == kernel.bn_in_op2regst_desc_id.end()) { return static_cast<Blob*>(nullptr); }
+          return Resolve(it->second, kernel.bn_in_op2lbi.at(bn));
+        };
+        FOR_RANGE(int64_t, i, 0, access_per_act) {
+          for (const std::string& bn : kernel.bns) { checksum += BnInOp2Blob(bn) != nullptr; }
+        }
+      }
+    });
+    KernelBlobBindings bindings(kernel.bn_in_op2regst_desc_id,
+                                [&](const std::string& bn) -> const LogicalBlobId& {
+                                  return kernel.bn_in_op2lbi.at(bn);
+                                });
+    const double bindings_ms = BenchmarkMilliseconds([&]() {
+      FOR_RANGE(int64_t, act, 0, act_num) {
+        bindings.NewAct();
+        const std::function<Blob*(const std::string&)> BnInOp2Blob = [&](const std::string& bn) {
+          return bindings.Blob4BnInOp(bn, Resolve);
+        };
+        FOR_RANGE(int64_t, i, 0, access_per_act) {
+          for (const std::string& bn : kernel.bns) { checksum -= BnInOp2Blob(bn) != nullptr; }
+        }
+      }
+    });
+    ASSERT_EQ(checksum, 0);
+    LOG(INFO) << "KernelBlobBindings " << in_out_num.first << " in " << in_out_num.second
+              << " out: lookup chain " << chain_ms / act_num * 1e6 << " ns/act, bindings "
+              << bindings_ms / act_num * 1e6 << " ns/act";
+  }
+}
+
+}  // namespace test
+
+}  // namespace oneflow
@@ -17,32 +17,59 @@ limitations under the License.
 
 namespace oneflow {
 
+void RegstRing::push_back(Regst* regst) {
+  if (size_ == buffer_.size()) {
+    std::vector<Regst*> buffer(std::max<size_t>(buffer_.size() * 2, 2));
+    FOR_RANGE(size_t, i, 0, size_) { buffer[i] = at(i); }
+    buffer_.swap(buffer);
+    head_ = 0;
+  }
+  buffer_[(head_ + size_) & (buffer_.size() - 1)] = regst;
+  size_ += 1;
+}
+
+void RegstRing::pop_front() {
+  CHECK_GT(size_, 0);
+  head_ = (head_ + 1) & (buffer_.size() - 1);
+  size_ -= 1;
+}
+
+int64_t RegstSlot::Index4RegstDescId(int64_t regst_desc_id) const {
+  const auto it = std::lower_bound(regst_desc_ids_.begin(), regst_desc_ids_.end(), regst_desc_id);
+  if (it == regst_desc_ids_.end() || *it != regst_desc_id) { return -1; }
+  return it - regst_desc_ids_.begin();
+}
+
 bool RegstSlot::HasRegstDescId(int64_t regst_desc_id) const {
   CHECK(is_inited_);
-  return regst_desc_id2regsts_.find(regst_desc_id) != regst_desc_id2regsts_.end();
+  return Index4RegstDescId(regst_desc_id) != -1;
 }
 
-const std::deque<Regst*>& RegstSlot::RegstDeq4RegstDescId(int64_t regst_desc_id) const {
+const RegstRing& RegstSlot::RegstDeq4RegstDescId(int64_t regst_desc_id) const {
   CHECK(is_inited_);
-  return regst_desc_id2regsts_.at(regst_desc_id);
+  const int64_t index = Index4RegstDescId(regst_desc_id);
+  CHECK_NE(index, -1);
+  return rings_.at(index);
 }
 
 int RegstSlot::TryPushBackRegst(Regst* regst) {
   CHECK(is_inited_);
-  auto it = regst_desc_id2regsts_.find(regst->regst_desc_id());
-  if (it == regst_desc_id2regsts_.end()) { return -1; }
-  if (it->second.empty()) { available_regst_desc_cnt_ += 1; }
-  it->second.push_back(regst);
+  const int64_t index = Index4RegstDescId(regst->regst_desc_id());
+  if (index == -1) { return -1; }
+  RegstRing* ring = &rings_.at(index);
+  if (ring->empty()) { available_regst_desc_cnt_ += 1; }
+  ring->push_back(regst);
   return 0;
 }
 
 int RegstSlot::TryPopFrontRegst(int64_t regst_desc_id) {
   CHECK(is_inited_);
-  auto it = regst_desc_id2regsts_.find(regst_desc_id);
-  if (it == regst_desc_id2regsts_.end()) { return -1; }
-  CHECK(it->second.empty() == false);
-  it->second.pop_front();
-  if (it->second.empty()) { available_regst_desc_cnt_ -= 1; }
+  const int64_t index = Index4RegstDescId(regst_desc_id);
+  if (index == -1) { return -1; }
+  RegstRing* ring = &rings_.at(index);
+  CHECK(ring->empty() == false);
+  ring->pop_front();
+  if (ring->empty()) { available_regst_desc_cnt_ -= 1; }
   return 0;
 }
 
@@ -53,31 +80,35 @@ void RegstSlot::PopFrontRegsts(const std::vector<int64_t>& regst_desc_ids) {
 
 void RegstSlot::InsertRegstDescId(int64_t regst_desc_id) {
   CHECK(is_inited_ == false);
-  CHECK(regst_desc_id2regsts_.emplace(regst_desc_id, std::deque<Regst*>()).second);
+  const auto it = std::lower_bound(regst_desc_ids_.begin(), regst_desc_ids_.end(), regst_desc_id);
+  CHECK(it == regst_desc_ids_.end() || *it != regst_desc_id);
+  rings_.insert(rings_.begin() + (it - regst_desc_ids_.begin()), RegstRing());
+  regst_desc_ids_.insert(it, regst_desc_id);
 }
 
 Regst* RegstSlot::Front(int64_t regst_desc_id) const {
   CHECK(is_inited_);
-  auto it = regst_desc_id2regsts_.find(regst_desc_id);
-  if (it == regst_desc_id2regsts_.end()) { return nullptr; }
-  if (it->second.empty()) { return nullptr; }
-  return it->second.front();
+  const int64_t index = Index4RegstDescId(regst_desc_id);
+  if (index == -1) { return nullptr; }
+  const RegstRing& ring = rings_.at(index);
+  if (ring.empty()) { return nullptr; }
+  return ring.front();
 }
 
 Regst* RegstSlot::SoleFront() const {
   CHECK(is_inited_);
   CHECK_EQ(1, total_regst_desc_cnt());
-  auto it = regst_desc_id2regsts_.begin();
-  if (it->second.empty()) { return nullptr; }
-  return it->second.front();
+  const RegstRing& ring = rings_.front();
+  if (ring.empty()) { return nullptr; }
+  return ring.front();
 }
 
 Regst* RegstSlot::FirstFront() const {
   CHECK(is_inited_);
   CHECK_GE(total_regst_desc_cnt(), 1);
-  auto it = regst_desc_id2regsts_.begin();
-  if (it->second.empty()) { return nullptr; }
-  return it->second.front();
+  const RegstRing& ring = rings_.front();
+  if (ring.empty()) { return nullptr; }
+  return ring.front();
 }
 
 void RegstSlot::InitedDone() {
@@ -87,18 +118,18 @@ void RegstSlot::InitedDone() {
 
 void RegstSlot::ForChosenFrontRegst(std::function<bool(int64_t)> IsChosenRegstDescId,
                                     std::function<void(Regst*)> Handler) const {
-  for (const auto& kv : regst_desc_id2regsts_) {
-    if (IsChosenRegstDescId(kv.first)) {
-      CHECK(kv.second.empty() == false);
-      Handler(kv.second.front());
+  FOR_RANGE(size_t, i, 0, regst_desc_ids_.size()) {
+    if (IsChosenRegstDescId(regst_desc_ids_.at(i))) {
+      CHECK(rings_.at(i).empty() == false);
+      Handler(rings_.at(i).front());
     }
   }
 }
 
 void RegstSlot::ForChosenRegstDeq(std::function<bool(int64_t)> IsChosenRegstDescId,
-                                  std::function<void(const std::deque<Regst*>&)> Handler) const {
-  for (const auto& kv : regst_desc_id2regsts_) {
-    if (IsChosenRegstDescId(kv.first)) { Handler(kv.second); }
+                                  std::function<void(const RegstRing&)> Handler) const {
+  FOR_RANGE(size_t, i, 0, regst_desc_ids_.size()) {
+    if (IsChosenRegstDescId(regst_desc_ids_.at(i))) { Handler(rings_.at(i)); }
   }
 }
 
@@ -106,7 +137,7 @@ void RegstSlot::ForEachFrontRegst(std::function<void(Regst*)> Handler) const {
   ForChosenFrontRegst([](int64_t) { return true; }, Handler);
 }
 
-void RegstSlot::ForEachRegstDeq(std::function<void(const std::deque<Regst*>&)> Handler) const {
+void RegstSlot::ForEachRegstDeq(std::function<void(const RegstRing&)> Handler) const {
   ForChosenRegstDeq([](int64_t) { return true; }, Handler);
 }
 
@@ -20,24 +20,49 @@ limitations under the License.
 
 namespace oneflow {
 
+// The regsts of one regst desc in fifo order. The buffer only grows, to the most regsts the slot
+// held at once, so pushing and popping stop allocating once the pipeline is full.
+class RegstRing final {
+ public:
+  RegstRing() : head_(0), size_(0) {}
+  ~RegstRing() = default;
+
+  bool empty() const { return size_ == 0; }
+  size_t size() const { return size_; }
+  Regst* front() const { return at(0); }
+  Regst* at(size_t i) const {
+    CHECK_LT(i, size_);
+    return buffer_[(head_ + i) & (buffer_.size() - 1)];
+  }
+
+  void push_back(Regst* regst);
+  void pop_front();
+
+ private:
+  // its size is zero or a power of two
+  std::vector<Regst*> buffer_;
+  size_t head_;
+  size_t size_;
+};
+
 class RegstSlot final {
  public:
   OF_DISALLOW_COPY_AND_MOVE(RegstSlot);
-  RegstSlot() : regst_desc_id2regsts_(), available_regst_desc_cnt_(0), is_inited_(false) {}
+  RegstSlot() : available_regst_desc_cnt_(0), is_inited_(false) {}
   ~RegstSlot() = default;
 
   bool is_inited() const { return is_inited_; }
-  size_t total_regst_desc_cnt() const { return regst_desc_id2regsts_.size(); }
+  size_t total_regst_desc_cnt() const { return regst_desc_ids_.size(); }
   size_t available_regst_desc_cnt() const { return available_regst_desc_cnt_; }
 
   bool IsCurSlotReady() const { return available_regst_desc_cnt() == total_regst_desc_cnt(); }
   bool HasRegstDescId(int64_t regst_desc_id) const;
-  const std::deque<Regst*>& RegstDeq4RegstDescId(int64_t regst_desc_id) const;
+  const RegstRing& RegstDeq4RegstDescId(int64_t regst_desc_id) const;
   void ForEachFrontRegst(std::function<void(Regst*)>) const;
-  void ForEachRegstDeq(std::function<void(const std::deque<Regst*>&)>) const;
+  void ForEachRegstDeq(std::function<void(const RegstRing&)>) const;
   void ForChosenFrontRegst(std::function<bool(int64_t)>, std::function<void(Regst*)>) const;
   void ForChosenRegstDeq(std::function<bool(int64_t)>,
-                         std::function<void(const std::deque<Regst*>&)>) const;
+                         std::function<void(const RegstRing&)>) const;
 
   Regst* Front(int64_t regst_desc_id) const;
   Regst* SoleFront() const;
@@ -53,7 +78,12 @@ class RegstSlot final {
   void InsertRegstDescId(int64_t regst_desc_id);
 
  private:
-  HashMap<int64_t, std::deque<Regst*>> regst_desc_id2regsts_;
+  // -1 if regst_desc_id is not in this slot
+  int64_t Index4RegstDescId(int64_t regst_desc_id) const;
+
+  // sorted, regst_desc_ids_.at(i) owns rings_.at(i)
+  std::vector<int64_t> regst_desc_ids_;
+  std::vector<RegstRing> rings_;
   size_t available_regst_desc_cnt_;
   bool is_inited_;
 };
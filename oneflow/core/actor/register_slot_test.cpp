@@ -0,0 +1,256 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "oneflow/core/actor/register_slot.h"
+#include "oneflow/core/job/machine_context.h"
+#include "oneflow/core/register/register_manager.h"
+
+namespace oneflow {
+
+namespace test {
+
+namespace {
+
+const int64_t kDataRegstDescId = 10;
+
+// Only compared by address, never dereferenced.
+Regst* FakeRegst(int64_t i) { return reinterpret_cast<Regst*>(0x1000 + i * 0x100); }
+
+RegstDescProto MakeCtrlRegstDesc(int64_t regst_desc_id, int32_t register_num) {
+  RegstDescProto regst_desc;
+  regst_desc.set_regst_desc_id(regst_desc_id);
+  regst_desc.set_producer_task_id(0);
+  regst_desc.set_min_register_num(register_num);
+  regst_desc.set_max_register_num(register_num);
+  regst_desc.set_register_num(register_num);
+  regst_desc.mutable_mem_case()->mutable_host_mem();
+  regst_desc.mutable_regst_desc_type()->mutable_ctrl_regst_desc();
+  regst_desc.set_enable_reuse_mem(false);
+  regst_desc.set_mem_block_id(-1);
+  regst_desc.set_mem_block_offset(-1);
+  return regst_desc;
+}
+
+// blob i is named after a shuffled position and has i + 1 elements, so neither the proto order
+// nor the element count agrees with the sorted lbi order
+RegstDescProto MakeDataRegstDesc(int64_t blob_num, int32_t register_num, int64_t mem_block_id) {
+  RegstDescProto regst_desc = MakeCtrlRegstDesc(kDataRegstDescId, register_num);
+  DataRegstDesc* data_regst_desc = regst_desc.mutable_regst_desc_type()->mutable_data_regst_desc();
+  HashMap<LogicalBlobId, std::unique_ptr<BlobDesc>> lbi2blob_desc;
+  FOR_RANGE(int64_t, i, 0, blob_num) {
+    LbiBlobDescPair* pair = data_regst_desc->add_lbi2blob_desc();
+    pair->mutable_lbi()->set_op_name("op");
+    pair->mutable_lbi()->set_blob_name("out_" + std::to_string((i * 7) % blob_num));
+    auto blob_desc = std::make_unique<BlobDesc>(Shape({i + 1}), DataType::kInt32);
+    blob_desc->ToProto(pair->mutable_blob_desc());
+    lbi2blob_desc.emplace(pair->lbi(), std::move(blob_desc));
+  }
+  ComputePackedBlobDesc(lbi2blob_desc)->ToProto(data_regst_desc->mutable_packed_blob_desc());
+  data_regst_desc->mutable_time_shape()->add_dim(1);
+  regst_desc.set_mem_block_id(mem_block_id);
+  regst_desc.set_mem_block_offset(0);
+  return regst_desc;
+}
+
+class RegstMgrTestEnv final {
+ public:
+  OF_DISALLOW_COPY_AND_MOVE(RegstMgrTestEnv);
+  explicit RegstMgrTestEnv(const std::vector<RegstDescProto>& regst_descs) {
+    Global<MachineCtx>::New(0);
+    Global<MemoryAllocator>::New();
+    Plan plan;
+    TaskProto* task = plan.add_task();
+    task->set_machine_id(0);
+    for (const RegstDescProto& regst_desc : regst_descs) {
+      (*task->mutable_produced_regst_desc())[std::to_string(regst_desc.regst_desc_id())] =
+          regst_desc;
+      if (regst_desc.mem_block_id() == -1) { continue; }
+      MemBlockProto* mem_block = plan.mutable_block_chunk_list()->add_mem_block();
+      mem_block->set_mem_block_id(regst_desc.mem_block_id());
+      mem_block->set_machine_id(0);
+      *mem_block->mutable_mem_case() = regst_desc.mem_case();
+      mem_block->set_enable_reuse_mem(false);
+      mem_block->set_mem_size(RtRegstDesc(regst_desc).TotalMainByteSize4AllRegst());
+    }
+    Global<RegstMgr>::New(plan);
+    for (const RegstDescProto& regst_desc : regst_descs) {
+      Global<RegstMgr>::Get()->NewRegsts(regst_desc, [&](Regst* regst) {
+        regst_desc_id2regsts_[regst_desc.regst_desc_id()].emplace_back(regst);
+      });
+    }
+  }
+  ~RegstMgrTestEnv() {
+    regst_desc_id2regsts_.clear();
+    Global<RegstMgr>::Delete();
+    Global<MemoryAllocator>::Delete();
+    Global<MachineCtx>::Delete();
+  }
+
+  Regst* regst(int64_t regst_desc_id, int64_t i) const {
+    return regst_desc_id2regsts_.at(regst_desc_id).at(i).get();
+  }
+  int64_t regst_num(int64_t regst_desc_id) const {
+    return regst_desc_id2regsts_.at(regst_desc_id).size();
+  }
+
+ private:
+  HashMap<int64_t, std::vector<std::unique_ptr<Regst>>> regst_desc_id2regsts_;
+};
+
+}  // namespace
+
+TEST(RegstRing, fifo_across_wraparound_and_growth) {
+  RegstRing ring;
+  std::deque<Regst*> expected;
+  int64_t pushed = 0;
+  const auto CheckSame = [&]() {
+    ASSERT_EQ(ring.size(), expected.size());
+    ASSERT_EQ(ring.empty(), expected.empty());
+    FOR_RANGE(size_t, i, 0, expected.size()) { ASSERT_EQ(ring.at(i), expected.at(i)); }
+  };
+  // every round leaves one more regst behind, so the head keeps moving while the buffer is full
+  // and each growth starts from a wrapped buffer
+  FOR_RANGE(int64_t, round, 1, 40) {
+    FOR_RANGE(int64_t, i, 0, round + 1) {
+      ring.push_back(FakeRegst(pushed));
+      expected.push_back(FakeRegst(pushed));
+      ++pushed;
+      CheckSame();
+    }
+    FOR_RANGE(int64_t, i, 0, round) {
+      ASSERT_EQ(ring.front(), expected.front());
+      ring.pop_front();
+      expected.pop_front();
+      CheckSame();
+    }
+  }
+  while (!expected.empty()) {
+    ASSERT_EQ(ring.front(), expected.front());
+    ring.pop_front();
+    expected.pop_front();
+  }
+  ASSERT_TRUE(ring.empty());
+}
+
+TEST(RegstSlot, available_regst_desc_cnt) {
+  RegstMgrTestEnv env({MakeCtrlRegstDesc(1, 2), MakeCtrlRegstDesc(2, 2), MakeCtrlRegstDesc(3, 2),
+                       MakeCtrlRegstDesc(4, 1)});
+  RegstSlot slot;
+  for (int64_t regst_desc_id : {3, 1, 2}) { slot.InsertRegstDescId(regst_desc_id); }
+  slot.InitedDone();
+  ASSERT_EQ(slot.total_regst_desc_cnt(), 3);
+  ASSERT_EQ(slot.available_regst_desc_cnt(), 0);
+  // a regst desc the slot does not hold is never counted
+  ASSERT_FALSE(slot.HasRegstDescId(4));
+  ASSERT_FALSE(slot.HasRegstDescId(0));
+  ASSERT_EQ(slot.TryPushBackRegst(env.regst(4, 0)), -1);
+  ASSERT_EQ(slot.TryPopFrontRegst(4), -1);
+  ASSERT_EQ(slot.Front(4), nullptr);
+  ASSERT_EQ(slot.available_regst_desc_cnt(), 0);
+
+  ASSERT_EQ(slot.TryPushBackRegst(env.regst(1, 0)), 0);
+  ASSERT_EQ(slot.TryPushBackRegst(env.regst(1, 1)), 0);
+  ASSERT_EQ(slot.available_regst_desc_cnt(), 1);
+  ASSERT_EQ(slot.TryPushBackRegst(env.regst(3, 0)), 0);
+  ASSERT_EQ(slot.available_regst_desc_cnt(), 2);
+  ASSERT_FALSE(slot.IsCurSlotReady());
+  ASSERT_EQ(slot.TryPushBackRegst(env.regst(2, 0)), 0);
+  ASSERT_EQ(slot.available_regst_desc_cnt(), 3);
+  ASSERT_TRUE(slot.IsCurSlotReady());
+
+  // regst descs are visited in ascending id order whatever the insertion order was
+  std::vector<int64_t> front_regst_desc_ids;
+  slot.ForEachFrontRegst(
+      [&](Regst* regst) { front_regst_desc_ids.push_back(regst->regst_desc_id()); });
+  ASSERT_EQ(front_regst_desc_ids, std::vector<int64_t>({1, 2, 3}));
+  ASSERT_EQ(slot.FirstFront(), env.regst(1, 0));
+
+  ASSERT_EQ(slot.TryPopFrontRegst(1), 0);
+  ASSERT_EQ(slot.available_regst_desc_cnt(), 3);
+  ASSERT_EQ(slot.Front(1), env.regst(1, 1));
+  ASSERT_EQ(slot.TryPopFrontRegst(1), 0);
+  ASSERT_EQ(slot.available_regst_desc_cnt(), 2);
+  ASSERT_EQ(slot.Front(1), nullptr);
+  ASSERT_FALSE(slot.IsCurSlotReady());
+  slot.PopFrontRegsts({2, 3});
+  ASSERT_EQ(slot.available_regst_desc_cnt(), 0);
+  slot.ForEachRegstDeq([](const RegstRing& ring) { ASSERT_TRUE(ring.empty()); });
+}
+
+TEST(RegstSlot, fifo_per_regst_desc_across_growth) {
+  const int32_t register_num = 9;
+  RegstMgrTestEnv env({MakeCtrlRegstDesc(1, register_num), MakeCtrlRegstDesc(2, register_num)});
+  RegstSlot slot;
+  slot.InsertRegstDescId(2);
+  slot.InsertRegstDescId(1);
+  slot.InitedDone();
+  // desc 1 is drained every third push, desc 2 fills up to register_num before it is drained
+  int64_t pushed_1 = 0;
+  int64_t popped_1 = 0;
+  FOR_RANGE(int64_t, i, 0, register_num) {
+    ASSERT_EQ(slot.TryPushBackRegst(env.regst(1, pushed_1++)), 0);
+    ASSERT_EQ(slot.TryPushBackRegst(env.regst(2, i)), 0);
+    if (i % 3 == 2) {
+      ASSERT_EQ(slot.Front(1), env.regst(1, popped_1++));
+      ASSERT_EQ(slot.TryPopFrontRegst(1), 0);
+    }
+  }
+  const RegstRing& ring_1 = slot.RegstDeq4RegstDescId(1);
+  ASSERT_EQ(ring_1.size(), pushed_1 - popped_1);
+  FOR_RANGE(size_t, i, 0, ring_1.size()) { ASSERT_EQ(ring_1.at(i), env.regst(1, popped_1 + i)); }
+  const RegstRing& ring_2 = slot.RegstDeq4RegstDescId(2);
+  ASSERT_EQ(ring_2.size(), register_num);
+  FOR_RANGE(int64_t, i, 0, register_num) {
+    ASSERT_EQ(slot.Front(2), env.regst(2, i));
+    ASSERT_EQ(slot.TryPopFrontRegst(2), 0);
+  }
+  ASSERT_EQ(slot.available_regst_desc_cnt(), 1);
+  while (popped_1 < pushed_1) {
+    ASSERT_EQ(slot.Front(1), env.regst(1, popped_1++));
+    ASSERT_EQ(slot.TryPopFrontRegst(1), 0);
+  }
+  ASSERT_EQ(slot.available_regst_desc_cnt(), 0);
+}
+
+TEST(Regst, get_blob_by_lbi_follows_sorted_lbis) {
+  const RegstDescProto regst_desc = MakeDataRegstDesc(5, 2, 1);
+  RegstMgrTestEnv env({regst_desc});
+  const RtRegstDesc& rt_regst_desc =
+      Global<RegstMgr>::Get()->RegstDesc4RegstDescId(kDataRegstDescId);
+  const std::vector<LogicalBlobId>& sorted_lbis = rt_regst_desc.sorted_lbis();
+  ASSERT_EQ(sorted_lbis.size(), 5);
+  ASSERT_TRUE(std::is_sorted(sorted_lbis.begin(), sorted_lbis.end()));
+  LogicalBlobId missing_lbi;
+  missing_lbi.set_op_name("op");
+  missing_lbi.set_blob_name("missing");
+  ASSERT_EQ(rt_regst_desc.GetBlobIndex4Lbi(missing_lbi), -1);
+  FOR_RANGE(int64_t, i, 0, env.regst_num(kDataRegstDescId)) {
+    Regst* regst = env.regst(kDataRegstDescId, i);
+    ASSERT_EQ(regst->GetBlobSize(), sorted_lbis.size());
+    ASSERT_EQ(regst->GetBlobByLbi(missing_lbi), nullptr);
+    FOR_RANGE(size_t, j, 0, sorted_lbis.size()) {
+      const LogicalBlobId& lbi = sorted_lbis.at(j);
+      ASSERT_EQ(rt_regst_desc.GetBlobIndex4Lbi(lbi), j);
+      const Blob* blob = regst->GetBlobByLbi(lbi);
+      ASSERT_NE(blob, nullptr);
+      // the blob found for an lbi is the one made from that lbi's blob desc
+      ASSERT_EQ(blob->blob_desc_ptr(), rt_regst_desc.GetRtBlobDescFromLbi(lbi));
+    }
+  }
+}
+
+}  // namespace test
+
+}  // namespace oneflow
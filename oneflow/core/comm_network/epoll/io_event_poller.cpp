@@ -14,6 +14,7 @@ See the License for the specific language governing permissions and
 limitations under the License.
 */
 #include "oneflow/core/comm_network/epoll/io_event_poller.h"
+#include "oneflow/core/thread/thread_placement.h"
 
 #ifdef PLATFORM_POSIX
 
@@ -84,6 +85,7 @@ void IOEventPoller::AddFd(int fd, std::function<void()>* read_handler,
 }
 
 void IOEventPoller::EpollLoop() {
+  if (Global<ThreadPlacement>::Get()) { Global<ThreadPlacement>::Get()->BindCommNetPollerThread(); }
   while (true) {
     int event_num = epoll_wait(epfd_, ep_events_, max_event_num_, -1);
     if (event_num == -1) {
@@ -17,6 +17,7 @@ limitations under the License.
 #include "oneflow/core/control/ctrl_client.h"
 #include "oneflow/core/job/resource_desc.h"
 #include "oneflow/core/job/global_for.h"
+#include "oneflow/core/thread/thread_placement.h"
 
 #if defined(WITH_RDMA) && defined(PLATFORM_POSIX)
 
@@ -129,6 +130,7 @@ void IBVerbsCommNet::DoRead(void* read_id, int64_t src_machine_id, void* src_tok
 }
 
 void IBVerbsCommNet::PollCQ() {
+  if (Global<ThreadPlacement>::Get()) { Global<ThreadPlacement>::Get()->BindCommNetPollerThread(); }
   std::vector<ibv_wc> wc_vec(max_poll_wc_num_);
   while (poll_exit_flag_.test_and_set() == false) {
     poll_exit_flag_.clear();
@@ -0,0 +1,43 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#ifndef ONEFLOW_CORE_COMMON_BENCHMARK_TEST_UTIL_H_
+#define ONEFLOW_CORE_COMMON_BENCHMARK_TEST_UTIL_H_
+
+#include <chrono>
+#include "oneflow/core/common/util.h"
+
+namespace oneflow {
+
+namespace test {
+
+// Benchmark tests are DISABLED_ so that a normal test run stays fast. Run them with
+// --gtest_also_run_disabled_tests --gtest_filter='*benchmark*'.
+
+// mean milliseconds of one Run, after a warm-up run
+inline double BenchmarkMilliseconds(const std::function<void()>& Run) {
+  Run();
+  const int32_t repeat = 5;
+  const auto start = std::chrono::steady_clock::now();
+  FOR_RANGE(int32_t, i, 0, repeat) { Run(); }
+  const auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(end - start).count() / repeat;
+}
+
+}  // namespace test
+
+}  // namespace oneflow
+
+#endif  // ONEFLOW_CORE_COMMON_BENCHMARK_TEST_UTIL_H_
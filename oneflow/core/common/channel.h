@@ -20,18 +20,24 @@ limitations under the License.
 
 namespace oneflow {
 
-enum ChannelStatus { kChannelStatusSuccess = 0, kChannelStatusErrorClosed };
+enum ChannelStatus { kChannelStatusSuccess = 0, kChannelStatusErrorClosed, kChannelStatusEmpty };
 
 template<typename T>
 class Channel final {
  public:
   OF_DISALLOW_COPY_AND_MOVE(Channel);
-  Channel() : is_closed_(false) {}
+  Channel() : is_closed_(false), item_cnt_(0) {}
   ~Channel() = default;
 
   ChannelStatus Send(const T& item);
+  // Takes the lock and wakes the receivers once for the whole range.
+  template<typename InputIt>
+  ChannelStatus SendMany(InputIt first, InputIt last);
   ChannelStatus Receive(T* item);
   ChannelStatus ReceiveMany(std::queue<T>* items);
+  // Never blocks and only takes the lock when there are items, so it is cheap to call in a loop.
+  // kChannelStatusEmpty also when the channel is closed, the blocking calls report that.
+  ChannelStatus TryReceiveMany(std::queue<T>* items);
   void Close();
 
  private:
@@ -39,6 +45,7 @@ class Channel final {
   mutable std::mutex mutex_;
   bool is_closed_;
   std::condition_variable cond_;
+  std::atomic<size_t> item_cnt_;
 };
 
 template<typename T>
@@ -46,10 +53,23 @@ ChannelStatus Channel<T>::Send(const T& item) {
   std::unique_lock<std::mutex> lock(mutex_);
   if (is_closed_) { return kChannelStatusErrorClosed; }
   queue_.push(item);
+  item_cnt_.store(queue_.size(), std::memory_order_release);
   cond_.notify_one();
   return kChannelStatusSuccess;
 }
 
+template<typename T>
+template<typename InputIt>
+ChannelStatus Channel<T>::SendMany(InputIt first, InputIt last) {
+  if (first == last) { return kChannelStatusSuccess; }
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (is_closed_) { return kChannelStatusErrorClosed; }
+  for (; first != last; ++first) { queue_.push(*first); }
+  item_cnt_.store(queue_.size(), std::memory_order_release);
+  cond_.notify_all();
+  return kChannelStatusSuccess;
+}
+
 template<typename T>
 ChannelStatus Channel<T>::Receive(T* item) {
   std::unique_lock<std::mutex> lock(mutex_);
@@ -57,6 +77,7 @@ ChannelStatus Channel<T>::Receive(T* item) {
   if (queue_.empty()) { return kChannelStatusErrorClosed; }
   *item = queue_.front();
   queue_.pop();
+  item_cnt_.store(queue_.size(), std::memory_order_release);
   return kChannelStatusSuccess;
 }
 
@@ -69,6 +90,20 @@ ChannelStatus Channel<T>::ReceiveMany(std::queue<T>* items) {
     items->push(std::move(queue_.front()));
     queue_.pop();
   }
+  item_cnt_.store(0, std::memory_order_release);
+  return kChannelStatusSuccess;
+}
+
+template<typename T>
+ChannelStatus Channel<T>::TryReceiveMany(std::queue<T>* items) {
+  if (item_cnt_.load(std::memory_order_acquire) == 0) { return kChannelStatusEmpty; }
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (queue_.empty()) { return kChannelStatusEmpty; }
+  while (!queue_.empty()) {
+    items->push(std::move(queue_.front()));
+    queue_.pop();
+  }
+  item_cnt_.store(0, std::memory_order_release);
   return kChannelStatusSuccess;
 }
 
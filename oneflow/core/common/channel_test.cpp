@@ -59,4 +59,56 @@ TEST(Channel, 30sender40receiver) {
   }
 }
 
+TEST(Channel, try_receive_many) {
+  Channel<int> channel;
+  std::queue<int> items;
+  ASSERT_EQ(channel.TryReceiveMany(&items), kChannelStatusEmpty);
+  ASSERT_TRUE(items.empty());
+  const int item_num = 10000;
+  std::thread sender([&channel]() {
+    for (int i = 0; i < item_num; ++i) { ASSERT_EQ(channel.Send(i), kChannelStatusSuccess); }
+  });
+  int expected = 0;
+  while (expected < item_num) {
+    ChannelStatus status = channel.TryReceiveMany(&items);
+    if (status == kChannelStatusEmpty) { continue; }
+    ASSERT_EQ(status, kChannelStatusSuccess);
+    ASSERT_FALSE(items.empty());
+    while (!items.empty()) {
+      ASSERT_EQ(items.front(), expected++);
+      items.pop();
+    }
+  }
+  sender.join();
+  channel.Close();
+  ASSERT_EQ(channel.TryReceiveMany(&items), kChannelStatusEmpty);
+  ASSERT_EQ(channel.ReceiveMany(&items), kChannelStatusErrorClosed);
+}
+
+TEST(Channel, send_many) {
+  Channel<int> channel;
+  const int batch_num = 100;
+  const int batch_size = 7;
+  std::thread sender([&channel]() {
+    std::vector<int> batch(batch_size);
+    for (int i = 0; i < batch_num; ++i) {
+      for (int j = 0; j < batch_size; ++j) { batch[j] = i * batch_size + j; }
+      ASSERT_EQ(channel.SendMany(batch.cbegin(), batch.cend()), kChannelStatusSuccess);
+    }
+    channel.Close();
+  });
+  std::queue<int> items;
+  int expected = 0;
+  while (channel.ReceiveMany(&items) == kChannelStatusSuccess) {
+    while (!items.empty()) {
+      ASSERT_EQ(items.front(), expected++);
+      items.pop();
+    }
+  }
+  sender.join();
+  ASSERT_EQ(expected, batch_num * batch_size);
+  std::vector<int> batch(1, 0);
+  ASSERT_EQ(channel.SendMany(batch.cbegin(), batch.cend()), kChannelStatusErrorClosed);
+}
+
 }  // namespace oneflow
@@ -0,0 +1,48 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#ifndef ONEFLOW_CORE_COMMON_CPU_ISA_H_
+#define ONEFLOW_CORE_COMMON_CPU_ISA_H_
+
+#include "oneflow/core/common/platform.h"
+
+namespace oneflow {
+
+// Simd extensions host kernels dispatch on, ordered from narrowest to widest.
+enum class CpuIsa {
+  kScalar = 0,
+  kAvx2 = 1,
+  kAvx512 = 2,
+};
+
+// Widest extension supported by the running cpu, detected once per process. Kernels compiled for
+// the baseline isa use it to pick functions built with OF_TARGET_AVX2 / OF_TARGET_AVX512.
+CpuIsa GetCpuIsa();
+
+}  // namespace oneflow
+
+#if defined(PLATFORM_IS_X86) && defined(__GNUC__)
+#define OF_CPU_ISA_DISPATCH
+#define OF_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#define OF_TARGET_AVX512 __attribute__((target("avx512f,avx2,fma")))
+#endif
+
+#if defined(__GNUC__)
+#define OF_PREFETCH(ptr) __builtin_prefetch(ptr)
+#else
+#define OF_PREFETCH(ptr)
+#endif
+
+#endif  // ONEFLOW_CORE_COMMON_CPU_ISA_H_
@@ -0,0 +1,79 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#ifndef ONEFLOW_CORE_COMMON_MONOTONIC_ARENA_H_
+#define ONEFLOW_CORE_COMMON_MONOTONIC_ARENA_H_
+
+#include "oneflow/core/common/util.h"
+
+namespace oneflow {
+
+// Carves memory out of large blocks and gives it back only when the arena is destroyed. Objects
+// placed in it are laid out contiguously in creation order and their destructors are up to the
+// owner, which suits containers built once and dropped as a whole, like the graphs of a compile.
+class MonotonicArena final {
+ public:
+  OF_DISALLOW_COPY_AND_MOVE(MonotonicArena);
+  static const size_t kDefaultBlockSize = 64 * 1024;
+
+  MonotonicArena() : MonotonicArena(kDefaultBlockSize) {}
+  explicit MonotonicArena(size_t block_size)
+      : block_size_(block_size), cur_(0), end_(0), allocated_size_(0) {
+    CHECK_GT(block_size_, 0);
+  }
+  ~MonotonicArena() = default;
+
+  void* Allocate(size_t size, size_t alignment) {
+    CHECK_GT(alignment, 0);
+    CHECK_EQ(alignment & (alignment - 1), 0);
+    uintptr_t ptr = AlignUp(cur_, alignment);
+    if (blocks_.empty() || ptr + size > end_) {
+      NewBlock(std::max(block_size_, size + alignment));
+      ptr = AlignUp(cur_, alignment);
+    }
+    cur_ = ptr + size;
+    allocated_size_ += size;
+    return reinterpret_cast<void*>(ptr);
+  }
+
+  template<typename T, typename... Args>
+  T* New(Args&&... args) {
+    return new (Allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+  }
+
+  size_t allocated_size() const { return allocated_size_; }
+  size_t block_num() const { return blocks_.size(); }
+
+ private:
+  static uintptr_t AlignUp(uintptr_t ptr, size_t alignment) {
+    return (ptr + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1);
+  }
+
+  void NewBlock(size_t size) {
+    blocks_.emplace_back(new char[size]);
+    cur_ = reinterpret_cast<uintptr_t>(blocks_.back().get());
+    end_ = cur_ + size;
+  }
+
+  const size_t block_size_;
+  std::vector<std::unique_ptr<char[]>> blocks_;
+  uintptr_t cur_;
+  uintptr_t end_;
+  size_t allocated_size_;
+};
+
+}  // namespace oneflow
+
+#endif  // ONEFLOW_CORE_COMMON_MONOTONIC_ARENA_H_
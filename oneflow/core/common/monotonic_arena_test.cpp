@@ -0,0 +1,83 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "oneflow/core/common/monotonic_arena.h"
+#include "gtest/gtest.h"
+
+namespace oneflow {
+
+namespace test {
+
+namespace {
+
+struct alignas(64) CacheLineAligned {
+  char data[8];
+};
+
+struct Counted {
+  explicit Counted(int64_t* cnt) : cnt(cnt) { ++*cnt; }
+  ~Counted() { --*cnt; }
+  int64_t* cnt;
+};
+
+}  // namespace
+
+TEST(MonotonicArena, contiguous_in_one_block) {
+  MonotonicArena arena(1024);
+  int64_t* first = arena.New<int64_t>(1);
+  int64_t* second = arena.New<int64_t>(2);
+  ASSERT_EQ(second, first + 1);
+  ASSERT_EQ(*first, 1);
+  ASSERT_EQ(*second, 2);
+  ASSERT_EQ(arena.block_num(), 1);
+  ASSERT_EQ(arena.allocated_size(), 2 * sizeof(int64_t));
+}
+
+TEST(MonotonicArena, alignment) {
+  MonotonicArena arena(1024);
+  arena.New<char>('x');
+  FOR_RANGE(int32_t, i, 0, 32) {
+    CacheLineAligned* ptr = arena.New<CacheLineAligned>();
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(ptr) % 64, 0);
+    arena.New<char>('y');
+  }
+}
+
+TEST(MonotonicArena, new_block) {
+  MonotonicArena arena(64);
+  FOR_RANGE(int32_t, i, 0, 16) { *arena.New<int64_t>() = i; }
+  ASSERT_GT(arena.block_num(), 1);
+  void* large = arena.Allocate(4096, 8);
+  std::memset(large, 0, 4096);
+  int64_t* after_large = arena.New<int64_t>(7);
+  ASSERT_EQ(*after_large, 7);
+}
+
+TEST(MonotonicArena, destructor_is_up_to_the_owner) {
+  int64_t cnt = 0;
+  {
+    MonotonicArena arena;
+    Counted* counted = arena.New<Counted>(&cnt);
+    arena.New<Counted>(&cnt);
+    ASSERT_EQ(cnt, 2);
+    counted->~Counted();
+    ASSERT_EQ(cnt, 1);
+  }
+  ASSERT_EQ(cnt, 1);
+}
+
+}  // namespace test
+
+}  // namespace oneflow
@@ -69,6 +69,14 @@ bool TxtString2PbMessage(const std::string& proto_str, PbMessage* msg) {
   return google::protobuf::TextFormat::ParseFromString(proto_str, msg);
 }
 
+void PbMessage2DeterministicString(const PbMessage& proto, std::string* str) {
+  str->clear();
+  google::protobuf::io::StringOutputStream string_stream(str);
+  google::protobuf::io::CodedOutputStream coded_stream(&string_stream);
+  coded_stream.SetSerializationDeterministic(true);
+  CHECK(proto.SerializePartialToCodedStream(&coded_stream));
+}
+
 bool HasFieldInPbMessage(const PbMessage& msg, const std::string& field_name) {
   PROTOBUF_GET_FIELDDESC(msg, field_name);
   return fd != nullptr;
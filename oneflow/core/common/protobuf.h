@@ -72,6 +72,10 @@ std::string PbMessage2TxtString(const PbMessage& proto);
 void PbMessage2TxtString(const PbMessage& proto, std::string* str);
 bool TxtString2PbMessage(const std::string& proto_str, PbMessage* proto);
 
+// Binary serialization with map entries in key order, equal messages give equal strings. Missing
+// required fields are allowed, e.g. in op confs without their op name
+void PbMessage2DeterministicString(const PbMessage& proto, std::string* str);
+
 // Does PbMessage have the field_name
 bool HasFieldInPbMessage(const PbMessage&, const std::string& field_name);
 
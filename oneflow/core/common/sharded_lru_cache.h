@@ -0,0 +1,157 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#ifndef ONEFLOW_CORE_COMMON_SHARDED_LRU_CACHE_H_
+#define ONEFLOW_CORE_COMMON_SHARDED_LRU_CACHE_H_
+
+#include <atomic>
+#include <list>
+#include <mutex>
+#include "oneflow/core/common/util.h"
+#include "oneflow/core/common/hash_eq_trait_ptr.h"
+
+namespace oneflow {
+
+// A thread-safe LRU map with a bounded number of entries. Keys are spread over independently
+// locked shards by hash, so concurrent lookups of different keys rarely contend, and every shard
+// evicts its own least recently used entries once it holds more than its share of the capacity.
+template<typename K, typename V>
+class ShardedLruCache final {
+ public:
+  OF_DISALLOW_COPY_AND_MOVE(ShardedLruCache);
+  static const size_t kDefaultShardNum = 64;
+
+  explicit ShardedLruCache(size_t capacity) : ShardedLruCache(capacity, kDefaultShardNum) {}
+  ShardedLruCache(size_t capacity, size_t shard_num)
+      : capacity_(0), hit_cnt_(0), miss_cnt_(0), eviction_cnt_(0) {
+    CHECK_GT(shard_num, 0);
+    FOR_RANGE(size_t, i, 0, shard_num) { shards_.emplace_back(new Shard()); }
+    SetCapacity(capacity);
+  }
+  ~ShardedLruCache() = default;
+
+  // on a hit, copies the value out and marks the entry as the most recently used one
+  bool Get(const K& key, V* value) { return Get(key, std::hash<K>()(key), value); }
+  bool Get(const K& key, size_t hash_value, V* value) {
+    Shard* shard = ShardForHash(hash_value);
+    {
+      std::unique_lock<std::mutex> lock(shard->mutex);
+      const auto& iter = shard->key2entry.find(HashEqTraitPtr<const K>(&key, hash_value));
+      if (iter != shard->key2entry.end()) {
+        shard->entries.splice(shard->entries.begin(), shard->entries, iter->second);
+        *value = iter->second->value;
+        hit_cnt_.fetch_add(1, std::memory_order_relaxed);
+        return true;
+      }
+    }
+    miss_cnt_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+
+  // inserts or overwrites the value of key, evicting the least recently used entries of the shard
+  // if it grows beyond its capacity
+  void Put(const K& key, const V& value) { Put(key, std::hash<K>()(key), value); }
+  void Put(const K& key, size_t hash_value, const V& value) {
+    Shard* shard = ShardForHash(hash_value);
+    std::unique_lock<std::mutex> lock(shard->mutex);
+    const auto& iter = shard->key2entry.find(HashEqTraitPtr<const K>(&key, hash_value));
+    if (iter != shard->key2entry.end()) {
+      iter->second->value = value;
+      shard->entries.splice(shard->entries.begin(), shard->entries, iter->second);
+      return;
+    }
+    shard->entries.emplace_front(Entry{key, value, hash_value});
+    const K* stored_key = &shard->entries.front().key;
+    shard->key2entry.emplace(HashEqTraitPtr<const K>(stored_key, hash_value),
+                             shard->entries.begin());
+    EvictIfFull(shard);
+  }
+
+  // the capacity is split evenly over the shards, rounding up
+  void SetCapacity(size_t capacity) {
+    CHECK_GT(capacity, 0);
+    if (capacity == capacity_.load()) { return; }
+    capacity_ = capacity;
+    const size_t shard_capacity = RoundUp(capacity, shards_.size()) / shards_.size();
+    for (auto& shard : shards_) {
+      std::unique_lock<std::mutex> lock(shard->mutex);
+      shard->capacity = shard_capacity;
+      EvictIfFull(shard.get());
+    }
+  }
+
+  void Clear() {
+    for (auto& shard : shards_) {
+      std::unique_lock<std::mutex> lock(shard->mutex);
+      shard->key2entry.clear();
+      shard->entries.clear();
+    }
+  }
+
+  size_t size() const {
+    size_t size = 0;
+    for (const auto& shard : shards_) {
+      std::unique_lock<std::mutex> lock(shard->mutex);
+      size += shard->entries.size();
+    }
+    return size;
+  }
+  size_t capacity() const { return capacity_; }
+  int64_t hit_cnt() const { return hit_cnt_; }
+  int64_t miss_cnt() const { return miss_cnt_; }
+  int64_t eviction_cnt() const { return eviction_cnt_; }
+
+ private:
+  struct Entry final {
+    K key;
+    V value;
+    size_t hash_value;
+  };
+  using EntryList = std::list<Entry>;
+  struct Shard final {
+    std::mutex mutex;
+    size_t capacity;
+    EntryList entries;
+    std::unordered_map<HashEqTraitPtr<const K>, typename EntryList::iterator> key2entry;
+  };
+
+  Shard* ShardForHash(size_t hash_value) const {
+    // the shard maps use the same hash value for their buckets, mix it before picking a shard
+    uint64_t h = hash_value;
+    h ^= h >> 33U;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33U;
+    return shards_.at(h % shards_.size()).get();
+  }
+
+  void EvictIfFull(Shard* shard) {
+    while (shard->entries.size() > shard->capacity) {
+      const Entry& last = shard->entries.back();
+      shard->key2entry.erase(HashEqTraitPtr<const K>(&last.key, last.hash_value));
+      shard->entries.pop_back();
+      eviction_cnt_.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  std::vector<std::unique_ptr<Shard>> shards_;
+  std::atomic<size_t> capacity_;
+  std::atomic<int64_t> hit_cnt_;
+  std::atomic<int64_t> miss_cnt_;
+  std::atomic<int64_t> eviction_cnt_;
+};
+
+}  // namespace oneflow
+
+#endif  // ONEFLOW_CORE_COMMON_SHARDED_LRU_CACHE_H_
@@ -0,0 +1,83 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "oneflow/core/common/sharded_lru_cache.h"
+#include <thread>
+
+namespace oneflow {
+
+namespace test {
+
+TEST(ShardedLruCache, get_and_put) {
+  ShardedLruCache<std::string, int64_t> cache(16, 1);
+  int64_t value = 0;
+  ASSERT_FALSE(cache.Get("a", &value));
+  cache.Put("a", 1);
+  cache.Put("b", 2);
+  ASSERT_TRUE(cache.Get("a", &value));
+  ASSERT_EQ(value, 1);
+  cache.Put("a", 3);
+  ASSERT_TRUE(cache.Get("a", &value));
+  ASSERT_EQ(value, 3);
+  ASSERT_EQ(cache.size(), 2);
+  ASSERT_EQ(cache.hit_cnt(), 2);
+  ASSERT_EQ(cache.miss_cnt(), 1);
+}
+
+TEST(ShardedLruCache, evict_least_recently_used) {
+  ShardedLruCache<int64_t, int64_t> cache(3, 1);
+  cache.Put(0, 0);
+  cache.Put(1, 10);
+  cache.Put(2, 20);
+  int64_t value = 0;
+  ASSERT_TRUE(cache.Get(0, &value));
+  cache.Put(3, 30);
+  ASSERT_EQ(cache.size(), 3);
+  ASSERT_EQ(cache.eviction_cnt(), 1);
+  ASSERT_FALSE(cache.Get(1, &value));
+  ASSERT_TRUE(cache.Get(0, &value));
+  ASSERT_TRUE(cache.Get(2, &value));
+  ASSERT_TRUE(cache.Get(3, &value));
+  cache.SetCapacity(1);
+  ASSERT_EQ(cache.size(), 1);
+  ASSERT_TRUE(cache.Get(3, &value));
+  ASSERT_EQ(value, 30);
+}
+
+TEST(ShardedLruCache, multi_thread) {
+  const int64_t capacity = 1024;
+  ShardedLruCache<int64_t, int64_t> cache(capacity);
+  std::vector<std::thread> threads;
+  FOR_RANGE(int64_t, t, 0, 4) {
+    threads.emplace_back([&cache, t]() {
+      FOR_RANGE(int64_t, i, 0, 10000) {
+        const int64_t key = (i * 7 + t) % 4096;
+        int64_t value = 0;
+        if (cache.Get(key, &value)) {
+          ASSERT_EQ(value, key * 2);
+        } else {
+          cache.Put(key, key * 2);
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) { thread.join(); }
+  ASSERT_LE(cache.size(), RoundUp(capacity, ShardedLruCache<int64_t, int64_t>::kDefaultShardNum));
+  ASSERT_EQ(cache.hit_cnt() + cache.miss_cnt(), 4 * 10000);
+}
+
+}  // namespace test
+
+}  // namespace oneflow
@@ -17,6 +17,7 @@ limitations under the License.
 #define ONEFLOW_CORE_DEVICE_CUDA_UTIL_H_
 
 #include "oneflow/core/common/data_type.h"
+#include "oneflow/core/common/platform.h"
 
 #ifdef WITH_CUDA
 
@@ -89,6 +90,11 @@ inline size_t GetCudaWorkTypeSize() { return OF_PP_SEQ_SIZE(CUDA_WORK_TYPE_SEQ);
 
 void NumaAwareCudaMallocHost(int32_t dev, void** ptr, size_t size);
 
+#ifdef PLATFORM_POSIX
+// the cpus on the numa node of the device
+void CudaDeviceGetCpuAffinity(int32_t dev_id, cpu_set_t* cpu_set);
+#endif
+
 template<typename T>
 void NumaAwareCudaMallocHost(int32_t dev, T** ptr, size_t size) {
   NumaAwareCudaMallocHost(dev, reinterpret_cast<void**>(ptr), size);
@@ -16,6 +16,8 @@ limitations under the License.
 #include "oneflow/core/device/memory_copier.h"
 #include "oneflow/core/common/auto_registration_factory.h"
 #include "oneflow/core/common/nd_index_offset_helper.h"
+#include "oneflow/core/kernel/util/host_simd_util.h"
+#include "oneflow/core/thread/thread_manager.h"
 
 namespace oneflow {
 
@@ -75,28 +77,65 @@ MemoryCopyNdDesc GetDescInBytes(const MemoryCopyNdDesc& desc) {
   return desc_in_bytes;
 }
 
+// Copies at least this large write their destination with streaming stores: they would evict
+// most of the last level cache anyway, and nobody reads a boxing output right after writing it.
+constexpr int64_t kNonTemporalMinCopySize = 8 * 1024 * 1024;
+// Streaming stores only pay off for rows spanning a few cache lines.
+constexpr int64_t kNonTemporalMinRowSize = 512;
+
+void HostCopySpan(void* dst, const void* src, size_t count, bool non_temporal) {
+  if (non_temporal) {
+    HostNonTemporalMemcpy(dst, src, count);
+  } else {
+    std::memcpy(dst, src, count);
+  }
+}
+
 }  // namespace
 
 template<int32_t NDIMS>
 void CopyNDCpuImpl(DeviceCtx* ctx, void* dst, const void* src, const MemoryCopyNdDesc& desc) {
-  NdIndexOffsetHelper<int64_t, NDIMS> src_helper(desc.src_shape.dim_vec().data());
-  NdIndexOffsetHelper<int64_t, NDIMS> dst_helper(desc.dst_shape.dim_vec().data());
-  NdIndexOffsetHelper<int64_t, NDIMS> copy_helper(desc.extent.dim_vec().data());
-  FOR_RANGE(int64_t, i, 0, desc.extent.elem_cnt()) {
-    int64_t copy_idx[NDIMS];
-    int64_t src_idx[NDIMS];
-    int64_t dst_idx[NDIMS];
-    copy_helper.OffsetToNdIndex(i, copy_idx);
-    FOR_RANGE(int64_t, j, 0, NDIMS) {
-      src_idx[j] = desc.src_pos.At(j) + copy_idx[j];
-      dst_idx[j] = desc.dst_pos.At(j) + copy_idx[j];
-    }
-    const int64_t src_offset = src_helper.NdIndexToOffset(src_idx);
-    const int64_t dst_offset = dst_helper.NdIndexToOffset(dst_idx);
-    unsigned char* dst_ptr = reinterpret_cast<unsigned char*>(dst) + dst_offset;
-    const unsigned char* src_ptr = reinterpret_cast<const unsigned char*>(src) + src_offset;
-    *dst_ptr = *src_ptr;
+  static_assert(NDIMS >= 2, "");
+  // The innermost axis is contiguous in both tensors: copy the box row by row with memcpy and walk
+  // the outer axes with an odometer, so there is no division per row.
+  int64_t src_strides[NDIMS];
+  int64_t dst_strides[NDIMS];
+  src_strides[NDIMS - 1] = 1;
+  dst_strides[NDIMS - 1] = 1;
+  for (int32_t i = NDIMS - 2; i >= 0; --i) {
+    src_strides[i] = src_strides[i + 1] * desc.src_shape.At(i + 1);
+    dst_strides[i] = dst_strides[i + 1] * desc.dst_shape.At(i + 1);
   }
+  const int64_t row_size = desc.extent.At(NDIMS - 1);
+  const int64_t num_rows = desc.extent.Count(0, NDIMS - 1);
+  const bool non_temporal =
+      num_rows * row_size >= kNonTemporalMinCopySize && row_size >= kNonTemporalMinRowSize;
+  const NdIndexOffsetHelper<int64_t, NDIMS - 1> row_helper(desc.extent.dim_vec().data());
+  const unsigned char* src_ptr = reinterpret_cast<const unsigned char*>(src);
+  unsigned char* dst_ptr = reinterpret_cast<unsigned char*>(dst);
+  // a copied row is read once and written once
+  const int64_t grain_size = MultiThreadLoopGrainSize(2 * row_size);
+  MultiThreadLoop(num_rows, grain_size, [&](int64_t begin, int64_t end) {
+    int64_t row_idx[NDIMS - 1];
+    row_helper.OffsetToNdIndex(begin, row_idx);
+    int64_t src_offset = desc.src_pos.At(NDIMS - 1);
+    int64_t dst_offset = desc.dst_pos.At(NDIMS - 1);
+    FOR_RANGE(int32_t, i, 0, NDIMS - 1) {
+      src_offset += (desc.src_pos.At(i) + row_idx[i]) * src_strides[i];
+      dst_offset += (desc.dst_pos.At(i) + row_idx[i]) * dst_strides[i];
+    }
+    FOR_RANGE(int64_t, row, begin, end) {
+      HostCopySpan(dst_ptr + dst_offset, src_ptr + src_offset, row_size, non_temporal);
+      for (int32_t i = NDIMS - 2; i >= 0; --i) {
+        src_offset += src_strides[i];
+        dst_offset += dst_strides[i];
+        if (++row_idx[i] < desc.extent.At(i)) { break; }
+        src_offset -= desc.extent.At(i) * src_strides[i];
+        dst_offset -= desc.extent.At(i) * dst_strides[i];
+        row_idx[i] = 0;
+      }
+    }
+  });
 }
 
 MemoryCopyNdDesc MemoryCopyNdDesc::CreateDimReducedDesc() const {
@@ -194,14 +233,43 @@ void MemoryCopier::CopyND(DeviceCtx* ctx, void* dst, const void* src,
   UNIMPLEMENTED();
 }
 
+void HostMemoryCopier::Copy(DeviceCtx* ctx, void* dst, const void* src,
+                            const MemoryCopyNdDesc& desc) const {
+  CheckMemoryCopyNdDesc(desc);
+  const int64_t num_axes = MemoryCopyNdDescGetNumAxes(desc);
+  if (num_axes == 1) {
+    Copy1D(ctx, (unsigned char*)dst + desc.dst_pos.At(0), (unsigned char*)src + desc.src_pos.At(0),
+           desc.extent.At(0));
+  } else {
+    // 2d and 3d boxes go through the same row engine as higher ranks, which splits their rows
+    // over the thread pool instead of looping over planes on the calling thread.
+    CopyND(ctx, dst, src, desc);
+  }
+}
+
 void HostMemoryCopier::Copy1D(DeviceCtx* ctx, void* dst, const void* src, size_t count) const {
-  memcpy(dst, src, count);
+  // Split into parts of whole cache lines so that no two threads write to the same line.
+  constexpr int64_t kCacheLineSize = 64;
+  const int64_t num_lines = RoundUp(count, kCacheLineSize) / kCacheLineSize;
+  const bool non_temporal = count >= kNonTemporalMinCopySize;
+  const int64_t grain_size = MultiThreadLoopGrainSize(2 * kCacheLineSize);
+  MultiThreadLoop(num_lines, grain_size, [&](int64_t line_begin, int64_t line_end) {
+    const int64_t begin = line_begin * kCacheLineSize;
+    const int64_t end = std::min<int64_t>(line_end * kCacheLineSize, count);
+    if (end <= begin) { return; }
+    HostCopySpan((unsigned char*)dst + begin, (const unsigned char*)src + begin, end - begin,
+                 non_temporal);
+  });
 }
 
 void HostMemoryCopier::CopyND(DeviceCtx* ctx, void* dst, const void* src,
                               const MemoryCopyNdDesc& desc) const {
   const int32_t num_axes = desc.src_shape.NumAxes();
-  if (num_axes == 4) {
+  if (num_axes == 2) {
+    CopyNDCpuImpl<2>(ctx, dst, src, desc);
+  } else if (num_axes == 3) {
+    CopyNDCpuImpl<3>(ctx, dst, src, desc);
+  } else if (num_axes == 4) {
     CopyNDCpuImpl<4>(ctx, dst, src, desc);
   } else if (num_axes == 5) {
     CopyNDCpuImpl<5>(ctx, dst, src, desc);
@@ -281,6 +349,8 @@ SPECIALIZE_COPY_ELEM(int8_t)
 #define SPECIALIZE_COPY_ND_CPU_IMPL(NDIMS)                                        \
   template void CopyNDCpuImpl<NDIMS>(DeviceCtx * ctx, void* dst, const void* src, \
                                      const MemoryCopyNdDesc& desc);
+SPECIALIZE_COPY_ND_CPU_IMPL(2)
+SPECIALIZE_COPY_ND_CPU_IMPL(3)
 SPECIALIZE_COPY_ND_CPU_IMPL(4)
 SPECIALIZE_COPY_ND_CPU_IMPL(5)
 SPECIALIZE_COPY_ND_CPU_IMPL(6)
@@ -65,6 +65,9 @@ class HostMemoryCopier final : public MemoryCopier {
   HostMemoryCopier() = default;
   ~HostMemoryCopier() override = default;
 
+  void Copy(DeviceCtx* ctx, void* dst, const void* src,
+            const MemoryCopyNdDesc& desc) const override;
+
  private:
   void Copy1D(DeviceCtx* ctx, void* dst, const void* src, size_t count) const override;
   void CopyND(DeviceCtx* ctx, void* dst, const void* src,
@@ -35,6 +35,8 @@ class CpuCallOpKernelInstructionType final : public CallOpKernelInstructionType
 
   using stream_type = vm::CpuStreamType;
 
+  bool Fusible() const override { return true; }
+
  private:
   const char* device_tag() const override { return stream_type().device_tag(); }
 };
@@ -48,6 +50,8 @@ class CpuUserStatelessCallOpKernelInstructionType final
 
   using stream_type = vm::CpuStreamType;
 
+  bool Fusible() const override { return true; }
+
  private:
   const char* device_tag() const override { return stream_type().device_tag(); }
 };
@@ -62,6 +66,8 @@ class CpuSystemStatelessCallOpKernelInstructionType final
 
   using stream_type = vm::CpuStreamType;
 
+  bool Fusible() const override { return true; }
+
  private:
   const char* device_tag() const override { return stream_type().device_tag(); }
 };
@@ -20,8 +20,9 @@ namespace oneflow {
 
 namespace user_op {
 
-void MultiThreadLoopInOpKernel(size_t num, std::function<void(size_t i)> Callback) {
-  MultiThreadLoop(num, Callback);
+void MultiThreadLoopInOpKernel(int64_t num, int64_t grain_size,
+                               const std::function<void(int64_t begin, int64_t end)>& Handler) {
+  MultiThreadLoop(num, grain_size, Handler);
 }
 
 }  // namespace user_op
@@ -22,7 +22,8 @@ namespace oneflow {
 
 namespace user_op {
 
-void MultiThreadLoopInOpKernel(size_t num, std::function<void(size_t i)> Callback);
+void MultiThreadLoopInOpKernel(int64_t num, int64_t grain_size,
+                               const std::function<void(int64_t begin, int64_t end)>& Handler);
 
 }  // namespace user_op
 
@@ -16,6 +16,8 @@ limitations under the License.
 #include "oneflow/core/framework/op_kernel_infer_cache.h"
 #include "oneflow/core/framework/op_kernel.h"
 #include "oneflow/core/operator/operator.h"
+#include "oneflow/core/job/resource_desc.h"
+#include "oneflow/core/job/global_for.h"
 
 namespace oneflow {
 
@@ -24,23 +26,22 @@ namespace user_op {
 OpKernelInferCache::OpKernelInferCache(const KernelConf& kernel_conf, const JobDesc& job_desc) {
   const OperatorConf& op_conf = kernel_conf.op_attribute().op_conf();
   std::shared_ptr<Operator> op = ConstructOp(op_conf, &job_desc);
-  cache_key_.job_desc = &job_desc;
+  cache_key_.job_conf_sym = SymbolOf(job_desc.job_conf());
   cache_key_.op_conf_sym = op->GetOpConfWithoutOpNameAndLbn();
   cache_key_.ibn_idx2shape_sym.resize(op->input_bns().size());
   cache_key_.dtype_signature_sym = SymbolOf(kernel_conf.dtype_signature());
-}
-
-bool OpKernelInferCache::IsCacheHit() const {
-  size_t hash_value = std::hash<KeyType>()(cache_key_);
-  HashEqTraitPtr<const KeyType> ptr_wrapper(&cache_key_, hash_value);
-  return cached_key2value_.find(ptr_wrapper) != cached_key2value_.end();
+  cache_key_.parallel_id = kernel_conf.user_conf().parallel_ctx().parallel_id();
+  cache_key_.parallel_num = kernel_conf.user_conf().parallel_ctx().parallel_num();
+  const auto* resource_desc = Global<ResourceDesc, ForSession>::Get();
+  if (resource_desc != nullptr) {
+    GlobalStore()->SetCapacity(resource_desc->kernel_infer_cache_max_size());
+  }
 }
 
 OpKernelInferCache::ValueType OpKernelInferCache::GetCacheValue() const {
-  size_t hash_value = std::hash<KeyType>()(cache_key_);
-  HashEqTraitPtr<const KeyType> ptr_wrapper(&cache_key_, hash_value);
-  CHECK(cached_key2value_.find(ptr_wrapper) != cached_key2value_.end());
-  return cached_key2value_.at(ptr_wrapper);
+  ValueType value;
+  if (!GlobalStore()->Get(cache_key_, &value)) { return nullptr; }
+  return value;
 }
 
 void OpKernelInferCache::UpdateCacheKey(KernelInferContext* ctx) {
@@ -57,7 +58,6 @@ void OpKernelInferCache::UpdateCacheKey(KernelInferContext* ctx) {
 }
 
 void OpKernelInferCache::UpdateCacheValue(KernelInferContext* ctx) {
-  if (cached_key2value_.size() >= max_size_) { Reset(); }
   auto* cache_value = new OpInferCacheValue();
   cache_value->obn_idx2shape_sym.resize(ctx->outputs().size());
   FOR_RANGE(int, i, 0, ctx->outputs().size()) {
@@ -68,30 +68,13 @@ void OpKernelInferCache::UpdateCacheValue(KernelInferContext* ctx) {
     out_shape_view.ToShape(&out_shape);
     cache_value->obn_idx2shape_sym.at(i).reset(out_shape);
   }
-  KeyType* new_key = new KeyType(cache_key_);
-  key_storage_.emplace_back(new_key);
-  size_t hash_value = std::hash<KeyType>()(cache_key_);
-  HashEqTraitPtr<const KeyType> ptr_wrapper(new_key, hash_value);
-  CHECK(cached_key2value_.emplace(ptr_wrapper, ValueType(cache_value)).second);
+  GlobalStore()->Put(cache_key_, ValueType(cache_value));
 }
 
-void OpKernelInferCache::Reset() {
-  CHECK_EQ(cached_key2value_.size(), key_storage_.size());
-  HashMap to_release_key2values;
-  KeyStorage to_release_key_storage;
-  std::swap(cached_key2value_, to_release_key2values);
-  std::swap(key_storage_, to_release_key_storage);
-  if (to_release_key2values.size() <= kReleaseInIndependentThreadThreshold) {
-    to_release_key2values.clear();
-    to_release_key_storage.clear();
-  } else {
-    std::thread(
-        [](HashMap&& cache, KeyStorage&& key_storage) {
-          cache.clear();
-          key_storage.clear();
-        },
-        std::move(to_release_key2values), std::move(to_release_key_storage));
-  }
+OpKernelInferCache::Store* OpKernelInferCache::GlobalStore() {
+  // never destructed, kernels of any session may still look it up during process exit
+  static Store* store = new Store(kDefaultStoreCapacity);
+  return store;
 }
 
 }  // namespace user_op
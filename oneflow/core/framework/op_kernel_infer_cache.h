@@ -17,7 +17,7 @@ limitations under the License.
 #define ONEFLOW_CORE_FRAMEWORK_OP_KERNEL_INFER_CACHE_H_
 
 #include "oneflow/core/operator/op_infer_cache.h"
-#include "oneflow/core/common/hash_eq_trait_ptr.h"
+#include "oneflow/core/common/sharded_lru_cache.h"
 #include "oneflow/core/kernel/kernel.pb.h"
 
 namespace oneflow {
@@ -26,28 +26,29 @@ namespace user_op {
 
 class KernelInferContext;
 
+// Looks up the output shapes of a kernel by its op conf, parallel rank and input shapes. Results
+// live in a process-wide sharded LRU store, shared by all kernels of the same op conf and rank,
+// including the ones of later sessions, and bounded by Resource.kernel_infer_cache_max_size
+// entries.
 class OpKernelInferCache final {
  public:
   using KeyType = OpInferCacheKey;
   using ValueType = std::shared_ptr<const OpInferCacheValue>;
-  using HashMap = std::unordered_map<HashEqTraitPtr<const KeyType>, ValueType>;
-  using KeyStorage = std::list<std::unique_ptr<KeyType>>;
-  static constexpr size_t kReleaseInIndependentThreadThreshold = 4096;
+  using Store = ShardedLruCache<KeyType, ValueType>;
+  static const size_t kDefaultStoreCapacity = 65536;
 
   OpKernelInferCache(const KernelConf& kernel_conf, const JobDesc& job_desc);
   ~OpKernelInferCache() = default;
 
-  bool IsCacheHit() const;
+  // nullptr on a miss
   ValueType GetCacheValue() const;
   void UpdateCacheKey(KernelInferContext* ctx);
   void UpdateCacheValue(KernelInferContext* ctx);
-  void Reset();
+
+  static Store* GlobalStore();
 
  private:
   KeyType cache_key_;
-  HashMap cached_key2value_;
-  KeyStorage key_storage_;
-  size_t max_size_;
 };
 
 }  // namespace user_op
@@ -18,6 +18,8 @@ limitations under the License.
 #include "oneflow/core/graph/collective_boxing_task_node.h"
 #include "oneflow/core/graph/boxing/chain_sub_task_graph_builder.h"
 #include "oneflow/core/graph/slice_boxing_task_node.h"
+#include "oneflow/core/job/resource_desc.h"
+#include "oneflow/core/job/global_for.h"
 
 namespace oneflow {
 
@@ -25,13 +27,13 @@ using namespace boxing::collective;
 
 namespace {
 
-void NcclInitCollectiveNode(CollectiveBoxingGenericTaskNode* node,
-                            const ParallelDesc& parallel_desc, int64_t parallel_id,
-                            const std::string& name, const LogicalBlobId& lbi,
-                            const BlobDesc& logical_blob_desc, OpType op_type, int64_t root) {
+void InitCollectiveNode(CollectiveBoxingGenericTaskNode* node, const ParallelDesc& parallel_desc,
+                        int64_t parallel_id, const std::string& name, const LogicalBlobId& lbi,
+                        const BlobDesc& logical_blob_desc, OpType op_type, int64_t root,
+                        Backend backend) {
   OperatorConf op_conf;
   op_conf.set_name(name);
-  op_conf.set_device_type(DeviceType::kGPU);
+  op_conf.set_device_type(parallel_desc.device_type());
   CollectiveBoxingGenericOpConf* conf = op_conf.mutable_collective_boxing_generic_conf();
   *conf->mutable_lbi() = lbi;
   RankDesc* rank_desc = conf->mutable_rank_desc();
@@ -52,15 +54,40 @@ void NcclInitCollectiveNode(CollectiveBoxingGenericTaskNode* node,
   } else {
     CHECK_EQ(root, -1);
   }
-  op_desc->set_backend(Backend::kBackendNCCL);
+  op_desc->set_backend(backend);
   rank_desc->set_rank(parallel_id);
 
   const int64_t machine_id = parallel_desc.MachineIdForParallelId(parallel_id);
   const int64_t device_id = parallel_desc.DeviceIdForParallelId(parallel_id);
-  const int64_t thrd_id = Global<IDMgr>::Get()->GetGpuNcclThrdId(device_id);
+  int64_t thrd_id = -1;
+  if (backend == Backend::kBackendNCCL) {
+    CHECK_EQ(parallel_desc.device_type(), DeviceType::kGPU);
+    thrd_id = Global<IDMgr>::Get()->GetGpuNcclThrdId(device_id);
+  } else if (backend == Backend::kBackendCpu) {
+    CHECK_EQ(parallel_desc.device_type(), DeviceType::kCPU);
+    thrd_id = Global<IDMgr>::Get()->GetCpuDeviceThrdId(device_id);
+  } else {
+    UNIMPLEMENTED();
+  }
   node->Init(machine_id, thrd_id, NewAreaId(), op_conf);
 }
 
+void NcclInitCollectiveNode(CollectiveBoxingGenericTaskNode* node,
+                            const ParallelDesc& parallel_desc, int64_t parallel_id,
+                            const std::string& name, const LogicalBlobId& lbi,
+                            const BlobDesc& logical_blob_desc, OpType op_type, int64_t root) {
+  InitCollectiveNode(node, parallel_desc, parallel_id, name, lbi, logical_blob_desc, op_type, root,
+                     Backend::kBackendNCCL);
+}
+
+void CpuInitCollectiveNode(CollectiveBoxingGenericTaskNode* node,
+                           const ParallelDesc& parallel_desc, int64_t parallel_id,
+                           const std::string& name, const LogicalBlobId& lbi,
+                           const BlobDesc& logical_blob_desc, OpType op_type, int64_t root) {
+  InitCollectiveNode(node, parallel_desc, parallel_id, name, lbi, logical_blob_desc, op_type, root,
+                     Backend::kBackendCpu);
+}
+
 int64_t FindRootParallelId(const ParallelDesc& multi_device, const ParallelDesc& sole_device) {
   CHECK_EQ(sole_device.parallel_num(), 1);
   const int64_t root_machine_id = sole_device.MachineIdForParallelId(0);
@@ -76,6 +103,17 @@ int64_t FindRootParallelId(const ParallelDesc& multi_device, const ParallelDesc&
   return root_parallel_id;
 }
 
+// The cpu backend exchanges data through shared memory, so every rank has to live in this
+// process: only cpu placements on a single machine are accepted.
+bool IsCpuBackendSupported(const ParallelDesc& parallel_desc, const BlobDesc& logical_blob_desc) {
+  return Global<ResourceDesc, ForSession>::Get()->collective_boxing_conf().enable_cpu_backend()
+         && parallel_desc.device_type() == DeviceType::kCPU
+         && parallel_desc.sorted_machine_ids().size() == 1
+         && !SubTskGphBuilderUtil::BlobHasDynamicShape(logical_blob_desc)
+         && (IsFloatingDataType(logical_blob_desc.data_type())
+             || IsIntegralDataType(logical_blob_desc.data_type()));
+}
+
 bool IsSourceTimeShape(const Shape& shape) {
   return shape.elem_cnt() == GlobalJobDesc().TotalBatchNum() * GlobalJobDesc().NumOfPiecesInBatch();
 }
@@ -351,6 +389,89 @@ class NcclCollectiveBoxingBroadcastSubTskGphBuilder final : public SubTskGphBuil
     }
   }
 };
+
+class CpuCollectiveBoxingSubTskGphBuilder final : public SubTskGphBuilder {
+ public:
+  OF_DISALLOW_COPY_AND_MOVE(CpuCollectiveBoxingSubTskGphBuilder);
+  CpuCollectiveBoxingSubTskGphBuilder() = default;
+  ~CpuCollectiveBoxingSubTskGphBuilder() override = default;
+
+  Maybe<void> Build(SubTskGphBuilderCtx* ctx,
+                    const std::vector<CompTaskNode*>& sorted_src_comp_tasks,
+                    const std::vector<CompTaskNode*>& sorted_dst_comp_tasks,
+                    const ParallelDesc& src_parallel_desc, const ParallelDesc& dst_parallel_desc,
+                    const LogicalBlobId& lbi, const BlobDesc& logical_blob_desc,
+                    const SbpParallel& src_sbp_parallel,
+                    const SbpParallel& dst_sbp_parallel) const override {
+    if (!IsCpuBackendSupported(src_parallel_desc, logical_blob_desc)
+        || !IsCpuBackendSupported(dst_parallel_desc, logical_blob_desc)) {
+      return Error::BoxingNotSupported();
+    }
+    if (dst_parallel_desc.Equals(src_parallel_desc) && dst_parallel_desc.parallel_num() > 1) {
+      const int64_t parallel_num = dst_parallel_desc.parallel_num();
+      OpType op_type = OpType::kOpTypeInvalid;
+      if (SubTskGphBuilderUtil::IsBoxingP2B(src_sbp_parallel, dst_sbp_parallel)) {
+        op_type = OpType::kOpTypeAllReduce;
+      } else if (SubTskGphBuilderUtil::IsBoxingP2S(src_sbp_parallel, dst_sbp_parallel)
+                 && dst_sbp_parallel.split_parallel().axis() == 0
+                 && logical_blob_desc.shape().At(0) % parallel_num == 0) {
+        op_type = OpType::kOpTypeReduceScatter;
+      } else if (SubTskGphBuilderUtil::IsBoxingS2B(src_sbp_parallel, dst_sbp_parallel)
+                 && src_sbp_parallel.split_parallel().axis() == 0
+                 && logical_blob_desc.shape().At(0) % parallel_num == 0) {
+        op_type = OpType::kOpTypeAllGather;
+      } else {
+        return Error::BoxingNotSupported();
+      }
+      const std::string op_name = "System-Boxing-CpuCollectiveBoxing-" + NewUniqueId();
+      FOR_RANGE(int64_t, i, 0, parallel_num) {
+        CompTaskNode* src_node = sorted_src_comp_tasks.at(i);
+        CompTaskNode* dst_node = sorted_dst_comp_tasks.at(i);
+        auto* collective_node = ctx->task_graph()->NewNode<CollectiveBoxingGenericTaskNode>();
+        CpuInitCollectiveNode(collective_node, src_parallel_desc, i, op_name, lbi,
+                              logical_blob_desc, op_type, -1);
+        Connect<TaskNode>(src_node, ctx->task_graph()->NewEdge(), collective_node);
+        Connect<TaskNode>(collective_node, ctx->task_graph()->NewEdge(), dst_node);
+      }
+      return Maybe<void>::Ok();
+    } else if (src_parallel_desc.parallel_num() > 1 && dst_parallel_desc.parallel_num() == 1
+               && src_sbp_parallel.has_partial_sum_parallel()) {
+      const int64_t root_parallel_id = FindRootParallelId(src_parallel_desc, dst_parallel_desc);
+      if (root_parallel_id == -1) { return Error::BoxingNotSupported(); }
+      const std::string op_name = "System-Boxing-CpuCollectiveBoxingReduce-" + NewUniqueId();
+      CompTaskNode* dst_node = sorted_dst_comp_tasks.front();
+      FOR_RANGE(int64_t, i, 0, src_parallel_desc.parallel_num()) {
+        CompTaskNode* src_node = sorted_src_comp_tasks.at(i);
+        auto* collective_node = ctx->task_graph()->NewNode<CollectiveBoxingGenericTaskNode>();
+        CpuInitCollectiveNode(collective_node, src_parallel_desc, i, op_name, lbi,
+                              logical_blob_desc, OpType::kOpTypeReduce, root_parallel_id);
+        Connect<TaskNode>(src_node, ctx->task_graph()->NewEdge(), collective_node);
+        if (i != root_parallel_id) { collective_node->BuildCtrlRegstDesc(dst_node); }
+        Connect<TaskNode>(collective_node, ctx->task_graph()->NewEdge(), dst_node);
+      }
+      return Maybe<void>::Ok();
+    } else if (src_parallel_desc.parallel_num() == 1 && dst_parallel_desc.parallel_num() > 1
+               && dst_sbp_parallel.has_broadcast_parallel()) {
+      const int64_t root_parallel_id = FindRootParallelId(dst_parallel_desc, src_parallel_desc);
+      if (root_parallel_id == -1) { return Error::BoxingNotSupported(); }
+      const std::string op_name = "System-Boxing-CpuCollectiveBoxingBroadcast-" + NewUniqueId();
+      CompTaskNode* src_node = sorted_src_comp_tasks.front();
+      FOR_RANGE(int64_t, i, 0, dst_parallel_desc.parallel_num()) {
+        CompTaskNode* dst_node = sorted_dst_comp_tasks.at(i);
+        auto* collective_node = ctx->task_graph()->NewNode<CollectiveBoxingGenericTaskNode>();
+        CpuInitCollectiveNode(collective_node, dst_parallel_desc, i, op_name, lbi,
+                              logical_blob_desc, OpType::kOpTypeBroadcast, root_parallel_id);
+        if (i != root_parallel_id) { src_node->BuildCtrlRegstDesc(collective_node); }
+        Connect<TaskNode>(src_node, ctx->task_graph()->NewEdge(), collective_node);
+        Connect<TaskNode>(collective_node, ctx->task_graph()->NewEdge(), dst_node);
+      }
+      return Maybe<void>::Ok();
+    } else {
+      return Error::BoxingNotSupported();
+    }
+  }
+};
+
 }  // namespace
 
 CollectiveBoxingSubTskGphBuilder::CollectiveBoxingSubTskGphBuilder() {
@@ -361,6 +482,7 @@ CollectiveBoxingSubTskGphBuilder::CollectiveBoxingSubTskGphBuilder() {
   builders.emplace_back(new NcclCollectiveBoxingReduceSubTskGphBuilder());
   builders.emplace_back(new CollectiveBoxingScatterThenNcclAllGatherSubTskGphBuilder());
   builders.emplace_back(new NcclCollectiveBoxingBroadcastSubTskGphBuilder());
+  builders.emplace_back(new CpuCollectiveBoxingSubTskGphBuilder());
   chain_builder_.reset(new ChainSubTskGphBuilder(builders));
 }
 
@@ -139,8 +139,7 @@ void ChainActSubGraph::InitNodes(
     chain_id_with_act_id2act_events[chain_act_id_pair].push_back(std::move(act_event));
   }
   for (auto& pair : chain_id_with_act_id2act_events) {
-    ChainActNode* chain_act_node = new ChainActNode(pair.first, std::move(pair.second));
-    AddAllocatedNode(chain_act_node);
+    ChainActNode* chain_act_node = NewNode(pair.first, std::move(pair.second));
     chain_act_node->ForEachActEvent([&](const ActEvent* act_event) {
       int64_t act_id = act_event->act_id();
       const TaskProto& task_proto = GetTaskProto(act_event->actor_id());
@@ -177,9 +176,7 @@ void ChainActSubGraph::InitEdges(
       }
     });
     for (const auto& pair : producer2max_stop_time) {
-      ChainActEdge* edge = new ChainActEdge(pair.second);
-      AddAllocatedEdge(edge);
-      Connect(pair.first, edge, mut_node);
+      Connect(pair.first, NewEdge(pair.second), mut_node);
     }
   });
 }
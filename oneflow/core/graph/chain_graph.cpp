@@ -389,11 +389,10 @@ void ChainGraph::PartialPriorTopoForEachNode(
 
 void ChainGraph::InitChainNode(const std::vector<std::vector<TaskNode*>>& chains) {
   for (auto& chain : chains) {
-    ChainNode* chain_node = new ChainNode(chain);
+    ChainNode* chain_node = NewNode(chain);
     for (auto& task_node : chain) {
       CHECK(task_node2chain_node_.emplace(task_node, chain_node).second);
     }
-    AddAllocatedNode(chain_node);
   }
 }
 
@@ -16,8 +16,12 @@ limitations under the License.
 #ifndef ONEFLOW_CORE_GRAPH_GRAPH_H_
 #define ONEFLOW_CORE_GRAPH_GRAPH_H_
 
+#include <atomic>
 #include <stack>
 #include "oneflow/core/common/str_util.h"
+#include "oneflow/core/common/monotonic_arena.h"
+#include "oneflow/core/common/blocking_counter.h"
+#include "oneflow/core/thread/thread_pool.h"
 #include "oneflow/core/graph/node.h"
 #include "oneflow/core/persistence/tee_persistent_log_stream.h"
 
@@ -41,6 +45,15 @@ class Graph {
   void SortedTopoForEachNode(std::function<bool(const EdgeType* lhs, const EdgeType* rhs)> LessThan,
                              std::function<void(NodeType*)> NodeHandler) const;
 
+  // Parallel For Each: handlers run concurrently on the global ThreadPool, so they may only write
+  // to the node they are given or to what it owns. Without a ThreadPool they run one by one.
+  void ParallelForEachNode(std::function<void(NodeType*)> NodeHandler) const;
+  // level-synchronous, a node is handled once all of its in nodes are, together with the other
+  // nodes becoming ready at the same time
+  void ParallelTopoForEachNode(std::function<void(NodeType*)> NodeHandler) const;
+  Maybe<void> ParallelTopoForEachNodeWithErrorCaptured(
+      std::function<Maybe<void>(NodeType*)> NodeHandler) const;
+
   void BfsForEachNode(
       const std::list<NodeType*>& starts,
       const std::function<void(NodeType*, const std::function<void(NodeType*)>&)>& ForEachNext,
@@ -120,10 +133,10 @@ class Graph {
   virtual const char* TypeName() const { return ""; }
 
   // Setters
-  template<typename DerivedNodeType = NodeType>
-  DerivedNodeType* NewNode();
+  template<typename DerivedNodeType = typename std::remove_const<NodeType>::type, class... Args>
+  DerivedNodeType* NewNode(Args&&... args);
   template<class... Args>
-  EdgeType* NewEdge(Args&&... args);
+  typename std::remove_const<EdgeType>::type* NewEdge(Args&&... args);
   void AddAllocatedNode(NodeType*);
   void AddAllocatedEdge(EdgeType*);
   void DeleteNode(NodeType*);
@@ -156,8 +169,26 @@ class Graph {
 
   void FfsForEachNode(const std::function<void(NodeType*)>& Handler) const;
 
-  std::vector<std::unique_ptr<NodeType>> nodes_;
-  std::vector<std::unique_ptr<EdgeType>> edges_;
+  static void ParallelForEach(const std::vector<NodeType*>& nodes,
+                              const std::function<void(NodeType*)>& Handler);
+
+  // Nodes and edges made by NewNode and NewEdge are placed in arena_, while the ones handed over
+  // by AddAllocatedNode and AddAllocatedEdge were allocated with new by the caller
+  struct Deleter {
+    bool in_arena;
+    template<typename T>
+    void operator()(T* ptr) const {
+      if (in_arena) {
+        ptr->~T();
+      } else {
+        delete ptr;
+      }
+    }
+  };
+
+  MonotonicArena arena_;
+  std::vector<std::unique_ptr<NodeType, Deleter>> nodes_;
+  std::vector<std::unique_ptr<EdgeType, Deleter>> edges_;
 };
 
 template<typename NodeType, typename EdgeType>
@@ -219,6 +250,94 @@ void Graph<NodeType, EdgeType>::SortedTopoForEachNode(
                   &NodeType::ForEachNodeOnSortedOutEdge, NodeHandler);
 }
 
+template<typename NodeType, typename EdgeType>
+void Graph<NodeType, EdgeType>::ParallelForEach(const std::vector<NodeType*>& nodes,
+                                                const std::function<void(NodeType*)>& Handler) {
+  ThreadPool* thread_pool = Global<ThreadPool>::Get();
+  if (thread_pool == nullptr || thread_pool->thread_num() <= 1 || nodes.size() <= 1) {
+    for (NodeType* node : nodes) { Handler(node); }
+    return;
+  }
+  // The calling thread takes nodes as well and the workers share the ownership of the state, so
+  // a traversal started inside a handler still finishes when every pool thread is busy waiting.
+  struct State {
+    State(const std::vector<NodeType*>* nodes, const std::function<void(NodeType*)>* Handler)
+        : nodes(nodes), Handler(Handler), size(nodes->size()), next(0), counter(nodes->size()) {}
+    const std::vector<NodeType*>* nodes;
+    const std::function<void(NodeType*)>* Handler;
+    const size_t size;
+    std::atomic<size_t> next;
+    BlockingCounter counter;
+  };
+  const auto state = std::make_shared<State>(&nodes, &Handler);
+  const std::function<void()> Work = [state]() {
+    while (true) {
+      const size_t i = state->next.fetch_add(1);
+      if (i >= state->size) { return; }
+      (*state->Handler)(state->nodes->at(i));
+      state->counter.Decrease();
+    }
+  };
+  const size_t work_num = std::min<size_t>(thread_pool->thread_num(), nodes.size() - 1);
+  FOR_RANGE(size_t, i, 0, work_num) { thread_pool->AddWork(Work); }
+  Work();
+  state->counter.WaitUntilCntEqualZero();
+}
+
+template<typename NodeType, typename EdgeType>
+void Graph<NodeType, EdgeType>::ParallelForEachNode(
+    std::function<void(NodeType*)> NodeHandler) const {
+  std::vector<NodeType*> nodes;
+  nodes.reserve(nodes_.size());
+  for (const auto& node : nodes_) { nodes.push_back(node.get()); }
+  ParallelForEach(nodes, NodeHandler);
+}
+
+template<typename NodeType, typename EdgeType>
+void Graph<NodeType, EdgeType>::ParallelTopoForEachNode(
+    std::function<void(NodeType*)> NodeHandler) const {
+  CHECK_JUST(ParallelTopoForEachNodeWithErrorCaptured([&](NodeType* node) {
+    NodeHandler(node);
+    return Maybe<void>::Ok();
+  }));
+}
+
+template<typename NodeType, typename EdgeType>
+Maybe<void> Graph<NodeType, EdgeType>::ParallelTopoForEachNodeWithErrorCaptured(
+    std::function<Maybe<void>(NodeType*)> NodeHandler) const {
+  HashMap<NodeType*, int64_t> node2pending_in_cnt;
+  std::vector<NodeType*> ready_nodes;
+  ForEachNode([&](NodeType* node) {
+    int64_t in_cnt = 0;
+    node->ForEachNodeOnInEdge([&](NodeType*) { ++in_cnt; });
+    if (in_cnt == 0) {
+      ready_nodes.push_back(node);
+    } else {
+      node2pending_in_cnt[node] = in_cnt;
+    }
+  });
+  while (!ready_nodes.empty()) {
+    std::vector<std::shared_ptr<ErrorProto>> errors(ready_nodes.size());
+    HashMap<NodeType*, size_t> node2index;
+    FOR_RANGE(size_t, i, 0, ready_nodes.size()) { node2index[ready_nodes.at(i)] = i; }
+    ParallelForEach(ready_nodes, [&](NodeType* node) {
+      const auto& maybe = NodeHandler(node);
+      if (!maybe.IsOk()) { errors.at(node2index.at(node)) = maybe.error(); }
+    });
+    for (const auto& error : errors) {
+      if (error) { return error; }
+    }
+    std::vector<NodeType*> next_ready_nodes;
+    for (NodeType* node : ready_nodes) {
+      node->ForEachNodeOnOutEdge([&](NodeType* out) {
+        if (--node2pending_in_cnt.at(out) == 0) { next_ready_nodes.push_back(out); }
+      });
+    }
+    ready_nodes.swap(next_ready_nodes);
+  }
+  return Maybe<void>::Ok();
+}
+
 template<typename NodeType, typename EdgeType>
 void Graph<NodeType, EdgeType>::ReverseTopoForEachNode(
     std::function<void(NodeType*)> NodeHandler) const {
@@ -241,35 +360,37 @@ NodeType* Graph<NodeType, EdgeType>::SoleNode() const {
 }
 
 template<typename NodeType, typename EdgeType>
-template<typename DerivedNodeType>
-DerivedNodeType* Graph<NodeType, EdgeType>::NewNode() {
-  DerivedNodeType* ret = new DerivedNodeType;
-  AddAllocatedNode(ret);
+template<typename DerivedNodeType, class... Args>
+DerivedNodeType* Graph<NodeType, EdgeType>::NewNode(Args&&... args) {
+  DerivedNodeType* ret = arena_.New<DerivedNodeType>(std::forward<Args>(args)...);
+  nodes_.emplace_back(ret, Deleter{true});
   return ret;
 }
 
 template<typename NodeType, typename EdgeType>
 template<class... Args>
-EdgeType* Graph<NodeType, EdgeType>::NewEdge(Args&&... args) {
-  EdgeType* ret = new EdgeType(std::forward<Args>(args)...);
-  AddAllocatedEdge(ret);
+typename std::remove_const<EdgeType>::type* Graph<NodeType, EdgeType>::NewEdge(Args&&... args) {
+  auto* ret = arena_.New<typename std::remove_const<EdgeType>::type>(std::forward<Args>(args)...);
+  edges_.emplace_back(ret, Deleter{true});
   return ret;
 }
 
 template<typename NodeType, typename EdgeType>
 void Graph<NodeType, EdgeType>::AddAllocatedNode(NodeType* node) {
-  nodes_.emplace_back(node);
+  nodes_.emplace_back(node, Deleter{false});
 }
 
 template<typename NodeType, typename EdgeType>
 void Graph<NodeType, EdgeType>::AddAllocatedEdge(EdgeType* edge) {
-  edges_.emplace_back(edge);
+  edges_.emplace_back(edge, Deleter{false});
 }
 
 template<typename NodeType, typename EdgeType>
 void Graph<NodeType, EdgeType>::DeleteNode(NodeType* node) {
-  Erase<std::vector<std::unique_ptr<NodeType>>>(
-      nodes_, [node](const std::unique_ptr<NodeType>& node_ptr) { return node_ptr.get() == node; });
+  Erase<std::vector<std::unique_ptr<NodeType, Deleter>>>(
+      nodes_, [node](const std::unique_ptr<NodeType, Deleter>& node_ptr) {
+        return node_ptr.get() == node;
+      });
 }
 
 template<typename NodeType, typename EdgeType>
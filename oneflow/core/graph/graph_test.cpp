@@ -0,0 +1,139 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "oneflow/core/graph/graph.h"
+
+namespace oneflow {
+
+namespace test {
+
+namespace {
+
+class TestEdge;
+
+class TestNode final : public Node<TestNode, TestEdge> {
+ public:
+  OF_DISALLOW_COPY_AND_MOVE(TestNode);
+  explicit TestNode(int64_t index) : index(index), visit_cnt(0), done(false) {}
+  ~TestNode() override = default;
+
+  const int64_t index;
+  std::atomic<int64_t> visit_cnt;
+  std::atomic<bool> done;
+};
+
+class TestEdge final : public Edge<TestNode, TestEdge> {
+ public:
+  OF_DISALLOW_COPY_AND_MOVE(TestEdge);
+  TestEdge() = default;
+  ~TestEdge() override = default;
+};
+
+class TestGraph final : public Graph<TestNode, TestEdge> {
+ public:
+  OF_DISALLOW_COPY_AND_MOVE(TestGraph);
+  // node i gets an edge from about edge_ratio of the nodes before it
+  TestGraph(int64_t node_num, double edge_ratio) {
+    std::mt19937 gen(node_num);
+    std::uniform_real_distribution<double> dis(0, 1);
+    FOR_RANGE(int64_t, i, 0, node_num) {
+      nodes_.push_back(NewNode(i));
+      FOR_RANGE(int64_t, j, 0, i) {
+        if (dis(gen) < edge_ratio) { Connect(nodes_.at(j), NewEdge(), nodes_.at(i)); }
+      }
+    }
+  }
+  ~TestGraph() override = default;
+
+  TestNode* node(int64_t index) const { return nodes_.at(index); }
+
+ private:
+  std::vector<TestNode*> nodes_;
+};
+
+// with and without a thread pool
+void ForEachThreadNum(const std::function<void()>& Run) {
+  Run();
+  Global<ThreadPool>::New(4);
+  Run();
+  Global<ThreadPool>::Delete();
+}
+
+}  // namespace
+
+TEST(Graph, parallel_for_each_node) {
+  ForEachThreadNum([]() {
+    TestGraph graph(1000, 0.01);
+    graph.ParallelForEachNode([](TestNode* node) { ++node->visit_cnt; });
+    graph.ForEachNode([](TestNode* node) { ASSERT_EQ(node->visit_cnt, 1); });
+  });
+}
+
+TEST(Graph, parallel_topo_for_each_node) {
+  ForEachThreadNum([]() {
+    TestGraph graph(300, 0.02);
+    std::atomic<int64_t> early_cnt(0);
+    graph.ParallelTopoForEachNode([&](TestNode* node) {
+      node->ForEachNodeOnInEdge([&](TestNode* in) {
+        if (!in->done) { ++early_cnt; }
+      });
+      ++node->visit_cnt;
+      node->done = true;
+    });
+    ASSERT_EQ(early_cnt, 0);
+    graph.ForEachNode([](TestNode* node) { ASSERT_EQ(node->visit_cnt, 1); });
+  });
+}
+
+TEST(Graph, parallel_topo_for_each_node_with_error_captured) {
+  ForEachThreadNum([]() {
+    TestGraph graph(300, 0.02);
+    TestNode* failed = graph.node(150);
+    const auto& maybe =
+        graph.ParallelTopoForEachNodeWithErrorCaptured([&](TestNode* node) -> Maybe<void> {
+          ++node->visit_cnt;
+          CHECK_NE_OR_RETURN(node->index, failed->index);
+          return Maybe<void>::Ok();
+        });
+    ASSERT_FALSE(maybe.IsOk());
+    ASSERT_EQ(failed->visit_cnt, 1);
+    // the traversal stops after the level of the failed node, so nothing it feeds is handled
+    std::function<void(TestNode*)> CheckNotVisited;
+    CheckNotVisited = [&](TestNode* node) {
+      ASSERT_EQ(node->visit_cnt, 0);
+      node->ForEachNodeOnOutEdge(CheckNotVisited);
+    };
+    failed->ForEachNodeOnOutEdge(CheckNotVisited);
+    graph.ForEachNode([](TestNode* node) { ASSERT_LE(node->visit_cnt, 1); });
+  });
+}
+
+TEST(Graph, nested_parallel_for_each_node) {
+  ForEachThreadNum([]() {
+    TestGraph graph(64, 0);
+    TestGraph inner_graph(64, 0);
+    // every handler starts a traversal of its own while the pool threads are busy
+    graph.ParallelForEachNode([&](TestNode* node) {
+      inner_graph.ParallelForEachNode([](TestNode* inner) { ++inner->visit_cnt; });
+      ++node->visit_cnt;
+    });
+    graph.ForEachNode([](TestNode* node) { ASSERT_EQ(node->visit_cnt, 1); });
+    inner_graph.ForEachNode([](TestNode* node) { ASSERT_EQ(node->visit_cnt, 64); });
+  });
+}
+
+}  // namespace test
+
+}  // namespace oneflow
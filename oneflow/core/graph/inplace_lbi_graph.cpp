@@ -212,10 +212,8 @@ void InplaceLbiGraph::Init(const InplaceObasInfo& obas_info,
   auto FindOrCreateNode = MakeMutFindOrCreateNode(Op4OpName);
   auto AddEdge = [&](const Operator& op, const LogicalBlobId& lbi, const std::string& ibn,
                      const std::string& obn, bool is_mut) {
-    auto* edge = new InplaceLbiEdge(&op, ibn, obn, is_mut);
-    AddAllocatedEdge(edge);
-    Connect<InplaceLbiNode, InplaceLbiEdge>(FindOrCreateNode(op.BnInOp2Lbi(ibn)), edge,
-                                            FindOrCreateNode(lbi));
+    Connect<InplaceLbiNode, InplaceLbiEdge>(FindOrCreateNode(op.BnInOp2Lbi(ibn)),
+                                            NewEdge(&op, ibn, obn, is_mut), FindOrCreateNode(lbi));
   };
 
   auto BuildNodeAndEdge4InplacePairs = [&](const OpBlobArgPairs& pairs, bool is_mut) {
@@ -41,9 +41,7 @@ InplaceRegstGraph::InplaceRegstGraph(const HashSet<const RegstDescProto*>& regst
       const RegstDescProto* in_regst_desc =
           RegstDesc4RegstDescId(regst_desc->hint_inplace_consumed_regst_desc_id());
       if (in_regst_desc != nullptr) {
-        auto* edge = new InplaceRegstEdge();
-        AddAllocatedEdge(edge);
-        Connect<InplaceRegstNode, InplaceRegstEdge>(FindOrCreate(in_regst_desc), edge,
+        Connect<InplaceRegstNode, InplaceRegstEdge>(FindOrCreate(in_regst_desc), NewEdge(),
                                                     FindOrCreate(regst_desc));
       }
     }
@@ -56,8 +54,7 @@ InplaceRegstGraph::MakeMutFindOrCreateNode() {
   return [regst_desc2node, this](const RegstDescProto* regst_desc) -> InplaceRegstNode* {
     auto it = regst_desc2node->find(regst_desc);
     if (it == regst_desc2node->end()) {
-      InplaceRegstNode* node = new InplaceRegstNode(regst_desc);
-      AddAllocatedNode(node);
+      InplaceRegstNode* node = NewNode(regst_desc);
       it = regst_desc2node->emplace(regst_desc, node).first;
     }
     return it->second;
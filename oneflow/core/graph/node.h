@@ -23,18 +23,24 @@ namespace oneflow {
 
 template<typename NodeType, typename EdgeType>
 void Connect(NodeType* src_node, EdgeType* edge, NodeType* dst_node) {
-  CHECK(src_node->out_edges_.insert(edge).second);
-  CHECK(dst_node->in_edges_.insert(edge).second);
+  // an unconnected edge is in no adjacency list yet, so there is nothing to deduplicate
   CHECK(edge->src_node_ == nullptr);
   CHECK(edge->dst_node_ == nullptr);
+  src_node->out_edges_.push_back(edge);
+  dst_node->in_edges_.push_back(edge);
   edge->src_node_ = src_node;
   edge->dst_node_ = dst_node;
 }
 
 template<typename EdgeType>
 void DisConnect(EdgeType* edge) {
-  CHECK_EQ(edge->src_node_->out_edges_.erase(edge), 1);
-  CHECK_EQ(edge->dst_node_->in_edges_.erase(edge), 1);
+  const auto EraseEdge = [edge](std::vector<EdgeType*>* edges) {
+    auto it = std::find(edges->begin(), edges->end(), edge);
+    CHECK(it != edges->end());
+    edges->erase(it);
+  };
+  EraseEdge(&edge->src_node_->out_edges_);
+  EraseEdge(&edge->dst_node_->in_edges_);
   edge->src_node_ = nullptr;
   edge->dst_node_ = nullptr;
 }
@@ -89,8 +95,8 @@ class Node {
     return *(out_edges_.begin());
   }
 
-  const std::unordered_set<EdgeType*>& in_edges() const { return in_edges_; }
-  const std::unordered_set<EdgeType*>& out_edges() const { return out_edges_; }
+  const std::vector<EdgeType*>& in_edges() const { return in_edges_; }
+  const std::vector<EdgeType*>& out_edges() const { return out_edges_; }
 
   void ForEachNodeOnInEdge(std::function<void(NodeType*)> Handler) const {
     for (EdgeType* edge : in_edges_) { Handler(edge->src_node()); }
@@ -115,8 +121,8 @@ class Node {
   }
 
   void DisconnectAllEdges() {
-    for (EdgeType* edge : in_edges_) { DisConnect(edge); }
-    for (EdgeType* edge : out_edges_) { DisConnect(edge); }
+    while (!in_edges_.empty()) { DisConnect(in_edges_.back()); }
+    while (!out_edges_.empty()) { DisConnect(out_edges_.back()); }
   }
 
   virtual std::string VisualStr() const { return ""; }
@@ -133,8 +139,8 @@ class Node {
   friend void DisConnect<EdgeType>(EdgeType* edge);
 
   int64_t node_id_;
-  HashSet<EdgeType*> in_edges_;
-  HashSet<EdgeType*> out_edges_;
+  std::vector<EdgeType*> in_edges_;
+  std::vector<EdgeType*> out_edges_;
   std::vector<EdgeType*> sorted_in_edges_;
   std::vector<EdgeType*> sorted_out_edges_;
 };
@@ -368,14 +368,40 @@ void OpNode::InitLbi2SbpParallel() {
   Update(op().output_bns());
 }
 
+void OpNode::MoveInferredResultFrom(OpNode* prev_op_node) {
+  obn2blob_parallel_desc_ = std::move(prev_op_node->obn2blob_parallel_desc_);
+  out_blob_time_shape_ = std::move(prev_op_node->out_blob_time_shape_);
+  bn2parallel_id2blob_desc_ = std::move(prev_op_node->bn2parallel_id2blob_desc_);
+  lbi2logical_blob_desc_ = std::move(prev_op_node->lbi2logical_blob_desc_);
+  input_blob_fastest_time_shape_ = std::move(prev_op_node->input_blob_fastest_time_shape_);
+  lbi2sbp_parallel_ = std::move(prev_op_node->lbi2sbp_parallel_);
+}
+
 Maybe<OpGraph> OpGraph::New(const Job& job) {
   const auto& op_graph = std::make_shared<OpGraph>();
   JUST(op_graph->Init(job));
   return op_graph;
 }
 
-Maybe<void> OpGraph::Init(const Job& job) {
-  InitNodes(job);
+Maybe<OpGraph> OpGraph::New(const Job& job, OpGraph* prev_op_graph) {
+  const auto& op_graph = std::make_shared<OpGraph>();
+  JUST(op_graph->Init(job, prev_op_graph));
+  return op_graph;
+}
+
+Maybe<void> OpGraph::Init(const Job& job) { return Init(job, nullptr); }
+
+Maybe<void> OpGraph::Init(const Job& job, OpGraph* prev_op_graph) {
+  job_desc_ = &GlobalJobDesc();
+  job_parallel_view_conf_ = job.job_parallel_view_conf();
+  for (const auto& pair : job.helper().identical_sbp_oba_pairs().pair()) {
+    identical_sbp_op_names_.insert(pair.first().op_name());
+    identical_sbp_op_names_.insert(pair.second().op_name());
+  }
+  if (prev_op_graph != nullptr && prev_op_graph->job_desc_ != job_desc_) {
+    prev_op_graph = nullptr;
+  }
+  InitNodes(job, prev_op_graph);
   ForEachNode([&](OpNode* node) {
     CHECK(op_name2op_node_.emplace(node->op().op_name(), node).second)
         << "op_name: " << node->op().op_name();
@@ -384,6 +410,7 @@ Maybe<void> OpGraph::Init(const Job& job) {
   InitProducerOpName2CtrlConsumerOpNames(job);
   CheckIsDAG();
   ForEachNode([](OpNode* node) { node->InitLbi2SourceNode(); });
+  ReuseInferredResults(prev_op_graph);
   InferBlobLastUsed();
   InferTimeShape();
   JUST(InferLogicalBlobDesc(job));
@@ -402,15 +429,79 @@ void OpGraph::CheckIsDAG() const {
   CHECK(!FindFirstNontrivialSCC(ForEachIn, ForEachOut));
 }
 
-void OpGraph::InitNodes(const Job& job) {
+void OpGraph::InitNodes(const Job& job, const OpGraph* prev_op_graph) {
   auto ParallelConf4OpName = MakeGetterParallelConf4OpName(job.placement());
   for (const auto& op_conf : job.net().op()) {
     op_names_.push_back(op_conf.name());
-    OpNode* node = new OpNode(ParallelDesc(*ParallelConf4OpName(op_conf.name())), op_conf);
-    AddAllocatedNode(node);
+    ParallelDesc parallel_desc(*ParallelConf4OpName(op_conf.name()));
+    const OpNode* prev_op_node = nullptr;
+    if (prev_op_graph != nullptr) { prev_op_node = prev_op_graph->OpNode4OpName(op_conf.name()); }
+    if (prev_op_node != nullptr && prev_op_node->parallel_desc() == parallel_desc
+        && PbMd().Equals(prev_op_node->origin_op_conf_, op_conf)) {
+      NewNode(parallel_desc, *prev_op_node);
+    } else {
+      NewNode(parallel_desc, op_conf);
+    }
   }
 }
 
+bool OpGraph::IsOpInferConfEqual(const std::string& op_name, const OpGraph& prev_op_graph) const {
+  if (identical_sbp_op_names_.find(op_name) != identical_sbp_op_names_.end()) { return false; }
+  const auto& prev_identical_sbp_op_names = prev_op_graph.identical_sbp_op_names_;
+  if (prev_identical_sbp_op_names.find(op_name) != prev_identical_sbp_op_names.end()) {
+    return false;
+  }
+  const auto& op_name2is_mirrored = job_parallel_view_conf_.op_name2is_mirrored_parallel_view();
+  const auto& prev_op_name2is_mirrored =
+      prev_op_graph.job_parallel_view_conf_.op_name2is_mirrored_parallel_view();
+  const auto& is_mirrored_iter = op_name2is_mirrored.find(op_name);
+  const auto& prev_is_mirrored_iter = prev_op_name2is_mirrored.find(op_name);
+  if ((is_mirrored_iter == op_name2is_mirrored.end())
+      != (prev_is_mirrored_iter == prev_op_name2is_mirrored.end())) {
+    return false;
+  }
+  if (is_mirrored_iter != op_name2is_mirrored.end()
+      && is_mirrored_iter->second != prev_is_mirrored_iter->second) {
+    return false;
+  }
+  const auto& op_name2sbp_sig_conf = job_parallel_view_conf_.op_name2sbp_signature_conf();
+  const auto& prev_op_name2sbp_sig_conf =
+      prev_op_graph.job_parallel_view_conf_.op_name2sbp_signature_conf();
+  const auto& sbp_sig_conf_iter = op_name2sbp_sig_conf.find(op_name);
+  const auto& prev_sbp_sig_conf_iter = prev_op_name2sbp_sig_conf.find(op_name);
+  if ((sbp_sig_conf_iter == op_name2sbp_sig_conf.end())
+      != (prev_sbp_sig_conf_iter == prev_op_name2sbp_sig_conf.end())) {
+    return false;
+  }
+  return sbp_sig_conf_iter == op_name2sbp_sig_conf.end()
+         || PbMd().Equals(sbp_sig_conf_iter->second, prev_sbp_sig_conf_iter->second);
+}
+
+void OpGraph::ReuseInferredResults(OpGraph* prev_op_graph) {
+  infer_dirty_op_node_num_ = node_num();
+  if (prev_op_graph == nullptr) { return; }
+  // An op keeps its previous results only if it was built from the same conf and placement, is
+  // inferred with the same parallel view conf, and all of its producers keep theirs as well
+  TopoForEachNode([&](OpNode* op_node) {
+    const std::string& op_name = op_node->op().op_name();
+    const auto& prev_iter = prev_op_graph->op_name2op_node_.find(op_name);
+    if (prev_iter == prev_op_graph->op_name2op_node_.end()) { return; }
+    OpNode* prev_op_node = prev_iter->second;
+    if (op_node->op_ != prev_op_node->op_) { return; }
+    bool infer_dirty = !IsOpInferConfEqual(op_name, *prev_op_graph);
+    for (OpEdge* edge : op_node->in_edges()) { infer_dirty |= edge->src_node()->infer_dirty_; }
+    if (infer_dirty) {
+      // never infer an operator twice, its inferred signatures would be mixed up
+      op_node->op_ = ConstructOp(op_node->origin_op_conf_,
+                                 op_node->parallel_desc().device_type(), job_desc_);
+    } else {
+      op_node->MoveInferredResultFrom(prev_op_node);
+      op_node->infer_dirty_ = false;
+      --infer_dirty_op_node_num_;
+    }
+  });
+}
+
 void OpGraph::InitEdges() {
   HashMap<LogicalBlobId, OpNode*> lbi2producer;
   HashMap<std::string, std::shared_ptr<HashMap<LogicalBlobId, std::string>>>
@@ -468,7 +559,8 @@ void OpGraph::InferBlobLastUsed() const {
 }
 
 void OpGraph::InferTimeShape() const {
-  TopoForEachNode([&](OpNode* op_node) {
+  ParallelTopoForEachNode([&](OpNode* op_node) {
+    if (!op_node->infer_dirty_) { return; }
     ParallelContext parallel_ctx;
     parallel_ctx.set_parallel_id(0);
     parallel_ctx.set_parallel_num(op_node->parallel_desc().parallel_num());
@@ -567,7 +659,18 @@ Maybe<void> OpGraph::InferLogicalBlobDesc(const Job& job) const {
     oba2sbp_identical_obas[pair.first()].push_back(pair.second());
     oba2sbp_identical_obas[pair.second()].push_back(pair.first());
   }
+  // Inferring one op writes the sbp conf of the ops sharing sbp with it, which must be seen in the
+  // same order every time, so only jobs without such pairs infer the ops of one level concurrently.
+  const auto& TopoForEachNodeWithErrorCaptured =
+      [&](const std::function<Maybe<void>(OpNode*)>& Handler) -> Maybe<void> {
+    if (oba2sbp_identical_obas.empty()) {
+      return ParallelTopoForEachNodeWithErrorCaptured(Handler);
+    } else {
+      return this->TopoForEachNodeWithErrorCaptured(Handler);
+    }
+  };
   JUST(TopoForEachNodeWithErrorCaptured([&](OpNode* op_node) -> Maybe<void> {
+    if (!op_node->infer_dirty_) { return Maybe<void>::Ok(); }
     // Infer ParallelSignature
     JUST(op_node->mut_op()->InferParallelSignatureIf());
     // Infer batch_axis
@@ -34,7 +34,14 @@ class OpNode final : public Node<OpNode, OpEdge> {
   explicit OpNode(const ParallelDesc& parallel_desc, const OperatorConf& op_conf)
       : parallel_desc_(parallel_desc),
         op_(ConstructOp(op_conf, parallel_desc.device_type(), &GlobalJobDesc())),
-        ibns_(op_->input_bns().begin(), op_->input_bns().end()) {}
+        ibns_(op_->input_bns().begin(), op_->input_bns().end()),
+        origin_op_conf_(op_conf) {}
+  // Shares the operator of an op node of the previous OpGraph built from the same op conf
+  OpNode(const ParallelDesc& parallel_desc, const OpNode& prev_op_node)
+      : parallel_desc_(parallel_desc),
+        op_(prev_op_node.op_),
+        ibns_(prev_op_node.ibns_),
+        origin_op_conf_(prev_op_node.origin_op_conf_) {}
   ~OpNode() = default;
 
   // Getters
@@ -89,6 +96,7 @@ class OpNode final : public Node<OpNode, OpEdge> {
   void InitInputBlobFastestTimeShape();
   void InitLbi2SbpParallel();
   void InitLbi2MirroredParallel();
+  void MoveInferredResultFrom(OpNode* prev_op_node);
 
   ParallelDesc parallel_desc_;
   HashMap<std::string, ParallelDesc> obn2blob_parallel_desc_;
@@ -100,6 +108,8 @@ class OpNode final : public Node<OpNode, OpEdge> {
   HashMap<LogicalBlobId, OpNode*> lbi2source_node_;
   std::unique_ptr<Shape> input_blob_fastest_time_shape_;
   HashMap<LogicalBlobId, SbpParallel> lbi2sbp_parallel_;
+  OperatorConf origin_op_conf_;
+  bool infer_dirty_ = true;
 };
 
 class OpEdge final : public Edge<OpNode, OpEdge> {
@@ -139,6 +149,9 @@ class OpGraph final : public Graph<OpNode, OpEdge> {
   ~OpGraph() override = default;
 
   static Maybe<OpGraph> New(const Job& job);
+  // Ops whose conf, placement and producers are all unchanged since prev_op_graph take over its
+  // inferred results instead of being inferred again. prev_op_graph is left unusable.
+  static Maybe<OpGraph> New(const Job& job, OpGraph* prev_op_graph);
 
   Maybe<void> ForEachOpNode(const std::function<Maybe<void>(const OpNode&)>& DoEach) const;
 
@@ -171,13 +184,18 @@ class OpGraph final : public Graph<OpNode, OpEdge> {
   void DumpOpTimeShape(Job* job) const;
   void DumpBatchAxisLbi(Job* job) const;
 
+  int64_t infer_dirty_op_node_num() const { return infer_dirty_op_node_num_; }
+
   Maybe<void> Init(const Job& job);
+  Maybe<void> Init(const Job& job, OpGraph* prev_op_graph);
 
  private:
-  void InitNodes(const Job& job);
+  void InitNodes(const Job& job, const OpGraph* prev_op_graph);
   void InitEdges();
   void InitProducerOpName2CtrlConsumerOpNames(const Job& job);
   void CheckIsDAG() const;
+  void ReuseInferredResults(OpGraph* prev_op_graph);
+  bool IsOpInferConfEqual(const std::string& op_name, const OpGraph& prev_op_graph) const;
   void InferBlobLastUsed() const;
   void InferTimeShape() const;
   void InferOpNodeSbpSignature(OpNode* op_node, const SbpSignature& sbp_sig_conf) const;
@@ -194,6 +212,10 @@ class OpGraph final : public Graph<OpNode, OpEdge> {
   HashMap<std::string, OpNode*> op_name2op_node_;
   std::list<std::string> op_names_;
   HashMap<std::string, HashSet<std::string>> producer_op_name2ctrl_consumer_op_names_;
+  const JobDesc* job_desc_ = nullptr;
+  JobParallelViewConf job_parallel_view_conf_;
+  HashSet<std::string> identical_sbp_op_names_;
+  int64_t infer_dirty_op_node_num_ = 0;
 };
 
 }  // namespace oneflow
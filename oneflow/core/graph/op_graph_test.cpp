@@ -0,0 +1,164 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "oneflow/core/graph/op_graph.h"
+#include "oneflow/core/job/env_desc.h"
+#include "oneflow/core/job/resource_desc.h"
+#include "oneflow/core/job/global_for.h"
+#include "oneflow/core/common/protobuf.h"
+#include "oneflow/core/thread/thread_pool.h"
+
+namespace oneflow {
+
+namespace test {
+
+namespace {
+
+class OpGraphTestEnv final {
+ public:
+  OF_DISALLOW_COPY_AND_MOVE(OpGraphTestEnv);
+  OpGraphTestEnv() {
+    EnvProto env_proto;
+    auto* machine = env_proto.add_machine();
+    machine->set_id(0);
+    machine->set_addr("127.0.0.1");
+    env_proto.set_ctrl_port(9527);
+    Global<EnvDesc>::New(env_proto);
+    Resource resource;
+    resource.set_machine_num(1);
+    resource.set_cpu_device_num(1);
+    Global<ResourceDesc, ForSession>::New(resource);
+    JobConfigProto job_conf;
+    job_conf.set_job_name("op_graph_test");
+    job_conf.mutable_predict_conf();
+    job_conf.mutable_default_initializer_conf()->mutable_constant_int_conf()->set_value(0);
+    Global<JobDesc>::New(job_conf, 0);
+  }
+  ~OpGraphTestEnv() {
+    Global<JobDesc>::Delete();
+    Global<ResourceDesc, ForSession>::Delete();
+    Global<EnvDesc>::Delete();
+  }
+};
+
+// var -> identity_i -> unique_i for every branch i, the unique op has a tmp blob whose size
+// depends on its input
+Job MakeJob(int64_t var_elem_cnt, DataType unique_out_idx, int64_t branch_num) {
+  Job job;
+  *job.mutable_job_conf() = GlobalJobDesc().job_conf();
+  auto* placement_group = job.mutable_placement()->add_placement_group();
+  placement_group->mutable_parallel_conf()->set_device_tag("cpu");
+  placement_group->mutable_parallel_conf()->add_device_name("0:0");
+  {
+    OperatorConf* op_conf = job.mutable_net()->add_op();
+    op_conf->set_name("var");
+    VariableOpConf* conf = op_conf->mutable_variable_conf();
+    conf->set_out("out");
+    conf->mutable_shape()->add_dim(var_elem_cnt);
+    conf->set_data_type(DataType::kInt32);
+    conf->mutable_split_axis();
+  }
+  FOR_RANGE(int64_t, i, 0, branch_num) {
+    const std::string suffix = i == 0 ? "" : "_" + std::to_string(i);
+    {
+      OperatorConf* op_conf = job.mutable_net()->add_op();
+      op_conf->set_name("identity" + suffix);
+      op_conf->mutable_identity_conf()->set_in("var/out");
+      op_conf->mutable_identity_conf()->set_out("out");
+    }
+    {
+      OperatorConf* op_conf = job.mutable_net()->add_op();
+      op_conf->set_name("unique" + suffix);
+      UniqueWithCountsOpConf* conf = op_conf->mutable_unique_with_counts_conf();
+      conf->set_x("identity" + suffix + "/out");
+      conf->set_y("y");
+      conf->set_idx("idx");
+      conf->set_count("count");
+      conf->set_num_unique("num_unique");
+      conf->set_out_idx(unique_out_idx);
+    }
+  }
+  for (const auto& op_conf : job.net().op()) {
+    placement_group->mutable_op_set()->add_op_name(op_conf.name());
+  }
+  return job;
+}
+
+Job MakeJob(int64_t var_elem_cnt, DataType unique_out_idx) {
+  return MakeJob(var_elem_cnt, unique_out_idx, 1);
+}
+
+Job DumpInferredResults(const OpGraph& op_graph) {
+  Job job;
+  op_graph.DumpLogicalBlobDesc(&job);
+  op_graph.DumpSbpSignature(&job);
+  op_graph.DumpOpTimeShape(&job);
+  op_graph.DumpBatchAxisLbi(&job);
+  return job;
+}
+
+void TestIncrementalInferMatchesFullInfer(const Job& prev_job, const Job& job,
+                                          int64_t expected_infer_dirty_op_node_num) {
+  std::shared_ptr<OpGraph> prev_op_graph = CHECK_JUST(OpGraph::New(prev_job));
+  std::shared_ptr<OpGraph> incremental = CHECK_JUST(OpGraph::New(job, prev_op_graph.get()));
+  std::shared_ptr<OpGraph> full = CHECK_JUST(OpGraph::New(job));
+  ASSERT_EQ(incremental->infer_dirty_op_node_num(), expected_infer_dirty_op_node_num);
+  ASSERT_EQ(full->infer_dirty_op_node_num(), full->node_num());
+  ASSERT_TRUE(PbMd().Equals(DumpInferredResults(*incremental), DumpInferredResults(*full)));
+  const auto& IncrementalBlobDesc4ModelLbi = incremental->MakeGetterBlobDesc4ModelLbi();
+  const auto& FullBlobDesc4ModelLbi = full->MakeGetterBlobDesc4ModelLbi();
+  const OpNode* unique = full->OpNode4OpName("unique");
+  ASSERT_EQ(unique->op().tmp_bns().size(), 1);
+  const LogicalBlobId& workspace_lbi = unique->op().BnInOp2Lbi(unique->op().tmp_bns().Get(0));
+  ASSERT_TRUE(IncrementalBlobDesc4ModelLbi(workspace_lbi) == FullBlobDesc4ModelLbi(workspace_lbi));
+}
+
+}  // namespace
+
+TEST(OpGraph, incremental_infer_of_unchanged_job) {
+  OpGraphTestEnv env;
+  TestIncrementalInferMatchesFullInfer(MakeJob(16, DataType::kInt32),
+                                       MakeJob(16, DataType::kInt32), 0);
+}
+
+TEST(OpGraph, incremental_infer_of_dirty_consumer) {
+  OpGraphTestEnv env;
+  // var and identity keep their results, unique is inferred against them
+  TestIncrementalInferMatchesFullInfer(MakeJob(16, DataType::kInt32),
+                                       MakeJob(16, DataType::kInt64), 1);
+}
+
+TEST(OpGraph, incremental_infer_of_dirty_producer) {
+  OpGraphTestEnv env;
+  // every consumer of a dirty producer is dirty as well
+  TestIncrementalInferMatchesFullInfer(MakeJob(16, DataType::kInt32),
+                                       MakeJob(32, DataType::kInt32), 3);
+}
+
+TEST(OpGraph, concurrent_infer_matches_serial_infer) {
+  OpGraphTestEnv env;
+  const Job job = MakeJob(16, DataType::kInt32, 16);
+  std::shared_ptr<OpGraph> serial = CHECK_JUST(OpGraph::New(job));
+  Global<ThreadPool>::New(4);
+  // the branches sit on the same topological level and get inferred by several threads
+  std::shared_ptr<OpGraph> concurrent = CHECK_JUST(OpGraph::New(job));
+  Global<ThreadPool>::Delete();
+  ASSERT_EQ(concurrent->node_num(), 33);
+  ASSERT_TRUE(PbMd().Equals(DumpInferredResults(*concurrent), DumpInferredResults(*serial)));
+}
+
+}  // namespace test
+
+}  // namespace oneflow
@@ -37,9 +37,8 @@ PlanTaskGraph::PlanTaskGraph(const Plan& plan) : plan_(&plan) {
 
 void PlanTaskGraph::InitNodes() {
   for (const auto& task : plan_->task()) {
-    PlanTaskNode* plan_task_node = new PlanTaskNode(task);
+    PlanTaskNode* plan_task_node = NewNode(task);
     task_id2plan_task_node_.insert({task.task_id(), plan_task_node});
-    AddAllocatedNode(plan_task_node);
   }
 }
 
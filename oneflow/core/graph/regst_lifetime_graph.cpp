@@ -32,8 +32,7 @@ void RegstLifetimeGraph::InitNodes(
   for (const RegstDescProto* regst_desc : regst_descs) {
     auto lifetime_actor_ids = std::make_unique<HashSet<int64_t>>();
     ComputeLifetimeActorIds(regst_desc, lifetime_actor_ids.get());
-    auto* node = new RegstLifetimeNode(regst_desc, std::move(lifetime_actor_ids));
-    AddAllocatedNode(node);
+    auto* node = NewNode(regst_desc, std::move(lifetime_actor_ids));
     nodes->push_back(node);
   }
 }
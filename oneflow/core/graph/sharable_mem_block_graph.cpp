@@ -74,9 +74,7 @@ SharableMemBlockGraph::SharableMemBlockGraph(
       auto* parent = new SharableMemBlockNode(pair.first, regst_descs);
       AddAllocatedNode(parent);
       for (const RegstDescProto* regst_desc : regst_descs) {
-        auto* edge = new SharableMemBlockEdge();
-        AddAllocatedEdge(edge);
-        Connect(parent, edge, regst_desc2node.at(regst_desc));
+        Connect(parent, NewEdge(), regst_desc2node.at(regst_desc));
       }
     });
   }
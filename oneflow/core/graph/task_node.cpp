@@ -19,7 +19,7 @@ namespace oneflow {
 
 namespace {
 
-void ForEachDataEdge(const std::unordered_set<TaskEdge*>& edges,
+void ForEachDataEdge(const std::vector<TaskEdge*>& edges,
                      const std::function<void(TaskEdge*)>& Handler) {
   for (TaskEdge* edge : edges) {
     const auto& regsts = edge->GetRegsts();
@@ -23,6 +23,7 @@ limitations under the License.
 #include "oneflow/core/kernel/batch_memcpy_kernel_util.h"
 #include "oneflow/core/job/global_for.h"
 #include "oneflow/core/thread/thread_pool.h"
+#include "oneflow/core/job/cpu_collective_boxing_util.h"
 
 namespace oneflow {
 
@@ -466,6 +467,131 @@ void NcclCollectiveBoxingExecutorBackend::Init(const CollectiveBoxingPlan& colle
   }
 }
 
+class CpuCollectiveBoxingExecutorBackend : public CollectiveBoxingExecutorBackend {
+ public:
+  OF_DISALLOW_COPY_AND_MOVE(CpuCollectiveBoxingExecutorBackend)
+  CpuCollectiveBoxingExecutorBackend();
+  ~CpuCollectiveBoxingExecutorBackend() override = default;
+
+ private:
+  void GroupRequests(const std::vector<const RequestDesc*>& requests,
+                     std::vector<std::vector<const RequestDesc*>>* groups) override;
+  void ExecuteGroup(const std::vector<const RequestDesc*>& group,
+                    const std::vector<std::map<int64_t, RuntimeRequestInfo>>& ranks) override;
+
+  struct GroupCtx {
+    std::vector<const RequestDesc*> requests;
+    std::vector<std::vector<const char*>> send_buffs;
+    std::vector<std::vector<char*>> recv_buffs;
+    std::vector<std::function<void(const Maybe<void>&)>> callbacks;
+    std::vector<CpuChunk> chunks;
+    std::atomic<int64_t> next_chunk_idx;
+    std::atomic<int64_t> num_running_workers;
+  };
+
+  ThreadPool* GetThreadPool();
+
+  const CollectiveBoxingConf collective_boxing_conf_;
+  int64_t fusion_threshold_;
+  int64_t chunk_size_;
+  std::mutex thread_pool_mutex_;
+  std::unique_ptr<ThreadPool> thread_pool_;
+};
+
+CpuCollectiveBoxingExecutorBackend::CpuCollectiveBoxingExecutorBackend()
+    : collective_boxing_conf_(Global<ResourceDesc, ForSession>::Get()->collective_boxing_conf()) {
+  CHECK_GT(collective_boxing_conf_.cpu_num_threads(), 0);
+  CHECK_GE(collective_boxing_conf_.cpu_fusion_threshold_mb(), 0);
+  fusion_threshold_ = collective_boxing_conf_.cpu_fusion_threshold_mb() * 1024 * 1024;
+  CHECK_GT(collective_boxing_conf_.cpu_chunk_size_kb(), 0);
+  chunk_size_ = collective_boxing_conf_.cpu_chunk_size_kb() * 1024;
+}
+
+ThreadPool* CpuCollectiveBoxingExecutorBackend::GetThreadPool() {
+  // the workers are only started once a plan really does cpu boxing
+  std::unique_lock<std::mutex> lock(thread_pool_mutex_);
+  if (!thread_pool_) {
+    thread_pool_.reset(new ThreadPool(collective_boxing_conf_.cpu_num_threads()));
+  }
+  return thread_pool_.get();
+}
+
+void CpuCollectiveBoxingExecutorBackend::GroupRequests(
+    const std::vector<const RequestDesc*>& requests,
+    std::vector<std::vector<const RequestDesc*>>* groups) {
+  std::vector<const RequestDesc*> group;
+  int64_t group_size = 0;
+  for (const RequestDesc* request : requests) {
+    const int64_t size = GetRequestSize(request);
+    if (!group.empty()
+        && (group.back()->device_set() != request->device_set()
+            || group_size + size > fusion_threshold_)) {
+      groups->emplace_back();
+      groups->back().swap(group);
+      group_size = 0;
+    }
+    group.push_back(request);
+    group_size += size;
+  }
+  if (!group.empty()) {
+    groups->emplace_back();
+    groups->back().swap(group);
+  }
+}
+
+void CpuCollectiveBoxingExecutorBackend::ExecuteGroup(
+    const std::vector<const RequestDesc*>& group,
+    const std::vector<std::map<int64_t, RuntimeRequestInfo>>& ranks) {
+  CHECK_EQ(group.size(), ranks.size());
+  if (group.empty()) { return; }
+  auto ctx = std::make_shared<GroupCtx>();
+  ctx->requests = group;
+  ctx->send_buffs.resize(group.size());
+  ctx->recv_buffs.resize(group.size());
+  for (int64_t i = 0; i < group.size(); ++i) {
+    const OpDesc& op_desc = group.at(i)->op_desc();
+    const int64_t num_ranks = op_desc.num_ranks();
+    const std::map<int64_t, RuntimeRequestInfo>& rank2request_info = ranks.at(i);
+    CHECK_EQ(rank2request_info.size(), num_ranks)
+        << "cpu collective boxing requires all ranks of " << op_desc.name()
+        << " to be on this machine";
+    ctx->send_buffs.at(i).resize(num_ranks);
+    ctx->recv_buffs.at(i).resize(num_ranks);
+    for (const auto& rank7request_info : rank2request_info) {
+      const int64_t rank = rank7request_info.first;
+      const RuntimeRequestInfo& request_info = rank7request_info.second;
+      ctx->send_buffs.at(i).at(rank) = static_cast<const char*>(request_info.send_buff);
+      ctx->recv_buffs.at(i).at(rank) = static_cast<char*>(request_info.recv_buff);
+      ctx->callbacks.push_back(request_info.callback);
+    }
+    const OpType op_type = op_desc.op_type();
+    if (op_type != OpType::kOpTypeAllGather && op_type != OpType::kOpTypeBroadcast) {
+      CHECK_EQ(op_desc.reduce_method(), kReduceMethodSum);
+    }
+    GenCpuChunks(op_desc, i, chunk_size_, &ctx->chunks);
+  }
+  ThreadPool* thread_pool = GetThreadPool();
+  const int64_t num_workers =
+      std::min<int64_t>(thread_pool->thread_num(), std::max<size_t>(ctx->chunks.size(), 1));
+  ctx->next_chunk_idx = 0;
+  ctx->num_running_workers = num_workers;
+  for (int64_t worker = 0; worker < num_workers; ++worker) {
+    thread_pool->AddWork([ctx]() {
+      while (true) {
+        const int64_t chunk_idx = ctx->next_chunk_idx.fetch_add(1, std::memory_order_relaxed);
+        if (chunk_idx >= ctx->chunks.size()) { break; }
+        const CpuChunk& chunk = ctx->chunks.at(chunk_idx);
+        ExecuteCpuChunk(ctx->requests.at(chunk.request_idx)->op_desc(),
+                        ctx->send_buffs.at(chunk.request_idx),
+                        ctx->recv_buffs.at(chunk.request_idx), chunk);
+      }
+      if (ctx->num_running_workers.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        for (const auto& callback : ctx->callbacks) { callback(Maybe<void>::Ok()); }
+      }
+    });
+  }
+}
+
 CollectiveBoxingExecutor::CollectiveBoxingExecutor(const Plan& plan)
     : collective_boxing_plan_(plan.collective_boxing_plan()) {
   auto it =
@@ -473,6 +599,10 @@ CollectiveBoxingExecutor::CollectiveBoxingExecutor(const Plan& plan)
           .emplace(Backend::kBackendNCCL, std::make_unique<NcclCollectiveBoxingExecutorBackend>())
           .first;
   it->second->Init(collective_boxing_plan_);
+  it = backends_
+           .emplace(Backend::kBackendCpu, std::make_unique<CpuCollectiveBoxingExecutorBackend>())
+           .first;
+  it->second->Init(collective_boxing_plan_);
   Init();
   DumpSummary();
 }
@@ -0,0 +1,129 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "oneflow/core/job/cpu_collective_boxing_util.h"
+#include "oneflow/core/common/shape.h"
+#include "oneflow/core/common/data_type.h"
+#include "oneflow/core/kernel/util/host_simd_util.h"
+
+namespace oneflow {
+
+namespace boxing {
+
+namespace collective {
+
+namespace {
+
+using CpuReduceSumFunc = void (*)(int64_t elem_cnt, const void* x, void* y);
+
+template<typename T>
+void CpuReduceSum(int64_t elem_cnt, const void* x, void* y) {
+  HostSimdAdd<T>(elem_cnt, static_cast<const T*>(x), static_cast<T*>(y));
+}
+
+CpuReduceSumFunc GetCpuReduceSumFunc(DataType data_type) {
+  switch (data_type) {
+#define MAKE_CPU_REDUCE_SUM_CASE(type_cpp, type_proto) \
+  case type_proto: return &CpuReduceSum<type_cpp>;
+    OF_PP_FOR_EACH_TUPLE(MAKE_CPU_REDUCE_SUM_CASE, ARITHMETIC_DATA_TYPE_SEQ)
+#undef MAKE_CPU_REDUCE_SUM_CASE
+    default: UNIMPLEMENTED(); return nullptr;
+  }
+}
+
+}  // namespace
+
+void GenCpuChunks(const OpDesc& op_desc, int64_t request_idx, int64_t chunk_size,
+                  std::vector<CpuChunk>* chunks) {
+  const OpType op_type = op_desc.op_type();
+  const int64_t num_ranks = op_desc.num_ranks();
+  const int64_t elem_cnt = Shape(op_desc.shape()).elem_cnt();
+  const int64_t chunk_elem_cnt =
+      std::max<int64_t>(chunk_size / GetSizeOfDataType(op_desc.data_type()), 1);
+  int64_t num_segments = 1;
+  if (op_type == OpType::kOpTypeReduceScatter || op_type == OpType::kOpTypeAllGather) {
+    CHECK_EQ(elem_cnt % num_ranks, 0);
+    num_segments = num_ranks;
+  }
+  const int64_t segment_elem_cnt = elem_cnt / num_segments;
+  for (int64_t segment = 0; segment < num_segments; ++segment) {
+    const int64_t segment_begin = segment * segment_elem_cnt;
+    const int64_t segment_end = segment_begin + segment_elem_cnt;
+    for (int64_t begin = segment_begin; begin < segment_end; begin += chunk_elem_cnt) {
+      // Rotate the reducing rank of all reduce so that its writes are spread over all ranks.
+      const int64_t rank =
+          op_type == OpType::kOpTypeAllReduce ? (begin / chunk_elem_cnt) % num_ranks : segment;
+      chunks->push_back(
+          CpuChunk{request_idx, rank, begin, std::min(begin + chunk_elem_cnt, segment_end)});
+    }
+  }
+}
+
+void ExecuteCpuChunk(const OpDesc& op_desc, const std::vector<const char*>& send_buffs,
+                     const std::vector<char*>& recv_buffs, const CpuChunk& chunk) {
+  const int64_t num_ranks = op_desc.num_ranks();
+  CHECK_EQ(send_buffs.size(), num_ranks);
+  CHECK_EQ(recv_buffs.size(), num_ranks);
+  const int64_t size_of_data_type = GetSizeOfDataType(op_desc.data_type());
+  const int64_t elem_cnt = chunk.end - chunk.begin;
+  const size_t size = elem_cnt * size_of_data_type;
+  const int64_t offset = chunk.begin * size_of_data_type;
+  const int64_t segment_offset =
+      offset - chunk.rank * Shape(op_desc.shape()).elem_cnt() / num_ranks * size_of_data_type;
+  const OpType op_type = op_desc.op_type();
+  auto ReduceTo = [&](int64_t dst_rank, char* dst) {
+    const CpuReduceSumFunc ReduceSum = GetCpuReduceSumFunc(op_desc.data_type());
+    if (dst != send_buffs.at(dst_rank) + offset) {
+      std::memcpy(dst, send_buffs.at(dst_rank) + offset, size);
+    }
+    for (int64_t rank = 0; rank < num_ranks; ++rank) {
+      if (rank != dst_rank) { ReduceSum(elem_cnt, send_buffs.at(rank) + offset, dst); }
+    }
+  };
+  if (op_type == OpType::kOpTypeAllReduce) {
+    // Reduce into the recv buffer of one rank, then copy out while the chunk is still in cache.
+    char* reduced = recv_buffs.at(chunk.rank) + offset;
+    ReduceTo(chunk.rank, reduced);
+    for (int64_t rank = 0; rank < num_ranks; ++rank) {
+      if (rank != chunk.rank) { std::memcpy(recv_buffs.at(rank) + offset, reduced, size); }
+    }
+  } else if (op_type == OpType::kOpTypeReduceScatter) {
+    ReduceTo(chunk.rank, recv_buffs.at(chunk.rank) + segment_offset);
+  } else if (op_type == OpType::kOpTypeAllGather) {
+    const char* src = send_buffs.at(chunk.rank) + segment_offset;
+    for (int64_t rank = 0; rank < num_ranks; ++rank) {
+      if (recv_buffs.at(rank) + offset != src) {
+        std::memcpy(recv_buffs.at(rank) + offset, src, size);
+      }
+    }
+  } else if (op_type == OpType::kOpTypeReduce) {
+    ReduceTo(op_desc.root(), recv_buffs.at(op_desc.root()) + offset);
+  } else if (op_type == OpType::kOpTypeBroadcast) {
+    const char* src = send_buffs.at(op_desc.root()) + offset;
+    for (int64_t rank = 0; rank < num_ranks; ++rank) {
+      if (recv_buffs.at(rank) + offset != src) {
+        std::memcpy(recv_buffs.at(rank) + offset, src, size);
+      }
+    }
+  } else {
+    UNIMPLEMENTED();
+  }
+}
+
+}  // namespace collective
+
+}  // namespace boxing
+
+}  // namespace oneflow
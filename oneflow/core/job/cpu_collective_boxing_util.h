@@ -0,0 +1,51 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#ifndef ONEFLOW_CORE_JOB_CPU_COLLECTIVE_BOXING_UTIL_H_
+#define ONEFLOW_CORE_JOB_CPU_COLLECTIVE_BOXING_UTIL_H_
+
+#include "oneflow/core/common/util.h"
+#include "oneflow/core/graph/boxing/collective_boxing.pb.h"
+
+namespace oneflow {
+
+namespace boxing {
+
+namespace collective {
+
+// A contiguous element range of one request. For reduce scatter and all gather the range stays
+// inside the segment owned by rank, for all reduce rank is the one the chunk is reduced on.
+struct CpuChunk {
+  int64_t request_idx;
+  int64_t rank;
+  int64_t begin;
+  int64_t end;
+};
+
+// Cuts the request into chunks of at most chunk_size bytes, which can be executed in any order
+void GenCpuChunks(const OpDesc& op_desc, int64_t request_idx, int64_t chunk_size,
+                  std::vector<CpuChunk>* chunks);
+
+// Executes one chunk of a request on the send and recv buffers of all of its ranks
+void ExecuteCpuChunk(const OpDesc& op_desc, const std::vector<const char*>& send_buffs,
+                     const std::vector<char*>& recv_buffs, const CpuChunk& chunk);
+
+}  // namespace collective
+
+}  // namespace boxing
+
+}  // namespace oneflow
+
+#endif  // ONEFLOW_CORE_JOB_CPU_COLLECTIVE_BOXING_UTIL_H_
@@ -0,0 +1,141 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "oneflow/core/job/cpu_collective_boxing_util.h"
+
+namespace oneflow {
+
+namespace boxing {
+
+namespace collective {
+
+namespace test {
+
+namespace {
+
+// 4 floats per chunk, so that segments of 10 elements end with a partial chunk
+const int64_t kChunkSize = 4 * sizeof(float);
+const int64_t kNumRanks = 3;
+
+OpDesc MakeOpDesc(OpType op_type, int64_t elem_cnt, int64_t root) {
+  OpDesc op_desc;
+  op_desc.set_name("cpu_boxing_test");
+  op_desc.set_op_type(op_type);
+  op_desc.set_reduce_method(kReduceMethodSum);
+  op_desc.set_root(root);
+  op_desc.set_data_type(DataType::kFloat);
+  op_desc.mutable_shape()->add_dim(elem_cnt);
+  op_desc.set_num_ranks(kNumRanks);
+  op_desc.set_backend(Backend::kBackendCpu);
+  return op_desc;
+}
+
+std::vector<std::vector<float>> MakeSendBuffers(int64_t elem_cnt) {
+  std::vector<std::vector<float>> send(kNumRanks, std::vector<float>(elem_cnt));
+  FOR_RANGE(int64_t, rank, 0, kNumRanks) {
+    FOR_RANGE(int64_t, i, 0, elem_cnt) { send.at(rank).at(i) = rank * 100 + i; }
+  }
+  return send;
+}
+
+// chunks are independent of each other, so run them backwards to make sure no order is assumed
+void ExecuteAllChunks(const OpDesc& op_desc, std::vector<std::vector<float>>* send,
+                      std::vector<std::vector<float>>* recv) {
+  std::vector<const char*> send_buffs(kNumRanks, nullptr);
+  std::vector<char*> recv_buffs(kNumRanks, nullptr);
+  FOR_RANGE(int64_t, rank, 0, kNumRanks) {
+    if (!send->at(rank).empty()) {
+      send_buffs.at(rank) = reinterpret_cast<const char*>(send->at(rank).data());
+    }
+    if (!recv->at(rank).empty()) {
+      recv_buffs.at(rank) = reinterpret_cast<char*>(recv->at(rank).data());
+    }
+  }
+  std::vector<CpuChunk> chunks;
+  GenCpuChunks(op_desc, 0, kChunkSize, &chunks);
+  for (auto it = chunks.rbegin(); it != chunks.rend(); ++it) {
+    ASSERT_LE(it->end - it->begin, kChunkSize / sizeof(float));
+    ExecuteCpuChunk(op_desc, send_buffs, recv_buffs, *it);
+  }
+}
+
+}  // namespace
+
+TEST(CpuCollectiveBoxing, all_reduce) {
+  const int64_t elem_cnt = 30;
+  auto send = MakeSendBuffers(elem_cnt);
+  std::vector<std::vector<float>> recv(kNumRanks, std::vector<float>(elem_cnt, -1));
+  ExecuteAllChunks(MakeOpDesc(OpType::kOpTypeAllReduce, elem_cnt, 0), &send, &recv);
+  FOR_RANGE(int64_t, rank, 0, kNumRanks) {
+    FOR_RANGE(int64_t, i, 0, elem_cnt) { ASSERT_EQ(recv.at(rank).at(i), 300 + 3 * i); }
+  }
+}
+
+TEST(CpuCollectiveBoxing, reduce_scatter) {
+  const int64_t elem_cnt = 30;
+  const int64_t segment_elem_cnt = elem_cnt / kNumRanks;
+  auto send = MakeSendBuffers(elem_cnt);
+  std::vector<std::vector<float>> recv(kNumRanks, std::vector<float>(segment_elem_cnt, -1));
+  ExecuteAllChunks(MakeOpDesc(OpType::kOpTypeReduceScatter, elem_cnt, 0), &send, &recv);
+  FOR_RANGE(int64_t, rank, 0, kNumRanks) {
+    FOR_RANGE(int64_t, i, 0, segment_elem_cnt) {
+      ASSERT_EQ(recv.at(rank).at(i), 300 + 3 * (rank * segment_elem_cnt + i));
+    }
+  }
+}
+
+TEST(CpuCollectiveBoxing, reduce) {
+  const int64_t elem_cnt = 30;
+  const int64_t root = 1;
+  auto send = MakeSendBuffers(elem_cnt);
+  std::vector<std::vector<float>> recv(kNumRanks);
+  recv.at(root).resize(elem_cnt, -1);
+  ExecuteAllChunks(MakeOpDesc(OpType::kOpTypeReduce, elem_cnt, root), &send, &recv);
+  FOR_RANGE(int64_t, i, 0, elem_cnt) { ASSERT_EQ(recv.at(root).at(i), 300 + 3 * i); }
+  // the send buffers are left as they are
+  ASSERT_TRUE(send == MakeSendBuffers(elem_cnt));
+}
+
+TEST(CpuCollectiveBoxing, all_gather) {
+  const int64_t elem_cnt = 30;
+  const int64_t segment_elem_cnt = elem_cnt / kNumRanks;
+  auto send = MakeSendBuffers(segment_elem_cnt);
+  std::vector<std::vector<float>> recv(kNumRanks, std::vector<float>(elem_cnt, -1));
+  ExecuteAllChunks(MakeOpDesc(OpType::kOpTypeAllGather, elem_cnt, 0), &send, &recv);
+  FOR_RANGE(int64_t, rank, 0, kNumRanks) {
+    FOR_RANGE(int64_t, i, 0, elem_cnt) {
+      ASSERT_EQ(recv.at(rank).at(i), send.at(i / segment_elem_cnt).at(i % segment_elem_cnt));
+    }
+  }
+}
+
+TEST(CpuCollectiveBoxing, broadcast) {
+  const int64_t elem_cnt = 30;
+  const int64_t root = 2;
+  auto all_send = MakeSendBuffers(elem_cnt);
+  std::vector<std::vector<float>> send(kNumRanks);
+  send.at(root) = all_send.at(root);
+  std::vector<std::vector<float>> recv(kNumRanks, std::vector<float>(elem_cnt, -1));
+  ExecuteAllChunks(MakeOpDesc(OpType::kOpTypeBroadcast, elem_cnt, root), &send, &recv);
+  FOR_RANGE(int64_t, rank, 0, kNumRanks) { ASSERT_TRUE(recv.at(rank) == send.at(root)); }
+}
+
+}  // namespace test
+
+}  // namespace collective
+
+}  // namespace boxing
+
+}  // namespace oneflow
@@ -65,6 +65,12 @@ int64_t IDMgr::GetGpuPhyIdFromThrdId(int64_t thrd_id) const {
   return thrd_id % gpu_device_num_;
 }
 
+int64_t IDMgr::GetCpuPhyIdFromThrdId(int64_t thrd_id) const {
+  CHECK_GE(thrd_id, GetCpuDeviceThrdId(0));
+  CHECK_LT(thrd_id, CommNetThrdId());
+  return thrd_id - GetCpuDeviceThrdId(0);
+}
+
 DeviceType IDMgr::GetDeviceTypeFromActorId(int64_t actor_id) const {
   int64_t thrd_id = ThrdId4ActorId(actor_id);
   return GetDeviceTypeFromThrdId(thrd_id);
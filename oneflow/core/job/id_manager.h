@@ -59,6 +59,7 @@ class IDMgr final {
   // GetFromThrdId
   DeviceType GetDeviceTypeFromThrdId(int64_t thrd_id) const;
   int64_t GetGpuPhyIdFromThrdId(int64_t thrd_id) const;
+  int64_t GetCpuPhyIdFromThrdId(int64_t thrd_id) const;
 
   // Runtime
   DeviceType GetDeviceTypeFromActorId(int64_t actor_id) const;
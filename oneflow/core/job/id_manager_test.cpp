@@ -110,4 +110,14 @@ TEST(IDMgr, runtime_thrd_id) {
   Delete();
 }
 
+TEST(IDMgr, cpu_phy_id) {
+  New();
+  FOR_RANGE(int64_t, dev_phy_id, 0, 5) {
+    const int64_t thrd_id = Global<IDMgr>::Get()->GetCpuDeviceThrdId(dev_phy_id);
+    ASSERT_EQ(Global<IDMgr>::Get()->GetDeviceTypeFromThrdId(thrd_id), DeviceType::kCPU);
+    ASSERT_EQ(Global<IDMgr>::Get()->GetCpuPhyIdFromThrdId(thrd_id), dev_phy_id);
+  }
+  Delete();
+}
+
 }  // namespace oneflow
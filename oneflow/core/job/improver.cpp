@@ -25,6 +25,8 @@ limitations under the License.
 #include "oneflow/core/job/profiler.h"
 #include "oneflow/core/job/global_for.h"
 #include "oneflow/core/job/parallel_desc.h"
+#include "oneflow/core/job/plan_simulator.h"
+#include "oneflow/core/job/plan_cost_model.h"
 #include "oneflow/core/graph/plan_task_graph.h"
 #include "oneflow/core/graph/regst_lifetime_graph.h"
 #include "oneflow/core/graph/sharable_mem_block_graph.h"
@@ -247,6 +249,31 @@ uint64_t CalcMemoryConsumed(
   return mem_consuming;
 }
 
+uint64_t CalcMemoryConsumed(const std::list<const RegstDescProto*>& regst_descs) {
+  uint64_t mem_consuming = 0;
+  HashMap<int64_t, uint64_t> mem_block_id2max_regst_desc_mem_bytes;
+  for (const RegstDescProto* regst_desc : regst_descs) {
+    uint64_t total_byte_size = RtRegstDesc(*regst_desc).TotalMainByteSize4AllRegst();
+    if (regst_desc->mem_block_id() == -1) {
+      mem_consuming += RoundUp(total_byte_size, kCudaMemAllocAlignSize);
+    } else {
+      auto& max_bytes = mem_block_id2max_regst_desc_mem_bytes[regst_desc->mem_block_id()];
+      max_bytes = std::max(max_bytes, total_byte_size + regst_desc->mem_block_offset());
+    }
+  }
+  for (const auto& pair : mem_block_id2max_regst_desc_mem_bytes) {
+    mem_consuming += RoundUp(pair.second, kCudaMemAllocAlignSize);
+  }
+  return mem_consuming;
+}
+
+bool IsSimulatedRegstNumTunable(const RegstDescProto& regst_desc) {
+  return regst_desc.mem_block_id() == -1 && regst_desc.inplace_consumed_regst_desc_id() == -1
+         && regst_desc.regst_desc_type().has_data_regst_desc()
+         && regst_desc.consumer_task_id_size() > 0
+         && regst_desc.register_num() < regst_desc.max_register_num();
+}
+
 std::shared_ptr<HashMap<int64_t, RegstDescProto*>> MakeRegstDescId2RegstDesc(Plan* plan) {
   auto regst_desc_id2regst_desc = std::make_shared<HashMap<int64_t, RegstDescProto*>>();
   for (int i = 0; i < plan->task_size(); i++) {
@@ -651,6 +678,101 @@ Maybe<void> Improver::ForEachImprovedRegstNum(
   return Maybe<void>::Ok();
 }
 
+Maybe<void> Improver::ForEachSimulatedRegstNum(
+    const Plan& plan, const HashMap<int64_t, double>& task_id2act_time,
+    const std::function<void(int64_t, uint64_t)>& Handler) const {
+  const int64_t simulated_piece_num = 32;
+  // regst descs tried per step, the ones the simulated pipeline stalls on the longest
+  const size_t max_tried_regst_desc_num = 8;
+  const double min_ii_improvement = 0.01;
+  PlanSimulator simulator(plan);
+  simulator.SetActTimes(task_id2act_time);
+  MemZoneRegstDescs mz_regst_descs;
+  MakeMemZoneRegstDescs(plan, &mz_regst_descs);
+  std::vector<std::vector<int64_t>> mz_available(mz_regst_descs.size());
+  HashMap<int64_t, std::pair<int64_t, int64_t>> regst_desc_id2mem_zone;
+  HashMap<int64_t, const RegstDescProto*> regst_desc_id2tunable_regst_desc;
+  FOR_RANGE(int64_t, machine_id, 0, mz_regst_descs.size()) {
+    FOR_RANGE(int64_t, mem_zone_id, 0, mz_regst_descs[machine_id].size()) {
+      const auto& regst_descs = mz_regst_descs[machine_id][mem_zone_id];
+      mz_available[machine_id].push_back(
+          static_cast<int64_t>(AvailableMemSize(machine_id, mem_zone_id))
+          - static_cast<int64_t>(CalcMemoryConsumed(regst_descs)));
+      for (const RegstDescProto* regst_desc : regst_descs) {
+        if (!IsSimulatedRegstNumTunable(*regst_desc)) { continue; }
+        regst_desc_id2tunable_regst_desc.emplace(regst_desc->regst_desc_id(), regst_desc);
+        regst_desc_id2mem_zone.emplace(regst_desc->regst_desc_id(),
+                                       std::make_pair(machine_id, mem_zone_id));
+      }
+    }
+  }
+  auto ExtraMemSize4OneMoreRegst = [&](const RegstDescProto* regst_desc) -> int64_t {
+    const uint64_t byte_size = RtRegstDesc(*regst_desc).MainByteSize4OneRegst();
+    const int64_t regst_num = simulator.RegstNum(regst_desc->regst_desc_id());
+    return RoundUp(byte_size * (regst_num + 1), kCudaMemAllocAlignSize)
+           - RoundUp(byte_size * regst_num, kCudaMemAllocAlignSize);
+  };
+
+  PlanSimulationResult simulation;
+  simulator.Simulate(simulated_piece_num, &simulation);
+  const double origin_ii = simulation.iteration_time;
+  if (std::isinf(origin_ii)) {
+    LOG(WARNING) << "simulated pipeline never finishes, register_num is left untuned";
+    return Maybe<void>::Ok();
+  }
+  double ii = origin_ii;
+  while (true) {
+    std::vector<std::pair<double, const RegstDescProto*>> stalled_regst_descs;
+    for (const auto& pair : simulation.regst_desc_id2stall_time) {
+      const auto& it = regst_desc_id2tunable_regst_desc.find(pair.first);
+      if (it == regst_desc_id2tunable_regst_desc.end()) { continue; }
+      stalled_regst_descs.emplace_back(pair.second, it->second);
+    }
+    std::sort(stalled_regst_descs.begin(), stalled_regst_descs.end(),
+              [](const std::pair<double, const RegstDescProto*>& lhs,
+                 const std::pair<double, const RegstDescProto*>& rhs) {
+                return lhs.first > rhs.first;
+              });
+    if (stalled_regst_descs.size() > max_tried_regst_desc_num) {
+      stalled_regst_descs.resize(max_tried_regst_desc_num);
+    }
+    const RegstDescProto* best_regst_desc = nullptr;
+    double best_gain = 0;
+    for (const auto& pair : stalled_regst_descs) {
+      const RegstDescProto* regst_desc = pair.second;
+      const int64_t regst_desc_id = regst_desc->regst_desc_id();
+      const int64_t regst_num = simulator.RegstNum(regst_desc_id);
+      if (regst_num >= regst_desc->max_register_num()) { continue; }
+      const auto& mem_zone = regst_desc_id2mem_zone.at(regst_desc_id);
+      const int64_t extra_mem_size = ExtraMemSize4OneMoreRegst(regst_desc);
+      if (extra_mem_size > mz_available[mem_zone.first][mem_zone.second]) { continue; }
+      simulator.SetRegstNum(regst_desc_id, regst_num + 1);
+      const double tried_ii = simulator.Simulate(simulated_piece_num);
+      simulator.SetRegstNum(regst_desc_id, regst_num);
+      if (tried_ii > ii * (1 - min_ii_improvement)) { continue; }
+      // ii saved per byte, so a cheap regst wins over a slightly better but bigger one
+      const double gain = (ii - tried_ii) / (extra_mem_size + 1);
+      if (gain > best_gain) {
+        best_gain = gain;
+        best_regst_desc = regst_desc;
+      }
+    }
+    if (best_regst_desc == nullptr) { break; }
+    const int64_t regst_desc_id = best_regst_desc->regst_desc_id();
+    const auto& mem_zone = regst_desc_id2mem_zone.at(regst_desc_id);
+    mz_available[mem_zone.first][mem_zone.second] -= ExtraMemSize4OneMoreRegst(best_regst_desc);
+    simulator.SetRegstNum(regst_desc_id, simulator.RegstNum(regst_desc_id) + 1);
+    simulator.Simulate(simulated_piece_num, &simulation);
+    ii = simulation.iteration_time;
+  }
+  LOG(INFO) << "simulated ii: " << origin_ii << " -> " << ii;
+  for (const auto& pair : regst_desc_id2tunable_regst_desc) {
+    const int64_t regst_num = simulator.RegstNum(pair.first);
+    if (regst_num != pair.second->register_num()) { Handler(pair.first, regst_num); }
+  }
+  return Maybe<void>::Ok();
+}
+
 void Improver::ForEachInferredMemBlockCriticalSection(
     const Plan& plan, const std::function<int64_t(int64_t)>& OrderInGraph4TaskId,
     const std::function<void(const std::vector<const RegstDescProto*>&)>& Handler) const {
@@ -705,6 +827,8 @@ Maybe<Plan> Improver::Improve(const AvailableMemDesc& amd, const Plan& naive_pla
   Init(amd, naive_plan);
   std::list<std::unique_ptr<ActEvent>> act_events;
   ParseActEvents(act_event_filepath, &act_events);
+  const HashMap<int64_t, double> task_id2act_time =
+      TaskId2MeanActTime(act_events, GlobalJobDesc().piece_num_of_experiment_phase());
   ChainActGraph chain_act_graph(naive_plan, std::move(act_events));
 
   auto PathDurations4RegstDescId = MakeGetterPathDurations4RegstDescId(chain_act_graph);
@@ -718,6 +842,9 @@ Maybe<Plan> Improver::Improve(const AvailableMemDesc& amd, const Plan& naive_pla
   Plan plan(complete_plan);
   JUST(ForEachImprovedRegstNum(complete_plan, true, base_ii, PathDurations4RegstDescId,
                                PathIIScales4RegstDescId, MakeSetterSetPlanRegstNum(&plan)));
+  if (GlobalJobDesc().regst_num_tuning_round() > 0) {
+    JUST(ForEachSimulatedRegstNum(plan, task_id2act_time, MakeSetterSetPlanRegstNum(&plan)));
+  }
   FixReliantCtrlRegstNum(plan, MakeGetterGetPlanRegstNum(&plan), MakeSetterSetPlanRegstNum(&plan));
   SetUniqueMemBlockId4UnreusedMemRegst(&plan);
   GenMemBlockAndChunk4Plan(&plan);
@@ -42,6 +42,9 @@ class Improver final {
       const std::function<const HashMap<int64_t, double>&(int64_t)>& PathDurations4RegstDescId,
       const std::function<const HashMap<int64_t, double>&(int64_t)>& PathIIScales4RegstDescId,
       const std::function<void(int64_t, uint64_t)>& Handler) const;
+  Maybe<void> ForEachSimulatedRegstNum(const Plan& plan,
+                                       const HashMap<int64_t, double>& task_id2act_time,
+                                       const std::function<void(int64_t, uint64_t)>& Handler) const;
   void ForEachInferredMemBlockCriticalSection(
       const Plan& plan, const std::function<int64_t(int64_t)>& OrderInGraph4TaskId,
       const std::function<void(const std::vector<const RegstDescProto*>&)>& Handler) const;
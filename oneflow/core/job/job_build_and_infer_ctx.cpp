@@ -65,7 +65,7 @@ Maybe<void> GetOpNames(const Job& job, HashSet<std::string>* op_names) {
 Maybe<void> EagerRunOps(const Job& job, HashSet<std::string>* op_names,
                         void (ForeignCallback::*interpret)(const std::string&, const std::string&)
                             const) {
-  const auto& op_graph = JUST(OpGraph::New(job));
+  const auto& op_graph = JUST(OpGraph4Job(job));
   const auto* foreign_callback = JUST(GlobalMaybe<ForeignCallback>());
   JUST(op_graph->ForEachOpNode([&](const OpNode& op_node) -> Maybe<void> {
     if (!op_names->insert(op_node.op().op_name()).second) { return Maybe<void>::Ok(); }
@@ -914,13 +914,15 @@ Maybe<void> LazyJobBuildAndInferCtx::Complete() {
     CHECK_OR_RETURN(job().job_conf().train_conf().has_primary_lr());
   }
   auto scope = std::make_unique<GlobalJobDescScope>(mut_job()->job_conf(), job_id());
+  IncrementalOpGraphScope op_graph_scope;
   auto DoPass = [&](const std::string& pass_name) -> Maybe<void> {
-    return FunctionPass(pass_name)(mut_job());
+    return ApplyFunctionPass(pass_name, mut_job());
   };
   if (GlobalJobDesc().Bool("__is_user_function__")) {
     JUST(DoPass("CompleteOfrecordDecoder"));
     JUST(DoPass("SetDefaultVariableConf"));
     JUST(DoPass("AutoMixedPrecision"));
+    JUST(DoPass("AutoParallelSbpSearch"));
     JUST(DoPass("TieUpChainHeadersUnReachableFromAnyVariableOps"));
     JUST(DoPass("NonDistributedOptimizerPass"));
     JUST(DoPass("AutoTrainStep"));
@@ -943,8 +945,9 @@ Maybe<void> EagerJobBuildAndInferCtx::Complete() {
   Global<JobDesc>::Delete();
   JUST(GetOpNames(job(), &executed_op_names_));
   auto scope = std::make_unique<GlobalJobDescScope>(mut_job()->job_conf(), job_id());
+  IncrementalOpGraphScope op_graph_scope;
   auto DoPass = [&](const std::string& pass_name) -> Maybe<void> {
-    return FunctionPass(pass_name)(mut_job());
+    return ApplyFunctionPass(pass_name, mut_job());
   };
   JUST(DoPass("AutoTrainStep"));
   JUST(DoPass("AutoLearningRate"));
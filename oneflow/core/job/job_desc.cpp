@@ -49,6 +49,10 @@ bool JobDesc::enable_experiment_run() const {
   return job_conf_.exp_run_conf().enable_experiment_run();
 }
 
+int64_t JobDesc::regst_num_tuning_round() const {
+  return job_conf_.exp_run_conf().regst_num_tuning_round();
+}
+
 int64_t JobDesc::TotalBatchNum() const { return job_conf_.total_batch_num(); }
 int64_t JobDesc::NumOfPiecesInBatch() const { return 1; }
 int32_t JobDesc::loss_scale_factor() const {
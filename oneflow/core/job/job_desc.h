@@ -49,6 +49,7 @@ class JobDesc final {
     return job_conf_.use_memory_allocation_algorithm_v2();
   }
   bool enable_experiment_run() const;
+  int64_t regst_num_tuning_round() const;
   bool enable_reuse_mem() const { return job_conf_.enable_reuse_mem(); }
   bool enable_inplace() const { return job_conf_.enable_inplace(); }
   bool enable_float_compute_for_half_gemm() const {
@@ -106,6 +107,23 @@ const JobDesc& GlobalJobDesc();
 bool IsPullJob(const std::string& job_name, const InterUserJobInfo& inter_user_job_info);
 bool IsPushJob(const std::string& job_name, const InterUserJobInfo& inter_user_job_info);
 
+inline bool operator==(const JobConfigProto& lhs, const JobConfigProto& rhs) {
+  return PbMd().Equals(lhs, rhs);
+}
+
 }  // namespace oneflow
 
+namespace std {
+
+template<>
+struct hash<oneflow::JobConfigProto> final {
+  size_t operator()(const oneflow::JobConfigProto& job_conf) const {
+    std::string serialized;
+    oneflow::PbMessage2DeterministicString(job_conf, &serialized);
+    return std::hash<std::string>()(serialized);
+  }
+};
+
+}  // namespace std
+
 #endif  // ONEFLOW_CORE_JOB_JOB_DESC_H_
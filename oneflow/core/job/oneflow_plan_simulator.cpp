@@ -0,0 +1,133 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "oneflow/core/common/protobuf.h"
+#include "oneflow/core/job/plan_simulator.h"
+#include "oneflow/core/job/plan_cost_model.h"
+#include "oneflow/core/actor/act_event_logger.h"
+
+DEFINE_string(plan, "", "Plan file path in text format, e.g. improved_plan in the log dir");
+DEFINE_string(act_event, "",
+              "Act events recorded by a run of the plan, e.g. experiment_act_event.bin in the log "
+              "dir. Act times of the tasks not recorded are estimated by the cost model.");
+DEFINE_int64(act_event_piece_num, 0,
+             "Number of pieces the run recording --act_event went through, e.g. "
+             "piece_num_of_experiment_phase for experiment_act_event.bin");
+DEFINE_int64(piece_num, 32, "Number of simulated pieces");
+DEFINE_int32(top_n, 10, "Number of tasks and regst descs listed in every section");
+DEFINE_double(act_overhead_ns, 5000, "Fixed time of every act");
+DEFINE_double(host_gflops, 100, "Compute of a cpu device");
+DEFINE_double(host_mem_gbps, 20, "Memory bandwidth of a cpu device");
+DEFINE_double(device_gflops, 10000, "Compute of a gpu device");
+DEFINE_double(device_mem_gbps, 500, "Memory bandwidth of a gpu device");
+DEFINE_double(pcie_gbps, 12, "Bandwidth of host to device copies");
+DEFINE_double(net_gbps, 10, "Bandwidth of the network between machines");
+DEFINE_double(net_latency_ns, 10000, "Latency of the network between machines");
+
+namespace oneflow {
+
+namespace {
+
+std::string TaskName(const TaskProto& task) {
+  std::string name = TaskType_Name(task.task_type()) + "[" + std::to_string(task.task_id()) + "]";
+  if (task.exec_sequence().exec_node_size() > 0) {
+    name += " " + task.exec_sequence().exec_node(0).kernel_conf().op_attribute().op_conf().name();
+  }
+  return name;
+}
+
+template<typename T>
+std::vector<std::pair<double, T>> TopN(const HashMap<T, double>& key2value) {
+  std::vector<std::pair<double, T>> value7keys;
+  for (const auto& pair : key2value) { value7keys.emplace_back(pair.second, pair.first); }
+  std::sort(value7keys.begin(), value7keys.end(),
+            [](const std::pair<double, T>& lhs, const std::pair<double, T>& rhs) {
+              return lhs.first > rhs.first;
+            });
+  if (value7keys.size() > FLAGS_top_n) { value7keys.resize(FLAGS_top_n); }
+  return value7keys;
+}
+
+void Run() {
+  Plan plan;
+  ParseProtoFromTextFile(FLAGS_plan, &plan);
+  HashMap<int64_t, const TaskProto*> task_id2task;
+  HashMap<int64_t, const TaskProto*> regst_desc_id2producer;
+  for (const TaskProto& task : plan.task()) {
+    task_id2task.emplace(task.task_id(), &task);
+    for (const auto& pair : task.produced_regst_desc()) {
+      regst_desc_id2producer.emplace(pair.second.regst_desc_id(), &task);
+    }
+  }
+  PlanCostModel cost_model;
+  cost_model.act_overhead = FLAGS_act_overhead_ns;
+  cost_model.host_flops = FLAGS_host_gflops;
+  cost_model.host_mem_bandwidth = FLAGS_host_mem_gbps;
+  cost_model.device_flops = FLAGS_device_gflops;
+  cost_model.device_mem_bandwidth = FLAGS_device_mem_gbps;
+  cost_model.host_device_bandwidth = FLAGS_pcie_gbps;
+  cost_model.net_bandwidth = FLAGS_net_gbps;
+  cost_model.net_latency = FLAGS_net_latency_ns;
+  PlanSimulator simulator(plan);
+  simulator.SetActTimes(TaskId2EstimatedActTime(plan, cost_model));
+  HashMap<int64_t, double> task_id2act_time;
+  if (!FLAGS_act_event.empty()) {
+    std::list<std::unique_ptr<ActEvent>> act_events;
+    ParseActEvents(FLAGS_act_event, &act_events);
+    CHECK_GT(FLAGS_act_event_piece_num, 0) << "--act_event needs --act_event_piece_num";
+    task_id2act_time = TaskId2MeanActTime(act_events, FLAGS_act_event_piece_num);
+    simulator.SetActTimes(task_id2act_time);
+  }
+  PlanSimulationResult result;
+  simulator.Simulate(FLAGS_piece_num, &result);
+
+  std::cout << "tasks: " << plan.task_size() << ", profiled: " << task_id2act_time.size()
+            << std::endl;
+  std::cout << "iteration time: " << result.iteration_time / 1e6 << " ms, "
+            << 1e9 / result.iteration_time << " pieces/s" << std::endl;
+  std::cout << "makespan of " << FLAGS_piece_num << " pieces: " << result.makespan / 1e6 << " ms"
+            << std::endl;
+  std::cout << "busiest tasks:" << std::endl;
+  for (const auto& pair : TopN(result.task_id2utilization)) {
+    std::cout << "  " << pair.first * 100 << "% " << TaskName(*task_id2task.at(pair.second))
+              << std::endl;
+  }
+  HashMap<int64_t, double> task_id2critical_act_cnt;
+  for (const auto& pair : result.critical_path) { task_id2critical_act_cnt[pair.first] += 1; }
+  std::cout << "critical path, " << result.critical_path.size() << " acts:" << std::endl;
+  for (const auto& pair : TopN(task_id2critical_act_cnt)) {
+    std::cout << "  " << pair.first << " acts " << TaskName(*task_id2task.at(pair.second))
+              << std::endl;
+  }
+  std::cout << "regst descs stalling their producers:" << std::endl;
+  for (const auto& pair : TopN(result.regst_desc_id2stall_time)) {
+    std::cout << "  " << pair.first / 1e6 << " ms regst_desc " << pair.second
+              << " register_num " << simulator.RegstNum(pair.second) << " of "
+              << TaskName(*regst_desc_id2producer.at(pair.second)) << std::endl;
+  }
+}
+
+}  // namespace
+
+}  // namespace oneflow
+
+int main(int argc, char* argv[]) {
+  using namespace oneflow;
+  gflags::SetUsageMessage("Predict the throughput of a plan by simulating its actors");
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  CHECK(!FLAGS_plan.empty()) << "--plan is required";
+  Run();
+  return 0;
+}
@@ -0,0 +1,156 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "oneflow/core/job/plan_cost_model.h"
+#include "oneflow/core/common/shape.h"
+#include "oneflow/core/common/data_type.h"
+#include "oneflow/core/graph/chain_act_graph.h"
+
+namespace oneflow {
+
+namespace {
+
+int64_t ByteSize4OneRegst(const RegstDescProto& regst_desc) {
+  if (!regst_desc.regst_desc_type().has_data_regst_desc()) { return 0; }
+  int64_t byte_size = 0;
+  for (const auto& pair : regst_desc.regst_desc_type().data_regst_desc().lbi2blob_desc()) {
+    const BlobDescProto& blob_desc = pair.blob_desc();
+    if (blob_desc.is_body_disabled()) { continue; }
+    byte_size += Shape(blob_desc.body().shape()).elem_cnt()
+                 * GetSizeOfDataType(blob_desc.body().data_type());
+  }
+  return byte_size;
+}
+
+bool IsDeviceTask(const TaskProto& task) {
+  for (const auto& pair : task.produced_regst_desc()) {
+    if (pair.second.mem_case().has_device_cuda_mem()) { return true; }
+  }
+  return false;
+}
+
+double EstimateFlops(const ExecNodeProto& exec_node,
+                     const HashMap<int64_t, const RegstDescProto*>& regst_desc_id2regst_desc) {
+  const OpAttribute& op_attribute = exec_node.kernel_conf().op_attribute();
+  auto Shape4Bn = [&](const std::string& bn, Shape* shape) -> bool {
+    const auto& regst_desc_id_it = exec_node.bn_in_op2regst_desc_id().find(bn);
+    if (regst_desc_id_it == exec_node.bn_in_op2regst_desc_id().end()) { return false; }
+    const auto& regst_desc_it = regst_desc_id2regst_desc.find(regst_desc_id_it->second);
+    if (regst_desc_it == regst_desc_id2regst_desc.end()) { return false; }
+    const auto& lbi_it = op_attribute.arg_signature().bn_in_op2lbi().find(bn);
+    if (lbi_it == op_attribute.arg_signature().bn_in_op2lbi().end()) { return false; }
+    const RegstDescTypeProto& regst_desc_type = regst_desc_it->second->regst_desc_type();
+    if (!regst_desc_type.has_data_regst_desc()) { return false; }
+    for (const auto& pair : regst_desc_type.data_regst_desc().lbi2blob_desc()) {
+      if (pair.lbi() == lbi_it->second) {
+        *shape = Shape(pair.blob_desc().body().shape());
+        return true;
+      }
+    }
+    return false;
+  };
+  double out_elem_cnt = 0;
+  for (const std::string& obn : op_attribute.output_bns()) {
+    Shape shape;
+    if (Shape4Bn(obn, &shape)) { out_elem_cnt += shape.elem_cnt(); }
+  }
+  if (op_attribute.op_conf().has_user_conf()) {
+    const UserOpConf& user_conf = op_attribute.op_conf().user_conf();
+    const std::string& op_type_name = user_conf.op_type_name();
+    Shape out;
+    if ((op_type_name == "matmul" || op_type_name == "batch_matmul"
+         || op_type_name == "broadcast_matmul")
+        && Shape4Bn("out_0", &out)) {
+      Shape a;
+      if (Shape4Bn("a_0", &a) && a.NumAxes() >= 2) {
+        const auto& transpose_a_it = user_conf.attr().find("transpose_a");
+        const bool transpose_a =
+            transpose_a_it != user_conf.attr().end() && transpose_a_it->second.at_bool();
+        const int64_t k = transpose_a ? a.At(a.NumAxes() - 2) : a.At(a.NumAxes() - 1);
+        return 2.0 * out.elem_cnt() * k;
+      }
+    } else if ((op_type_name == "conv1d" || op_type_name == "conv2d" || op_type_name == "conv3d")
+               && Shape4Bn("out_0", &out)) {
+      Shape weight;
+      if (Shape4Bn("weight_0", &weight) && weight.At(0) > 0) {
+        return 2.0 * out.elem_cnt() * (weight.elem_cnt() / weight.At(0));
+      }
+    }
+  }
+  // most other ops do a handful of operations per output element
+  return out_elem_cnt;
+}
+
+}  // namespace
+
+HashMap<int64_t, double> TaskId2MeanActTime(const std::list<std::unique_ptr<ActEvent>>& act_events,
+                                            int64_t piece_num) {
+  CHECK_GT(piece_num, 0);
+  HashMap<int64_t, double> task_id2total_act_time;
+  for (const auto& act_event : act_events) {
+    task_id2total_act_time[act_event->actor_id()] += Duration4ActEvent(*act_event);
+  }
+  HashMap<int64_t, double> task_id2act_time;
+  for (const auto& pair : task_id2total_act_time) {
+    task_id2act_time.emplace(pair.first, pair.second / piece_num);
+  }
+  return task_id2act_time;
+}
+
+HashMap<int64_t, double> TaskId2EstimatedActTime(const Plan& plan,
+                                                 const PlanCostModel& cost_model) {
+  HashMap<int64_t, const RegstDescProto*> regst_desc_id2regst_desc;
+  for (const TaskProto& task : plan.task()) {
+    for (const auto& pair : task.produced_regst_desc()) {
+      regst_desc_id2regst_desc.emplace(pair.second.regst_desc_id(), &pair.second);
+    }
+  }
+  HashMap<int64_t, double> task_id2act_time;
+  for (const TaskProto& task : plan.task()) {
+    double in_bytes = 0;
+    for (const auto& pair : task.consumed_regst_desc_id()) {
+      for (int64_t regst_desc_id : pair.second.regst_desc_id()) {
+        const auto& it = regst_desc_id2regst_desc.find(regst_desc_id);
+        if (it != regst_desc_id2regst_desc.end()) { in_bytes += ByteSize4OneRegst(*it->second); }
+      }
+    }
+    double out_bytes = 0;
+    for (const auto& pair : task.produced_regst_desc()) {
+      out_bytes += ByteSize4OneRegst(pair.second);
+    }
+    double act_time = cost_model.act_overhead;
+    if (task.task_type() == TaskType::kCopyHd) {
+      act_time += out_bytes / cost_model.host_device_bandwidth;
+    } else if (task.task_type() == TaskType::kCopyCommNet) {
+      act_time += cost_model.net_latency + out_bytes / cost_model.net_bandwidth;
+    } else {
+      double flops = 0;
+      for (const ExecNodeProto& exec_node : task.exec_sequence().exec_node()) {
+        flops += EstimateFlops(exec_node, regst_desc_id2regst_desc);
+      }
+      const bool is_device = IsDeviceTask(task);
+      const double compute_time =
+          flops / (is_device ? cost_model.device_flops : cost_model.host_flops);
+      const double mem_time = (in_bytes + out_bytes)
+                              / (is_device ? cost_model.device_mem_bandwidth
+                                           : cost_model.host_mem_bandwidth);
+      act_time += std::max(compute_time, mem_time);
+    }
+    task_id2act_time.emplace(task.task_id(), act_time);
+  }
+  return task_id2act_time;
+}
+
+}  // namespace oneflow
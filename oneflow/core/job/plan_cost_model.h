@@ -0,0 +1,50 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#ifndef ONEFLOW_CORE_JOB_PLAN_COST_MODEL_H_
+#define ONEFLOW_CORE_JOB_PLAN_COST_MODEL_H_
+
+#include "oneflow/core/common/util.h"
+#include "oneflow/core/job/plan.pb.h"
+#include "oneflow/core/actor/act_event.pb.h"
+
+namespace oneflow {
+
+// Hardware assumed for a plan that never ran. Times are in ns, bandwidths in bytes per ns (GB/s)
+// and compute in FLOPs per ns (GFLOPS).
+struct PlanCostModel {
+  double act_overhead = 5000;
+  double host_flops = 100;
+  double host_mem_bandwidth = 20;
+  double device_flops = 10000;
+  double device_mem_bandwidth = 500;
+  double host_device_bandwidth = 12;
+  double net_bandwidth = 10;
+  double net_latency = 10000;
+};
+
+// Mean time per piece of every profiled task, act_events being recorded over piece_num pieces.
+// Tasks acting several times per piece get the time of all those acts, and tasks acting less
+// often than once per piece get their total time spread over the pieces.
+HashMap<int64_t, double> TaskId2MeanActTime(const std::list<std::unique_ptr<ActEvent>>& act_events,
+                                            int64_t piece_num);
+
+// Act time of every task of the plan by a roofline over the FLOPs of its ops and the bytes of its
+// regsts. Copy tasks only move bytes, over PCIe or the network.
+HashMap<int64_t, double> TaskId2EstimatedActTime(const Plan& plan, const PlanCostModel& cost_model);
+
+}  // namespace oneflow
+
+#endif  // ONEFLOW_CORE_JOB_PLAN_COST_MODEL_H_
@@ -0,0 +1,99 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "oneflow/core/job/plan_cost_model.h"
+
+namespace oneflow {
+
+namespace test {
+
+namespace {
+
+RegstDescProto* AddFloatRegstDesc(TaskProto* task, int64_t regst_desc_id, int64_t elem_cnt) {
+  RegstDescProto& regst_desc = (*task->mutable_produced_regst_desc())["out"];
+  regst_desc.set_regst_desc_id(regst_desc_id);
+  regst_desc.set_producer_task_id(task->task_id());
+  BlobDescProto* blob_desc = regst_desc.mutable_regst_desc_type()
+                                 ->mutable_data_regst_desc()
+                                 ->add_lbi2blob_desc()
+                                 ->mutable_blob_desc();
+  blob_desc->mutable_body()->mutable_shape()->add_dim(elem_cnt);
+  blob_desc->mutable_body()->set_data_type(DataType::kFloat);
+  blob_desc->set_is_body_disabled(false);
+  return &regst_desc;
+}
+
+}  // namespace
+
+TEST(PlanCostModel, copy_and_compute) {
+  Plan plan;
+  TaskProto* h2d = plan.add_task();
+  h2d->set_task_id(0);
+  h2d->set_task_type(TaskType::kCopyHd);
+  AddFloatRegstDesc(h2d, 10, 1000)->add_consumer_task_id(1);
+  TaskProto* compute = plan.add_task();
+  compute->set_task_id(1);
+  compute->set_task_type(TaskType::kNormalForward);
+  (*compute->mutable_consumed_regst_desc_id())["in"].add_regst_desc_id(10);
+  AddFloatRegstDesc(compute, 11, 1000)->mutable_mem_case()->mutable_device_cuda_mem();
+  PlanCostModel cost_model;
+  cost_model.act_overhead = 1;
+  cost_model.host_device_bandwidth = 4;
+  cost_model.device_mem_bandwidth = 8;
+  const HashMap<int64_t, double> task_id2act_time = TaskId2EstimatedActTime(plan, cost_model);
+  ASSERT_DOUBLE_EQ(task_id2act_time.at(0), 1 + 4000.0 / 4);
+  ASSERT_DOUBLE_EQ(task_id2act_time.at(1), 1 + 8000.0 / 8);
+}
+
+TEST(PlanCostModel, mean_act_time) {
+  std::list<std::unique_ptr<ActEvent>> act_events;
+  auto AddActEvent = [&](int64_t actor_id, double start_time, double stop_time) {
+    act_events.emplace_back(new ActEvent());
+    act_events.back()->set_actor_id(actor_id);
+    act_events.back()->set_start_time(start_time);
+    act_events.back()->set_stop_time(stop_time);
+  };
+  AddActEvent(0, 0, 2);
+  AddActEvent(0, 2, 6);
+  AddActEvent(1, 6, 10);
+  const HashMap<int64_t, double> task_id2act_time = TaskId2MeanActTime(act_events, 2);
+  ASSERT_DOUBLE_EQ(task_id2act_time.at(0), 3);
+  // acting once every two pieces
+  ASSERT_DOUBLE_EQ(task_id2act_time.at(1), 2);
+}
+
+TEST(PlanCostModel, mean_act_time_of_multi_act_task) {
+  std::list<std::unique_ptr<ActEvent>> act_events;
+  auto AddActEvent = [&](int64_t actor_id, double start_time, double stop_time) {
+    act_events.emplace_back(new ActEvent());
+    act_events.back()->set_actor_id(actor_id);
+    act_events.back()->set_start_time(start_time);
+    act_events.back()->set_stop_time(stop_time);
+  };
+  const int64_t piece_num = 2;
+  FOR_RANGE(int64_t, piece, 0, piece_num) {
+    // task 0 acts four times per piece, task 1 once
+    FOR_RANGE(int64_t, i, 0, 4) { AddActEvent(0, piece * 10 + i, piece * 10 + i + 1); }
+    AddActEvent(1, piece * 10 + 4, piece * 10 + 9);
+  }
+  const HashMap<int64_t, double> task_id2act_time = TaskId2MeanActTime(act_events, piece_num);
+  ASSERT_DOUBLE_EQ(task_id2act_time.at(0), 4);
+  // not scaled down by the act count of task 0
+  ASSERT_DOUBLE_EQ(task_id2act_time.at(1), 5);
+}
+
+}  // namespace test
+
+}  // namespace oneflow
@@ -0,0 +1,204 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "oneflow/core/job/plan_simulator.h"
+
+namespace oneflow {
+
+PlanSimulator::PlanSimulator(const Plan& plan) {
+  std::map<std::pair<int64_t, int64_t>, int64_t> machine_thrd2thrd;
+  for (const TaskProto& task_proto : plan.task()) {
+    const auto machine_thrd = std::make_pair(task_proto.machine_id(), task_proto.thrd_id());
+    auto thrd_it = machine_thrd2thrd.emplace(machine_thrd, machine_thrd2thrd.size()).first;
+    CHECK(task_id2index_.emplace(task_proto.task_id(), tasks_.size()).second);
+    TaskNode task;
+    task.task_id = task_proto.task_id();
+    task.thrd = thrd_it->second;
+    task.act_time = 0;
+    tasks_.push_back(task);
+  }
+  thrd_num_ = machine_thrd2thrd.size();
+  for (const TaskProto& task_proto : plan.task()) {
+    const int64_t producer = task_id2index_.at(task_proto.task_id());
+    for (const auto& pair : task_proto.produced_regst_desc()) {
+      const RegstDescProto& regst_desc_proto = pair.second;
+      const int64_t index = regst_descs_.size();
+      CHECK(regst_desc_id2index_.emplace(regst_desc_proto.regst_desc_id(), index).second);
+      RegstDescNode regst_desc;
+      regst_desc.regst_desc_id = regst_desc_proto.regst_desc_id();
+      regst_desc.regst_num = regst_desc_proto.register_num();
+      regst_desc.producer = producer;
+      for (int64_t consumer_task_id : regst_desc_proto.consumer_task_id()) {
+        // consumers outside the plan never hold the regst in this simulation
+        auto consumer_it = task_id2index_.find(consumer_task_id);
+        if (consumer_it == task_id2index_.end()) { continue; }
+        regst_desc.consumers.push_back(consumer_it->second);
+        tasks_.at(consumer_it->second).consumed.push_back(index);
+      }
+      tasks_.at(producer).produced.push_back(index);
+      regst_descs_.push_back(regst_desc);
+    }
+  }
+}
+
+void PlanSimulator::SetActTime(int64_t task_id, double act_time) {
+  CHECK_GE(act_time, 0);
+  tasks_.at(task_id2index_.at(task_id)).act_time = act_time;
+}
+
+void PlanSimulator::SetRegstNum(int64_t regst_desc_id, int64_t regst_num) {
+  CHECK_GE(regst_num, 1);
+  regst_descs_.at(regst_desc_id2index_.at(regst_desc_id)).regst_num = regst_num;
+}
+
+void PlanSimulator::SetActTimes(const HashMap<int64_t, double>& task_id2act_time) {
+  for (const TaskNode& task : tasks_) {
+    const auto& it = task_id2act_time.find(task.task_id);
+    if (it != task_id2act_time.end()) { SetActTime(it->first, it->second); }
+  }
+}
+
+int64_t PlanSimulator::RegstNum(int64_t regst_desc_id) const {
+  return regst_descs_.at(regst_desc_id2index_.at(regst_desc_id)).regst_num;
+}
+
+void PlanSimulator::Simulate(int64_t piece_num, PlanSimulationResult* result) const {
+  CHECK_NOTNULL(result);
+  DoSimulate(piece_num, result);
+}
+
+double PlanSimulator::Simulate(int64_t piece_num) const { return DoSimulate(piece_num, nullptr); }
+
+double PlanSimulator::DoSimulate(int64_t piece_num, PlanSimulationResult* result) const {
+  CHECK_GT(piece_num, 0);
+  const int64_t task_num = tasks_.size();
+  std::vector<int64_t> started_cnt(task_num, 0);
+  std::vector<int64_t> finished_cnt(task_num, 0);
+  // an act of the task is queued on its thread or running
+  std::vector<bool> is_task_busy(task_num, false);
+  std::vector<int64_t> stalling_regst_desc(task_num, -1);
+  std::vector<double> stall_start_time(task_num, 0);
+  std::vector<double> stall_time(regst_descs_.size(), 0);
+  std::vector<std::deque<int64_t>> thrd_queues(thrd_num_);
+  std::vector<bool> is_thrd_busy(thrd_num_, false);
+  std::vector<double> piece_finish_time(piece_num, 0);
+  // an act is indexed by task * piece_num + act_id, its cause is the act whose finish started it
+  std::vector<int64_t> act2cause(result != nullptr ? task_num * piece_num : 0, -1);
+  int64_t finished_act = -1;
+  using FinishEvent = std::pair<double, int64_t>;
+  std::priority_queue<FinishEvent, std::vector<FinishEvent>, std::greater<FinishEvent>>
+      finish_events;
+
+  auto TryEnqueue = [&](int64_t task, double now) {
+    if (is_task_busy[task] || started_cnt[task] == piece_num) { return; }
+    const int64_t act_id = started_cnt[task];
+    for (int64_t regst_desc : tasks_[task].consumed) {
+      if (finished_cnt[regst_descs_[regst_desc].producer] <= act_id) { return; }
+    }
+    for (int64_t regst_desc : tasks_[task].produced) {
+      int64_t freed_cnt = act_id;
+      for (int64_t consumer : regst_descs_[regst_desc].consumers) {
+        freed_cnt = std::min(freed_cnt, finished_cnt[consumer]);
+      }
+      if (act_id - freed_cnt >= regst_descs_[regst_desc].regst_num) {
+        if (stalling_regst_desc[task] == -1) {
+          stalling_regst_desc[task] = regst_desc;
+          stall_start_time[task] = now;
+        }
+        return;
+      }
+    }
+    if (stalling_regst_desc[task] != -1) {
+      stall_time[stalling_regst_desc[task]] += now - stall_start_time[task];
+      stalling_regst_desc[task] = -1;
+    }
+    is_task_busy[task] = true;
+    thrd_queues[tasks_[task].thrd].push_back(task);
+  };
+  auto TryDispatch = [&](int64_t thrd, double now) {
+    if (is_thrd_busy[thrd] || thrd_queues[thrd].empty()) { return; }
+    const int64_t task = thrd_queues[thrd].front();
+    thrd_queues[thrd].pop_front();
+    is_thrd_busy[thrd] = true;
+    if (result != nullptr) { act2cause[task * piece_num + started_cnt[task]] = finished_act; }
+    started_cnt[task] += 1;
+    finish_events.emplace(now + tasks_[task].act_time, task);
+  };
+
+  FOR_RANGE(int64_t, task, 0, task_num) { TryEnqueue(task, 0); }
+  FOR_RANGE(int64_t, thrd, 0, thrd_num_) { TryDispatch(thrd, 0); }
+  while (!finish_events.empty()) {
+    const double now = finish_events.top().first;
+    const int64_t task = finish_events.top().second;
+    finish_events.pop();
+    const TaskNode& node = tasks_[task];
+    finished_act = task * piece_num + finished_cnt[task];
+    double& cur_piece_finish_time = piece_finish_time[finished_cnt[task]];
+    cur_piece_finish_time = std::max(cur_piece_finish_time, now);
+    finished_cnt[task] += 1;
+    is_task_busy[task] = false;
+    is_thrd_busy[node.thrd] = false;
+    TryEnqueue(task, now);
+    for (int64_t regst_desc : node.produced) {
+      for (int64_t consumer : regst_descs_[regst_desc].consumers) {
+        TryEnqueue(consumer, now);
+        TryDispatch(tasks_[consumer].thrd, now);
+      }
+    }
+    for (int64_t regst_desc : node.consumed) {
+      const int64_t producer = regst_descs_[regst_desc].producer;
+      TryEnqueue(producer, now);
+      TryDispatch(tasks_[producer].thrd, now);
+    }
+    TryDispatch(node.thrd, now);
+  }
+
+  const bool is_all_finished =
+      std::all_of(finished_cnt.begin(), finished_cnt.end(),
+                  [piece_num](int64_t act_cnt) { return act_cnt == piece_num; });
+  double iteration_time = std::numeric_limits<double>::infinity();
+  if (is_all_finished) {
+    // the first half of the pieces fills the pipeline
+    if (piece_num == 1) {
+      iteration_time = piece_finish_time.front();
+    } else {
+      const int64_t warmup_piece_num = piece_num / 2;
+      iteration_time = (piece_finish_time.back() - piece_finish_time.at(warmup_piece_num - 1))
+                       / (piece_num - warmup_piece_num);
+    }
+  }
+  if (result != nullptr) {
+    result->iteration_time = iteration_time;
+    result->makespan = *std::max_element(piece_finish_time.begin(), piece_finish_time.end());
+    result->task_id2utilization.clear();
+    for (const TaskNode& task : tasks_) {
+      result->task_id2utilization[task.task_id] =
+          result->makespan > 0 ? task.act_time * piece_num / result->makespan : 0;
+    }
+    result->regst_desc_id2stall_time.clear();
+    FOR_RANGE(int64_t, i, 0, regst_descs_.size()) {
+      if (stall_time[i] == 0) { continue; }
+      result->regst_desc_id2stall_time[regst_descs_[i].regst_desc_id] = stall_time[i];
+    }
+    result->critical_path.clear();
+    for (int64_t act = finished_act; act != -1; act = act2cause[act]) {
+      result->critical_path.emplace_back(tasks_[act / piece_num].task_id, act % piece_num);
+    }
+    std::reverse(result->critical_path.begin(), result->critical_path.end());
+  }
+  return iteration_time;
+}
+
+}  // namespace oneflow
@@ -0,0 +1,86 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#ifndef ONEFLOW_CORE_JOB_PLAN_SIMULATOR_H_
+#define ONEFLOW_CORE_JOB_PLAN_SIMULATOR_H_
+
+#include "oneflow/core/common/util.h"
+#include "oneflow/core/job/plan.pb.h"
+
+namespace oneflow {
+
+struct PlanSimulationResult {
+  // steady state time per piece, infinity if the pipeline stalls forever
+  double iteration_time;
+  double makespan;
+  // busy time over makespan
+  HashMap<int64_t, double> task_id2utilization;
+  // how long tasks waited for a free regst of each regst desc
+  HashMap<int64_t, double> regst_desc_id2stall_time;
+  // (task_id, act_id) of the acts each starting right when the one before finished, ending with
+  // the last act
+  std::vector<std::pair<int64_t, int64_t>> critical_path;
+};
+
+// Discrete event simulation of the actor pipeline of a plan. Every task acts once per piece, an
+// act starts when the consumed regsts of the same piece are produced, a free regst of every
+// produced regst desc is available and the thread of the task is idle. Regsts are freed when all
+// consumers finished the act reading them. Device streams, the comm net and the copy engines are
+// modeled by the actor threads driving them, which run one act at a time.
+class PlanSimulator final {
+ public:
+  OF_DISALLOW_COPY_AND_MOVE(PlanSimulator);
+  explicit PlanSimulator(const Plan& plan);
+  ~PlanSimulator() = default;
+
+  // time of one act, 0 by default
+  void SetActTime(int64_t task_id, double act_time);
+  void SetActTimes(const HashMap<int64_t, double>& task_id2act_time);
+  // register_num of the plan by default
+  void SetRegstNum(int64_t regst_desc_id, int64_t regst_num);
+  int64_t RegstNum(int64_t regst_desc_id) const;
+
+  void Simulate(int64_t piece_num, PlanSimulationResult* result) const;
+  // the iteration time only
+  double Simulate(int64_t piece_num) const;
+
+ private:
+  struct RegstDescNode {
+    int64_t regst_desc_id;
+    int64_t regst_num;
+    int64_t producer;
+    std::vector<int64_t> consumers;
+  };
+  struct TaskNode {
+    int64_t task_id;
+    int64_t thrd;
+    double act_time;
+    std::vector<int64_t> consumed;
+    std::vector<int64_t> produced;
+  };
+
+  // fills result only when it is not nullptr
+  double DoSimulate(int64_t piece_num, PlanSimulationResult* result) const;
+
+  std::vector<TaskNode> tasks_;
+  std::vector<RegstDescNode> regst_descs_;
+  int64_t thrd_num_;
+  HashMap<int64_t, int64_t> task_id2index_;
+  HashMap<int64_t, int64_t> regst_desc_id2index_;
+};
+
+}  // namespace oneflow
+
+#endif  // ONEFLOW_CORE_JOB_PLAN_SIMULATOR_H_
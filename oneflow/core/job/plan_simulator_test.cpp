@@ -0,0 +1,109 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "oneflow/core/job/plan_simulator.h"
+
+namespace oneflow {
+
+namespace test {
+
+namespace {
+
+TaskProto* AddTask(Plan* plan, int64_t task_id, int64_t thrd_id) {
+  TaskProto* task = plan->add_task();
+  task->set_task_id(task_id);
+  task->set_machine_id(0);
+  task->set_thrd_id(thrd_id);
+  return task;
+}
+
+void Connect(TaskProto* producer, TaskProto* consumer, int64_t regst_desc_id, int32_t regst_num) {
+  RegstDescProto& regst_desc =
+      (*producer->mutable_produced_regst_desc())["out_" + std::to_string(regst_desc_id)];
+  regst_desc.set_regst_desc_id(regst_desc_id);
+  regst_desc.set_producer_task_id(producer->task_id());
+  regst_desc.add_consumer_task_id(consumer->task_id());
+  regst_desc.set_register_num(regst_num);
+  (*consumer->mutable_consumed_regst_desc_id())["in"].add_regst_desc_id(regst_desc_id);
+}
+
+}  // namespace
+
+TEST(PlanSimulator, producer_consumer) {
+  Plan plan;
+  Connect(AddTask(&plan, 0, 0), AddTask(&plan, 1, 1), 10, 1);
+  PlanSimulator simulator(plan);
+  simulator.SetActTime(0, 1);
+  simulator.SetActTime(1, 2);
+  PlanSimulationResult result;
+  // a single regst serializes the producer and the consumer
+  simulator.Simulate(16, &result);
+  ASSERT_DOUBLE_EQ(result.iteration_time, 3);
+  ASSERT_DOUBLE_EQ(result.makespan, 48);
+  ASSERT_GT(result.regst_desc_id2stall_time.at(10), 0);
+  simulator.SetRegstNum(10, 2);
+  ASSERT_EQ(simulator.RegstNum(10), 2);
+  simulator.Simulate(16, &result);
+  ASSERT_DOUBLE_EQ(result.iteration_time, 2);
+  // the consumer is the bottleneck once the producer runs ahead
+  ASSERT_DOUBLE_EQ(result.task_id2utilization.at(1), 32.0 / 33.0);
+  ASSERT_DOUBLE_EQ(result.task_id2utilization.at(0), 16.0 / 33.0);
+  ASSERT_EQ(result.critical_path.front().first, 0);
+  ASSERT_EQ(result.critical_path.back().first, 1);
+  ASSERT_EQ(result.critical_path.back().second, 15);
+  ASSERT_EQ(result.critical_path.size(), 17);
+}
+
+TEST(PlanSimulator, deadlock) {
+  Plan plan;
+  TaskProto* lhs = AddTask(&plan, 0, 0);
+  TaskProto* rhs = AddTask(&plan, 1, 1);
+  Connect(lhs, rhs, 10, 1);
+  Connect(rhs, lhs, 11, 1);
+  PlanSimulator simulator(plan);
+  ASSERT_TRUE(std::isinf(simulator.Simulate(4)));
+}
+
+TEST(PlanSimulator, shared_thread) {
+  Plan plan;
+  Connect(AddTask(&plan, 0, 0), AddTask(&plan, 1, 0), 10, 4);
+  PlanSimulator simulator(plan);
+  simulator.SetActTime(0, 1);
+  simulator.SetActTime(1, 2);
+  // the producer runs ahead by a few acts, which fades out over many pieces
+  ASSERT_NEAR(simulator.Simulate(64), 3, 0.1);
+}
+
+TEST(PlanSimulator, copy_hides_behind_compute) {
+  // copy -> compute -> copy back, every stage on its own thread
+  Plan plan;
+  TaskProto* h2d = AddTask(&plan, 0, 0);
+  TaskProto* compute = AddTask(&plan, 1, 1);
+  TaskProto* d2h = AddTask(&plan, 2, 2);
+  Connect(h2d, compute, 10, 1);
+  Connect(compute, d2h, 11, 1);
+  PlanSimulator simulator(plan);
+  simulator.SetActTime(0, 2);
+  simulator.SetActTime(1, 3);
+  simulator.SetActTime(2, 2);
+  ASSERT_DOUBLE_EQ(simulator.Simulate(32), 5);
+  simulator.SetRegstNum(10, 2);
+  simulator.SetRegstNum(11, 2);
+  ASSERT_DOUBLE_EQ(simulator.Simulate(32), 3);
+}
+
+}  // namespace test
+
+}  // namespace oneflow
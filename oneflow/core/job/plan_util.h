@@ -18,6 +18,7 @@ limitations under the License.
 
 #include <functional>
 #include "oneflow/core/job/plan.pb.h"
+#include "oneflow/core/job/job.pb.h"
 
 namespace oneflow {
 
@@ -26,6 +27,7 @@ struct PlanUtil {
   static std::function<const TaskProto*(int64_t)> MakeGetterTaskProto4TaskId(const Plan& plan);
   static void CleanUselessMemBlockAndCheckValid(Plan* plan);
   static void ToDotFile(const Plan& plan, const std::string& filepath);
+  static void GenCollectiveBoxingPlan(Job* job, Plan* plan);
 };
 
 }  // namespace oneflow
@@ -0,0 +1,144 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include <gtest/gtest.h>
+#include "oneflow/core/job/plan_util.h"
+#include "oneflow/core/job/env_desc.h"
+#include "oneflow/core/job/resource_desc.h"
+#include "oneflow/core/job/job_desc.h"
+#include "oneflow/core/job/id_manager.h"
+#include "oneflow/core/job/global_for.h"
+#include "oneflow/core/graph/boxing/collective_boxing_util.h"
+
+namespace oneflow {
+
+namespace test {
+
+namespace {
+
+class PlanUtilTestEnv final {
+ public:
+  OF_DISALLOW_COPY_AND_MOVE(PlanUtilTestEnv);
+  explicit PlanUtilTestEnv(int64_t cpu_device_num) {
+    EnvProto env_proto;
+    auto* machine = env_proto.add_machine();
+    machine->set_id(0);
+    machine->set_addr("127.0.0.1");
+    env_proto.set_ctrl_port(9527);
+    Global<EnvDesc>::New(env_proto);
+    Resource resource;
+    resource.set_machine_num(1);
+    resource.set_cpu_device_num(cpu_device_num);
+    Global<ResourceDesc, ForSession>::New(resource);
+    Global<IDMgr>::New();
+    JobConfigProto job_conf;
+    job_conf.set_job_name("plan_util_test");
+    job_conf.mutable_predict_conf();
+    Global<JobDesc>::New(job_conf, 0);
+  }
+  ~PlanUtilTestEnv() {
+    Global<JobDesc>::Delete();
+    Global<IDMgr>::Delete();
+    Global<ResourceDesc, ForSession>::Delete();
+    Global<EnvDesc>::Delete();
+  }
+};
+
+TaskProto* AddCpuTask(Plan* plan, int64_t dev_phy_id, TaskType task_type) {
+  const int64_t thrd_id = Global<IDMgr>::Get()->GetCpuDeviceThrdId(dev_phy_id);
+  TaskProto* task = plan->add_task();
+  task->set_task_type(task_type);
+  task->set_machine_id(0);
+  task->set_thrd_id(thrd_id);
+  task->set_task_id(Global<IDMgr>::Get()->NewTaskId(0, thrd_id, 0));
+  task->mutable_task_set_info()->set_chain_id(plan->task_size());
+  task->mutable_task_set_info()->set_order_in_graph(plan->task_size());
+  return task;
+}
+
+TaskProto* AddCollectiveBoxingTask(Plan* plan, int64_t dev_phy_id,
+                                   const boxing::collective::OpDesc& op_desc, int64_t rank) {
+  TaskProto* task = AddCpuTask(plan, dev_phy_id, TaskType::kCollectiveBoxingGeneric);
+  OperatorConf* op_conf = task->mutable_exec_sequence()
+                              ->add_exec_node()
+                              ->mutable_kernel_conf()
+                              ->mutable_op_attribute()
+                              ->mutable_op_conf();
+  op_conf->set_name(op_desc.name() + "_" + std::to_string(rank));
+  boxing::collective::RankDesc* rank_desc =
+      op_conf->mutable_collective_boxing_generic_conf()->mutable_rank_desc();
+  *rank_desc->mutable_op_desc() = op_desc;
+  rank_desc->set_rank(rank);
+  return task;
+}
+
+void Connect(TaskProto* producer, TaskProto* consumer) {
+  const std::string name = "out_" + std::to_string(consumer->task_id());
+  RegstDescProto& regst_desc = (*producer->mutable_produced_regst_desc())[name];
+  regst_desc.set_producer_task_id(producer->task_id());
+  regst_desc.add_consumer_task_id(consumer->task_id());
+}
+
+boxing::collective::OpDesc MakeCpuOpDesc(const std::string& name,
+                                         boxing::collective::OpType op_type, int64_t num_ranks) {
+  boxing::collective::OpDesc op_desc;
+  op_desc.set_name(name);
+  op_desc.set_op_type(op_type);
+  op_desc.set_data_type(DataType::kFloat);
+  op_desc.mutable_shape()->add_dim(1024);
+  op_desc.set_num_ranks(num_ranks);
+  op_desc.set_backend(boxing::collective::Backend::kBackendCpu);
+  return op_desc;
+}
+
+}  // namespace
+
+TEST(PlanUtil, cpu_collective_boxing_plan) {
+  using namespace boxing::collective;
+  const int64_t num_ranks = 4;
+  PlanUtilTestEnv env(num_ranks);
+  const OpDesc all_reduce = MakeCpuOpDesc("all_reduce", OpType::kOpTypeAllReduce, num_ranks);
+  const OpDesc all_gather = MakeCpuOpDesc("all_gather", OpType::kOpTypeAllGather, num_ranks);
+  Plan plan;
+  // compute_i -> all_reduce rank i -> all_gather rank i, with rank i on cpu device i
+  FOR_RANGE(int64_t, rank, 0, num_ranks) {
+    TaskProto* compute = AddCpuTask(&plan, rank, TaskType::kNormalForward);
+    TaskProto* first = AddCollectiveBoxingTask(&plan, rank, all_reduce, rank);
+    TaskProto* second = AddCollectiveBoxingTask(&plan, rank, all_gather, rank);
+    Connect(compute, first);
+    Connect(first, second);
+  }
+  PlanUtil::GenCollectiveBoxingPlan(nullptr, &plan);
+  const RequestSet& request_set =
+      plan.collective_boxing_plan().job_id2request_set().at(GlobalJobDesc().job_id());
+  ASSERT_EQ(request_set.request_size(), 2);
+  FOR_RANGE(int64_t, i, 0, request_set.request_size()) {
+    const RequestDesc& request = request_set.request(i);
+    ASSERT_TRUE(request.op_desc() == (i == 0 ? all_reduce : all_gather));
+    ASSERT_EQ(request.order(), i);
+    ASSERT_EQ(request.dependency_depth(), i);
+    ASSERT_EQ(request.device_set().device_size(), num_ranks);
+    FOR_RANGE(int64_t, rank, 0, num_ranks) {
+      const DeviceDesc& device = request.device_set().device(rank);
+      ASSERT_EQ(device.machine_id(), 0);
+      ASSERT_EQ(device.device_type(), DeviceType::kCPU);
+      ASSERT_EQ(device.device_id(), rank);
+    }
+  }
+}
+
+}  // namespace test
+
+}  // namespace oneflow
@@ -50,4 +50,20 @@ CollectiveBoxingConf ResourceDesc::collective_boxing_conf() const {
   }
 }
 
+ThreadPlacementConf ResourceDesc::thread_placement_conf() const {
+  if (resource_.has_thread_placement_conf()) {
+    return resource_.thread_placement_conf();
+  } else {
+    return ThreadPlacementConf();
+  }
+}
+
+ActorThreadPollConf ResourceDesc::actor_thread_poll_conf() const {
+  if (resource_.has_actor_thread_poll_conf()) {
+    return resource_.actor_thread_poll_conf();
+  } else {
+    return ActorThreadPollConf();
+  }
+}
+
 }  // namespace oneflow
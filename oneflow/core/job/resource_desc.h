@@ -50,9 +50,12 @@ class ResourceDesc final {
   }
   bool enable_thread_local_cache() const { return resource_.enable_thread_local_cache(); }
   size_t thread_local_cache_max_size() const { return resource_.thread_local_cache_max_size(); }
+  size_t kernel_infer_cache_max_size() const { return resource_.kernel_infer_cache_max_size(); }
   int32_t ComputeThreadPoolSize() const;
   bool enable_debug_mode() const;
   CollectiveBoxingConf collective_boxing_conf() const;
+  ThreadPlacementConf thread_placement_conf() const;
+  ActorThreadPollConf actor_thread_poll_conf() const;
 
   void SetMachineNum(int32_t val) { resource_.set_machine_num(val); }
   void SetCpuDeviceNum(int32_t val) { resource_.set_cpu_device_num(val); }
@@ -23,6 +23,7 @@ limitations under the License.
 #include "oneflow/core/job/global_for.h"
 #include "oneflow/core/job/runtime_job_descs.h"
 #include "oneflow/core/thread/thread_manager.h"
+#include "oneflow/core/thread/thread_placement.h"
 #include "oneflow/core/actor/act_event_logger.h"
 #include "oneflow/core/graph/task_node.h"
 #include "oneflow/core/device/cuda_util.h"
@@ -110,6 +111,7 @@ void Runtime::NewAllGlobal(const Plan& plan, size_t total_piece_num, bool is_exp
       && Global<RuntimeCtx>::Get()->NeedCollectActEvent()) {
     Global<ActEventLogger>::New(is_experiment_phase);
   }
+  Global<ThreadPlacement>::New(Global<ResourceDesc, ForSession>::Get()->thread_placement_conf());
   if (Global<ResourceDesc, ForSession>::Get()->TotalMachineNum() > 1) {
 #ifdef PLATFORM_POSIX
     if (Global<ResourceDesc, ForSession>::Get()->use_rdma()) {
@@ -145,6 +147,7 @@ void Runtime::DeleteAllGlobal() {
   Global<ActEventLogger>::Delete();
   Global<RuntimeCtx>::Delete();
   Global<summary::EventsWriter>::Delete();
+  Global<ThreadPlacement>::Delete();
 }
 
 }  // namespace oneflow
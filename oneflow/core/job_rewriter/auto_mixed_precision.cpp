@@ -129,7 +129,7 @@ void InsertCastOpImpl(bool f2h, const OpGraph& op_graph, const HashSet<OpNode*>&
                       JobBuilder* job_builder) {
   HashSet<OpEdge*> white_set_edges;
   {
-    std::function<const std::unordered_set<OpEdge*>&(OpNode*)> Node2Edges =
+    std::function<const std::vector<OpEdge*>&(OpNode*)> Node2Edges =
         f2h ? &OpNode::in_edges : &OpNode::out_edges;
     std::function<OpNode*(OpEdge*)> OppositeNode = f2h ? &OpEdge::src_node : &OpEdge::dst_node;
     op_graph.ForEachNode([&](OpNode* node) {
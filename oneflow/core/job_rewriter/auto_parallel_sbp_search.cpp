@@ -0,0 +1,461 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "oneflow/core/job_rewriter/op_graph_pass.h"
+#include "oneflow/core/framework/config_def.h"
+#include "oneflow/core/job/sbp_parallel.h"
+
+namespace oneflow {
+
+namespace {
+
+REGISTER_FUNCTION_CONFIG_DEF()
+    .Bool("enable_auto_parallel_sbp_search", false,
+          "choose sbp signatures of user ops by a global compute and boxing cost search")
+    .Double("auto_parallel_device_bandwidth_gbps", 500,
+            "device memory bandwidth used to estimate compute cost")
+    .Double("auto_parallel_intra_node_bandwidth_gbps", 10,
+            "per device bandwidth of boxing inside a machine")
+    .Double("auto_parallel_inter_node_bandwidth_gbps", 5,
+            "per device bandwidth of boxing across machines");
+
+// No sub task graph builder boxes a broadcast or split blob into a partial sum one, and greedy
+// inference rules such signatures out the same way, so B->P and S->P are never picked
+constexpr double kInfeasibleCost = 1e18;
+constexpr int32_t kMaxSearchRoundNum = 16;
+
+struct SbpCostModel {
+  double device_bandwidth;
+  double intra_node_bandwidth;
+  double inter_node_bandwidth;
+};
+
+int64_t BlobBytes(const BlobDesc& blob_desc) {
+  return blob_desc.shape().elem_cnt() * GetSizeOfDataType(blob_desc.data_type());
+}
+
+double DeviceBytes(double bytes, const SbpParallel& sbp_parallel, int64_t parallel_num) {
+  return sbp_parallel.has_split_parallel() ? bytes / parallel_num : bytes;
+}
+
+// total bytes received by all consumer devices, kInfeasibleCost for unsupported boxing
+double BoxingVolume(const SbpParallel& src_sbp, const ParallelDesc& src_pd,
+                    const SbpParallel& dst_sbp, const ParallelDesc& dst_pd, double bytes) {
+  if (src_pd == dst_pd) {
+    const int64_t n = src_pd.parallel_num();
+    if (n == 1 || src_sbp == dst_sbp) { return 0; }
+    if (dst_sbp.has_partial_sum_parallel()) { return kInfeasibleCost; }
+    if (src_sbp.has_broadcast_parallel()) { return 0; }
+    if (src_sbp.has_split_parallel()) {
+      // all2all or all-gather
+      return dst_sbp.has_split_parallel() ? bytes * (n - 1) / n : bytes * (n - 1);
+    }
+    CHECK(src_sbp.has_partial_sum_parallel());
+    // reduce-scatter or all-reduce
+    return dst_sbp.has_split_parallel() ? bytes * (n - 1) : 2 * bytes * (n - 1);
+  }
+  if (dst_sbp.has_partial_sum_parallel()) { return kInfeasibleCost; }
+  double volume = dst_sbp.has_broadcast_parallel() ? bytes * dst_pd.parallel_num() : bytes;
+  if (src_sbp.has_partial_sum_parallel()) { volume += bytes * (src_pd.parallel_num() - 1); }
+  return volume;
+}
+
+bool IsCrossMachine(const ParallelDesc& src_pd, const ParallelDesc& dst_pd) {
+  if (src_pd.sorted_machine_ids().size() > 1 || dst_pd.sorted_machine_ids().size() > 1) {
+    return true;
+  }
+  return src_pd.sorted_machine_ids() != dst_pd.sorted_machine_ids();
+}
+
+struct SearchNode {
+  const OpNode* op_node;
+  bool searchable;
+  std::vector<SbpSignature> candidates;
+  std::vector<double> compute_costs;
+  int32_t greedy;
+  int32_t chosen;
+  std::vector<int64_t> edge_ids;
+  int64_t chain_prev;
+  int64_t chain_next;
+  int64_t chain_next_edge_id;
+};
+
+struct SearchEdge {
+  int64_t src;
+  int64_t dst;
+  double bytes;
+  // [src candidate][dst candidate]
+  std::vector<std::vector<double>> costs;
+  std::vector<std::vector<double>> volumes;
+};
+
+class SbpSignatureSearcher final {
+ public:
+  OF_DISALLOW_COPY_AND_MOVE(SbpSignatureSearcher);
+  SbpSignatureSearcher(const OpGraph& op_graph, const Job& job, const SbpCostModel& cost_model)
+      : cost_model_(cost_model) {
+    CHECK_JUST(InitNodes(op_graph, job));
+    InitEdges(op_graph);
+    InitChains();
+  }
+  ~SbpSignatureSearcher() = default;
+
+  void Search();
+  double TotalCost() const;
+  double TotalBoxingVolume() const;
+  void ForEachSearchableNode(
+      const std::function<void(const OpNode*, const SbpSignature&, bool)>& Handler) const;
+
+ private:
+  Maybe<void> InitNodes(const OpGraph& op_graph, const Job& job);
+  void InitEdges(const OpGraph& op_graph);
+  void InitChains();
+  double EdgeCost(int64_t edge_id) const {
+    const SearchEdge& edge = edges_.at(edge_id);
+    return edge.costs.at(nodes_.at(edge.src).chosen).at(nodes_.at(edge.dst).chosen);
+  }
+  double LocalCost(const std::vector<int64_t>& node_ids) const;
+  bool OptimizeChain(const std::vector<int64_t>& chain);
+  bool OptimizeNode(int64_t node_id);
+
+  SbpCostModel cost_model_;
+  std::vector<SearchNode> nodes_;
+  std::vector<SearchEdge> edges_;
+  std::vector<std::vector<int64_t>> chains_;
+  HashMap<const OpNode*, int64_t> op_node2node_id_;
+};
+
+Maybe<void> SbpSignatureSearcher::InitNodes(const OpGraph& op_graph, const Job& job) {
+  HashSet<std::string> op_names_with_identical_sbp;
+  for (const auto& pair : job.helper().identical_sbp_oba_pairs().pair()) {
+    op_names_with_identical_sbp.insert(pair.first().op_name());
+    op_names_with_identical_sbp.insert(pair.second().op_name());
+  }
+  const auto& op_name2sbp_sig_conf = job.job_parallel_view_conf().op_name2sbp_signature_conf();
+  const auto& op_name2is_mirrored =
+      job.job_parallel_view_conf().op_name2is_mirrored_parallel_view();
+  auto IsMirrored = [&](const OpNode* op_node) -> Maybe<bool> {
+    const auto& iter = op_name2is_mirrored.find(op_node->op().op_name());
+    if (iter != op_name2is_mirrored.end() && iter->second) { return true; }
+    for (const auto& ibn : op_node->op().input_bns()) {
+      if (JUST(op_node->op().OptMirroredParallel4BnInOp(ibn))->has_mirrored_parallel()) {
+        return true;
+      }
+    }
+    for (const auto& obn : op_node->op().output_bns()) {
+      if (JUST(op_node->op().OptMirroredParallel4BnInOp(obn))->has_mirrored_parallel()) {
+        return true;
+      }
+    }
+    return false;
+  };
+  JUST(op_graph.TopoForEachNodeWithErrorCaptured([&](OpNode* op_node) -> Maybe<void> {
+    op_node2node_id_.emplace(op_node, nodes_.size());
+    nodes_.emplace_back();
+    SearchNode* node = &nodes_.back();
+    node->op_node = op_node;
+    node->greedy = 0;
+    node->chosen = 0;
+    node->chain_prev = -1;
+    node->chain_next = -1;
+    node->chain_next_edge_id = -1;
+    const Operator& op = op_node->op();
+    const ParallelDesc& parallel_desc = op_node->parallel_desc();
+    // only user ops are searched, other ops may override their own sbp inference
+    node->searchable = op.op_conf().has_user_conf() && parallel_desc.parallel_num() > 1
+                       && op_names_with_identical_sbp.find(op.op_name())
+                              == op_names_with_identical_sbp.end()
+                       && !JUST(IsMirrored(op_node));
+    if (node->searchable) {
+      auto LogicalBlobDesc4Ibn = [&](const std::string& ibn) -> Maybe<const BlobDesc*> {
+        return &op_node->LogicalBlobDesc4Lbi(op.BnInOp2Lbi(ibn));
+      };
+      SbpSignatureList sbp_sig_list;
+      JUST(op.GetSbpSignaturesIf(LogicalBlobDesc4Ibn, parallel_desc, &sbp_sig_list));
+      SbpSignature sbp_sig_conf;
+      const auto& conf_iter = op_name2sbp_sig_conf.find(op.op_name());
+      if (conf_iter != op_name2sbp_sig_conf.end()) { sbp_sig_conf = conf_iter->second; }
+      SbpSignatureList filtered_sbp_sig_list;
+      FilterSbpSignatureList(sbp_sig_list, sbp_sig_conf, &filtered_sbp_sig_list);
+      node->candidates.assign(filtered_sbp_sig_list.sbp_signature().begin(),
+                              filtered_sbp_sig_list.sbp_signature().end());
+      const auto& greedy_iter = std::find(node->candidates.begin(), node->candidates.end(),
+                                          op_node->sbp_signature());
+      if (greedy_iter == node->candidates.end()) {
+        node->searchable = false;
+      } else {
+        node->greedy = greedy_iter - node->candidates.begin();
+        node->chosen = node->greedy;
+      }
+    }
+    if (!node->searchable) { node->candidates = {op_node->sbp_signature()}; }
+    for (const SbpSignature& sbp_signature : node->candidates) {
+      double device_bytes = 0;
+      for (const auto& pair : sbp_signature.bn_in_op2sbp_parallel()) {
+        const BlobDesc& blob_desc = op_node->LogicalBlobDesc4Lbi(op.BnInOp2Lbi(pair.first));
+        device_bytes +=
+            DeviceBytes(BlobBytes(blob_desc), pair.second, parallel_desc.parallel_num());
+      }
+      node->compute_costs.push_back(device_bytes / cost_model_.device_bandwidth);
+    }
+    return Maybe<void>::Ok();
+  }));
+  return Maybe<void>::Ok();
+}
+
+void SbpSignatureSearcher::InitEdges(const OpGraph& op_graph) {
+  op_graph.ForEachEdge([&](const OpEdge* op_edge) {
+    const int64_t src_id = op_node2node_id_.at(op_edge->src_node());
+    const int64_t dst_id = op_node2node_id_.at(op_edge->dst_node());
+    const SearchNode& src = nodes_.at(src_id);
+    const SearchNode& dst = nodes_.at(dst_id);
+    SearchEdge edge;
+    edge.src = src_id;
+    edge.dst = dst_id;
+    edge.bytes = 0;
+    edge.costs.assign(src.candidates.size(), std::vector<double>(dst.candidates.size(), 0));
+    edge.volumes.assign(src.candidates.size(), std::vector<double>(dst.candidates.size(), 0));
+    const ParallelDesc& dst_pd = dst.op_node->parallel_desc();
+    for (const LogicalBlobId& lbi : op_edge->lbis()) {
+      const std::string& obn = op_edge->lbi2obn().at(lbi);
+      const ParallelDesc& src_pd = src.op_node->BlobParallelDesc4Obn(obn);
+      const double bandwidth = IsCrossMachine(src_pd, dst_pd) ? cost_model_.inter_node_bandwidth
+                                                              : cost_model_.intra_node_bandwidth;
+      const double bytes = BlobBytes(src.op_node->LogicalBlobDesc4Lbi(lbi));
+      edge.bytes += bytes;
+      FOR_RANGE(int64_t, i, 0, src.candidates.size()) {
+        const SbpParallel& src_sbp = src.candidates.at(i).bn_in_op2sbp_parallel().at(obn);
+        FOR_RANGE(int64_t, j, 0, dst.candidates.size()) {
+          for (const std::string& ibn : op_edge->lbi2ibns().at(lbi)) {
+            const SbpParallel& dst_sbp = dst.candidates.at(j).bn_in_op2sbp_parallel().at(ibn);
+            const double volume = BoxingVolume(src_sbp, src_pd, dst_sbp, dst_pd, bytes);
+            edge.volumes[i][j] += volume;
+            edge.costs[i][j] += volume == kInfeasibleCost
+                                    ? kInfeasibleCost
+                                    : volume / dst_pd.parallel_num() / bandwidth;
+          }
+        }
+      }
+    }
+    nodes_.at(src_id).edge_ids.push_back(edges_.size());
+    nodes_.at(dst_id).edge_ids.push_back(edges_.size());
+    edges_.push_back(std::move(edge));
+  });
+}
+
+// Covers the searchable nodes with disjoint paths, linking the heaviest edges first. Every path
+// is then solved exactly by dynamic programming while the rest of the graph is held fixed.
+void SbpSignatureSearcher::InitChains() {
+  std::vector<int64_t> edge_ids;
+  FOR_RANGE(int64_t, edge_id, 0, edges_.size()) {
+    const SearchEdge& edge = edges_.at(edge_id);
+    if (nodes_.at(edge.src).searchable && nodes_.at(edge.dst).searchable) {
+      edge_ids.push_back(edge_id);
+    }
+  }
+  std::stable_sort(edge_ids.begin(), edge_ids.end(), [&](int64_t lhs, int64_t rhs) {
+    return edges_.at(lhs).bytes > edges_.at(rhs).bytes;
+  });
+  for (int64_t edge_id : edge_ids) {
+    SearchNode* src = &nodes_.at(edges_.at(edge_id).src);
+    SearchNode* dst = &nodes_.at(edges_.at(edge_id).dst);
+    if (src->chain_next != -1 || dst->chain_prev != -1) { continue; }
+    src->chain_next = edges_.at(edge_id).dst;
+    src->chain_next_edge_id = edge_id;
+    dst->chain_prev = edges_.at(edge_id).src;
+  }
+  // nodes_ is in topological order, so are the chain heads
+  FOR_RANGE(int64_t, node_id, 0, nodes_.size()) {
+    if (!nodes_.at(node_id).searchable || nodes_.at(node_id).chain_prev != -1) { continue; }
+    std::vector<int64_t> chain;
+    for (int64_t cur = node_id; cur != -1; cur = nodes_.at(cur).chain_next) {
+      chain.push_back(cur);
+    }
+    chains_.push_back(std::move(chain));
+  }
+}
+
+double SbpSignatureSearcher::LocalCost(const std::vector<int64_t>& node_ids) const {
+  double cost = 0;
+  HashSet<int64_t> visited_edge_ids;
+  for (int64_t node_id : node_ids) {
+    const SearchNode& node = nodes_.at(node_id);
+    cost += node.compute_costs.at(node.chosen);
+    for (int64_t edge_id : node.edge_ids) {
+      if (visited_edge_ids.insert(edge_id).second) { cost += EdgeCost(edge_id); }
+    }
+  }
+  return cost;
+}
+
+bool SbpSignatureSearcher::OptimizeChain(const std::vector<int64_t>& chain) {
+  const int64_t len = chain.size();
+  HashMap<int64_t, int64_t> node_id2pos;
+  FOR_RANGE(int64_t, pos, 0, len) { node_id2pos.emplace(chain.at(pos), pos); }
+  // unary[pos][s]: compute cost plus cost of every edge but the chain links, the other endpoint
+  // of such edges keeps its current choice
+  std::vector<std::vector<double>> unary(len);
+  FOR_RANGE(int64_t, pos, 0, len) {
+    const SearchNode& node = nodes_.at(chain.at(pos));
+    unary[pos] = node.compute_costs;
+    for (int64_t edge_id : node.edge_ids) {
+      if (edge_id == node.chain_next_edge_id) { continue; }
+      if (pos > 0 && edge_id == nodes_.at(chain.at(pos - 1)).chain_next_edge_id) { continue; }
+      const SearchEdge& edge = edges_.at(edge_id);
+      const bool is_src = edge.src == chain.at(pos);
+      const int64_t other = is_src ? edge.dst : edge.src;
+      // an edge between two nodes of this chain is counted once, from its source
+      if (!is_src && node_id2pos.find(other) != node_id2pos.end()) { continue; }
+      const int32_t other_chosen = nodes_.at(other).chosen;
+      FOR_RANGE(int64_t, s, 0, unary[pos].size()) {
+        unary[pos][s] += is_src ? edge.costs.at(s).at(other_chosen)
+                                : edge.costs.at(other_chosen).at(s);
+      }
+    }
+  }
+  // viterbi
+  std::vector<std::vector<double>> best(len);
+  std::vector<std::vector<int32_t>> from(len);
+  best[0] = unary[0];
+  FOR_RANGE(int64_t, pos, 1, len) {
+    const SearchEdge& link = edges_.at(nodes_.at(chain.at(pos - 1)).chain_next_edge_id);
+    best[pos].assign(unary[pos].size(), 0);
+    from[pos].assign(unary[pos].size(), 0);
+    FOR_RANGE(int64_t, s, 0, unary[pos].size()) {
+      double min_cost = GetMaxVal<double>();
+      FOR_RANGE(int64_t, p, 0, best[pos - 1].size()) {
+        const double cost = best[pos - 1][p] + link.costs.at(p).at(s);
+        if (cost < min_cost) {
+          min_cost = cost;
+          from[pos][s] = p;
+        }
+      }
+      best[pos][s] = min_cost + unary[pos][s];
+    }
+  }
+  std::vector<int32_t> old_chosen(len);
+  FOR_RANGE(int64_t, pos, 0, len) { old_chosen[pos] = nodes_.at(chain.at(pos)).chosen; }
+  const double old_cost = LocalCost(chain);
+  const std::vector<double>& last = best.at(len - 1);
+  int32_t s = std::min_element(last.begin(), last.end()) - last.begin();
+  for (int64_t pos = len - 1; pos >= 0; --pos) {
+    nodes_.at(chain.at(pos)).chosen = s;
+    if (pos > 0) { s = from[pos][s]; }
+  }
+  // edges inside the chain that skip a link make the dp approximate, keep only strict gains
+  if (LocalCost(chain) < old_cost * (1 - 1e-9)) { return true; }
+  FOR_RANGE(int64_t, pos, 0, len) { nodes_.at(chain.at(pos)).chosen = old_chosen[pos]; }
+  bool improved = false;
+  for (int64_t node_id : chain) { improved |= OptimizeNode(node_id); }
+  return improved;
+}
+
+bool SbpSignatureSearcher::OptimizeNode(int64_t node_id) {
+  SearchNode* node = &nodes_.at(node_id);
+  const int32_t old_chosen = node->chosen;
+  const double old_cost = LocalCost({node_id});
+  int32_t best_chosen = old_chosen;
+  double best_cost = old_cost;
+  FOR_RANGE(int32_t, s, 0, node->candidates.size()) {
+    node->chosen = s;
+    const double cost = LocalCost({node_id});
+    if (cost < best_cost * (1 - 1e-9)) {
+      best_cost = cost;
+      best_chosen = s;
+    }
+  }
+  node->chosen = best_chosen;
+  return best_chosen != old_chosen;
+}
+
+void SbpSignatureSearcher::Search() {
+  FOR_RANGE(int32_t, round, 0, kMaxSearchRoundNum) {
+    bool improved = false;
+    for (const auto& chain : chains_) { improved |= OptimizeChain(chain); }
+    if (!improved) { break; }
+  }
+}
+
+double SbpSignatureSearcher::TotalCost() const {
+  double cost = 0;
+  for (const SearchNode& node : nodes_) { cost += node.compute_costs.at(node.chosen); }
+  FOR_RANGE(int64_t, edge_id, 0, edges_.size()) { cost += EdgeCost(edge_id); }
+  return cost;
+}
+
+double SbpSignatureSearcher::TotalBoxingVolume() const {
+  double volume = 0;
+  for (const SearchEdge& edge : edges_) {
+    volume += edge.volumes.at(nodes_.at(edge.src).chosen).at(nodes_.at(edge.dst).chosen);
+  }
+  return volume;
+}
+
+void SbpSignatureSearcher::ForEachSearchableNode(
+    const std::function<void(const OpNode*, const SbpSignature&, bool)>& Handler) const {
+  for (const SearchNode& node : nodes_) {
+    if (!node.searchable) { continue; }
+    Handler(node.op_node, node.candidates.at(node.chosen), node.chosen != node.greedy);
+  }
+}
+
+class AutoParallelSbpSearch final : public OpGraphPass {
+ public:
+  OF_DISALLOW_COPY_AND_MOVE(AutoParallelSbpSearch);
+  AutoParallelSbpSearch() = default;
+  ~AutoParallelSbpSearch() override = default;
+  bool IsEnabled() const override {
+    return GlobalJobDesc().Bool("enable_auto_parallel_sbp_search");
+  }
+  Maybe<void> Apply(const OpGraph& op_graph, Job* job) const override;
+};
+
+Maybe<void> AutoParallelSbpSearch::Apply(const OpGraph& op_graph, Job* job) const {
+  SbpCostModel cost_model;
+  cost_model.device_bandwidth =
+      GlobalJobDesc().Double("auto_parallel_device_bandwidth_gbps") * 1e9;
+  cost_model.intra_node_bandwidth =
+      GlobalJobDesc().Double("auto_parallel_intra_node_bandwidth_gbps") * 1e9;
+  cost_model.inter_node_bandwidth =
+      GlobalJobDesc().Double("auto_parallel_inter_node_bandwidth_gbps") * 1e9;
+  CHECK_GT_OR_RETURN(cost_model.device_bandwidth, 0);
+  CHECK_GT_OR_RETURN(cost_model.intra_node_bandwidth, 0);
+  CHECK_GT_OR_RETURN(cost_model.inter_node_bandwidth, 0);
+  SbpSignatureSearcher searcher(op_graph, *job, cost_model);
+  const double greedy_cost = searcher.TotalCost();
+  const double greedy_volume = searcher.TotalBoxingVolume();
+  searcher.Search();
+  // pin every searched op, otherwise the greedy inference of unchanged ops may react to the new
+  // sbp of their producers
+  auto* op_name2sbp_sig_conf =
+      job->mutable_job_parallel_view_conf()->mutable_op_name2sbp_signature_conf();
+  int64_t changed_cnt = 0;
+  searcher.ForEachSearchableNode(
+      [&](const OpNode* op_node, const SbpSignature& sbp_signature, bool is_changed) {
+        (*op_name2sbp_sig_conf)[op_node->op().op_name()] = sbp_signature;
+        changed_cnt += is_changed;
+      });
+  LOG(INFO) << "AutoParallelSbpSearch of job " << job->job_conf().job_name() << ": " << changed_cnt
+            << " op(s) changed, predicted boxing volume " << searcher.TotalBoxingVolume() / 1e6
+            << " MB (greedy " << greedy_volume / 1e6 << " MB), predicted cost "
+            << searcher.TotalCost() * 1e3 << " ms (greedy " << greedy_cost * 1e3 << " ms)";
+  return Maybe<void>::Ok();
+}
+
+}  // namespace
+
+REGISTER_FUNCTION_PASS("AutoParallelSbpSearch", AutoParallelSbpSearch);
+
+}  // namespace oneflow
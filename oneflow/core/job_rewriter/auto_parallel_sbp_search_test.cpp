@@ -0,0 +1,124 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "oneflow/core/job_rewriter/op_graph_pass.h"
+#include "oneflow/core/framework/user_op_conf.h"
+#include "oneflow/core/job/env_desc.h"
+#include "oneflow/core/job/resource_desc.h"
+#include "oneflow/core/job/global_for.h"
+
+namespace oneflow {
+
+namespace test {
+
+namespace {
+
+class AutoParallelTestEnv final {
+ public:
+  OF_DISALLOW_COPY_AND_MOVE(AutoParallelTestEnv);
+  AutoParallelTestEnv() {
+    EnvProto env_proto;
+    auto* machine = env_proto.add_machine();
+    machine->set_id(0);
+    machine->set_addr("127.0.0.1");
+    env_proto.set_ctrl_port(9527);
+    Global<EnvDesc>::New(env_proto);
+    Resource resource;
+    resource.set_machine_num(1);
+    resource.set_cpu_device_num(2);
+    Global<ResourceDesc, ForSession>::New(resource);
+    JobConfigProto job_conf;
+    job_conf.set_job_name("auto_parallel_sbp_search_test");
+    job_conf.mutable_predict_conf();
+    job_conf.mutable_default_initializer_conf()->mutable_constant_conf()->set_value(0);
+    (*job_conf.mutable_flag_name2flag_value())["enable_auto_parallel_sbp_search"].set_at_bool(true);
+    Global<JobDesc>::New(job_conf, 0);
+  }
+  ~AutoParallelTestEnv() {
+    Global<JobDesc>::Delete();
+    Global<ResourceDesc, ForSession>::Delete();
+    Global<EnvDesc>::Delete();
+  }
+};
+
+SbpSignature MakeSplitSignature(const std::vector<std::string>& bns, int64_t axis) {
+  SbpSignature sbp_signature;
+  for (const auto& bn : bns) {
+    (*sbp_signature.mutable_bn_in_op2sbp_parallel())[bn].mutable_split_parallel()->set_axis(axis);
+  }
+  return sbp_signature;
+}
+
+// var (split 0, float) -> cast (to double) -> relu (pinned to split 1). Greedy inference keeps
+// cast on split 0 as its input is, and boxes the double blob into relu. Boxing the float input of
+// cast instead moves half the bytes, so cast on split 1 is the unique optimum.
+Job MakeJob() {
+  Job job;
+  *job.mutable_job_conf() = GlobalJobDesc().job_conf();
+  auto* placement_group = job.mutable_placement()->add_placement_group();
+  placement_group->mutable_parallel_conf()->set_device_tag("cpu");
+  placement_group->mutable_parallel_conf()->add_device_name("0:0-1");
+  {
+    OperatorConf* op_conf = job.mutable_net()->add_op();
+    op_conf->set_name("var");
+    VariableOpConf* conf = op_conf->mutable_variable_conf();
+    conf->set_out("out");
+    conf->mutable_shape()->add_dim(64);
+    conf->mutable_shape()->add_dim(64);
+    conf->set_data_type(DataType::kFloat);
+    conf->mutable_split_axis()->set_value(0);
+  }
+  *job.mutable_net()->add_op() = user_op::UserOpConfWrapperBuilder("cast")
+                                     .Op("cast")
+                                     .Input("in", "var/out")
+                                     .Output("out")
+                                     .Attr<DataType>("dtype", DataType::kDouble)
+                                     .Build()
+                                     .op_conf();
+  *job.mutable_net()->add_op() = user_op::UserOpConfWrapperBuilder("relu")
+                                     .Op("relu")
+                                     .Input("in", "cast/out_0")
+                                     .Output("out")
+                                     .Build()
+                                     .op_conf();
+  for (const auto& op_conf : job.net().op()) {
+    placement_group->mutable_op_set()->add_op_name(op_conf.name());
+  }
+  (*job.mutable_job_parallel_view_conf()->mutable_op_name2sbp_signature_conf())["relu"] =
+      MakeSplitSignature({"in_0", "out_0"}, 1);
+  return job;
+}
+
+}  // namespace
+
+TEST(AutoParallelSbpSearch, boxes_the_smaller_blob) {
+  AutoParallelTestEnv env;
+  Job job = MakeJob();
+  const SbpSignature greedy_sbp_signature =
+      CHECK_JUST(OpGraph::New(job))->OpNode4OpName("cast")->sbp_signature();
+  ASSERT_TRUE(greedy_sbp_signature == MakeSplitSignature({"in_0", "out_0"}, 0));
+  CHECK_JUST(FunctionPass("AutoParallelSbpSearch")(&job));
+  const auto& op_name2sbp_sig_conf = job.job_parallel_view_conf().op_name2sbp_signature_conf();
+  ASSERT_TRUE(op_name2sbp_sig_conf.at("cast") == MakeSplitSignature({"in_0", "out_0"}, 1));
+  ASSERT_TRUE(op_name2sbp_sig_conf.at("relu") == MakeSplitSignature({"in_0", "out_0"}, 1));
+  // the pinned signatures are what the next inference picks
+  const auto& op_graph = CHECK_JUST(OpGraph::New(job));
+  ASSERT_TRUE(op_graph->OpNode4OpName("cast")->sbp_signature()
+              == MakeSplitSignature({"in_0", "out_0"}, 1));
+}
+
+}  // namespace test
+
+}  // namespace oneflow
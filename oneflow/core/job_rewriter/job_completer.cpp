@@ -39,15 +39,15 @@ void CheckOpGraph(const OpGraph& op_graph) {
 }
 
 void WithOpGraphAndMutJob(Job* job, const std::function<void(const OpGraph&, Job*)>& Handler) {
-  OpGraph op_graph(*job);
-  Handler(op_graph, job);
+  const auto& op_graph = CHECK_JUST(OpGraph4Job(*job));
+  Handler(*op_graph, job);
 }
 
 void WithOpGraphAndMutJobBuilder(Job* job,
                                  const std::function<void(const OpGraph&, JobBuilder*)>& Handler) {
-  OpGraph op_graph(*job);
+  const auto& op_graph = CHECK_JUST(OpGraph4Job(*job));
   JobBuilder job_builder(job);
-  Handler(op_graph, &job_builder);
+  Handler(*op_graph, &job_builder);
 }
 
 void SetCtrlInOpName4VariableOp(const OpGraph& op_graph, JobBuilder* job_builder) {
@@ -91,6 +91,7 @@ void SetCtrlInOpName4VariableOp(const OpGraph& op_graph, JobBuilder* job_builder
 }  // namespace
 
 void JobCompleter::Complete(Job* job) const {
+  IncrementalOpGraphScope op_graph_scope;
   FunctionPass("DumpTimeShapeAndBlobParallelConfPass")(job);
   WithOpGraphAndMutJobBuilder(job, &GroupBoxingByDstParallel);
   if (GlobalJobDesc().enable_keep_header_only()) {
@@ -113,7 +114,7 @@ void JobCompleter::Complete(Job* job) const {
                     "WITH_TENSORRT was not enabled when compiling the project.";
 #endif  // OF_WITH_XRT
   }
-  CheckOpGraph(OpGraph(*job));
+  CheckOpGraph(*CHECK_JUST(OpGraph4Job(*job)));
 }
 
 }  // namespace oneflow
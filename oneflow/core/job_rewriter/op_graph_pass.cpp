@@ -24,8 +24,38 @@ HashMap<std::string, const OpGraphPass*>* PassName2FunctionPass() {
   return &pass_name2job_pass;
 }
 
+struct IncrementalOpGraphCtx {
+  std::shared_ptr<OpGraph> latest_op_graph;
+  int64_t infer_dirty_op_node_num;
+  int64_t op_node_num;
+};
+
+std::vector<IncrementalOpGraphCtx>* IncrementalOpGraphCtxStack() {
+  thread_local std::vector<IncrementalOpGraphCtx> ctx_stack;
+  return &ctx_stack;
+}
+
 }  // namespace
 
+IncrementalOpGraphScope::IncrementalOpGraphScope() {
+  IncrementalOpGraphCtxStack()->push_back(IncrementalOpGraphCtx{nullptr, 0, 0});
+}
+
+IncrementalOpGraphScope::~IncrementalOpGraphScope() { IncrementalOpGraphCtxStack()->pop_back(); }
+
+Maybe<OpGraph> OpGraph4Job(const Job& job) {
+  auto* ctx_stack = IncrementalOpGraphCtxStack();
+  if (ctx_stack->empty()) { return OpGraph::New(job); }
+  IncrementalOpGraphCtx* ctx = &ctx_stack->back();
+  std::shared_ptr<OpGraph> prev_op_graph = std::move(ctx->latest_op_graph);
+  // a pass applied by another pass must not take over the graph its caller is still reading
+  if (prev_op_graph.use_count() > 1) { prev_op_graph.reset(); }
+  ctx->latest_op_graph = JUST(OpGraph::New(job, prev_op_graph.get()));
+  ctx->infer_dirty_op_node_num += ctx->latest_op_graph->infer_dirty_op_node_num();
+  ctx->op_node_num += ctx->latest_op_graph->node_num();
+  return ctx->latest_op_graph;
+}
+
 void RegisterFunctionPass(const std::string& pass_name, const OpGraphPass* pass) {
   CHECK(PassName2FunctionPass()->emplace(pass_name, pass).second);
 }
@@ -40,4 +70,23 @@ const OpGraphPass& FunctionPass(const std::string& pass_name) {
   return *iter->second;
 }
 
+Maybe<void> ApplyFunctionPass(const std::string& pass_name, Job* job) {
+  auto* ctx_stack = IncrementalOpGraphCtxStack();
+  if (!ctx_stack->empty()) {
+    ctx_stack->back().infer_dirty_op_node_num = 0;
+    ctx_stack->back().op_node_num = 0;
+  }
+  const double start = GetCurTime();
+  JUST(FunctionPass(pass_name)(job));
+  const double cost_ms = (GetCurTime() - start) / 1e6;
+  if (ctx_stack->empty() || ctx_stack->back().op_node_num == 0) {
+    VLOG(1) << "function pass " << pass_name << " costs " << cost_ms << " ms";
+  } else {
+    VLOG(1) << "function pass " << pass_name << " costs " << cost_ms << " ms, inferred "
+            << ctx_stack->back().infer_dirty_op_node_num << " of " << ctx_stack->back().op_node_num
+            << " op nodes";
+  }
+  return Maybe<void>::Ok();
+}
+
 }  // namespace oneflow
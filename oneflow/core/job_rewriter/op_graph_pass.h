@@ -22,6 +22,17 @@ limitations under the License.
 
 namespace oneflow {
 
+// Within the lifetime of an IncrementalOpGraphScope, OpGraph4Job builds each OpGraph from the
+// previous one, so ops not changed since, nor fed by changed ones, are not inferred again.
+class IncrementalOpGraphScope final {
+ public:
+  OF_DISALLOW_COPY_AND_MOVE(IncrementalOpGraphScope);
+  IncrementalOpGraphScope();
+  ~IncrementalOpGraphScope();
+};
+
+Maybe<OpGraph> OpGraph4Job(const Job& job);
+
 class OpGraphPass {
  public:
   OpGraphPass() = default;
@@ -33,9 +44,8 @@ class OpGraphPass {
   }
   virtual bool IsEnabled() const { return true; }
   virtual Maybe<void> Apply(Job* job) const {
-    OpGraph op_graph;
-    JUST(op_graph.Init(*job));
-    return Apply(op_graph, job);
+    const auto& op_graph = JUST(OpGraph4Job(*job));
+    return Apply(*op_graph, job);
   }
   virtual Maybe<void> Apply(const OpGraph& op_graph, Job* job) const {
     JobBuilder job_builder(job);
@@ -53,6 +63,8 @@ class OpGraphPass {
 void RegisterFunctionPass(const std::string& pass_name, const OpGraphPass* pass);
 bool HasFunctionPass(const std::string& pass_name);
 const OpGraphPass& FunctionPass(const std::string& pass_name);
+// Applies the function pass and logs its time cost and how many ops it inferred
+Maybe<void> ApplyFunctionPass(const std::string& pass_name, Job* job);
 
 }  // namespace oneflow
 
@@ -14,11 +14,17 @@ See the License for the specific language governing permissions and
 limitations under the License.
 */
 #include "oneflow/core/kernel/gather_kernel_util.h"
+#include "oneflow/core/common/cpu_isa.h"
+#include "oneflow/core/thread/thread_manager.h"
 
 namespace oneflow {
 
 namespace {
 
+constexpr size_t kCacheLineSize = 64;
+constexpr int64_t kGatherPrefetchDistance = 4;
+constexpr size_t kGatherMaxPrefetchBytesPerRow = 16 * kCacheLineSize;
+
 Shape GetFlatShape(const ShapeView& shape, int64_t axis) {
   CHECK_GT(shape.NumAxes(), 0);
   CHECK_GE(axis, 0);
@@ -76,19 +82,49 @@ void GatherKernelUtilImpl<DeviceType::kCPU, T, K>::Forward(DeviceCtx* ctx, const
   const int64_t outer_dim_size = flat_in_shape.At(0);
   const int64_t gather_dim_size = flat_in_shape.At(1);
   const int64_t inner_dim_size = flat_in_shape.At(2);
-  FOR_RANGE(int64_t, outer_idx, 0, outer_dim_size) {
-    FOR_RANGE(int64_t, i, 0, num_indices) {
-      CHECK_GE(indices[i], 0);
-      const int64_t idx = indices[i] - offset;
-      T* to = out + outer_idx * num_indices * inner_dim_size + i * inner_dim_size;
-      if (idx >= 0 && idx < gather_dim_size) {
-        const T* from = in + outer_idx * gather_dim_size * inner_dim_size + idx * inner_dim_size;
-        std::copy(from, from + inner_dim_size, to);
+  const int64_t row_num = outer_dim_size * num_indices;
+  const size_t row_bytes = inner_dim_size * sizeof(T);
+  if (row_num == 0 || inner_dim_size == 0) { return; }
+  auto SrcRow = [&](int64_t row) -> const T* {
+    const int64_t outer_idx = row / num_indices;
+    const K index = indices[row % num_indices];
+    CHECK_GE(index, 0);
+    const int64_t idx = index - offset;
+    if (idx < 0 || idx >= gather_dim_size) { return nullptr; }
+    return in + (outer_idx * gather_dim_size + idx) * inner_dim_size;
+  };
+  // Rows are looked up in random order, so the hardware prefetcher cannot follow them; the rows
+  // kGatherPrefetchDistance ahead are requested explicitly while the current one is copied.
+  const size_t prefetch_bytes = std::min(row_bytes, kGatherMaxPrefetchBytesPerRow);
+  // a gathered row is read once and written once
+  const int64_t grain_size = MultiThreadLoopGrainSize(2 * row_bytes);
+  MultiThreadLoop(row_num, grain_size, [&](int64_t begin, int64_t end) {
+    // the source of every row is looked up once, when it is prefetched, and kept until its copy
+    const T* src_rows[kGatherPrefetchDistance];
+    FOR_RANGE(int64_t, row, begin, std::min(end, begin + kGatherPrefetchDistance)) {
+      src_rows[row % kGatherPrefetchDistance] = SrcRow(row);
+    }
+    FOR_RANGE(int64_t, row, begin, end) {
+      const T*& src_row = src_rows[row % kGatherPrefetchDistance];
+      const T* from = src_row;
+      const int64_t prefetch_row = row + kGatherPrefetchDistance;
+      if (prefetch_row < end) {
+        src_row = SrcRow(prefetch_row);
+        if (src_row != nullptr) {
+          const char* prefetch_ptr = reinterpret_cast<const char*>(src_row);
+          for (size_t i = 0; i < prefetch_bytes; i += kCacheLineSize) {
+            OF_PREFETCH(prefetch_ptr + i);
+          }
+        }
+      }
+      T* to = out + row * inner_dim_size;
+      if (from != nullptr) {
+        std::memcpy(to, from, row_bytes);
       } else {
-        std::memset(to, 0, inner_dim_size * sizeof(K));
+        std::memset(to, 0, row_bytes);
       }
     }
-  }
+  });
 }
 
 #define INITIATE_GATHER_KERNEL_UTIL_CPU_IMPL(in_type_pair, index_type_pair)              \
@@ -0,0 +1,95 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "oneflow/core/kernel/gather_kernel_util.h"
+#include "oneflow/core/thread/thread_pool.h"
+#include <gtest/gtest.h>
+
+namespace oneflow {
+
+namespace test {
+
+namespace {
+
+template<typename T, typename K>
+void NaiveGather(const std::vector<K>& indices, const std::vector<T>& in,
+                 const Shape& flat_in_shape, int64_t offset, std::vector<T>* out) {
+  const int64_t gather_dim_size = flat_in_shape.At(1);
+  const int64_t inner_dim_size = flat_in_shape.At(2);
+  const int64_t num_indices = indices.size();
+  out->assign(flat_in_shape.At(0) * num_indices * inner_dim_size, static_cast<T>(0));
+  FOR_RANGE(int64_t, outer_idx, 0, flat_in_shape.At(0)) {
+    FOR_RANGE(int64_t, i, 0, num_indices) {
+      const int64_t idx = indices[i] - offset;
+      if (idx < 0 || idx >= gather_dim_size) { continue; }
+      FOR_RANGE(int64_t, j, 0, inner_dim_size) {
+        out->at((outer_idx * num_indices + i) * inner_dim_size + j) =
+            in.at((outer_idx * gather_dim_size + idx) * inner_dim_size + j);
+      }
+    }
+  }
+}
+
+// Indices cover [0, 2 * gather_dim_size) in a scrambled order, so with an offset of
+// gather_dim_size / 2 about half of them fall outside this shard and their rows must be zeros.
+template<typename T, typename K>
+void TestGather(int64_t outer_dim_size, int64_t gather_dim_size, int64_t inner_dim_size,
+                int64_t num_indices) {
+  const Shape flat_in_shape({outer_dim_size, gather_dim_size, inner_dim_size});
+  std::vector<T> in(flat_in_shape.elem_cnt());
+  FOR_RANGE(int64_t, i, 0, in.size()) { in[i] = static_cast<T>(i % 101 + 1); }
+  std::vector<K> indices(num_indices);
+  FOR_RANGE(int64_t, i, 0, num_indices) {
+    indices[i] = static_cast<K>((i * 7919) % (2 * gather_dim_size));
+  }
+  for (const int64_t offset : {int64_t(0), gather_dim_size / 2}) {
+    std::vector<T> expected;
+    NaiveGather(indices, in, flat_in_shape, offset, &expected);
+    // garbage that every row, including the out-of-range ones, has to overwrite
+    std::vector<T> out(expected.size(), static_cast<T>(-1));
+    GatherKernelUtilImpl<DeviceType::kCPU, T, K>::Forward(nullptr, indices.data(), num_indices,
+                                                          in.data(), flat_in_shape, out.data(),
+                                                          offset);
+    ASSERT_TRUE(out == expected) << "offset " << offset;
+  }
+}
+
+template<typename T, typename K>
+void TestGatherShapes() {
+  TestGather<T, K>(1, 10, 1, 3);
+  TestGather<T, K>(3, 17, 5, 9);
+  TestGather<T, K>(2, 50, 300, 777);
+  TestGather<T, K>(1, 8, 16, 0);
+}
+
+}  // namespace
+
+TEST(GatherKernelUtil, cpu) {
+  // an 8-byte T with a 4-byte K catches rows that are cleared with the size of the index type
+  TestGatherShapes<double, int32_t>();
+  TestGatherShapes<float, int64_t>();
+  TestGatherShapes<int8_t, int32_t>();
+}
+
+TEST(GatherKernelUtil, cpu_multi_thread) {
+  Global<ThreadPool>::New(4);
+  TestGatherShapes<double, int32_t>();
+  TestGatherShapes<float, int64_t>();
+  Global<ThreadPool>::Delete();
+}
+
+}  // namespace test
+
+}  // namespace oneflow
@@ -32,10 +32,12 @@ RuntimeBlobShapeInferHelper::RuntimeBlobShapeInferHelper(const OperatorConf& op_
   });
   parallel_ctx_.set_parallel_id(0);
   parallel_ctx_.set_parallel_num(1);
-  op_infer_cache_key_.job_desc = job_desc;
+  op_infer_cache_key_.job_conf_sym = SymbolOf(job_desc->job_conf());
   op_infer_cache_key_.op_conf_sym = op_->GetOpConfWithoutOpNameAndLbn();
   op_infer_cache_key_.ibn_idx2shape_sym.resize(op_->input_bns().size());
   op_infer_cache_key_.dtype_signature_sym = SymbolOf(kernel_conf.dtype_signature());
+  op_infer_cache_key_.parallel_id = parallel_ctx_.parallel_id();
+  op_infer_cache_key_.parallel_num = parallel_ctx_.parallel_num();
 }
 
 void RuntimeBlobShapeInferHelper::UpdateInputBlobDescs7OpInferCacheKey(
@@ -14,9 +14,18 @@ See the License for the specific language governing permissions and
 limitations under the License.
 */
 #include "oneflow/core/kernel/unsorted_segment_sum_kernel_util.h"
+#include "oneflow/core/kernel/util/host_simd_util.h"
+#include "oneflow/core/common/balanced_splitter.h"
+#include "oneflow/core/thread/thread_manager.h"
 
 namespace oneflow {
 
+namespace {
+
+constexpr int64_t kSegmentSumParallelMinBytes = 256 * 1024;
+
+}  // namespace
+
 template<typename T, typename K>
 struct UnsortedSegmentSumKernelUtil<DeviceType::kCPU, T, K> final {
   static void UnsortedSegmentSum(DeviceCtx* ctx, const K* segment_ids, const T* data,
@@ -30,18 +39,60 @@ void UnsortedSegmentSumKernelUtil<DeviceType::kCPU, T, K>::UnsortedSegmentSum(
     DeviceCtx* ctx, const K* segment_ids, const T* data, int64_t num_segment_ids,
     int64_t num_segments, int64_t outer_dim_size, int64_t inner_dim_size, int64_t segment_id_offset,
     T* out) {
-  FOR_RANGE(int64_t, outer_idx, 0, outer_dim_size) {
-    FOR_RANGE(int64_t, i, 0, num_segment_ids) {
-      CHECK_GE(segment_ids[i], 0);
-      const int64_t idx = segment_ids[i] - segment_id_offset;
-      T* to = out + outer_idx * num_segments * inner_dim_size + idx * inner_dim_size;
-      if (idx >= 0 && idx < num_segments) {
-        const T* from = data + outer_idx * num_segment_ids * inner_dim_size + i * inner_dim_size;
-        std::transform(from, from + inner_dim_size, to, to, std::plus<T>());
+  // (segment, position) of every id that falls into this shard of the output
+  std::vector<std::pair<int64_t, int64_t>> segment_and_pos;
+  segment_and_pos.reserve(num_segment_ids);
+  FOR_RANGE(int64_t, i, 0, num_segment_ids) {
+    CHECK_GE(segment_ids[i], 0);
+    const int64_t idx = segment_ids[i] - segment_id_offset;
+    if (idx >= 0 && idx < num_segments) { segment_and_pos.emplace_back(idx, i); }
+  }
+  const int64_t num_valid = segment_and_pos.size();
+  const int64_t total_bytes = num_valid * outer_dim_size * inner_dim_size * sizeof(T);
+  const int64_t part_num =
+      Global<ThreadPool>::Get() == nullptr || total_bytes < kSegmentSumParallelMinBytes
+          ? 1
+          : std::min<int64_t>(num_valid, Global<ThreadPool>::Get()->thread_num());
+  if (part_num <= 1) {
+    FOR_RANGE(int64_t, outer_idx, 0, outer_dim_size) {
+      for (const auto& pair : segment_and_pos) {
+        T* to = out + (outer_idx * num_segments + pair.first) * inner_dim_size;
+        const T* from = data + (outer_idx * num_segment_ids + pair.second) * inner_dim_size;
+        HostSimdAdd<T>(inner_dim_size, from, to);
       }
     }
+    return;
   }
+  // Sorting by segment groups all rows that accumulate into the same output row. Every part gets
+  // whole groups only, so parts never write the same row and no atomics or partial buffers are
+  // needed. Positions stay ascending inside a group, which keeps the summation order, and so the
+  // result, identical to the serial loop.
+  std::sort(segment_and_pos.begin(), segment_and_pos.end());
+  const BalancedSplitter bs(num_valid, part_num);
+  std::vector<int64_t> part_begin(part_num + 1, num_valid);
+  part_begin[0] = 0;
+  FOR_RANGE(int64_t, part_id, 1, part_num) {
+    int64_t begin = std::max(bs.At(part_id).begin(), part_begin[part_id - 1]);
+    while (begin > 0 && begin < num_valid
+           && segment_and_pos[begin].first == segment_and_pos[begin - 1].first) {
+      ++begin;
+    }
+    part_begin[part_id] = begin;
+  }
+  MultiThreadLoop(part_num, 1, [&](int64_t part_id_begin, int64_t part_id_end) {
+    FOR_RANGE(int64_t, part_id, part_id_begin, part_id_end) {
+      FOR_RANGE(int64_t, outer_idx, 0, outer_dim_size) {
+        FOR_RANGE(int64_t, i, part_begin[part_id], part_begin[part_id + 1]) {
+          const std::pair<int64_t, int64_t>& pair = segment_and_pos[i];
+          T* to = out + (outer_idx * num_segments + pair.first) * inner_dim_size;
+          const T* from = data + (outer_idx * num_segment_ids + pair.second) * inner_dim_size;
+          HostSimdAdd<T>(inner_dim_size, from, to);
+        }
+      }
+    }
+  });
 }
+
 #define INITIATE_UNSORTED_SEGMENT_SUM_KERNEL_UTIL_CPU(in_type_pair, index_type_pair)             \
   template struct UnsortedSegmentSumKernelUtil<DeviceType::kCPU, OF_PP_PAIR_FIRST(in_type_pair), \
                                                OF_PP_PAIR_FIRST(index_type_pair)>;
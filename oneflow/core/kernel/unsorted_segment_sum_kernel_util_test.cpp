@@ -0,0 +1,95 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "oneflow/core/kernel/unsorted_segment_sum_kernel_util.h"
+#include "oneflow/core/thread/thread_pool.h"
+#include <gtest/gtest.h>
+
+namespace oneflow {
+
+namespace test {
+
+namespace {
+
+template<typename T, typename K>
+void NaiveUnsortedSegmentSum(const std::vector<K>& segment_ids, const std::vector<T>& data,
+                             int64_t num_segments, int64_t outer_dim_size, int64_t inner_dim_size,
+                             int64_t segment_id_offset, std::vector<T>* out) {
+  const int64_t num_segment_ids = segment_ids.size();
+  out->assign(outer_dim_size * num_segments * inner_dim_size, static_cast<T>(0));
+  FOR_RANGE(int64_t, outer_idx, 0, outer_dim_size) {
+    FOR_RANGE(int64_t, i, 0, num_segment_ids) {
+      const int64_t idx = segment_ids[i] - segment_id_offset;
+      if (idx < 0 || idx >= num_segments) { continue; }
+      FOR_RANGE(int64_t, j, 0, inner_dim_size) {
+        out->at((outer_idx * num_segments + idx) * inner_dim_size + j) +=
+            data.at((outer_idx * num_segment_ids + i) * inner_dim_size + j);
+      }
+    }
+  }
+}
+
+// Ids are drawn from [0, 2 * num_segments) but only from every third segment, so with an
+// offset part of them belong to another shard and most segments of this shard stay empty.
+template<typename T, typename K>
+void TestUnsortedSegmentSum(int64_t num_segment_ids, int64_t num_segments, int64_t outer_dim_size,
+                            int64_t inner_dim_size) {
+  std::vector<K> segment_ids(num_segment_ids);
+  FOR_RANGE(int64_t, i, 0, num_segment_ids) {
+    segment_ids[i] = static_cast<K>((i * 7919) % (2 * num_segments) / 3 * 3);
+  }
+  std::vector<T> data(outer_dim_size * num_segment_ids * inner_dim_size);
+  FOR_RANGE(int64_t, i, 0, data.size()) { data[i] = static_cast<T>(i % 13) / 4; }
+  for (const int64_t offset : {int64_t(0), num_segments / 2}) {
+    std::vector<T> expected;
+    NaiveUnsortedSegmentSum(segment_ids, data, num_segments, outer_dim_size, inner_dim_size,
+                            offset, &expected);
+    std::vector<T> out(expected.size(), static_cast<T>(0));
+    UnsortedSegmentSumKernelUtil<DeviceType::kCPU, T, K>::UnsortedSegmentSum(
+        nullptr, segment_ids.data(), data.data(), num_segment_ids, num_segments, outer_dim_size,
+        inner_dim_size, offset, out.data());
+    // the kernel keeps the summation order of every output row, so even floats match exactly
+    ASSERT_TRUE(out == expected) << "offset " << offset;
+  }
+}
+
+template<typename T, typename K>
+void TestUnsortedSegmentSumShapes() {
+  TestUnsortedSegmentSum<T, K>(1, 1, 1, 1);
+  TestUnsortedSegmentSum<T, K>(10, 7, 2, 3);
+  TestUnsortedSegmentSum<T, K>(0, 5, 2, 3);
+  // large enough to be split into parts when a thread pool exists
+  TestUnsortedSegmentSum<T, K>(2000, 300, 2, 67);
+}
+
+}  // namespace
+
+TEST(UnsortedSegmentSumKernelUtil, cpu) {
+  TestUnsortedSegmentSumShapes<float, int32_t>();
+  TestUnsortedSegmentSumShapes<double, int64_t>();
+  TestUnsortedSegmentSumShapes<int32_t, int32_t>();
+}
+
+TEST(UnsortedSegmentSumKernelUtil, cpu_multi_thread) {
+  Global<ThreadPool>::New(4);
+  TestUnsortedSegmentSumShapes<float, int32_t>();
+  TestUnsortedSegmentSumShapes<double, int64_t>();
+  TestUnsortedSegmentSumShapes<int32_t, int32_t>();
+  Global<ThreadPool>::Delete();
+}
+
+}  // namespace test
+
+}  // namespace oneflow
@@ -14,6 +14,7 @@ See the License for the specific language governing permissions and
 limitations under the License.
 */
 #include "oneflow/core/kernel/util/host_dnn_interface.h"
+#include "oneflow/core/kernel/util/host_vec_math.h"
 
 namespace oneflow {
 
@@ -34,8 +35,7 @@ static void ReluBackwardImpl(DeviceCtx* ctx, const int64_t n, const T* x, const
 
 template<typename T>
 static void SigmoidImpl(DeviceCtx* ctx, int64_t n, const T* x, T* y) {
-  T half = static_cast<T>(0.5);
-  for (int64_t i = 0; i != n; ++i) { y[i] = half * std::tanh(half * x[i]) + half; }
+  HostVecSigmoid<T>(n, x, y);
 }
 
 template<typename T>
@@ -46,7 +46,7 @@ static void SigmoidBackwardImpl(DeviceCtx* ctx, const int64_t n, const T* x, con
 
 template<typename T>
 static void TanHImpl(DeviceCtx* ctx, int64_t n, const T* x, T* y) {
-  for (int64_t i = 0; i != n; ++i) { y[i] = std::tanh(x[i]); }
+  HostVecTanh<T>(n, x, y);
 }
 
 template<typename T>
@@ -0,0 +1,416 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "oneflow/core/kernel/util/host_permute.h"
+#include "oneflow/core/common/shape_vec.h"
+#include "oneflow/core/thread/thread_manager.h"
+#if defined(__SSE2__) || defined(OF_CPU_ISA_DISPATCH)
+#include <immintrin.h>
+#endif
+
+namespace oneflow {
+
+namespace {
+
+// edge of the leaf tile of the recursive 2d transpose, a 32x32 tile of 8-byte elements plus its
+// destination fits in l1
+constexpr int64_t kTransposeTileSize = 32;
+// edge of the plane panels that are handed out to the thread pool
+constexpr int64_t kTransposePanelSize = 4 * kTransposeTileSize;
+
+template<size_t size>
+struct BitwiseElem;
+
+template<>
+struct BitwiseElem<1> {
+  using type = uint8_t;
+};
+
+template<>
+struct BitwiseElem<2> {
+  using type = uint16_t;
+};
+
+template<>
+struct BitwiseElem<4> {
+  using type = uint32_t;
+};
+
+template<>
+struct BitwiseElem<8> {
+  using type = uint64_t;
+};
+
+// Drops size-1 axes and merges input axes that stay adjacent and in order in the output. After
+// this the innermost axis of x is either the innermost axis of y or lies in a different plane.
+void SimplifyPermutation(int32_t num_axes, const int64_t* x_dims, const int32_t* permutation,
+                         DimVector* dims, std::vector<int32_t>* perm) {
+  std::vector<int32_t> kept_axis(num_axes, -1);
+  DimVector kept_dims;
+  FOR_RANGE(int32_t, i, 0, num_axes) {
+    if (x_dims[i] == 1) { continue; }
+    kept_axis[i] = kept_dims.size();
+    kept_dims.push_back(x_dims[i]);
+  }
+  std::vector<int32_t> kept_perm;
+  FOR_RANGE(int32_t, i, 0, num_axes) {
+    const int32_t axis = kept_axis.at(permutation[i]);
+    if (axis != -1) { kept_perm.push_back(axis); }
+  }
+  // first and last input axis of every run of output axes
+  std::vector<std::pair<int32_t, int32_t>> groups;
+  FOR_RANGE(size_t, i, 0, kept_perm.size()) {
+    if (i > 0 && kept_perm[i] == kept_perm[i - 1] + 1) {
+      groups.back().second = kept_perm[i];
+    } else {
+      groups.emplace_back(kept_perm[i], kept_perm[i]);
+    }
+  }
+  std::vector<int32_t> group_order(groups.size());
+  std::iota(group_order.begin(), group_order.end(), 0);
+  std::sort(group_order.begin(), group_order.end(),
+            [&](int32_t lhs, int32_t rhs) { return groups[lhs].first < groups[rhs].first; });
+  dims->clear();
+  perm->resize(groups.size());
+  FOR_RANGE(size_t, i, 0, group_order.size()) {
+    const std::pair<int32_t, int32_t>& group = groups[group_order[i]];
+    int64_t dim = 1;
+    FOR_RANGE(int32_t, axis, group.first, group.second + 1) { dim *= kept_dims[axis]; }
+    dims->push_back(dim);
+    perm->at(group_order[i]) = i;
+  }
+}
+
+DimVector RowMajorStrides(const DimVector& dims) {
+  DimVector strides(dims.size());
+  int64_t stride = 1;
+  for (int32_t i = dims.size() - 1; i >= 0; --i) {
+    strides[i] = stride;
+    stride *= dims[i];
+  }
+  return strides;
+}
+
+template<typename T>
+struct TransposeMicroKernel {
+  static constexpr int64_t kSize = 4;
+  static void Transpose(const T* src, int64_t src_ld, T* dst, int64_t dst_ld) {
+    for (int64_t i = 0; i < kSize; ++i) {
+      for (int64_t j = 0; j < kSize; ++j) { dst[j * dst_ld + i] = src[i * src_ld + j]; }
+    }
+  }
+};
+
+#if defined(__SSE2__)
+
+template<>
+struct TransposeMicroKernel<uint32_t> {
+  static constexpr int64_t kSize = 4;
+  static void Transpose(const uint32_t* src, int64_t src_ld, uint32_t* dst, int64_t dst_ld) {
+    const float* s = reinterpret_cast<const float*>(src);
+    float* d = reinterpret_cast<float*>(dst);
+    __m128 r0 = _mm_loadu_ps(s + 0 * src_ld);
+    __m128 r1 = _mm_loadu_ps(s + 1 * src_ld);
+    __m128 r2 = _mm_loadu_ps(s + 2 * src_ld);
+    __m128 r3 = _mm_loadu_ps(s + 3 * src_ld);
+    _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+    _mm_storeu_ps(d + 0 * dst_ld, r0);
+    _mm_storeu_ps(d + 1 * dst_ld, r1);
+    _mm_storeu_ps(d + 2 * dst_ld, r2);
+    _mm_storeu_ps(d + 3 * dst_ld, r3);
+  }
+};
+
+#endif
+
+#ifdef OF_CPU_ISA_DISPATCH
+
+// 8x8 tiles of 4-byte elements, picked at runtime when the cpu has avx2
+struct TransposeMicroKernelAvx2 {
+  static constexpr int64_t kSize = 8;
+  OF_TARGET_AVX2 static void Transpose(const uint32_t* src, int64_t src_ld, uint32_t* dst,
+                                       int64_t dst_ld) {
+    const float* s = reinterpret_cast<const float*>(src);
+    float* d = reinterpret_cast<float*>(dst);
+    const __m256 r0 = _mm256_loadu_ps(s + 0 * src_ld);
+    const __m256 r1 = _mm256_loadu_ps(s + 1 * src_ld);
+    const __m256 r2 = _mm256_loadu_ps(s + 2 * src_ld);
+    const __m256 r3 = _mm256_loadu_ps(s + 3 * src_ld);
+    const __m256 r4 = _mm256_loadu_ps(s + 4 * src_ld);
+    const __m256 r5 = _mm256_loadu_ps(s + 5 * src_ld);
+    const __m256 r6 = _mm256_loadu_ps(s + 6 * src_ld);
+    const __m256 r7 = _mm256_loadu_ps(s + 7 * src_ld);
+    const __m256 t0 = _mm256_unpacklo_ps(r0, r1);
+    const __m256 t1 = _mm256_unpackhi_ps(r0, r1);
+    const __m256 t2 = _mm256_unpacklo_ps(r2, r3);
+    const __m256 t3 = _mm256_unpackhi_ps(r2, r3);
+    const __m256 t4 = _mm256_unpacklo_ps(r4, r5);
+    const __m256 t5 = _mm256_unpackhi_ps(r4, r5);
+    const __m256 t6 = _mm256_unpacklo_ps(r6, r7);
+    const __m256 t7 = _mm256_unpackhi_ps(r6, r7);
+    const __m256 u0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+    const __m256 u1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+    const __m256 u2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+    const __m256 u3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+    const __m256 u4 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(1, 0, 1, 0));
+    const __m256 u5 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(3, 2, 3, 2));
+    const __m256 u6 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(1, 0, 1, 0));
+    const __m256 u7 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(3, 2, 3, 2));
+    _mm256_storeu_ps(d + 0 * dst_ld, _mm256_permute2f128_ps(u0, u4, 0x20));
+    _mm256_storeu_ps(d + 1 * dst_ld, _mm256_permute2f128_ps(u1, u5, 0x20));
+    _mm256_storeu_ps(d + 2 * dst_ld, _mm256_permute2f128_ps(u2, u6, 0x20));
+    _mm256_storeu_ps(d + 3 * dst_ld, _mm256_permute2f128_ps(u3, u7, 0x20));
+    _mm256_storeu_ps(d + 4 * dst_ld, _mm256_permute2f128_ps(u0, u4, 0x31));
+    _mm256_storeu_ps(d + 5 * dst_ld, _mm256_permute2f128_ps(u1, u5, 0x31));
+    _mm256_storeu_ps(d + 6 * dst_ld, _mm256_permute2f128_ps(u2, u6, 0x31));
+    _mm256_storeu_ps(d + 7 * dst_ld, _mm256_permute2f128_ps(u3, u7, 0x31));
+  }
+};
+
+#endif  // OF_CPU_ISA_DISPATCH
+
+// src is a rows x cols matrix with leading dimension src_ld, dst receives its transpose
+template<typename MicroKernel, typename T>
+inline void TransposeTile(const T* src, int64_t src_ld, T* dst, int64_t dst_ld, int64_t rows,
+                          int64_t cols) {
+  constexpr int64_t kSize = MicroKernel::kSize;
+  int64_t i = 0;
+  for (; i + kSize <= rows; i += kSize) {
+    int64_t j = 0;
+    for (; j + kSize <= cols; j += kSize) {
+      MicroKernel::Transpose(src + i * src_ld + j, src_ld, dst + j * dst_ld + i, dst_ld);
+    }
+    for (; j < cols; ++j) {
+      for (int64_t k = i; k < i + kSize; ++k) { dst[j * dst_ld + k] = src[k * src_ld + j]; }
+    }
+  }
+  for (; i < rows; ++i) {
+    for (int64_t j = 0; j < cols; ++j) { dst[j * dst_ld + i] = src[i * src_ld + j]; }
+  }
+}
+
+template<typename T>
+void TransposeTileBaseline(const T* src, int64_t src_ld, T* dst, int64_t dst_ld, int64_t rows,
+                           int64_t cols) {
+  TransposeTile<TransposeMicroKernel<T>>(src, src_ld, dst, dst_ld, rows, cols);
+}
+
+#ifdef OF_CPU_ISA_DISPATCH
+
+OF_TARGET_AVX2 void TransposeTileAvx2(const uint32_t* src, int64_t src_ld, uint32_t* dst,
+                                      int64_t dst_ld, int64_t rows, int64_t cols) {
+  TransposeTile<TransposeMicroKernelAvx2>(src, src_ld, dst, dst_ld, rows, cols);
+}
+
+#endif  // OF_CPU_ISA_DISPATCH
+
+// A leaf tile transpose and the edge of its micro-kernel
+template<typename T>
+struct TransposeTiler {
+  void (*Transpose)(const T* src, int64_t src_ld, T* dst, int64_t dst_ld, int64_t rows,
+                    int64_t cols);
+  int64_t micro_kernel_size;
+};
+
+template<typename T>
+TransposeTiler<T> SelectTransposeTiler(CpuIsa isa) {
+  return TransposeTiler<T>{&TransposeTileBaseline<T>, TransposeMicroKernel<T>::kSize};
+}
+
+template<>
+TransposeTiler<uint32_t> SelectTransposeTiler<uint32_t>(CpuIsa isa) {
+#ifdef OF_CPU_ISA_DISPATCH
+  if (isa != CpuIsa::kScalar) {
+    return TransposeTiler<uint32_t>{&TransposeTileAvx2, TransposeMicroKernelAvx2::kSize};
+  }
+#endif
+  return TransposeTiler<uint32_t>{&TransposeTileBaseline<uint32_t>,
+                                  TransposeMicroKernel<uint32_t>::kSize};
+}
+
+// Cache-oblivious transpose: halves the longer edge until the block fits in a leaf tile. Split
+// points are kept on micro-kernel boundaries so only the outer edges take the scalar path.
+template<typename T>
+void TransposeRecursive(const TransposeTiler<T>& tiler, const T* src, int64_t src_ld, T* dst,
+                        int64_t dst_ld, int64_t rows, int64_t cols) {
+  const int64_t align = tiler.micro_kernel_size;
+  if (rows <= kTransposeTileSize && cols <= kTransposeTileSize) {
+    tiler.Transpose(src, src_ld, dst, dst_ld, rows, cols);
+  } else if (rows >= cols) {
+    const int64_t half = RoundUp(rows / 2, align);
+    TransposeRecursive(tiler, src, src_ld, dst, dst_ld, half, cols);
+    TransposeRecursive(tiler, src + half * src_ld, src_ld, dst + half, dst_ld, rows - half, cols);
+  } else {
+    const int64_t half = RoundUp(cols / 2, align);
+    TransposeRecursive(tiler, src, src_ld, dst, dst_ld, rows, half);
+    TransposeRecursive(tiler, src + half, src_ld, dst + half * dst_ld, dst_ld, rows, cols - half);
+  }
+}
+
+template<typename T>
+void ParallelCopy(int64_t elem_cnt, const T* x, T* y) {
+  const int64_t grain_size = MultiThreadLoopGrainSize(2 * sizeof(T));
+  MultiThreadLoop(elem_cnt, grain_size, [&](int64_t begin, int64_t end) {
+    memcpy(y + begin, x + begin, (end - begin) * sizeof(T));
+  });
+}
+
+// The innermost axis is kept, every row of y is a contiguous row of x.
+template<typename T>
+void PermuteRows(const DimVector& dims, const std::vector<int32_t>& perm, const T* x, T* y) {
+  const int32_t outer_num_axes = dims.size() - 1;
+  const int64_t row_size = dims.back();
+  const DimVector x_strides = RowMajorStrides(dims);
+  DimVector y_dims(outer_num_axes);
+  DimVector x_strides_in_y_order(outer_num_axes);
+  int64_t row_num = 1;
+  FOR_RANGE(int32_t, i, 0, outer_num_axes) {
+    y_dims[i] = dims[perm[i]];
+    x_strides_in_y_order[i] = x_strides[perm[i]];
+    row_num *= y_dims[i];
+  }
+  const int64_t grain_size = MultiThreadLoopGrainSize(2 * row_size * sizeof(T));
+  MultiThreadLoop(row_num, grain_size, [&](int64_t begin, int64_t end) {
+    DimVector index(outer_num_axes);
+    int64_t x_offset = 0;
+    int64_t remaining = begin;
+    for (int32_t i = outer_num_axes - 1; i >= 0; --i) {
+      index[i] = remaining % y_dims[i];
+      remaining /= y_dims[i];
+      x_offset += index[i] * x_strides_in_y_order[i];
+    }
+    FOR_RANGE(int64_t, row, begin, end) {
+      memcpy(y + row * row_size, x + x_offset, row_size * sizeof(T));
+      for (int32_t i = outer_num_axes - 1; i >= 0; --i) {
+        index[i] += 1;
+        x_offset += x_strides_in_y_order[i];
+        if (index[i] < y_dims[i]) { break; }
+        x_offset -= y_dims[i] * x_strides_in_y_order[i];
+        index[i] = 0;
+      }
+    }
+  });
+}
+
+// The innermost axes of x and y differ. They span a 2d plane that is transposed for every index
+// of the remaining outer axes; planes are cut into panels along their longer edge so that a
+// single large plane still spreads over the thread pool.
+template<typename T>
+void PermutePlanes(CpuIsa isa, const DimVector& dims, const std::vector<int32_t>& perm, const T* x,
+                   T* y) {
+  const TransposeTiler<T> tiler = SelectTransposeTiler<T>(isa);
+  const int32_t num_axes = dims.size();
+  const int32_t row_axis = perm.back();
+  const int32_t col_axis = num_axes - 1;
+  const DimVector x_strides = RowMajorStrides(dims);
+  DimVector y_dims(num_axes);
+  FOR_RANGE(int32_t, i, 0, num_axes) { y_dims[i] = dims[perm[i]]; }
+  const DimVector y_strides = RowMajorStrides(y_dims);
+  DimVector y_strides_in_x_order(num_axes);
+  FOR_RANGE(int32_t, i, 0, num_axes) { y_strides_in_x_order[perm[i]] = y_strides[i]; }
+  DimVector outer_dims;
+  DimVector outer_x_strides;
+  DimVector outer_y_strides;
+  int64_t outer_num = 1;
+  FOR_RANGE(int32_t, i, 0, num_axes) {
+    const int32_t axis = perm[i];
+    if (axis == row_axis || axis == col_axis) { continue; }
+    outer_dims.push_back(dims[axis]);
+    outer_x_strides.push_back(x_strides[axis]);
+    outer_y_strides.push_back(y_strides_in_x_order[axis]);
+    outer_num *= dims[axis];
+  }
+  const int64_t rows = dims[row_axis];
+  const int64_t cols = dims[col_axis];
+  const int64_t src_ld = x_strides[row_axis];
+  const int64_t dst_ld = y_strides_in_x_order[col_axis];
+  const bool split_rows = rows >= cols;
+  const int64_t panel_num = RoundUp(split_rows ? rows : cols, kTransposePanelSize)
+                            / kTransposePanelSize;
+  const int64_t panel_bytes = (split_rows ? cols : rows) * kTransposePanelSize * sizeof(T);
+  const int64_t grain_size = MultiThreadLoopGrainSize(2 * panel_bytes);
+  MultiThreadLoop(outer_num * panel_num, grain_size, [&](int64_t task_begin, int64_t task_end) {
+    FOR_RANGE(int64_t, task, task_begin, task_end) {
+      int64_t outer_index = task / panel_num;
+      const int64_t panel = task % panel_num;
+      int64_t x_offset = 0;
+      int64_t y_offset = 0;
+      for (int32_t i = outer_dims.size() - 1; i >= 0; --i) {
+        const int64_t index = outer_index % outer_dims[i];
+        outer_index /= outer_dims[i];
+        x_offset += index * outer_x_strides[i];
+        y_offset += index * outer_y_strides[i];
+      }
+      const int64_t begin = panel * kTransposePanelSize;
+      if (split_rows) {
+        const int64_t panel_rows = std::min(kTransposePanelSize, rows - begin);
+        TransposeRecursive(tiler, x + x_offset + begin * src_ld, src_ld, y + y_offset + begin,
+                           dst_ld, panel_rows, cols);
+      } else {
+        const int64_t panel_cols = std::min(kTransposePanelSize, cols - begin);
+        TransposeRecursive(tiler, x + x_offset + begin, src_ld, y + y_offset + begin * dst_ld,
+                           dst_ld, rows, panel_cols);
+      }
+    }
+  });
+}
+
+template<typename T>
+void HostPermuteImpl(CpuIsa isa, int32_t num_axes, const int64_t* x_dims,
+                     const int32_t* permutation, const T* x, T* y) {
+  int64_t elem_cnt = 1;
+  FOR_RANGE(int32_t, i, 0, num_axes) { elem_cnt *= x_dims[i]; }
+  if (elem_cnt == 0) { return; }
+  DimVector dims;
+  std::vector<int32_t> perm;
+  SimplifyPermutation(num_axes, x_dims, permutation, &dims, &perm);
+  if (dims.size() <= 1) {
+    ParallelCopy(elem_cnt, x, y);
+  } else if (perm.back() == dims.size() - 1) {
+    PermuteRows(dims, perm, x, y);
+  } else {
+    PermutePlanes(isa, dims, perm, x, y);
+  }
+}
+
+}  // namespace
+
+void HostPermute(int32_t num_axes, const int64_t* x_dims, const int32_t* permutation,
+                 size_t elem_size, const void* x, void* y) {
+  HostPermute(GetCpuIsa(), num_axes, x_dims, permutation, elem_size, x, y);
+}
+
+void HostPermute(CpuIsa isa, int32_t num_axes, const int64_t* x_dims, const int32_t* permutation,
+                 size_t elem_size, const void* x, void* y) {
+  CHECK_LE(num_axes, SHAPE_MAX_AXIS_SIZE);
+  CHECK_LE(static_cast<int32_t>(isa), static_cast<int32_t>(GetCpuIsa()));
+#define HOST_PERMUTE_ENTRY(size)                                                          \
+  case size: {                                                                            \
+    using T = BitwiseElem<size>::type;                                                    \
+    HostPermuteImpl<T>(isa, num_axes, x_dims, permutation, reinterpret_cast<const T*>(x), \
+                       reinterpret_cast<T*>(y));                                          \
+    break;                                                                                \
+  }
+  switch (elem_size) {
+    HOST_PERMUTE_ENTRY(1)
+    HOST_PERMUTE_ENTRY(2)
+    HOST_PERMUTE_ENTRY(4)
+    HOST_PERMUTE_ENTRY(8)
+    default: UNIMPLEMENTED() << "element size " << elem_size;
+  }
+#undef HOST_PERMUTE_ENTRY
+}
+
+}  // namespace oneflow
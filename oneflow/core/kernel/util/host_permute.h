@@ -0,0 +1,48 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#ifndef ONEFLOW_CORE_KERNEL_UTIL_HOST_PERMUTE_H_
+#define ONEFLOW_CORE_KERNEL_UTIL_HOST_PERMUTE_H_
+
+#include "oneflow/core/common/util.h"
+#include "oneflow/core/common/cpu_isa.h"
+
+namespace oneflow {
+
+// y is x with its axes permuted: y.shape[i] == x.shape[permutation[i]]. Both tensors are dense
+// and row-major, elements are moved bitwise so any data type of size 1, 2, 4 or 8 is supported.
+//
+// Size-1 axes are dropped and input axes that stay adjacent in y are merged before copying. When
+// the innermost axis is kept, whole rows are moved with memcpy; otherwise every 2d plane formed by
+// the two innermost axes of x and y is transposed with a cache-oblivious recursive blocking and
+// 4x4 simd micro-kernels, or 8x8 avx2 ones for 4-byte elements when GetCpuIsa() has avx2.
+// Independent planes and row panels run on the thread pool.
+void HostPermute(int32_t num_axes, const int64_t* x_dims, const int32_t* permutation,
+                 size_t elem_size, const void* x, void* y);
+
+// Same as above with the micro-kernels of isa, which must not be wider than GetCpuIsa(). Lets
+// tests run every code path the cpu supports.
+void HostPermute(CpuIsa isa, int32_t num_axes, const int64_t* x_dims, const int32_t* permutation,
+                 size_t elem_size, const void* x, void* y);
+
+template<typename T>
+void HostPermute(int32_t num_axes, const int64_t* x_dims, const int32_t* permutation, const T* x,
+                 T* y) {
+  HostPermute(num_axes, x_dims, permutation, sizeof(T), x, y);
+}
+
+}  // namespace oneflow
+
+#endif  // ONEFLOW_CORE_KERNEL_UTIL_HOST_PERMUTE_H_
@@ -0,0 +1,149 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "oneflow/core/kernel/util/host_permute.h"
+#include "oneflow/core/common/benchmark_test_util.h"
+#include "oneflow/core/thread/thread_pool.h"
+#include <gtest/gtest.h>
+
+namespace oneflow {
+
+namespace test {
+
+namespace {
+
+template<typename T>
+void NaivePermute(const std::vector<int64_t>& x_dims, const std::vector<int32_t>& perm,
+                  const T* x, T* y) {
+  const int32_t num_axes = x_dims.size();
+  std::vector<int64_t> x_strides(num_axes, 1);
+  for (int32_t i = num_axes - 2; i >= 0; --i) { x_strides[i] = x_strides[i + 1] * x_dims[i + 1]; }
+  std::vector<int64_t> y_dims(num_axes);
+  FOR_RANGE(int32_t, i, 0, num_axes) { y_dims[i] = x_dims[perm[i]]; }
+  const int64_t elem_cnt =
+      std::accumulate(x_dims.begin(), x_dims.end(), 1LL, std::multiplies<int64_t>());
+  std::vector<int64_t> y_index(num_axes, 0);
+  FOR_RANGE(int64_t, y_offset, 0, elem_cnt) {
+    int64_t x_offset = 0;
+    FOR_RANGE(int32_t, i, 0, num_axes) { x_offset += y_index[i] * x_strides[perm[i]]; }
+    y[y_offset] = x[x_offset];
+    for (int32_t i = num_axes - 1; i >= 0; --i) {
+      if (++y_index[i] < y_dims[i]) { break; }
+      y_index[i] = 0;
+    }
+  }
+}
+
+template<typename T>
+void TestPermute(const std::vector<int64_t>& x_dims, const std::vector<int32_t>& perm) {
+  const int64_t elem_cnt =
+      std::accumulate(x_dims.begin(), x_dims.end(), 1LL, std::multiplies<int64_t>());
+  std::vector<T> x(elem_cnt);
+  FOR_RANGE(int64_t, i, 0, elem_cnt) { x[i] = static_cast<T>(i * 7 + 3); }
+  std::vector<T> expected(elem_cnt);
+  std::vector<T> y(elem_cnt);
+  NaivePermute(x_dims, perm, x.data(), expected.data());
+  HostPermute<T>(x_dims.size(), x_dims.data(), perm.data(), x.data(), y.data());
+  ASSERT_TRUE(expected == y);
+  // and again on every narrower isa the cpu supports
+  FOR_RANGE(int32_t, isa, 0, static_cast<int32_t>(GetCpuIsa())) {
+    std::fill(y.begin(), y.end(), T());
+    HostPermute(static_cast<CpuIsa>(isa), x_dims.size(), x_dims.data(), perm.data(), sizeof(T),
+                x.data(), y.data());
+    ASSERT_TRUE(expected == y) << "isa " << isa;
+  }
+}
+
+template<typename T>
+void TestCommonPermutations() {
+  TestPermute<T>({5}, {0});
+  TestPermute<T>({3, 1, 4}, {1, 2, 0});
+  TestPermute<T>({37, 53}, {1, 0});
+  TestPermute<T>({2, 3, 67, 45}, {0, 2, 3, 1});
+  TestPermute<T>({2, 67, 45, 3}, {0, 3, 1, 2});
+  TestPermute<T>({2, 9, 4, 16}, {0, 2, 1, 3});
+  TestPermute<T>({2, 4, 9, 16}, {0, 1, 3, 2});
+  TestPermute<T>({3, 5, 7, 2, 4}, {4, 2, 0, 3, 1});
+  TestPermute<T>({1, 300, 1, 129}, {3, 2, 1, 0});
+}
+
+}  // namespace
+
+TEST(HostPermute, int8) { TestCommonPermutations<int8_t>(); }
+
+TEST(HostPermute, int16) { TestCommonPermutations<int16_t>(); }
+
+TEST(HostPermute, float) { TestCommonPermutations<float>(); }
+
+TEST(HostPermute, double) { TestCommonPermutations<double>(); }
+
+TEST(HostPermute, avx2_micro_kernel) {
+  if (GetCpuIsa() < CpuIsa::kAvx2) { return; }
+  // planes whose edges are multiples of the 8x8 micro-kernel, or leave a scalar border
+  const std::vector<std::vector<int64_t>> plane_dims = {{8, 8}, {16, 40}, {9, 17}, {71, 33}};
+  for (const std::vector<int64_t>& dims : plane_dims) {
+    const int64_t elem_cnt = dims.at(0) * dims.at(1);
+    std::vector<float> x(elem_cnt);
+    FOR_RANGE(int64_t, i, 0, elem_cnt) { x[i] = static_cast<float>(i); }
+    std::vector<float> expected(elem_cnt);
+    std::vector<float> y(elem_cnt);
+    const std::vector<int32_t> perm = {1, 0};
+    NaivePermute(dims, perm, x.data(), expected.data());
+    HostPermute(CpuIsa::kAvx2, 2, dims.data(), perm.data(), sizeof(float), x.data(), y.data());
+    ASSERT_TRUE(expected == y) << dims.at(0) << "x" << dims.at(1);
+  }
+}
+
+TEST(HostPermute, multi_thread) {
+  Global<ThreadPool>::New(4);
+  TestPermute<float>({4, 64, 56, 56}, {0, 2, 3, 1});
+  TestPermute<float>({1, 1024, 1024}, {0, 2, 1});
+  TestPermute<double>({4, 128, 12, 64}, {0, 2, 1, 3});
+  Global<ThreadPool>::Delete();
+}
+
+TEST(HostPermute, DISABLED_benchmark) {
+  Global<ThreadPool>::New(std::max<int32_t>(std::thread::hardware_concurrency(), 1));
+  struct Case {
+    std::string name;
+    std::vector<int64_t> dims;
+    std::vector<int32_t> perm;
+  };
+  const std::vector<Case> cases = {
+      {"nchw_to_nhwc", {8, 64, 56, 56}, {0, 2, 3, 1}},
+      {"nhwc_to_nchw", {8, 56, 56, 64}, {0, 3, 1, 2}},
+      {"split_heads", {8, 128, 12, 64}, {0, 2, 1, 3}},
+      {"key_transpose", {8, 12, 128, 64}, {0, 1, 3, 2}},
+  };
+  for (const Case& c : cases) {
+    const int64_t elem_cnt =
+        std::accumulate(c.dims.begin(), c.dims.end(), 1LL, std::multiplies<int64_t>());
+    std::vector<float> x(elem_cnt, 1.0f);
+    std::vector<float> y(elem_cnt);
+    const double naive_ms =
+        BenchmarkMilliseconds([&]() { NaivePermute(c.dims, c.perm, x.data(), y.data()); });
+    const double permute_ms = BenchmarkMilliseconds([&]() {
+      HostPermute<float>(c.dims.size(), c.dims.data(), c.perm.data(), x.data(), y.data());
+    });
+    LOG(INFO) << "HostPermute " << c.name << ": naive " << naive_ms << " ms, blocked "
+              << permute_ms << " ms, "
+              << 2.0 * elem_cnt * sizeof(float) / (permute_ms * 1e6) << " GB/s";
+  }
+  Global<ThreadPool>::Delete();
+}
+
+}  // namespace test
+
+}  // namespace oneflow
@@ -0,0 +1,494 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "oneflow/core/kernel/util/host_radix_sort.h"
+#include "oneflow/core/common/balanced_splitter.h"
+#include "oneflow/core/thread/thread_manager.h"
+
+namespace oneflow {
+
+namespace {
+
+constexpr int32_t kRadixBits = 8;
+constexpr int32_t kRadixSize = 1 << kRadixBits;
+constexpr int32_t kRadixMask = kRadixSize - 1;
+// rows up to this size are insertion sorted, the digit histograms do not pay off for them
+constexpr int64_t kInsertionSortMaxSize = 32;
+// rows are spread over the thread pool once the tensor has this many elements
+constexpr int64_t kParallelMinElemCnt = 32 * 1024;
+// a row is split across threads only if every thread gets at least this many elements
+constexpr int64_t kParallelMinPartSize = 32 * 1024;
+// top-k up to this k keeps a heap of indices, larger k selects with radix histograms
+constexpr int64_t kHeapTopKMaxK = 64;
+
+template<typename T, typename U>
+struct IntegralRadixTraits {
+  using Key = U;
+  static constexpr U kSignBit = static_cast<U>(1) << (sizeof(U) * 8 - 1);
+  static U Encode(T v) { return static_cast<U>(v) ^ kSignBit; }
+  static T Decode(U key) { return static_cast<T>(key ^ kSignBit); }
+};
+
+// Negative values get all bits flipped so that larger magnitudes come first, the others only get
+// the sign bit set. NaNs end up beyond the infinity of the same sign.
+template<typename T, typename U>
+struct FloatingRadixTraits {
+  using Key = U;
+  static constexpr U kSignBit = static_cast<U>(1) << (sizeof(U) * 8 - 1);
+  static U Encode(T v) {
+    U bits;
+    std::memcpy(&bits, &v, sizeof(U));
+    const U sign_mask = static_cast<U>(static_cast<U>(0) - (bits >> (sizeof(U) * 8 - 1)));
+    return bits ^ (sign_mask | kSignBit);
+  }
+  static T Decode(U key) {
+    const U sign_mask = static_cast<U>((key >> (sizeof(U) * 8 - 1)) - static_cast<U>(1));
+    const U bits = key ^ (sign_mask | kSignBit);
+    T v;
+    std::memcpy(&v, &bits, sizeof(U));
+    return v;
+  }
+};
+
+template<typename T>
+struct RadixTraits;
+
+template<>
+struct RadixTraits<float> final : public FloatingRadixTraits<float, uint32_t> {};
+
+template<>
+struct RadixTraits<double> final : public FloatingRadixTraits<double, uint64_t> {};
+
+template<>
+struct RadixTraits<int32_t> final : public IntegralRadixTraits<int32_t, uint32_t> {};
+
+template<>
+struct RadixTraits<int64_t> final : public IntegralRadixTraits<int64_t, uint64_t> {};
+
+template<typename T>
+using RadixKey = typename RadixTraits<T>::Key;
+
+// descending order is the ascending order of the complemented keys
+template<typename K>
+K FlipBits(bool descending) {
+  return descending ? ~static_cast<K>(0) : static_cast<K>(0);
+}
+
+int64_t ThreadNum() {
+  return Global<ThreadPool>::Get() == nullptr ? 1 : Global<ThreadPool>::Get()->thread_num();
+}
+
+// Calls Handler(part_id, range) for part_num balanced pieces of [0, n), on the thread pool if
+// there is more than one piece.
+template<typename F>
+void ForEachPart(int64_t n, int64_t part_num, const F& Handler) {
+  if (part_num <= 1) {
+    Handler(0, Range(0, n));
+    return;
+  }
+  const BalancedSplitter bs(n, part_num);
+  MultiThreadLoop(part_num, 1, [&](int64_t part_id_begin, int64_t part_id_end) {
+    FOR_RANGE(int64_t, part_id, part_id_begin, part_id_end) { Handler(part_id, bs.At(part_id)); }
+  });
+}
+
+// Calls Handler(row, part_num) for every row. Rows are spread over the thread pool and get
+// part_num 1, unless there are fewer rows than threads and they are large: then rows are handled
+// one after another and each is split into part_num pieces.
+template<typename F>
+void ForEachRow(int64_t instance_num, int64_t instance_size, const F& Handler) {
+  const int64_t thread_num = ThreadNum();
+  if (thread_num > 1 && instance_num < thread_num
+      && instance_size >= 2 * kParallelMinPartSize) {
+    const int64_t part_num = std::min(thread_num, instance_size / kParallelMinPartSize);
+    FOR_RANGE(int64_t, row, 0, instance_num) { Handler(row, part_num); }
+  } else {
+    const int64_t part_num = instance_num * instance_size >= kParallelMinElemCnt
+                                 ? std::min(thread_num, instance_num)
+                                 : 1;
+    ForEachPart(instance_num, part_num, [&](int64_t, const Range& range) {
+      FOR_RANGE(int64_t, row, range.begin(), range.end()) { Handler(row, 1); }
+    });
+  }
+}
+
+template<typename K, typename V>
+void InsertionSort(int64_t n, K* keys, V* values) {
+  FOR_RANGE(int64_t, i, 1, n) {
+    const K key = keys[i];
+    const V value = values == nullptr ? V() : values[i];
+    int64_t j = i;
+    for (; j > 0 && keys[j - 1] > key; --j) {
+      keys[j] = keys[j - 1];
+      if (values != nullptr) { values[j] = values[j - 1]; }
+    }
+    keys[j] = key;
+    if (values != nullptr) { values[j] = value; }
+  }
+}
+
+template<typename K, typename V, bool has_values, bool values_are_positions>
+void ScatterByDigit(const Range& range, int32_t shift, const K* keys, const V* values,
+                    int64_t* offset, K* keys_out, V* values_out) {
+  FOR_RANGE(int64_t, i, range.begin(), range.end()) {
+    const K key = keys[i];
+    const int64_t pos = offset[(key >> shift) & kRadixMask]++;
+    keys_out[pos] = key;
+    if (has_values) { values_out[pos] = values_are_positions ? static_cast<V>(i) : values[i]; }
+  }
+}
+
+// Stable ascending sort of n encoded keys. values, if not null, are moved along with the keys;
+// with values_are_positions their content is ignored and the positions 0..n-1 are attached
+// instead. keys_alt and values_alt are scratch buffers of n elements, the returned pair points to
+// the buffers that hold the result.
+template<typename K, typename V>
+std::pair<K*, V*> RadixSortEncoded(int64_t n, int64_t part_num, bool values_are_positions,
+                                   K* keys, K* keys_alt, V* values, V* values_alt) {
+  if (n <= kInsertionSortMaxSize) {
+    if (values_are_positions) { std::iota(values, values + n, 0); }
+    InsertionSort(n, keys, values);
+    return std::make_pair(keys, values);
+  }
+  constexpr int32_t kPassNum = sizeof(K) * 8 / kRadixBits;
+  // digit histograms of every pass, one set per part. The totals do not change when keys move,
+  // the per part counts of a pass are recomputed if a previous pass moved the keys.
+  std::vector<int64_t> part_hist(part_num * kPassNum * kRadixSize, 0);
+  ForEachPart(n, part_num, [&](int64_t part_id, const Range& range) {
+    int64_t* hist = part_hist.data() + part_id * kPassNum * kRadixSize;
+    FOR_RANGE(int64_t, i, range.begin(), range.end()) {
+      K key = keys[i];
+      FOR_RANGE(int32_t, pass, 0, kPassNum) {
+        ++hist[pass * kRadixSize + (key & kRadixMask)];
+        key >>= kRadixBits;
+      }
+    }
+  });
+  std::vector<int64_t> part_offset(part_num * kRadixSize);
+  bool keys_moved = false;
+  FOR_RANGE(int32_t, pass, 0, kPassNum) {
+    const int32_t shift = pass * kRadixBits;
+    auto PassHist = [&](int64_t part_id) {
+      return part_hist.data() + (part_id * kPassNum + pass) * kRadixSize;
+    };
+    const int32_t first_digit = (keys[0] >> shift) & kRadixMask;
+    int64_t first_digit_cnt = 0;
+    FOR_RANGE(int64_t, part_id, 0, part_num) { first_digit_cnt += PassHist(part_id)[first_digit]; }
+    if (first_digit_cnt == n) { continue; }
+    if (keys_moved && part_num > 1) {
+      ForEachPart(n, part_num, [&](int64_t part_id, const Range& range) {
+        int64_t* hist = PassHist(part_id);
+        std::fill(hist, hist + kRadixSize, 0);
+        FOR_RANGE(int64_t, i, range.begin(), range.end()) {
+          ++hist[(keys[i] >> shift) & kRadixMask];
+        }
+      });
+    }
+    int64_t base = 0;
+    FOR_RANGE(int32_t, digit, 0, kRadixSize) {
+      FOR_RANGE(int64_t, part_id, 0, part_num) {
+        part_offset[part_id * kRadixSize + digit] = base;
+        base += PassHist(part_id)[digit];
+      }
+    }
+    ForEachPart(n, part_num, [&](int64_t part_id, const Range& range) {
+      int64_t* offset = part_offset.data() + part_id * kRadixSize;
+      if (values == nullptr) {
+        ScatterByDigit<K, V, false, false>(range, shift, keys, values, offset, keys_alt,
+                                           values_alt);
+      } else if (values_are_positions) {
+        ScatterByDigit<K, V, true, true>(range, shift, keys, values, offset, keys_alt, values_alt);
+      } else {
+        ScatterByDigit<K, V, true, false>(range, shift, keys, values, offset, keys_alt,
+                                          values_alt);
+      }
+    });
+    std::swap(keys, keys_alt);
+    std::swap(values, values_alt);
+    values_are_positions = false;
+    keys_moved = true;
+  }
+  if (values_are_positions) { std::iota(values, values + n, 0); }
+  return std::make_pair(keys, values);
+}
+
+// The top-k paths compare radix keys instead of values: they are totally ordered even with NaNs
+// and rank every element the same way as the radix select does for larger k.
+template<typename T>
+bool RadixKeyLess(T lhs, T rhs) {
+  return RadixTraits<T>::Encode(lhs) < RadixTraits<T>::Encode(rhs);
+}
+
+template<typename T>
+void HeapTopK(int64_t n, int64_t k, bool sorted, const T* in, int32_t* out) {
+  using K = RadixKey<T>;
+  auto Better = [in](int32_t lhs, int32_t rhs) {
+    const K lhs_key = RadixTraits<T>::Encode(in[lhs]);
+    const K rhs_key = RadixTraits<T>::Encode(in[rhs]);
+    return lhs_key > rhs_key || (lhs_key == rhs_key && lhs < rhs);
+  };
+  // a heap ordered by Better keeps the worst of the current top k at out[0]
+  std::iota(out, out + k, 0);
+  std::make_heap(out, out + k, Better);
+  K worst = RadixTraits<T>::Encode(in[out[0]]);
+  FOR_RANGE(int64_t, i, k, n) {
+    // later indices lose ties, so only strictly larger elements enter the heap
+    if (RadixTraits<T>::Encode(in[i]) > worst) {
+      std::pop_heap(out, out + k, Better);
+      out[k - 1] = i;
+      std::push_heap(out, out + k, Better);
+      worst = RadixTraits<T>::Encode(in[out[0]]);
+    }
+  }
+  if (sorted) { std::sort_heap(out, out + k, Better); }
+}
+
+// Finds the top k of n elements digit by digit from the most significant one. On return exactly
+// k - *remaining elements have (key & *mask) > *prefix and the first *remaining elements with
+// (key & *mask) == *prefix complete the top k. candidates, used only with part_num 1, has room for
+// n indices and keeps the elements that still share the prefix so later digits skip the others.
+template<typename T>
+void RadixSelect(int64_t n, int64_t k, int64_t part_num, const T* in, int32_t* candidates,
+                 RadixKey<T>* prefix, RadixKey<T>* mask, int64_t* remaining) {
+  using K = RadixKey<T>;
+  *prefix = 0;
+  *mask = 0;
+  *remaining = k;
+  int64_t candidate_num = -1;
+  std::vector<int64_t> part_hist(part_num * kRadixSize);
+  for (int32_t shift = sizeof(K) * 8 - kRadixBits; shift >= 0; shift -= kRadixBits) {
+    std::fill(part_hist.begin(), part_hist.end(), 0);
+    if (candidate_num >= 0) {
+      FOR_RANGE(int64_t, j, 0, candidate_num) {
+        ++part_hist[(RadixTraits<T>::Encode(in[candidates[j]]) >> shift) & kRadixMask];
+      }
+    } else {
+      ForEachPart(n, part_num, [&](int64_t part_id, const Range& range) {
+        int64_t* hist = part_hist.data() + part_id * kRadixSize;
+        FOR_RANGE(int64_t, i, range.begin(), range.end()) {
+          const K key = RadixTraits<T>::Encode(in[i]);
+          if ((key & *mask) == *prefix) { ++hist[(key >> shift) & kRadixMask]; }
+        }
+      });
+    }
+    int32_t digit = kRadixMask;
+    int64_t digit_cnt = 0;
+    for (;; --digit) {
+      digit_cnt = 0;
+      FOR_RANGE(int64_t, part_id, 0, part_num) {
+        digit_cnt += part_hist[part_id * kRadixSize + digit];
+      }
+      if (digit_cnt >= *remaining) { break; }
+      *remaining -= digit_cnt;
+    }
+    *prefix |= static_cast<K>(digit) << shift;
+    *mask |= static_cast<K>(kRadixMask) << shift;
+    // all elements sharing the prefix are in the top k, the lower digits do not matter
+    if (digit_cnt == *remaining) { break; }
+    if (part_num == 1 && shift > 0) {
+      int64_t new_candidate_num = 0;
+      const int64_t scan_num = candidate_num >= 0 ? candidate_num : n;
+      FOR_RANGE(int64_t, j, 0, scan_num) {
+        const int32_t i = candidate_num >= 0 ? candidates[j] : j;
+        if ((RadixTraits<T>::Encode(in[i]) & *mask) == *prefix) {
+          candidates[new_candidate_num++] = i;
+        }
+      }
+      candidate_num = new_candidate_num;
+    }
+  }
+}
+
+// Writes the indices selected by RadixSelect to out in index order: first the larger elements,
+// then the first remaining tied ones.
+template<typename T>
+void CollectTopK(int64_t n, int64_t k, int64_t part_num, const T* in, RadixKey<T> prefix,
+                 RadixKey<T> mask, int64_t remaining, int32_t* out) {
+  using K = RadixKey<T>;
+  std::vector<int64_t> larger_offset(part_num, 0);
+  std::vector<int64_t> tied_offset(part_num, k - remaining);
+  if (part_num > 1) {
+    std::vector<int64_t> larger_cnt(part_num, 0);
+    std::vector<int64_t> tied_cnt(part_num, 0);
+    ForEachPart(n, part_num, [&](int64_t part_id, const Range& range) {
+      FOR_RANGE(int64_t, i, range.begin(), range.end()) {
+        const K key = RadixTraits<T>::Encode(in[i]) & mask;
+        larger_cnt[part_id] += key > prefix;
+        tied_cnt[part_id] += key == prefix;
+      }
+    });
+    FOR_RANGE(int64_t, part_id, 1, part_num) {
+      larger_offset[part_id] = larger_offset[part_id - 1] + larger_cnt[part_id - 1];
+      tied_offset[part_id] = tied_offset[part_id - 1] + tied_cnt[part_id - 1];
+    }
+  }
+  ForEachPart(n, part_num, [&](int64_t part_id, const Range& range) {
+    int64_t larger_pos = larger_offset[part_id];
+    int64_t tied_pos = tied_offset[part_id];
+    FOR_RANGE(int64_t, i, range.begin(), range.end()) {
+      const K key = RadixTraits<T>::Encode(in[i]) & mask;
+      if (key > prefix) {
+        out[larger_pos++] = i;
+      } else if (key == prefix && tied_pos < k) {
+        out[tied_pos++] = i;
+      }
+    }
+  });
+}
+
+// Sorts the k indices in out by descending value. Equal values are already in index order, the
+// stable radix sort keeps it that way.
+template<typename T>
+void SortTopK(int64_t k, const T* in, int32_t* out, RadixKey<T>* keys, RadixKey<T>* keys_alt,
+              int32_t* values_alt) {
+  using K = RadixKey<T>;
+  const K flip = FlipBits<K>(true);
+  FOR_RANGE(int64_t, j, 0, k) { keys[j] = RadixTraits<T>::Encode(in[out[j]]) ^ flip; }
+  const int32_t* sorted =
+      RadixSortEncoded<K, int32_t>(k, 1, false, keys, keys_alt, out, values_alt).second;
+  if (sorted != out) { std::copy(sorted, sorted + k, out); }
+}
+
+}  // namespace
+
+template<typename T>
+void HostRadixSort(int64_t instance_num, int64_t instance_size, bool descending, const T* in,
+                   T* out, void* tmp) {
+  using K = RadixKey<T>;
+  // keys are as wide as T, so out doubles as the first key buffer
+  K* keys_buf = reinterpret_cast<K*>(out);
+  K* keys_alt_buf = reinterpret_cast<K*>(tmp);
+  const K flip = FlipBits<K>(descending);
+  ForEachRow(instance_num, instance_size, [&](int64_t row, int64_t part_num) {
+    const int64_t offset = row * instance_size;
+    K* keys = keys_buf + offset;
+    ForEachPart(instance_size, part_num, [&](int64_t, const Range& range) {
+      FOR_RANGE(int64_t, i, range.begin(), range.end()) {
+        keys[i] = RadixTraits<T>::Encode(in[offset + i]) ^ flip;
+      }
+    });
+    const K* sorted = RadixSortEncoded<K, int32_t>(instance_size, part_num, false, keys,
+                                                   keys_alt_buf + offset, nullptr, nullptr)
+                          .first;
+    ForEachPart(instance_size, part_num, [&](int64_t, const Range& range) {
+      FOR_RANGE(int64_t, i, range.begin(), range.end()) {
+        out[offset + i] = RadixTraits<T>::Decode(sorted[i] ^ flip);
+      }
+    });
+  });
+}
+
+template<typename T>
+size_t HostRadixSortTmpBytes(int64_t instance_num, int64_t instance_size) {
+  return instance_num * instance_size * sizeof(RadixKey<T>);
+}
+
+template<typename T>
+void HostRadixArgSort(int64_t instance_num, int64_t instance_size, bool descending, const T* in,
+                      int32_t* out, void* tmp) {
+  using K = RadixKey<T>;
+  const int64_t elem_cnt = instance_num * instance_size;
+  K* keys_buf = reinterpret_cast<K*>(tmp);
+  K* keys_alt_buf = keys_buf + elem_cnt;
+  int32_t* values_alt_buf = reinterpret_cast<int32_t*>(keys_alt_buf + elem_cnt);
+  const K flip = FlipBits<K>(descending);
+  ForEachRow(instance_num, instance_size, [&](int64_t row, int64_t part_num) {
+    const int64_t offset = row * instance_size;
+    K* keys = keys_buf + offset;
+    ForEachPart(instance_size, part_num, [&](int64_t, const Range& range) {
+      FOR_RANGE(int64_t, i, range.begin(), range.end()) {
+        keys[i] = RadixTraits<T>::Encode(in[offset + i]) ^ flip;
+      }
+    });
+    const int32_t* sorted =
+        RadixSortEncoded<K, int32_t>(instance_size, part_num, true, keys, keys_alt_buf + offset,
+                                     out + offset, values_alt_buf + offset)
+            .second;
+    if (sorted != out + offset) {
+      ForEachPart(instance_size, part_num, [&](int64_t, const Range& range) {
+        std::copy(sorted + range.begin(), sorted + range.end(), out + offset + range.begin());
+      });
+    }
+  });
+}
+
+template<typename T>
+size_t HostRadixArgSortTmpBytes(int64_t instance_num, int64_t instance_size) {
+  return instance_num * instance_size * (2 * sizeof(RadixKey<T>) + sizeof(int32_t));
+}
+
+template<typename T>
+void HostTopK(int64_t instance_num, int64_t instance_size, int64_t k, bool sorted, const T* in,
+              int32_t* out, void* tmp) {
+  using K = RadixKey<T>;
+  k = std::min(k, instance_size);
+  if (k <= 0) { return; }
+  // layout of tmp, see HostTopKTmpBytes: keys, alternate keys and alternate values of the k
+  // selected elements of every row for the final sort, then n candidates per row for selection
+  K* keys_buf = reinterpret_cast<K*>(tmp);
+  K* keys_alt_buf = keys_buf + instance_num * k;
+  int32_t* values_alt_buf = reinterpret_cast<int32_t*>(keys_alt_buf + instance_num * k);
+  int32_t* candidates_buf = values_alt_buf + instance_num * k;
+  ForEachRow(instance_num, instance_size, [&](int64_t row, int64_t part_num) {
+    const T* in_row = in + row * instance_size;
+    int32_t* out_row = out + row * k;
+    if (part_num == 1 && k == 1) {
+      *out_row =
+          std::distance(in_row, std::max_element(in_row, in_row + instance_size, RadixKeyLess<T>));
+    } else if (part_num == 1 && k <= kHeapTopKMaxK) {
+      HeapTopK(instance_size, k, sorted, in_row, out_row);
+    } else {
+      K prefix = 0;
+      K mask = 0;
+      int64_t remaining = 0;
+      RadixSelect(instance_size, k, part_num, in_row, candidates_buf + row * instance_size,
+                  &prefix, &mask, &remaining);
+      CollectTopK(instance_size, k, part_num, in_row, prefix, mask, remaining, out_row);
+      if (sorted && k > 1) {
+        SortTopK(k, in_row, out_row, keys_buf + row * k, keys_alt_buf + row * k,
+                 values_alt_buf + row * k);
+      }
+    }
+  });
+}
+
+template<typename T>
+size_t HostTopKTmpBytes(int64_t instance_num, int64_t instance_size, int64_t k) {
+  k = std::min(k, instance_size);
+  if (k <= 1) { return 0; }
+  const size_t sort_bytes = k * (2 * sizeof(RadixKey<T>) + sizeof(int32_t));
+  const size_t candidates_bytes = k > kHeapTopKMaxK ? instance_size * sizeof(int32_t) : 0;
+  return instance_num * (sort_bytes + candidates_bytes);
+}
+
+#define INSTANTIATE_HOST_RADIX_SORT(T)                                                            \
+  template void HostRadixSort<T>(int64_t instance_num, int64_t instance_size, bool descending,    \
+                                 const T* in, T* out, void* tmp);                                 \
+  template size_t HostRadixSortTmpBytes<T>(int64_t instance_num, int64_t instance_size);          \
+  template void HostRadixArgSort<T>(int64_t instance_num, int64_t instance_size, bool descending, \
+                                    const T* in, int32_t* out, void* tmp);                        \
+  template size_t HostRadixArgSortTmpBytes<T>(int64_t instance_num, int64_t instance_size);       \
+  template void HostTopK<T>(int64_t instance_num, int64_t instance_size, int64_t k, bool sorted,  \
+                            const T* in, int32_t* out, void* tmp);                                \
+  template size_t HostTopKTmpBytes<T>(int64_t instance_num, int64_t instance_size, int64_t k);
+
+INSTANTIATE_HOST_RADIX_SORT(float)
+INSTANTIATE_HOST_RADIX_SORT(double)
+INSTANTIATE_HOST_RADIX_SORT(int32_t)
+INSTANTIATE_HOST_RADIX_SORT(int64_t)
+
+#undef INSTANTIATE_HOST_RADIX_SORT
+
+}  // namespace oneflow
@@ -0,0 +1,57 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#ifndef ONEFLOW_CORE_KERNEL_UTIL_HOST_RADIX_SORT_H_
+#define ONEFLOW_CORE_KERNEL_UTIL_HOST_RADIX_SORT_H_
+
+#include "oneflow/core/common/util.h"
+
+namespace oneflow {
+
+// Row-wise sorting of a dense [instance_num, instance_size] tensor on the host for float, double,
+// int32_t and int64_t. Keys are mapped to order-preserving unsigned integers and sorted with a
+// stable lsd radix sort on 8-bit digits, digits shared by every key of a row are skipped. Rows are
+// spread over the thread pool; when there are fewer rows than threads and the rows are large,
+// every row is split across the threads with per-thread digit histograms instead.
+
+// out holds the rows of in sorted. tmp must hold HostRadixSortTmpBytes<T>() bytes.
+template<typename T>
+void HostRadixSort(int64_t instance_num, int64_t instance_size, bool descending, const T* in,
+                   T* out, void* tmp);
+template<typename T>
+size_t HostRadixSortTmpBytes(int64_t instance_num, int64_t instance_size);
+
+// out holds the indices that sort every row of in, equal keys keep their original order. tmp must
+// hold HostRadixArgSortTmpBytes<T>() bytes.
+template<typename T>
+void HostRadixArgSort(int64_t instance_num, int64_t instance_size, bool descending, const T* in,
+                      int32_t* out, void* tmp);
+template<typename T>
+size_t HostRadixArgSortTmpBytes(int64_t instance_num, int64_t instance_size);
+
+// out holds the indices of the k largest elements of every row, ordered by value when sorted is
+// set; of two equal elements the lower index wins and a NaN ranks beyond the infinity of its
+// sign, as in the sorts above. Small k keeps a heap of the best indices seen so far, larger k
+// finds the k-th largest key digit by digit from radix histograms and sorts the selection with
+// the radix sort above. tmp must hold HostTopKTmpBytes<T>() bytes.
+template<typename T>
+void HostTopK(int64_t instance_num, int64_t instance_size, int64_t k, bool sorted, const T* in,
+              int32_t* out, void* tmp);
+template<typename T>
+size_t HostTopKTmpBytes(int64_t instance_num, int64_t instance_size, int64_t k);
+
+}  // namespace oneflow
+
+#endif  // ONEFLOW_CORE_KERNEL_UTIL_HOST_RADIX_SORT_H_
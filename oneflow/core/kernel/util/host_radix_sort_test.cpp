@@ -0,0 +1,237 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "oneflow/core/kernel/util/host_radix_sort.h"
+#include "oneflow/core/common/benchmark_test_util.h"
+#include "oneflow/core/thread/thread_pool.h"
+#include <gtest/gtest.h>
+
+namespace oneflow {
+
+namespace test {
+
+namespace {
+
+// values in [-range / 4, range / 4] with a step of 1 / 4 for floating types, small ranges give
+// many ties
+template<typename T>
+std::vector<T> RandomData(int64_t elem_cnt, int64_t range) {
+  std::mt19937 gen(elem_cnt + range);
+  std::uniform_int_distribution<int64_t> dis(-range, range);
+  std::vector<T> data(elem_cnt);
+  for (T& v : data) { v = static_cast<T>(dis(gen)) / static_cast<T>(4); }
+  return data;
+}
+
+// like the radix keys, a NaN ranks beyond the infinity of its sign
+template<typename T>
+bool NaiveLess(T lhs, T rhs) {
+  const auto NaNRank = [](T v) -> int32_t {
+    return std::isnan(static_cast<double>(v)) ? (std::signbit(static_cast<double>(v)) ? -1 : 1) : 0;
+  };
+  if (NaNRank(lhs) != NaNRank(rhs)) { return NaNRank(lhs) < NaNRank(rhs); }
+  return NaNRank(lhs) == 0 && lhs < rhs;
+}
+
+template<typename T>
+std::vector<int32_t> NaiveArgSort(int64_t instance_num, int64_t instance_size, bool descending,
+                                  const std::vector<T>& in) {
+  std::vector<int32_t> indices(instance_num * instance_size);
+  FOR_RANGE(int64_t, row, 0, instance_num) {
+    const T* x = in.data() + row * instance_size;
+    int32_t* y = indices.data() + row * instance_size;
+    std::iota(y, y + instance_size, 0);
+    std::stable_sort(y, y + instance_size, [&](int32_t lhs, int32_t rhs) {
+      return descending ? NaiveLess(x[rhs], x[lhs]) : NaiveLess(x[lhs], x[rhs]);
+    });
+  }
+  return indices;
+}
+
+template<typename T>
+void TestSort(int64_t instance_num, int64_t instance_size, int64_t range) {
+  const int64_t elem_cnt = instance_num * instance_size;
+  const std::vector<T> in = RandomData<T>(elem_cnt, range);
+  for (const bool descending : {false, true}) {
+    const std::vector<int32_t> expected_indices =
+        NaiveArgSort(instance_num, instance_size, descending, in);
+    std::vector<T> expected(elem_cnt);
+    FOR_RANGE(int64_t, i, 0, elem_cnt) {
+      expected[i] = in[i / instance_size * instance_size + expected_indices[i]];
+    }
+    std::vector<T> out(elem_cnt);
+    std::vector<char> tmp(HostRadixSortTmpBytes<T>(instance_num, instance_size));
+    HostRadixSort<T>(instance_num, instance_size, descending, in.data(), out.data(), tmp.data());
+    ASSERT_TRUE(out == expected);
+    std::vector<int32_t> indices(elem_cnt);
+    tmp.resize(HostRadixArgSortTmpBytes<T>(instance_num, instance_size));
+    HostRadixArgSort<T>(instance_num, instance_size, descending, in.data(), indices.data(),
+                        tmp.data());
+    ASSERT_TRUE(indices == expected_indices);
+  }
+}
+
+template<typename T>
+void TestTopK(int64_t instance_num, int64_t instance_size, int64_t k, const std::vector<T>& in) {
+  const std::vector<int32_t> sorted_indices = NaiveArgSort(instance_num, instance_size, true, in);
+  std::vector<int32_t> expected(instance_num * k);
+  FOR_RANGE(int64_t, row, 0, instance_num) {
+    std::copy(sorted_indices.begin() + row * instance_size,
+              sorted_indices.begin() + row * instance_size + k, expected.begin() + row * k);
+  }
+  std::vector<char> tmp(HostTopKTmpBytes<T>(instance_num, instance_size, k));
+  for (const bool sorted : {true, false}) {
+    std::vector<int32_t> out(instance_num * k);
+    HostTopK<T>(instance_num, instance_size, k, sorted, in.data(), out.data(), tmp.data());
+    if (!sorted) {
+      FOR_RANGE(int64_t, row, 0, instance_num) {
+        std::sort(out.begin() + row * k, out.begin() + (row + 1) * k);
+        std::sort(expected.begin() + row * k, expected.begin() + (row + 1) * k);
+      }
+    }
+    ASSERT_TRUE(out == expected);
+  }
+}
+
+template<typename T>
+void TestTopK(int64_t instance_num, int64_t instance_size, int64_t k, int64_t range) {
+  TestTopK<T>(instance_num, instance_size, k, RandomData<T>(instance_num * instance_size, range));
+}
+
+// NaNs and infinities of both signs sprinkled over random data
+template<typename T>
+void TestTopKWithNaN(int64_t instance_num, int64_t instance_size, int64_t k) {
+  std::vector<T> in = RandomData<T>(instance_num * instance_size, 100);
+  const T nan = std::numeric_limits<T>::quiet_NaN();
+  const T inf = std::numeric_limits<T>::infinity();
+  FOR_RANGE(size_t, i, 0, in.size()) {
+    if (i % 7 == 3) {
+      in[i] = nan;
+    } else if (i % 11 == 5) {
+      in[i] = -nan;
+    } else if (i % 13 == 1) {
+      in[i] = inf;
+    } else if (i % 17 == 2) {
+      in[i] = -inf;
+    }
+  }
+  TestTopK<T>(instance_num, instance_size, k, in);
+}
+
+template<typename T>
+void TestCommonSortCases() {
+  TestSort<T>(1, 1, 10);
+  TestSort<T>(5, 17, 10);
+  TestSort<T>(3, 1000, 4);
+  TestSort<T>(7, 3000, 1 << 20);
+  TestSort<T>(2, 4096, 0);
+}
+
+template<typename T>
+void TestCommonTopKCases() {
+  TestTopK<T>(4, 7, 3, 10);
+  TestTopK<T>(6, 1000, 1, 100);
+  TestTopK<T>(6, 1000, 10, 3);
+  TestTopK<T>(3, 5000, 300, 1 << 20);
+  TestTopK<T>(3, 5000, 300, 20);
+  TestTopK<T>(2, 1000, 1000, 1000);
+}
+
+}  // namespace
+
+TEST(HostRadixSort, sort_float) { TestCommonSortCases<float>(); }
+
+TEST(HostRadixSort, sort_double) { TestCommonSortCases<double>(); }
+
+TEST(HostRadixSort, sort_int32) { TestCommonSortCases<int32_t>(); }
+
+TEST(HostRadixSort, sort_int64) { TestCommonSortCases<int64_t>(); }
+
+TEST(HostRadixSort, top_k_float) { TestCommonTopKCases<float>(); }
+
+TEST(HostRadixSort, top_k_double) { TestCommonTopKCases<double>(); }
+
+TEST(HostRadixSort, top_k_nan) {
+  for (const int64_t k : {1, 5, 60, 300}) {
+    TestTopKWithNaN<float>(3, 1000, k);
+    TestTopKWithNaN<double>(3, 1000, k);
+  }
+}
+
+TEST(HostRadixSort, top_k_int32) { TestCommonTopKCases<int32_t>(); }
+
+TEST(HostRadixSort, top_k_int64) { TestCommonTopKCases<int64_t>(); }
+
+TEST(HostRadixSort, multi_thread) {
+  Global<ThreadPool>::New(4);
+  TestSort<float>(64, 2048, 1 << 20);
+  TestSort<float>(2, 300000, 1 << 20);
+  TestSort<int64_t>(1, 200000, 50);
+  TestTopK<float>(64, 2048, 16, 1 << 20);
+  TestTopK<float>(2, 300000, 5, 1 << 20);
+  TestTopK<float>(1, 300000, 2000, 1 << 20);
+  TestTopK<int32_t>(1, 300000, 100, 30);
+  Global<ThreadPool>::Delete();
+}
+
+TEST(HostRadixSort, DISABLED_benchmark) {
+  Global<ThreadPool>::New(std::max<int32_t>(std::thread::hardware_concurrency(), 1));
+  struct Case {
+    int64_t instance_num;
+    int64_t instance_size;
+    int64_t k;
+  };
+  const std::vector<Case> cases = {{256, 4096, 10}, {4, 1 << 20, 100}, {1, 1 << 22, 1000}};
+  for (const Case& c : cases) {
+    const int64_t elem_cnt = c.instance_num * c.instance_size;
+    const std::vector<float> in = RandomData<float>(elem_cnt, 1 << 24);
+    std::vector<float> out(elem_cnt);
+    std::vector<int32_t> indices(elem_cnt);
+    std::vector<char> tmp(std::max(HostRadixSortTmpBytes<float>(c.instance_num, c.instance_size),
+                                   HostTopKTmpBytes<float>(c.instance_num, c.instance_size, c.k)));
+    const double std_sort_ms = BenchmarkMilliseconds([&]() {
+      out = in;
+      FOR_RANGE(int64_t, row, 0, c.instance_num) {
+        std::sort(out.begin() + row * c.instance_size, out.begin() + (row + 1) * c.instance_size);
+      }
+    });
+    const double radix_sort_ms = BenchmarkMilliseconds([&]() {
+      HostRadixSort<float>(c.instance_num, c.instance_size, false, in.data(), out.data(),
+                           tmp.data());
+    });
+    const double nth_element_ms = BenchmarkMilliseconds([&]() {
+      FOR_RANGE(int64_t, row, 0, c.instance_num) {
+        const float* x = in.data() + row * c.instance_size;
+        int32_t* y = indices.data() + row * c.instance_size;
+        std::iota(y, y + c.instance_size, 0);
+        std::nth_element(y, y + c.k, y + c.instance_size,
+                         [&](int32_t lhs, int32_t rhs) { return x[lhs] > x[rhs]; });
+        std::sort(y, y + c.k, [&](int32_t lhs, int32_t rhs) { return x[lhs] > x[rhs]; });
+      }
+    });
+    const double top_k_ms = BenchmarkMilliseconds([&]() {
+      HostTopK<float>(c.instance_num, c.instance_size, c.k, true, in.data(), indices.data(),
+                      tmp.data());
+    });
+    LOG(INFO) << "HostRadixSort " << c.instance_num << "x" << c.instance_size << ": std::sort "
+              << std_sort_ms << " ms, radix sort " << radix_sort_ms << " ms; top " << c.k
+              << ": nth_element " << nth_element_ms << " ms, HostTopK " << top_k_ms << " ms";
+  }
+  Global<ThreadPool>::Delete();
+}
+
+}  // namespace test
+
+}  // namespace oneflow
@@ -0,0 +1,139 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "oneflow/core/kernel/util/host_simd_util.h"
+#include "oneflow/core/common/cpu_isa.h"
+#ifdef OF_CPU_ISA_DISPATCH
+#include <immintrin.h>
+#endif
+
+namespace oneflow {
+
+namespace {
+
+template<typename T>
+void AddScalar(int64_t n, const T* a, const T* b, T* out) {
+  FOR_RANGE(int64_t, i, 0, n) { out[i] = a[i] + b[i]; }
+}
+
+#ifdef OF_CPU_ISA_DISPATCH
+
+// Every simd variant is generated from one body: VecT is the register type, kWidth the number of
+// lanes and Load / Add / Store the matching intrinsics. Both lanes are loaded before anything is
+// stored, so out may alias a or b.
+#define DEFINE_SIMD_ADD(isa_attr, func_name, T, VecT, kWidth, Load, Add, Store) \
+  isa_attr void func_name(int64_t n, const T* a, const T* b, T* out) {          \
+    int64_t i = 0;                                                              \
+    for (; i + 2 * kWidth <= n; i += 2 * kWidth) {                              \
+      const VecT out0 = Add(Load(a + i), Load(b + i));                          \
+      const VecT out1 = Add(Load(a + i + kWidth), Load(b + i + kWidth));        \
+      Store(out + i, out0);                                                     \
+      Store(out + i + kWidth, out1);                                            \
+    }                                                                           \
+    for (; i < n; ++i) { out[i] = a[i] + b[i]; }                                \
+  }
+
+#define LOAD_SI256(p) _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p))
+#define STORE_SI256(p, v) _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v)
+#define LOAD_SI512(p) _mm512_loadu_si512(reinterpret_cast<const void*>(p))
+#define STORE_SI512(p, v) _mm512_storeu_si512(reinterpret_cast<void*>(p), v)
+
+DEFINE_SIMD_ADD(OF_TARGET_AVX2, AddAvx2, float, __m256, 8, _mm256_loadu_ps, _mm256_add_ps,
+                _mm256_storeu_ps)
+DEFINE_SIMD_ADD(OF_TARGET_AVX2, AddAvx2, double, __m256d, 4, _mm256_loadu_pd, _mm256_add_pd,
+                _mm256_storeu_pd)
+DEFINE_SIMD_ADD(OF_TARGET_AVX2, AddAvx2, int32_t, __m256i, 8, LOAD_SI256, _mm256_add_epi32,
+                STORE_SI256)
+DEFINE_SIMD_ADD(OF_TARGET_AVX2, AddAvx2, int64_t, __m256i, 4, LOAD_SI256, _mm256_add_epi64,
+                STORE_SI256)
+DEFINE_SIMD_ADD(OF_TARGET_AVX512, AddAvx512, float, __m512, 16, _mm512_loadu_ps, _mm512_add_ps,
+                _mm512_storeu_ps)
+DEFINE_SIMD_ADD(OF_TARGET_AVX512, AddAvx512, double, __m512d, 8, _mm512_loadu_pd, _mm512_add_pd,
+                _mm512_storeu_pd)
+DEFINE_SIMD_ADD(OF_TARGET_AVX512, AddAvx512, int32_t, __m512i, 16, LOAD_SI512, _mm512_add_epi32,
+                STORE_SI512)
+DEFINE_SIMD_ADD(OF_TARGET_AVX512, AddAvx512, int64_t, __m512i, 8, LOAD_SI512, _mm512_add_epi64,
+                STORE_SI512)
+
+#undef STORE_SI512
+#undef LOAD_SI512
+#undef STORE_SI256
+#undef LOAD_SI256
+#undef DEFINE_SIMD_ADD
+
+#endif  // OF_CPU_ISA_DISPATCH
+
+template<typename T>
+using AddFunc = void (*)(int64_t, const T*, const T*, T*);
+
+template<typename T>
+AddFunc<T> SelectAddFunc() {
+#ifdef OF_CPU_ISA_DISPATCH
+  switch (GetCpuIsa()) {
+    case CpuIsa::kAvx512: return static_cast<AddFunc<T>>(&AddAvx512);
+    case CpuIsa::kAvx2: return static_cast<AddFunc<T>>(&AddAvx2);
+    default: break;
+  }
+#endif
+  return &AddScalar<T>;
+}
+
+}  // namespace
+
+#define SPECIALIZE_HOST_SIMD_ADD(T)                                \
+  template<>                                                       \
+  void HostSimdAdd<T>(int64_t n, const T* a, const T* b, T* out) { \
+    static const AddFunc<T> add_func = SelectAddFunc<T>();         \
+    add_func(n, a, b, out);                                        \
+  }                                                                \
+  template<>                                                       \
+  void HostSimdAdd<T>(int64_t n, const T* x, T* y) {               \
+    HostSimdAdd<T>(n, y, x, y);                                    \
+  }
+SPECIALIZE_HOST_SIMD_ADD(float)
+SPECIALIZE_HOST_SIMD_ADD(double)
+SPECIALIZE_HOST_SIMD_ADD(int32_t)
+SPECIALIZE_HOST_SIMD_ADD(int64_t)
+#undef SPECIALIZE_HOST_SIMD_ADD
+
+void HostNonTemporalMemcpy(void* dst, const void* src, size_t count) {
+#ifdef OF_CPU_ISA_DISPATCH
+  // Streaming stores are sse2, which every x86-64 cpu has, so there is nothing to dispatch on.
+  // Write-combining works on whole cache lines: align dst first and move 64 bytes per iteration.
+  char* dst_ptr = static_cast<char*>(dst);
+  const char* src_ptr = static_cast<const char*>(src);
+  const size_t misalignment = reinterpret_cast<uintptr_t>(dst_ptr) % 16;
+  const size_t head = std::min<size_t>(misalignment == 0 ? 0 : 16 - misalignment, count);
+  std::memcpy(dst_ptr, src_ptr, head);
+  size_t i = head;
+  for (; i + 64 <= count; i += 64) {
+    const __m128i v0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src_ptr + i));
+    const __m128i v1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src_ptr + i + 16));
+    const __m128i v2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src_ptr + i + 32));
+    const __m128i v3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src_ptr + i + 48));
+    _mm_stream_si128(reinterpret_cast<__m128i*>(dst_ptr + i), v0);
+    _mm_stream_si128(reinterpret_cast<__m128i*>(dst_ptr + i + 16), v1);
+    _mm_stream_si128(reinterpret_cast<__m128i*>(dst_ptr + i + 32), v2);
+    _mm_stream_si128(reinterpret_cast<__m128i*>(dst_ptr + i + 48), v3);
+  }
+  // Streaming stores are weakly ordered, fence before anyone else may look at dst.
+  _mm_sfence();
+  std::memcpy(dst_ptr + i, src_ptr + i, count - i);
+#else
+  std::memcpy(dst, src, count);
+#endif
+}
+
+}  // namespace oneflow
@@ -0,0 +1,60 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#ifndef ONEFLOW_CORE_KERNEL_UTIL_HOST_SIMD_UTIL_H_
+#define ONEFLOW_CORE_KERNEL_UTIL_HOST_SIMD_UTIL_H_
+
+#include "oneflow/core/common/util.h"
+
+namespace oneflow {
+
+// y[i] += x[i] for i in [0, n). float, double, int32_t and int64_t use avx2 / avx-512 code paths
+// picked at runtime by GetCpuIsa(), other types fall back to a plain loop.
+template<typename T>
+void HostSimdAdd(int64_t n, const T* x, T* y) {
+  FOR_RANGE(int64_t, i, 0, n) { y[i] += x[i]; }
+}
+
+template<>
+void HostSimdAdd<float>(int64_t n, const float* x, float* y);
+template<>
+void HostSimdAdd<double>(int64_t n, const double* x, double* y);
+template<>
+void HostSimdAdd<int32_t>(int64_t n, const int32_t* x, int32_t* y);
+template<>
+void HostSimdAdd<int64_t>(int64_t n, const int64_t* x, int64_t* y);
+
+// out[i] = a[i] + b[i] for i in [0, n), out may alias a or b. Same dispatch as above.
+template<typename T>
+void HostSimdAdd(int64_t n, const T* a, const T* b, T* out) {
+  FOR_RANGE(int64_t, i, 0, n) { out[i] = a[i] + b[i]; }
+}
+
+template<>
+void HostSimdAdd<float>(int64_t n, const float* a, const float* b, float* out);
+template<>
+void HostSimdAdd<double>(int64_t n, const double* a, const double* b, double* out);
+template<>
+void HostSimdAdd<int32_t>(int64_t n, const int32_t* a, const int32_t* b, int32_t* out);
+template<>
+void HostSimdAdd<int64_t>(int64_t n, const int64_t* a, const int64_t* b, int64_t* out);
+
+// memcpy whose stores bypass the cache hierarchy. Only worth it for copies well beyond the size of
+// the last level cache whose destination is not read back soon, e.g. large boxing outputs.
+void HostNonTemporalMemcpy(void* dst, const void* src, size_t count);
+
+}  // namespace oneflow
+
+#endif  // ONEFLOW_CORE_KERNEL_UTIL_HOST_SIMD_UTIL_H_
@@ -0,0 +1,65 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "oneflow/core/kernel/util/host_simd_util.h"
+#include <gtest/gtest.h>
+
+namespace oneflow {
+
+namespace test {
+
+namespace {
+
+// Lengths around the widest unrolled step (2 x 16 lanes) exercise the simd body and the tail.
+template<typename T>
+void TestHostSimdAdd() {
+  for (const int64_t n : {0, 1, 7, 8, 15, 16, 31, 32, 33, 63, 64, 65, 1000}) {
+    std::vector<T> a(n);
+    std::vector<T> b(n);
+    std::vector<T> expected(n);
+    FOR_RANGE(int64_t, i, 0, n) {
+      a[i] = static_cast<T>(i % 17) - 8;
+      b[i] = static_cast<T>(i % 5) * 3;
+      expected[i] = a[i] + b[i];
+    }
+    std::vector<T> out(n);
+    HostSimdAdd<T>(n, a.data(), b.data(), out.data());
+    ASSERT_TRUE(out == expected) << "n " << n;
+    // y += x
+    std::vector<T> y = b;
+    HostSimdAdd<T>(n, a.data(), y.data());
+    ASSERT_TRUE(y == expected) << "n " << n;
+    // out aliasing a
+    std::vector<T> aliased = a;
+    HostSimdAdd<T>(n, aliased.data(), b.data(), aliased.data());
+    ASSERT_TRUE(aliased == expected) << "n " << n;
+  }
+}
+
+}  // namespace
+
+TEST(HostSimdAdd, float) { TestHostSimdAdd<float>(); }
+
+TEST(HostSimdAdd, double) { TestHostSimdAdd<double>(); }
+
+TEST(HostSimdAdd, int32) { TestHostSimdAdd<int32_t>(); }
+
+TEST(HostSimdAdd, int64) { TestHostSimdAdd<int64_t>(); }
+
+TEST(HostSimdAdd, int8) { TestHostSimdAdd<int8_t>(); }
+
+}  // namespace test
+
+}  // namespace oneflow
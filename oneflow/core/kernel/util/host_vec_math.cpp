@@ -0,0 +1,537 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "oneflow/core/kernel/util/host_vec_math.h"
+#include "oneflow/core/common/cpu_isa.h"
+
+namespace oneflow {
+
+namespace {
+
+// Generic simd vectors of 4, 8 and 16 lanes. The approximations are written once against them and
+// inlined into entry points compiled for the baseline isa, avx2 and avx-512.
+typedef float Float4 __attribute__((vector_size(16)));
+typedef int32_t Int4 __attribute__((vector_size(16)));
+typedef float Float8 __attribute__((vector_size(32)));
+typedef int32_t Int8 __attribute__((vector_size(32)));
+typedef float Float16 __attribute__((vector_size(64)));
+typedef int32_t Int16 __attribute__((vector_size(64)));
+
+template<typename F>
+struct IntVec;
+
+template<>
+struct IntVec<Float4> {
+  using type = Int4;
+};
+
+template<>
+struct IntVec<Float8> {
+  using type = Int8;
+};
+
+template<>
+struct IntVec<Float16> {
+  using type = Int16;
+};
+
+#define OF_VEC_INLINE inline __attribute__((always_inline))
+
+// Helpers returning wide vectors are always inlined into the entry points compiled for the matching
+// isa, the abi change gcc warns about never applies.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wpsabi"
+#endif
+
+constexpr float kInf = std::numeric_limits<float>::infinity();
+constexpr float kNaN = std::numeric_limits<float>::quiet_NaN();
+// adding and subtracting 1.5 * 2^23 rounds a float with |x| < 2^22 to the nearest integer, the
+// bits of the sum minus kRoundMagicBits are that integer
+constexpr float kRoundMagic = 12582912.0f;
+constexpr int32_t kRoundMagicBits = 0x4B400000;
+
+template<typename F>
+OF_VEC_INLINE F Broadcast(float v) {
+  return F{} + v;
+}
+
+template<typename F, typename I = typename IntVec<F>::type>
+OF_VEC_INLINE F Select(const I& mask, const F& a, const F& b) {
+  return (F)((mask & (I)a) | (~mask & (I)b));
+}
+
+template<typename F>
+OF_VEC_INLINE F Min(const F& a, const F& b) {
+  return Select(a < b, a, b);
+}
+
+template<typename F>
+OF_VEC_INLINE F Max(const F& a, const F& b) {
+  return Select(a > b, a, b);
+}
+
+template<typename F, typename I = typename IntVec<F>::type>
+OF_VEC_INLINE F Abs(const F& x) {
+  return (F)((I)x & 0x7fffffff);
+}
+
+template<typename F, typename I = typename IntVec<F>::type>
+OF_VEC_INLINE F CopySign(const F& magnitude, const F& sign) {
+  return (F)((I)magnitude | ((I)sign & static_cast<int32_t>(0x80000000)));
+}
+
+// Cephes expf: x = n * ln2 + r with |r| <= ln2 / 2, exp(r) from a degree 6 polynomial
+template<typename F, typename I = typename IntVec<F>::type>
+OF_VEC_INLINE F VecExp(const F& input) {
+  // below -104 the result underflows to zero, above 89 it overflows to inf
+  const F x = Max(Min(input, Broadcast<F>(89.0f)), Broadcast<F>(-104.0f));
+  const F shifted = x * 1.44269504088896341f + kRoundMagic;
+  const F n = shifted - kRoundMagic;
+  const I n_int = (I)shifted - kRoundMagicBits;
+  // ln2 is split in two so that n * ln2 is exact
+  F r = x - n * 0.693359375f;
+  r = r + n * 2.12194440e-4f;
+  const F z = r * r;
+  F p = 1.9875691500e-4f * r + 1.3981999507e-3f;
+  p = p * r + 8.3334519073e-3f;
+  p = p * r + 4.1665795894e-2f;
+  p = p * r + 1.6666665459e-1f;
+  p = p * r + 5.0000001201e-1f;
+  p = p * z + r + 1.0f;
+  // 2^n is applied in two halves, so results close to overflow and denormal results are formed
+  // from normal scale factors
+  const I n_hi = n_int >> 1;
+  const I n_lo = n_int - n_hi;
+  const F result = p * (F)((n_hi + 127) << 23) * (F)((n_lo + 127) << 23);
+  return Select(input != input, input, result);
+}
+
+// Cephes logf: x = m * 2^e with m in [sqrt(0.5), sqrt(2)), log(m) from a degree 8 polynomial
+template<typename F, typename I = typename IntVec<F>::type>
+OF_VEC_INLINE F VecLog(const F& input) {
+  const I denormal = input < std::numeric_limits<float>::min();
+  const F x = Select(denormal, input * 8388608.0f, input);
+  const I bits = (I)x;
+  const I e_int = ((bits >> 23) & 0xff) - 126;
+  F e = ((F)(e_int + kRoundMagicBits) - kRoundMagic)
+        - Select(denormal, Broadcast<F>(23.0f), Broadcast<F>(0.0f));
+  F m = (F)((bits & 0x007fffff) | 0x3f000000);
+  const I below_sqrt_half = m < 0.707106781186547524f;
+  e = e - Select(below_sqrt_half, Broadcast<F>(1.0f), Broadcast<F>(0.0f));
+  m = (m - 1.0f) + Select(below_sqrt_half, m, Broadcast<F>(0.0f));
+  const F z = m * m;
+  F p = 7.0376836292e-2f * m - 1.1514610310e-1f;
+  p = p * m + 1.1676998740e-1f;
+  p = p * m - 1.2420140846e-1f;
+  p = p * m + 1.4249322787e-1f;
+  p = p * m - 1.6668057665e-1f;
+  p = p * m + 2.0000714765e-1f;
+  p = p * m - 2.4999993993e-1f;
+  p = p * m + 3.3333331174e-1f;
+  F y = p * m * z;
+  y = y - 2.12194440e-4f * e;
+  y = y - 0.5f * z;
+  F result = (m + y) + 0.693359375f * e;
+  result = Select(input == kInf, input, result);
+  result = Select(input == 0.0f, Broadcast<F>(-kInf), result);
+  // negative inputs and nans
+  return Select(input >= 0.0f, result, Broadcast<F>(kNaN));
+}
+
+// Cephes tanhf below |x| = 0.625, 1 - 2 / (exp(2 |x|) + 1) above
+template<typename F>
+OF_VEC_INLINE F VecTanh(const F& x) {
+  const F abs_x = Abs(x);
+  const F z = x * x;
+  F p = -5.70498872745e-3f * z + 2.06390887954e-2f;
+  p = p * z - 5.37397155531e-2f;
+  p = p * z + 1.33314422036e-1f;
+  p = p * z - 3.33332819422e-1f;
+  const F small = p * z * x + x;
+  const F large = CopySign(1.0f - 2.0f / (VecExp(abs_x + abs_x) + 1.0f), x);
+  return Select(abs_x < 0.625f, small, large);
+}
+
+// 1 / (1 + exp(-x)) for x >= 0, exp(x) / (1 + exp(x)) otherwise, so that the result keeps its
+// relative accuracy down to the denormals
+template<typename F>
+OF_VEC_INLINE F VecSigmoid(const F& x) {
+  const F e = VecExp(-Abs(x));
+  const F r = 1.0f / (1.0f + e);
+  return Select(x < 0.0f, e * r, r);
+}
+
+// exp(c - s * b * b) for b >= 0, small c and s in {0.5, 1}. b * b is split into
+// m * m + (b - m) * (b + m) with m = b rounded to 1/16: m * m is exact and the rounding error of
+// the small rest stays far below the precision of the result, unlike that of b * b for large b.
+template<typename F>
+OF_VEC_INLINE F VecExpNegSquare(const F& b, float s, const F& c) {
+  const F m = ((b * 16.0f + kRoundMagic) - kRoundMagic) * 0.0625f;
+  return VecExp(c - s * ((b - m) * (b + m))) * VecExp(-s * (m * m));
+}
+
+// Taylor series of erf up to x^15, used for |x| < 0.5 where the truncation error is below 1e-10
+template<typename F>
+OF_VEC_INLINE F VecErfSeries(const F& x) {
+  const F z = x * x;
+  F p = -1.492565035840625e-05f * z + 1.2055332981789664e-04f;
+  p = p * z - 8.548327023450852e-04f;
+  p = p * z + 5.223977625442188e-03f;
+  p = p * z - 2.6866170645131252e-02f;
+  p = p * z + 1.1283791670955126e-01f;
+  p = p * z - 3.7612638903183754e-01f;
+  p = p * z + 1.1283791670955126f;
+  return p * x;
+}
+
+// erfc(scale * x) with scale * scale == square in {0.5, 1}. The scaled argument is only used for
+// the smooth parts, exp(-(scale * x)^2) is computed from x so that scaling does not cost
+// precision in the tails. Away from zero erfc(|a|) comes from the Chebyshev fit of Numerical
+// Recipes (relative error below 1.2e-7), erfc(a) = 2 - erfc(-a) for negative a, and near zero
+// 1 - erf(a) from the series.
+template<typename F>
+OF_VEC_INLINE F VecScaledErfc(const F& x, float scale, float square) {
+  const F scaled = x * scale;
+  const F b = Min(Abs(x), Broadcast<F>(16.0f / std::abs(scale)));
+  const F t = 1.0f / (1.0f + 0.5f * std::abs(scale) * b);
+  F p = 0.17087277f * t - 0.82215223f;
+  p = p * t + 1.48851587f;
+  p = p * t - 1.13520398f;
+  p = p * t + 0.27886807f;
+  p = p * t - 0.18628806f;
+  p = p * t + 0.09678418f;
+  p = p * t + 0.37409196f;
+  p = p * t + 1.00002368f;
+  p = p * t - 1.26551223f;
+  const F tail = t * VecExpNegSquare(b, square, p);
+  const F large = Select(scaled < 0.0f, 2.0f - tail, tail);
+  return Select(Abs(scaled) < 0.5f, 1.0f - VecErfSeries(scaled), large);
+}
+
+template<typename F>
+OF_VEC_INLINE F VecErf(const F& x) {
+  const F abs_x = Abs(x);
+  const F large = CopySign(1.0f - VecScaledErfc(abs_x, 1.0f, 1.0f), x);
+  const F result = Select(abs_x < 0.5f, VecErfSeries(x), large);
+  return Select(x != x, x, result);
+}
+
+constexpr double kSqrtHalf = 0.7071067811865476;
+constexpr double kInvSqrt2Pi = 0.3989422804014327;
+
+struct ExpOp {
+  template<typename F>
+  static OF_VEC_INLINE F Apply(const F& x) {
+    return VecExp(x);
+  }
+  static double Apply(double x) { return std::exp(x); }
+};
+
+struct LogOp {
+  template<typename F>
+  static OF_VEC_INLINE F Apply(const F& x) {
+    return VecLog(x);
+  }
+  static double Apply(double x) { return std::log(x); }
+};
+
+struct TanhOp {
+  template<typename F>
+  static OF_VEC_INLINE F Apply(const F& x) {
+    return VecTanh(x);
+  }
+  static double Apply(double x) { return std::tanh(x); }
+};
+
+struct SigmoidOp {
+  template<typename F>
+  static OF_VEC_INLINE F Apply(const F& x) {
+    return VecSigmoid(x);
+  }
+  static double Apply(double x) { return 1.0 / (1.0 + std::exp(-x)); }
+};
+
+struct ErfOp {
+  template<typename F>
+  static OF_VEC_INLINE F Apply(const F& x) {
+    return VecErf(x);
+  }
+  static double Apply(double x) { return std::erf(x); }
+};
+
+struct GeluOp {
+  template<typename F>
+  static OF_VEC_INLINE F Apply(const F& x) {
+    return 0.5f * x * VecScaledErfc(x, static_cast<float>(-kSqrtHalf), 0.5f);
+  }
+  static double Apply(double x) { return 0.5 * x * std::erfc(-kSqrtHalf * x); }
+};
+
+struct GeluGradOp {
+  template<typename F>
+  static OF_VEC_INLINE F Apply(const F& x, const F& dy) {
+    const F cdf = 0.5f * VecScaledErfc(x, static_cast<float>(-kSqrtHalf), 0.5f);
+    const F pdf = VecExpNegSquare(Min(Abs(x), Broadcast<F>(20.0f)), 0.5f, F{})
+                  * static_cast<float>(kInvSqrt2Pi);
+    return dy * (cdf + x * pdf);
+  }
+  static double Apply(double x, double dy) {
+    return dy * (0.5 * std::erfc(-kSqrtHalf * x) + x * std::exp(-0.5 * x * x) * kInvSqrt2Pi);
+  }
+};
+
+// Full vectors are loaded unaligned, the tail is padded with zeros and goes through the same
+// approximation so that every element gets the same rounding.
+template<typename F, typename Op>
+OF_VEC_INLINE void ApplyVec(int64_t n, const float* x, float* y) {
+  constexpr int64_t kWidth = sizeof(F) / sizeof(float);
+  int64_t i = 0;
+  for (; i + kWidth <= n; i += kWidth) {
+    F v;
+    std::memcpy(&v, x + i, sizeof(F));
+    const F r = Op::Apply(v);
+    std::memcpy(y + i, &r, sizeof(F));
+  }
+  if (i < n) {
+    F v = F{};
+    std::memcpy(&v, x + i, (n - i) * sizeof(float));
+    const F r = Op::Apply(v);
+    std::memcpy(y + i, &r, (n - i) * sizeof(float));
+  }
+}
+
+template<typename F, typename Op>
+OF_VEC_INLINE void ApplyVec(int64_t n, const float* x, const float* dy, float* dx) {
+  constexpr int64_t kWidth = sizeof(F) / sizeof(float);
+  int64_t i = 0;
+  for (; i + kWidth <= n; i += kWidth) {
+    F v;
+    F g;
+    std::memcpy(&v, x + i, sizeof(F));
+    std::memcpy(&g, dy + i, sizeof(F));
+    const F r = Op::Apply(v, g);
+    std::memcpy(dx + i, &r, sizeof(F));
+  }
+  if (i < n) {
+    F v = F{};
+    F g = F{};
+    std::memcpy(&v, x + i, (n - i) * sizeof(float));
+    std::memcpy(&g, dy + i, (n - i) * sizeof(float));
+    const F r = Op::Apply(v, g);
+    std::memcpy(dx + i, &r, (n - i) * sizeof(float));
+  }
+}
+
+template<typename Op>
+void UnaryBaseline(int64_t n, const float* x, float* y) {
+  ApplyVec<Float4, Op>(n, x, y);
+}
+
+template<typename Op>
+void BinaryBaseline(int64_t n, const float* x, const float* dy, float* dx) {
+  ApplyVec<Float4, Op>(n, x, dy, dx);
+}
+
+#ifdef OF_CPU_ISA_DISPATCH
+
+template<typename Op>
+OF_TARGET_AVX2 void UnaryAvx2(int64_t n, const float* x, float* y) {
+  ApplyVec<Float8, Op>(n, x, y);
+}
+
+template<typename Op>
+OF_TARGET_AVX2 void BinaryAvx2(int64_t n, const float* x, const float* dy, float* dx) {
+  ApplyVec<Float8, Op>(n, x, dy, dx);
+}
+
+template<typename Op>
+OF_TARGET_AVX512 void UnaryAvx512(int64_t n, const float* x, float* y) {
+  ApplyVec<Float16, Op>(n, x, y);
+}
+
+template<typename Op>
+OF_TARGET_AVX512 void BinaryAvx512(int64_t n, const float* x, const float* dy, float* dx) {
+  ApplyVec<Float16, Op>(n, x, dy, dx);
+}
+
+#endif  // OF_CPU_ISA_DISPATCH
+
+using UnaryFunc = void (*)(int64_t, const float*, float*);
+using BinaryFunc = void (*)(int64_t, const float*, const float*, float*);
+
+template<typename Op>
+UnaryFunc SelectUnaryFunc(CpuIsa isa) {
+#ifdef OF_CPU_ISA_DISPATCH
+  switch (isa) {
+    case CpuIsa::kAvx512: return &UnaryAvx512<Op>;
+    case CpuIsa::kAvx2: return &UnaryAvx2<Op>;
+    default: break;
+  }
+#endif
+  return &UnaryBaseline<Op>;
+}
+
+template<typename Op>
+BinaryFunc SelectBinaryFunc(CpuIsa isa) {
+#ifdef OF_CPU_ISA_DISPATCH
+  switch (isa) {
+    case CpuIsa::kAvx512: return &BinaryAvx512<Op>;
+    case CpuIsa::kAvx2: return &BinaryAvx2<Op>;
+    default: break;
+  }
+#endif
+  return &BinaryBaseline<Op>;
+}
+
+template<typename Op>
+void Unary(int64_t n, const float* x, float* y) {
+  static const UnaryFunc func = SelectUnaryFunc<Op>(GetCpuIsa());
+  func(n, x, y);
+}
+
+template<typename Op>
+void Unary(CpuIsa isa, int64_t n, const float* x, float* y) {
+  CHECK_LE(static_cast<int32_t>(isa), static_cast<int32_t>(GetCpuIsa()));
+  SelectUnaryFunc<Op>(isa)(n, x, y);
+}
+
+template<typename Op>
+void Unary(int64_t n, const double* x, double* y) {
+  FOR_RANGE(int64_t, i, 0, n) { y[i] = Op::Apply(x[i]); }
+}
+
+template<typename Op>
+void Unary(CpuIsa isa, int64_t n, const double* x, double* y) {
+  Unary<Op>(n, x, y);
+}
+
+template<typename Op>
+void Binary(int64_t n, const float* x, const float* dy, float* dx) {
+  static const BinaryFunc func = SelectBinaryFunc<Op>(GetCpuIsa());
+  func(n, x, dy, dx);
+}
+
+template<typename Op>
+void Binary(CpuIsa isa, int64_t n, const float* x, const float* dy, float* dx) {
+  CHECK_LE(static_cast<int32_t>(isa), static_cast<int32_t>(GetCpuIsa()));
+  SelectBinaryFunc<Op>(isa)(n, x, dy, dx);
+}
+
+template<typename Op>
+void Binary(int64_t n, const double* x, const double* dy, double* dx) {
+  FOR_RANGE(int64_t, i, 0, n) { dx[i] = Op::Apply(x[i], dy[i]); }
+}
+
+template<typename Op>
+void Binary(CpuIsa isa, int64_t n, const double* x, const double* dy, double* dx) {
+  Binary<Op>(n, x, dy, dx);
+}
+
+#undef OF_VEC_INLINE
+
+}  // namespace
+
+template<typename T>
+void HostVecExp(int64_t n, const T* x, T* y) {
+  Unary<ExpOp>(n, x, y);
+}
+
+template<typename T>
+void HostVecExp(CpuIsa isa, int64_t n, const T* x, T* y) {
+  Unary<ExpOp>(isa, n, x, y);
+}
+
+template<typename T>
+void HostVecLog(int64_t n, const T* x, T* y) {
+  Unary<LogOp>(n, x, y);
+}
+
+template<typename T>
+void HostVecLog(CpuIsa isa, int64_t n, const T* x, T* y) {
+  Unary<LogOp>(isa, n, x, y);
+}
+
+template<typename T>
+void HostVecTanh(int64_t n, const T* x, T* y) {
+  Unary<TanhOp>(n, x, y);
+}
+
+template<typename T>
+void HostVecTanh(CpuIsa isa, int64_t n, const T* x, T* y) {
+  Unary<TanhOp>(isa, n, x, y);
+}
+
+template<typename T>
+void HostVecSigmoid(int64_t n, const T* x, T* y) {
+  Unary<SigmoidOp>(n, x, y);
+}
+
+template<typename T>
+void HostVecSigmoid(CpuIsa isa, int64_t n, const T* x, T* y) {
+  Unary<SigmoidOp>(isa, n, x, y);
+}
+
+template<typename T>
+void HostVecErf(int64_t n, const T* x, T* y) {
+  Unary<ErfOp>(n, x, y);
+}
+
+template<typename T>
+void HostVecErf(CpuIsa isa, int64_t n, const T* x, T* y) {
+  Unary<ErfOp>(isa, n, x, y);
+}
+
+template<typename T>
+void HostVecGelu(int64_t n, const T* x, T* y) {
+  Unary<GeluOp>(n, x, y);
+}
+
+template<typename T>
+void HostVecGelu(CpuIsa isa, int64_t n, const T* x, T* y) {
+  Unary<GeluOp>(isa, n, x, y);
+}
+
+template<typename T>
+void HostVecGeluGrad(int64_t n, const T* x, const T* dy, T* dx) {
+  Binary<GeluGradOp>(n, x, dy, dx);
+}
+
+template<typename T>
+void HostVecGeluGrad(CpuIsa isa, int64_t n, const T* x, const T* dy, T* dx) {
+  Binary<GeluGradOp>(isa, n, x, dy, dx);
+}
+
+#define INSTANTIATE_HOST_VEC_MATH(T)                                           \
+  template void HostVecExp<T>(int64_t n, const T* x, T* y);                    \
+  template void HostVecLog<T>(int64_t n, const T* x, T* y);                    \
+  template void HostVecTanh<T>(int64_t n, const T* x, T* y);                   \
+  template void HostVecSigmoid<T>(int64_t n, const T* x, T* y);                \
+  template void HostVecErf<T>(int64_t n, const T* x, T* y);                    \
+  template void HostVecGelu<T>(int64_t n, const T* x, T* y);                   \
+  template void HostVecGeluGrad<T>(int64_t n, const T* x, const T* dy, T* dx); \
+  template void HostVecExp<T>(CpuIsa isa, int64_t n, const T* x, T* y);        \
+  template void HostVecLog<T>(CpuIsa isa, int64_t n, const T* x, T* y);        \
+  template void HostVecTanh<T>(CpuIsa isa, int64_t n, const T* x, T* y);       \
+  template void HostVecSigmoid<T>(CpuIsa isa, int64_t n, const T* x, T* y);    \
+  template void HostVecErf<T>(CpuIsa isa, int64_t n, const T* x, T* y);        \
+  template void HostVecGelu<T>(CpuIsa isa, int64_t n, const T* x, T* y);       \
+  template void HostVecGeluGrad<T>(CpuIsa isa, int64_t n, const T* x, const T* dy, T* dx);
+
+INSTANTIATE_HOST_VEC_MATH(float)
+INSTANTIATE_HOST_VEC_MATH(double)
+
+#undef INSTANTIATE_HOST_VEC_MATH
+
+}  // namespace oneflow
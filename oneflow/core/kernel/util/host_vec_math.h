@@ -0,0 +1,77 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#ifndef ONEFLOW_CORE_KERNEL_UTIL_HOST_VEC_MATH_H_
+#define ONEFLOW_CORE_KERNEL_UTIL_HOST_VEC_MATH_H_
+
+#include "oneflow/core/common/util.h"
+#include "oneflow/core/common/cpu_isa.h"
+
+namespace oneflow {
+
+// Elementwise math over [0, n) on the calling thread, y may alias x. float uses polynomial
+// approximations evaluated on avx-512, avx2 or baseline simd registers picked at runtime by
+// GetCpuIsa(); their error against the correctly rounded result is a few ulp (see
+// host_vec_math_test.cpp), denormals, infinities and nans follow <cmath>. double calls <cmath>.
+template<typename T>
+void HostVecExp(int64_t n, const T* x, T* y);
+
+template<typename T>
+void HostVecLog(int64_t n, const T* x, T* y);
+
+template<typename T>
+void HostVecTanh(int64_t n, const T* x, T* y);
+
+template<typename T>
+void HostVecSigmoid(int64_t n, const T* x, T* y);
+
+template<typename T>
+void HostVecErf(int64_t n, const T* x, T* y);
+
+// y = 0.5 * x * (1 + erf(x / sqrt(2))), evaluated through erfc so that large negative x keeps
+// its relative accuracy
+template<typename T>
+void HostVecGelu(int64_t n, const T* x, T* y);
+
+// dx = dy * (0.5 * (1 + erf(x / sqrt(2))) + x * exp(-x * x / 2) / sqrt(2 * pi))
+template<typename T>
+void HostVecGeluGrad(int64_t n, const T* x, const T* dy, T* dx);
+
+// Same as above with the float code paths of isa, which must not be wider than GetCpuIsa(). Lets
+// tests hold every code path the cpu supports to the same reference.
+template<typename T>
+void HostVecExp(CpuIsa isa, int64_t n, const T* x, T* y);
+
+template<typename T>
+void HostVecLog(CpuIsa isa, int64_t n, const T* x, T* y);
+
+template<typename T>
+void HostVecTanh(CpuIsa isa, int64_t n, const T* x, T* y);
+
+template<typename T>
+void HostVecSigmoid(CpuIsa isa, int64_t n, const T* x, T* y);
+
+template<typename T>
+void HostVecErf(CpuIsa isa, int64_t n, const T* x, T* y);
+
+template<typename T>
+void HostVecGelu(CpuIsa isa, int64_t n, const T* x, T* y);
+
+template<typename T>
+void HostVecGeluGrad(CpuIsa isa, int64_t n, const T* x, const T* dy, T* dx);
+
+}  // namespace oneflow
+
+#endif  // ONEFLOW_CORE_KERNEL_UTIL_HOST_VEC_MATH_H_
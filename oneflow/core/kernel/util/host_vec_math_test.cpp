@@ -0,0 +1,255 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "oneflow/core/kernel/util/host_vec_math.h"
+#include "oneflow/core/common/benchmark_test_util.h"
+#include "oneflow/core/common/cpu_isa.h"
+#include <gtest/gtest.h>
+
+namespace oneflow {
+
+namespace test {
+
+namespace {
+
+int64_t UlpDistance(float lhs, float rhs) {
+  auto OrderedBits = [](float v) {
+    int32_t bits;
+    std::memcpy(&bits, &v, sizeof(bits));
+    return bits < 0 ? static_cast<int64_t>(std::numeric_limits<int32_t>::min()) - bits
+                    : static_cast<int64_t>(bits);
+  };
+  return std::abs(OrderedBits(lhs) - OrderedBits(rhs));
+}
+
+std::vector<float> LinearPoints(float lower, float upper, int64_t num) {
+  std::vector<float> points(num);
+  FOR_RANGE(int64_t, i, 0, num) { points[i] = lower + (upper - lower) * i / (num - 1); }
+  return points;
+}
+
+// every positive float from the denormals to the largest finite value, at a fixed bit stride
+std::vector<float> PositivePoints(int32_t stride) {
+  std::vector<float> points;
+  for (int32_t bits = 1; bits < 0x7f800000; bits += stride) {
+    float v;
+    std::memcpy(&v, &bits, sizeof(v));
+    points.push_back(v);
+  }
+  return points;
+}
+
+using HostVecUnaryFunc = void (*)(int64_t, const float*, float*);
+using HostVecIsaUnaryFunc = void (*)(CpuIsa, int64_t, const float*, float*);
+
+// the scalar fallback and every wider isa up to the one GetCpuIsa() picks
+std::vector<CpuIsa> SupportedCpuIsas() {
+  std::vector<CpuIsa> isas;
+  FOR_RANGE(int32_t, isa, 0, static_cast<int32_t>(GetCpuIsa()) + 1) {
+    isas.push_back(static_cast<CpuIsa>(isa));
+  }
+  return isas;
+}
+
+// max ulp error of Func on points against the double precision Reference rounded to float,
+// results below min_abs are compared with an absolute tolerance of min_abs instead
+int64_t MaxUlpError(HostVecIsaUnaryFunc Func, CpuIsa isa,
+                    const std::function<double(double)>& Reference,
+                    const std::vector<float>& points, double min_abs) {
+  std::vector<float> y(points.size());
+  Func(isa, points.size(), points.data(), y.data());
+  int64_t max_ulp = 0;
+  FOR_RANGE(size_t, i, 0, points.size()) {
+    const double expected = Reference(points[i]);
+    if (std::abs(expected) < min_abs) {
+      EXPECT_LE(std::abs(y[i] - expected), min_abs) << points[i];
+    } else {
+      max_ulp = std::max(max_ulp, UlpDistance(y[i], static_cast<float>(expected)));
+    }
+  }
+  return max_ulp;
+}
+
+double Gelu(double x) { return 0.5 * x * std::erfc(-x / std::sqrt(2.0)); }
+
+double GeluGrad(double x) {
+  return 0.5 * std::erfc(-x / std::sqrt(2.0)) + x * std::exp(-0.5 * x * x) / std::sqrt(2 * M_PI);
+}
+
+double Sigmoid(double x) { return 1.0 / (1.0 + std::exp(-x)); }
+
+}  // namespace
+
+TEST(HostVecMath, exp) {
+  const auto Exp = [](double x) { return std::exp(x); };
+  const std::vector<float> points = LinearPoints(-103.9f, 88.7f, 1 << 20);
+  for (const CpuIsa isa : SupportedCpuIsas()) {
+    SCOPED_TRACE(static_cast<int32_t>(isa));
+    EXPECT_LE(MaxUlpError(&HostVecExp<float>, isa, Exp, points, 0), 2);
+  }
+}
+
+TEST(HostVecMath, log) {
+  const auto Log = [](double x) { return std::log(x); };
+  const std::vector<float> positive_points = PositivePoints(997);
+  const std::vector<float> points = LinearPoints(0.5f, 2.0f, 1 << 20);
+  for (const CpuIsa isa : SupportedCpuIsas()) {
+    SCOPED_TRACE(static_cast<int32_t>(isa));
+    EXPECT_LE(MaxUlpError(&HostVecLog<float>, isa, Log, positive_points, 0), 2);
+    EXPECT_LE(MaxUlpError(&HostVecLog<float>, isa, Log, points, 0), 2);
+  }
+}
+
+TEST(HostVecMath, tanh) {
+  const auto Tanh = [](double x) { return std::tanh(x); };
+  const std::vector<float> points = LinearPoints(-10.0f, 10.0f, 1 << 20);
+  const std::vector<float> positive_points = PositivePoints(997);
+  for (const CpuIsa isa : SupportedCpuIsas()) {
+    SCOPED_TRACE(static_cast<int32_t>(isa));
+    EXPECT_LE(MaxUlpError(&HostVecTanh<float>, isa, Tanh, points, 0), 3);
+    EXPECT_LE(MaxUlpError(&HostVecTanh<float>, isa, Tanh, positive_points, 0), 3);
+  }
+}
+
+TEST(HostVecMath, sigmoid) {
+  const std::vector<float> points = LinearPoints(-100.0f, 30.0f, 1 << 20);
+  for (const CpuIsa isa : SupportedCpuIsas()) {
+    SCOPED_TRACE(static_cast<int32_t>(isa));
+    EXPECT_LE(MaxUlpError(&HostVecSigmoid<float>, isa, Sigmoid, points, 0), 3);
+  }
+}
+
+TEST(HostVecMath, erf) {
+  const auto Erf = [](double x) { return std::erf(x); };
+  const std::vector<float> points = LinearPoints(-5.0f, 5.0f, 1 << 20);
+  const std::vector<float> positive_points = PositivePoints(997);
+  for (const CpuIsa isa : SupportedCpuIsas()) {
+    SCOPED_TRACE(static_cast<int32_t>(isa));
+    EXPECT_LE(MaxUlpError(&HostVecErf<float>, isa, Erf, points, 0), 4);
+    EXPECT_LE(MaxUlpError(&HostVecErf<float>, isa, Erf, positive_points, 0), 4);
+  }
+}
+
+TEST(HostVecMath, gelu) {
+  const std::vector<float> points = LinearPoints(-12.0f, 12.0f, 1 << 20);
+  for (const CpuIsa isa : SupportedCpuIsas()) {
+    SCOPED_TRACE(static_cast<int32_t>(isa));
+    EXPECT_LE(MaxUlpError(&HostVecGelu<float>, isa, Gelu, points, 0), 8);
+  }
+}
+
+TEST(HostVecMath, gelu_grad) {
+  const std::vector<float> x = LinearPoints(-12.0f, 12.0f, 1 << 20);
+  const std::vector<float> dy(x.size(), 1.0f);
+  std::vector<float> dx(x.size());
+  for (const CpuIsa isa : SupportedCpuIsas()) {
+    SCOPED_TRACE(static_cast<int32_t>(isa));
+    HostVecGeluGrad<float>(isa, x.size(), x.data(), dy.data(), dx.data());
+    FOR_RANGE(size_t, i, 0, x.size()) { ASSERT_NEAR(dx[i], GeluGrad(x[i]), 1e-6) << x[i]; }
+  }
+}
+
+TEST(HostVecMath, special_values) {
+  const float inf = std::numeric_limits<float>::infinity();
+  const float nan = std::numeric_limits<float>::quiet_NaN();
+  const std::vector<float> x = {inf, -inf, nan, 0.0f, -1.0f, 1e-45f, 100.0f, -200.0f, 3.0f};
+  std::vector<float> y(x.size());
+  for (const CpuIsa isa : SupportedCpuIsas()) {
+    SCOPED_TRACE(static_cast<int32_t>(isa));
+    HostVecExp<float>(isa, x.size(), x.data(), y.data());
+    EXPECT_EQ(y[0], inf);
+    EXPECT_EQ(y[1], 0.0f);
+    EXPECT_TRUE(std::isnan(y[2]));
+    EXPECT_EQ(y[6], inf);
+    EXPECT_EQ(y[7], 0.0f);
+    HostVecLog<float>(isa, x.size(), x.data(), y.data());
+    EXPECT_EQ(y[0], inf);
+    EXPECT_TRUE(std::isnan(y[1]));
+    EXPECT_TRUE(std::isnan(y[2]));
+    EXPECT_EQ(y[3], -inf);
+    EXPECT_TRUE(std::isnan(y[4]));
+    EXPECT_NEAR(y[5], std::log(static_cast<double>(x[5])), 1e-4);
+    HostVecTanh<float>(isa, x.size(), x.data(), y.data());
+    EXPECT_EQ(y[0], 1.0f);
+    EXPECT_EQ(y[1], -1.0f);
+    EXPECT_TRUE(std::isnan(y[2]));
+    HostVecSigmoid<float>(isa, x.size(), x.data(), y.data());
+    EXPECT_EQ(y[0], 1.0f);
+    EXPECT_EQ(y[1], 0.0f);
+    EXPECT_TRUE(std::isnan(y[2]));
+    HostVecErf<float>(isa, x.size(), x.data(), y.data());
+    EXPECT_EQ(y[0], 1.0f);
+    EXPECT_EQ(y[1], -1.0f);
+    EXPECT_TRUE(std::isnan(y[2]));
+    EXPECT_EQ(y[3], 0.0f);
+  }
+}
+
+TEST(HostVecMath, default_isa) {
+  // the entry points without an isa run the code path of GetCpuIsa()
+  const std::vector<float> x = LinearPoints(-8.0f, 8.0f, 4097);
+  std::vector<float> y(x.size());
+  std::vector<float> expected(x.size());
+  HostVecGelu<float>(x.size(), x.data(), y.data());
+  HostVecGelu<float>(GetCpuIsa(), x.size(), x.data(), expected.data());
+  ASSERT_TRUE(y == expected);
+}
+
+TEST(HostVecMath, double) {
+  const std::vector<float> points = LinearPoints(-4.0f, 4.0f, 1001);
+  const std::vector<double> x(points.begin(), points.end());
+  std::vector<double> y(x.size());
+  HostVecExp<double>(x.size(), x.data(), y.data());
+  FOR_RANGE(size_t, i, 0, x.size()) { ASSERT_DOUBLE_EQ(y[i], std::exp(x[i])); }
+  HostVecGelu<double>(x.size(), x.data(), y.data());
+  FOR_RANGE(size_t, i, 0, x.size()) { ASSERT_NEAR(y[i], Gelu(x[i]), 1e-15); }
+}
+
+TEST(HostVecMath, DISABLED_benchmark) {
+  const int64_t n = 1 << 22;
+  const std::vector<float> x = LinearPoints(-8.0f, 8.0f, n);
+  const std::vector<float> positive_x = LinearPoints(1e-3f, 1e3f, n);
+  std::vector<float> y(n);
+  struct Case {
+    std::string name;
+    HostVecUnaryFunc vec_func;
+    std::function<float(float)> std_func;
+    const std::vector<float>* x;
+  };
+  const std::vector<Case> cases = {
+      {"exp", &HostVecExp<float>, [](float v) { return std::exp(v); }, &x},
+      {"log", &HostVecLog<float>, [](float v) { return std::log(v); }, &positive_x},
+      {"tanh", &HostVecTanh<float>, [](float v) { return std::tanh(v); }, &x},
+      {"sigmoid", &HostVecSigmoid<float>, [](float v) { return 1.0f / (1.0f + std::exp(-v)); },
+       &x},
+      {"erf", &HostVecErf<float>, [](float v) { return std::erf(v); }, &x},
+      {"gelu", &HostVecGelu<float>,
+       [](float v) { return 0.5f * v * (1.0f + std::erf(v * 0.70710678f)); }, &x},
+  };
+  for (const Case& c : cases) {
+    const float* in = c.x->data();
+    const double std_ms = BenchmarkMilliseconds([&]() {
+      FOR_RANGE(int64_t, i, 0, n) { y[i] = c.std_func(in[i]); }
+    });
+    const double vec_ms = BenchmarkMilliseconds([&]() { c.vec_func(n, in, y.data()); });
+    LOG(INFO) << "HostVecMath " << c.name << " (isa " << static_cast<int32_t>(GetCpuIsa())
+              << "): <cmath> " << n / (std_ms * 1e3) << " M/s, simd " << n / (vec_ms * 1e3)
+              << " M/s";
+  }
+}
+
+}  // namespace test
+
+}  // namespace oneflow
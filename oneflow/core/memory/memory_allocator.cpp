@@ -28,7 +28,9 @@ void* MemoryAllocatorImpl::Allocate(MemoryCase mem_case, size_t size) {
   void* ptr = nullptr;
   if (mem_case.has_host_mem()) {
     if (mem_case.host_mem().has_cuda_pinned_mem()) {
-      if (Global<ResourceDesc, ForSession>::Get()->enable_numa_aware_cuda_malloc_host()) {
+      const ResourceDesc* resource_desc = Global<ResourceDesc, ForSession>::Get();
+      if (resource_desc->enable_numa_aware_cuda_malloc_host()
+          || resource_desc->thread_placement_conf().bind_gpu_threads_to_local_numa_node()) {
         NumaAwareCudaMallocHost(mem_case.host_mem().cuda_pinned_mem().device_id(), &ptr, size);
       } else {
         CudaCheck(cudaMallocHost(&ptr, size));
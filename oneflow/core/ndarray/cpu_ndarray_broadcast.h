@@ -0,0 +1,90 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#ifndef ONEFLOW_CORE_NDARRAY_CPU_NDARRAY_BROADCAST_H_
+#define ONEFLOW_CORE_NDARRAY_CPU_NDARRAY_BROADCAST_H_
+
+#include "oneflow/core/ndarray/xpu_shape.h"
+#include "oneflow/core/thread/thread_manager.h"
+
+namespace oneflow {
+
+// Element strides of x seen through the shape of y it is broadcast to, 0 on the broadcast axes
+template<int NDIMS>
+void InitBroadcastStrides(const XpuShape& y_shape, const XpuShape& x_shape,
+                          int64_t strides[NDIMS]) {
+  FOR_RANGE(int, i, 0, NDIMS) {
+    if (x_shape.At(i) == y_shape.At(i)) {
+      strides[i] = x_shape.DimElemNum(i);
+    } else {
+      CHECK_EQ(x_shape.At(i), 1);
+      strides[i] = 0;
+    }
+  }
+}
+
+template<int NDIMS>
+bool IsInnermostAxisBroadcast(const int64_t strides[NDIMS]) {
+  return strides[NDIMS - 1] == 0;
+}
+
+// Calls DoEachRow(y_offset, operand_offsets, n) for the pieces of innermost rows covering the
+// elements [begin, end) of y. Only the first element is located by div/mod, the following rows
+// advance the coordinate counter and the operand offsets incrementally, so callers are left with a
+// plain unit-stride inner loop over n elements.
+template<int NDIMS, int NUM_OPERANDS, typename DoEachRowT>
+void ForEachBroadcastRow(const XpuShape& y_shape, const int64_t strides[NUM_OPERANDS][NDIMS],
+                         int64_t begin, int64_t end, const DoEachRowT& DoEachRow) {
+  if (begin >= end) { return; }
+  const int64_t row_size = y_shape.At(NDIMS - 1);
+  int64_t coord[NDIMS];
+  y_shape.Offset2Coordinate<NDIMS>(begin, coord);
+  int64_t offsets[NUM_OPERANDS];
+  FOR_RANGE(int, k, 0, NUM_OPERANDS) {
+    offsets[k] = 0;
+    FOR_RANGE(int, i, 0, NDIMS) { offsets[k] += coord[i] * strides[k][i]; }
+  }
+  int64_t y_offset = begin;
+  while (y_offset < end) {
+    const int64_t n = std::min(row_size - coord[NDIMS - 1], end - y_offset);
+    DoEachRow(y_offset, static_cast<const int64_t*>(offsets), n);
+    y_offset += n;
+    FOR_RANGE(int, k, 0, NUM_OPERANDS) { offsets[k] -= coord[NDIMS - 1] * strides[k][NDIMS - 1]; }
+    coord[NDIMS - 1] = 0;
+    for (int i = NDIMS - 2; i >= 0; --i) {
+      FOR_RANGE(int, k, 0, NUM_OPERANDS) { offsets[k] += strides[k][i]; }
+      if (++coord[i] < y_shape.At(i)) { break; }
+      FOR_RANGE(int, k, 0, NUM_OPERANDS) { offsets[k] -= strides[k][i] * y_shape.At(i); }
+      coord[i] = 0;
+    }
+  }
+}
+
+// ForEachBroadcastRow over all of y, with the elements split across the thread pool when there is
+// enough work. Splitting elements rather than rows keeps a few long rows parallel too.
+template<int NDIMS, int NUM_OPERANDS, typename DoEachRowT>
+void ParallelForEachBroadcastRow(const XpuShape& y_shape,
+                                 const int64_t strides[NUM_OPERANDS][NDIMS],
+                                 int64_t bytes_per_elem, const DoEachRowT& DoEachRow) {
+  MultiThreadLoop(y_shape.ElemNum(), MultiThreadLoopGrainSize(bytes_per_elem),
+                  [&](int64_t begin, int64_t end) {
+                    ForEachBroadcastRow<NDIMS, NUM_OPERANDS>(y_shape, strides, begin, end,
+                                                             DoEachRow);
+                  });
+}
+
+}  // namespace oneflow
+
+#endif  // ONEFLOW_CORE_NDARRAY_CPU_NDARRAY_BROADCAST_H_
@@ -0,0 +1,184 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "oneflow/core/ndarray/ndarray_apply_broadcast_binary.h"
+#include "oneflow/core/common/benchmark_test_util.h"
+#include "oneflow/core/ndarray/ndarray_apply_broadcast_unary.h"
+#include "oneflow/core/thread/thread_pool.h"
+#include <gtest/gtest.h>
+
+namespace oneflow {
+
+namespace test {
+
+namespace {
+
+int64_t BroadcastOffset(const Shape& y_shape, const Shape& x_shape, int64_t y_offset) {
+  int64_t x_offset = 0;
+  FOR_RANGE(int64_t, i, 0, y_shape.NumAxes()) {
+    const int64_t coord = y_offset / y_shape.Count(i + 1) % y_shape.At(i);
+    x_offset = x_offset * x_shape.At(i) + (x_shape.At(i) == 1 ? 0 : coord);
+  }
+  return x_offset;
+}
+
+std::vector<float> MakeData(const Shape& shape, int64_t seed) {
+  std::vector<float> data(shape.elem_cnt());
+  FOR_RANGE(int64_t, i, 0, data.size()) { data[i] = static_cast<float>((i * 7 + seed) % 13 - 6); }
+  return data;
+}
+
+template<template<typename> class binary_func>
+void TestBroadcastBinary(const DimVector& a_dim, const DimVector& b_dim) {
+  using RetT = typename BinaryFuncTrait<binary_func, float>::return_type;
+  const Shape a_shape(a_dim);
+  const Shape b_shape(b_dim);
+  DimVector y_dim(a_dim.size());
+  FOR_RANGE(int64_t, i, 0, y_dim.size()) { y_dim[i] = std::max(a_dim[i], b_dim[i]); }
+  const Shape y_shape(y_dim);
+  const std::vector<float> a = MakeData(a_shape, 1);
+  const std::vector<float> b = MakeData(b_shape, 5);
+  std::vector<RetT> expected(y_shape.elem_cnt());
+  FOR_RANGE(int64_t, i, 0, expected.size()) {
+    expected[i] = binary_func<float>::Invoke(a[BroadcastOffset(y_shape, a_shape, i)],
+                                             b[BroadcastOffset(y_shape, b_shape, i)]);
+  }
+  std::vector<RetT> y(y_shape.elem_cnt());
+  NdarrayApplyBroadcastBinary<DeviceType::kCPU, float, binary_func>::Apply(
+      nullptr, XpuVarNdarray<RetT>(y_shape, y.data()),
+      XpuVarNdarray<const float>(a_shape, a.data()), XpuVarNdarray<const float>(b_shape, b.data()));
+  ASSERT_TRUE(expected == y);
+}
+
+void TestBroadcastInplaceAdd(const DimVector& y_dim, const DimVector& x_dim) {
+  const Shape y_shape(y_dim);
+  const Shape x_shape(x_dim);
+  std::vector<float> y = MakeData(y_shape, 3);
+  const std::vector<float> x = MakeData(x_shape, 4);
+  std::vector<float> expected(y);
+  FOR_RANGE(int64_t, i, 0, expected.size()) {
+    expected[i] += x[BroadcastOffset(y_shape, x_shape, i)];
+  }
+  NdarrayApplyBroadcastBinary<DeviceType::kCPU, float, BinaryFuncAdd>::InplaceApply(
+      nullptr, XpuVarNdarray<float>(y_shape, y.data()),
+      XpuVarNdarray<const float>(x_shape, x.data()));
+  ASSERT_TRUE(expected == y);
+}
+
+void TestBroadcastNegative(const DimVector& y_dim, const DimVector& x_dim) {
+  const Shape y_shape(y_dim);
+  const Shape x_shape(x_dim);
+  const std::vector<float> x = MakeData(x_shape, 2);
+  std::vector<float> expected(y_shape.elem_cnt());
+  FOR_RANGE(int64_t, i, 0, expected.size()) {
+    expected[i] = -x[BroadcastOffset(y_shape, x_shape, i)];
+  }
+  std::vector<float> y(y_shape.elem_cnt());
+  NdarrayApplyBroadcastUnary<DeviceType::kCPU, float, UnaryFuncNegative>::Apply(
+      nullptr, XpuVarNdarray<float>(y_shape, y.data()),
+      XpuVarNdarray<const float>(x_shape, x.data()));
+  ASSERT_TRUE(expected == y);
+}
+
+}  // namespace
+
+TEST(CpuNdarrayBroadcast, binary) {
+  TestBroadcastBinary<BinaryFuncSub>({2, 3, 4}, {1, 1, 4});
+  TestBroadcastBinary<BinaryFuncSub>({2, 3, 4}, {2, 3, 1});
+  TestBroadcastBinary<BinaryFuncSub>({2, 3, 1}, {2, 3, 4});
+  TestBroadcastBinary<BinaryFuncSub>({2, 3, 4}, {1, 1, 1});
+  TestBroadcastBinary<BinaryFuncSub>({2, 1, 4}, {1, 3, 1});
+  TestBroadcastBinary<BinaryFuncMul>({2, 1, 5, 1}, {1, 3, 1, 6});
+  TestBroadcastBinary<BinaryFuncMax>({3, 1, 4, 1, 2}, {3, 5, 4, 2, 1});
+  TestBroadcastBinary<BinaryFuncGT>({4, 1, 7}, {1, 6, 7});
+  TestBroadcastBinary<BinaryFuncAdd>({0, 3}, {0, 1});
+}
+
+TEST(CpuNdarrayBroadcast, inplace_binary) {
+  TestBroadcastInplaceAdd({2, 3, 4}, {1, 3, 1});
+  TestBroadcastInplaceAdd({2, 3, 4}, {2, 1, 4});
+  TestBroadcastInplaceAdd({5, 6}, {1, 1});
+}
+
+TEST(CpuNdarrayBroadcast, unary) {
+  TestBroadcastNegative({3, 4}, {1, 4});
+  TestBroadcastNegative({3, 4}, {3, 1});
+  TestBroadcastNegative({2, 3, 4}, {2, 1, 4});
+}
+
+TEST(CpuNdarrayBroadcast, multi_thread) {
+  Global<ThreadPool>::New(4);
+  TestBroadcastBinary<BinaryFuncAdd>({1}, {1 << 20});
+  TestBroadcastBinary<BinaryFuncAdd>({32, 64, 16, 16}, {1, 64, 1, 1});
+  TestBroadcastBinary<BinaryFuncSub>({512, 300}, {1, 300});
+  TestBroadcastBinary<BinaryFuncMul>({3000, 1}, {1, 70});
+  TestBroadcastBinary<BinaryFuncLT>({7, 1, 9000}, {7, 5, 1});
+  TestBroadcastInplaceAdd({64, 33, 50}, {64, 1, 50});
+  TestBroadcastNegative({1000, 100}, {1000, 1});
+  Global<ThreadPool>::Delete();
+}
+
+TEST(CpuNdarrayBroadcast, DISABLED_benchmark) {
+  // Every case is a float add, written in 4 axes so that it can also be fed to the expression
+  // template path the cpu wrapper used before.
+  struct Case {
+    std::string name;
+    DimVector a_dim;
+    DimVector b_dim;
+  };
+  const std::vector<Case> cases = {
+      {"bias_add_nchw", {32, 64, 56, 56}, {1, 64, 1, 1}},
+      {"bias_add_nhwc", {32, 56, 56, 64}, {1, 1, 1, 64}},
+      {"row", {1, 1, 4096, 1024}, {1, 1, 1, 1024}},
+      {"column", {1, 1, 4096, 1024}, {1, 1, 4096, 1}},
+      {"scalar", {1, 1, 1, 1 << 22}, {1, 1, 1, 1}},
+      {"outer", {1, 1, 2048, 1}, {1, 1, 1, 2048}},
+  };
+  const int32_t thread_num = std::max<int32_t>(std::thread::hardware_concurrency(), 1);
+  for (const Case& c : cases) {
+    const Shape a_shape(c.a_dim);
+    const Shape b_shape(c.b_dim);
+    DimVector y_dim(c.a_dim.size());
+    FOR_RANGE(int64_t, i, 0, y_dim.size()) { y_dim[i] = std::max(c.a_dim[i], c.b_dim[i]); }
+    const Shape y_shape(y_dim);
+    const std::vector<float> a(a_shape.elem_cnt(), 1.0f);
+    const std::vector<float> b(b_shape.elem_cnt(), 2.0f);
+    std::vector<float> y(y_shape.elem_cnt());
+    const XpuVarNdarray<float> y_ndarray(y_shape, y.data());
+    const XpuVarNdarray<const float> a_ndarray(a_shape, a.data());
+    const XpuVarNdarray<const float> b_ndarray(b_shape, b.data());
+    const double expr_ms = BenchmarkMilliseconds([&]() {
+      NdarrayApplyBroadcastBinaryCore<float, 4, BinaryFuncAdd>::Apply(y_ndarray, a_ndarray,
+                                                                      b_ndarray);
+    });
+    const auto Run = [&]() {
+      NdarrayApplyBroadcastBinary<DeviceType::kCPU, float, BinaryFuncAdd>::Apply(
+          nullptr, y_ndarray, a_ndarray, b_ndarray);
+    };
+    const double single_thread_ms = BenchmarkMilliseconds(Run);
+    Global<ThreadPool>::New(thread_num);
+    const double multi_thread_ms = BenchmarkMilliseconds(Run);
+    Global<ThreadPool>::Delete();
+    const double bytes = (y_shape.elem_cnt() + a_shape.elem_cnt() + b_shape.elem_cnt()) * 4.0;
+    LOG(INFO) << "CpuNdarrayBroadcast " << c.name << ": expression template " << expr_ms
+              << " ms, single thread " << single_thread_ms << " ms, " << thread_num
+              << " threads " << multi_thread_ms << " ms, " << bytes / (multi_thread_ms * 1e6)
+              << " GB/s";
+  }
+}
+
+}  // namespace test
+
+}  // namespace oneflow
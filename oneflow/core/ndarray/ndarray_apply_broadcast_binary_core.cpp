@@ -14,15 +14,66 @@ See the License for the specific language governing permissions and
 limitations under the License.
 */
 #include "oneflow/core/ndarray/ndarray_apply_broadcast_binary_core.h"
+#include "oneflow/core/ndarray/cpu_ndarray_broadcast.h"
 
 namespace oneflow {
 
+namespace {
+
+// An operand whose innermost axis is broadcast contributes one scalar per row, which covers the
+// scalar-broadcast and column-broadcast cases. A row-broadcast operand keeps a contiguous
+// innermost axis and gets zero strides on the outer axes instead.
+template<typename T, int NDIMS, template<typename> class binary_func, bool is_a_innermost_broadcast,
+         bool is_b_innermost_broadcast>
+struct BroadcastBinaryRows final {
+  using RetT = typename BinaryFuncTrait<binary_func, T>::return_type;
+  static void Apply(const XpuShape& y_shape, const int64_t strides[2][NDIMS], RetT* y, const T* a,
+                    const T* b) {
+    const int64_t elem_bytes = sizeof(RetT) + 2 * sizeof(T);
+    ParallelForEachBroadcastRow<NDIMS, 2>(
+        y_shape, strides, elem_bytes, [&](int64_t y_offset, const int64_t* offsets, int64_t n) {
+          RetT* y_row = y + y_offset;
+          const T* a_row = a + offsets[0];
+          const T* b_row = b + offsets[1];
+          const T a_scalar = a_row[0];
+          const T b_scalar = b_row[0];
+          FOR_RANGE(int64_t, i, 0, n) {
+            y_row[i] = binary_func<T>::Invoke(is_a_innermost_broadcast ? a_scalar : a_row[i],
+                                              is_b_innermost_broadcast ? b_scalar : b_row[i]);
+          }
+        });
+  }
+};
+
+template<typename T, int NDIMS, template<typename> class binary_func>
+struct CpuBroadcastBinary final {
+  using RetT = typename BinaryFuncTrait<binary_func, T>::return_type;
+  using RowsFunc = void (*)(const XpuShape&, const int64_t[2][NDIMS], RetT*, const T*, const T*);
+
+  static void Apply(const XpuShape& y_shape, const int64_t strides[2][NDIMS], RetT* y,
+                    const T* a, const T* b) {
+    if (y_shape.ElemNum() == 0) { return; }
+    static const RowsFunc rows_funcs[2][2] = {
+        {&BroadcastBinaryRows<T, NDIMS, binary_func, false, false>::Apply,
+         &BroadcastBinaryRows<T, NDIMS, binary_func, false, true>::Apply},
+        {&BroadcastBinaryRows<T, NDIMS, binary_func, true, false>::Apply,
+         &BroadcastBinaryRows<T, NDIMS, binary_func, true, true>::Apply}};
+    rows_funcs[IsInnermostAxisBroadcast<NDIMS>(strides[0])]
+              [IsInnermostAxisBroadcast<NDIMS>(strides[1])](y_shape, strides, y, a, b);
+  }
+};
+
+}  // namespace
+
 template<typename T, int NDIMS, template<typename> class binary_func>
 struct NdarrayApplyBroadcastBinaryCoreWrapper<DeviceType::kCPU, T, NDIMS, binary_func> final {
   static void Apply(DeviceCtx* ctx,
                     const XpuVarNdarray<typename BinaryFuncTrait<binary_func, T>::return_type>& y,
                     const XpuVarNdarray<const T>& a, const XpuVarNdarray<const T>& b) {
-    NdarrayApplyBroadcastBinaryCore<T, NDIMS, binary_func>::Apply(y, a, b);
+    int64_t strides[2][NDIMS];
+    InitBroadcastStrides<NDIMS>(y.shape(), a.shape(), strides[0]);
+    InitBroadcastStrides<NDIMS>(y.shape(), b.shape(), strides[1]);
+    CpuBroadcastBinary<T, NDIMS, binary_func>::Apply(y.shape(), strides, y.ptr(), a.ptr(), b.ptr());
   }
 };
 
@@ -31,7 +82,10 @@ struct NdarrayApplyBroadcastInplaceBinaryCoreWrapper<DeviceType::kCPU, T, NDIMS,
     final {
   static void InplaceApply(DeviceCtx* ctx, const XpuVarNdarray<T>& y,
                            const XpuVarNdarray<const T>& x) {
-    NdarrayApplyBroadcastBinaryCore<T, NDIMS, binary_func>::InplaceApply(y, x);
+    int64_t strides[2][NDIMS];
+    InitBroadcastStrides<NDIMS>(y.shape(), y.shape(), strides[0]);
+    InitBroadcastStrides<NDIMS>(y.shape(), x.shape(), strides[1]);
+    CpuBroadcastBinary<T, NDIMS, binary_func>::Apply(y.shape(), strides, y.ptr(), y.ptr(), x.ptr());
   }
 };
 
@@ -14,13 +14,42 @@ See the License for the specific language governing permissions and
 limitations under the License.
 */
 #include "oneflow/core/ndarray/ndarray_apply_broadcast_unary_core.h"
+#include "oneflow/core/ndarray/cpu_ndarray_broadcast.h"
 
 namespace oneflow {
 
+namespace {
+
+template<typename T, int NDIMS, template<typename> class unary_func, bool is_x_innermost_broadcast>
+struct BroadcastUnaryRows final {
+  static void Apply(const XpuShape& y_shape, const int64_t strides[1][NDIMS], T* y, const T* x) {
+    ParallelForEachBroadcastRow<NDIMS, 1>(
+        y_shape, strides, 2 * sizeof(T), [&](int64_t y_offset, const int64_t* offsets, int64_t n) {
+          T* y_row = y + y_offset;
+          const T* x_row = x + offsets[0];
+          if (is_x_innermost_broadcast) {
+            const T y_val = unary_func<T>::Invoke(x_row[0]);
+            FOR_RANGE(int64_t, i, 0, n) { y_row[i] = y_val; }
+          } else {
+            FOR_RANGE(int64_t, i, 0, n) { y_row[i] = unary_func<T>::Invoke(x_row[i]); }
+          }
+        });
+  }
+};
+
+}  // namespace
+
 template<typename T, int NDIMS, template<typename> class unary_func>
 struct NdarrayApplyBroadcastUnaryCoreWrapper<DeviceType::kCPU, T, NDIMS, unary_func> final {
   static void Apply(DeviceCtx* ctx, const XpuVarNdarray<T>& y, const XpuVarNdarray<const T>& x) {
-    NdarrayApplyBroadcastUnaryCore<T, NDIMS, unary_func>::Apply(y, x);
+    if (y.shape().ElemNum() == 0) { return; }
+    int64_t strides[1][NDIMS];
+    InitBroadcastStrides<NDIMS>(y.shape(), x.shape(), strides[0]);
+    if (IsInnermostAxisBroadcast<NDIMS>(strides[0])) {
+      BroadcastUnaryRows<T, NDIMS, unary_func, true>::Apply(y.shape(), strides, y.ptr(), x.ptr());
+    } else {
+      BroadcastUnaryRows<T, NDIMS, unary_func, false>::Apply(y.shape(), strides, y.ptr(), x.ptr());
+    }
   }
 };
 
@@ -25,9 +25,12 @@ limitations under the License.
 namespace oneflow {
 
 struct OpInferCacheKey final {
-  const JobDesc* job_desc;
+  Symbol<JobConfigProto> job_conf_sym;
   Symbol<OperatorConf> op_conf_sym;
   Symbol<DTypeSignature> dtype_signature_sym;
+  // ops like reshape infer a different slice of the output on every parallel rank
+  int64_t parallel_id;
+  int64_t parallel_num;
   std::vector<Symbol<Shape>> ibn_idx2shape_sym;
 };
 
@@ -36,8 +39,9 @@ struct OpInferCacheValue final {
 };
 
 inline bool operator==(const OpInferCacheKey& lhs, const OpInferCacheKey& rhs) {
-  return lhs.job_desc == rhs.job_desc && lhs.op_conf_sym == rhs.op_conf_sym
+  return lhs.job_conf_sym == rhs.job_conf_sym && lhs.op_conf_sym == rhs.op_conf_sym
          && lhs.dtype_signature_sym == rhs.dtype_signature_sym
+         && lhs.parallel_id == rhs.parallel_id && lhs.parallel_num == rhs.parallel_num
          && lhs.ibn_idx2shape_sym == rhs.ibn_idx2shape_sym;
 }
 
@@ -53,14 +57,17 @@ template<>
 struct hash<oneflow::OpInferCacheKey> final {
   size_t operator()(const oneflow::OpInferCacheKey& op_infer_cache_key) const {
     using namespace oneflow;
-    size_t ibn_idx2shape_sym_hash_value = 0;
+    size_t hash_value = std::hash<Symbol<JobConfigProto>>()(op_infer_cache_key.job_conf_sym);
+    HashCombine(&hash_value, std::hash<Symbol<OperatorConf>>()(op_infer_cache_key.op_conf_sym));
+    HashCombine(&hash_value,
+                std::hash<Symbol<DTypeSignature>>()(op_infer_cache_key.dtype_signature_sym));
+    HashCombine(&hash_value, std::hash<int64_t>()(op_infer_cache_key.parallel_id));
+    HashCombine(&hash_value, std::hash<int64_t>()(op_infer_cache_key.parallel_num));
+    // combined in order, inputs of equal shapes must not cancel each other out
     for (const auto& shape_sym : op_infer_cache_key.ibn_idx2shape_sym) {
-      ibn_idx2shape_sym_hash_value ^= std::hash<Symbol<Shape>>()(shape_sym);
+      HashCombine(&hash_value, std::hash<Symbol<Shape>>()(shape_sym));
     }
-    return std::hash<const JobDesc*>()(op_infer_cache_key.job_desc)
-           ^ std::hash<Symbol<OperatorConf>>()(op_infer_cache_key.op_conf_sym)
-           ^ ibn_idx2shape_sym_hash_value
-           ^ std::hash<Symbol<DTypeSignature>>()(op_infer_cache_key.dtype_signature_sym);
+    return hash_value;
   }
 };
 
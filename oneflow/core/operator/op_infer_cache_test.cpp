@@ -0,0 +1,73 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include <gtest/gtest.h>
+#include "oneflow/core/operator/op_infer_cache.h"
+#include "oneflow/core/operator/operator.h"
+
+namespace oneflow {
+
+namespace test {
+
+namespace {
+
+JobConfigProto MakeJobConf(const std::vector<int64_t>& flag_ids) {
+  JobConfigProto job_conf;
+  job_conf.set_job_name("op_infer_cache_test");
+  for (int64_t flag_id : flag_ids) {
+    UserOpAttrVal val;
+    val.set_at_int64(flag_id);
+    (*job_conf.mutable_flag_name2flag_value())["flag_" + std::to_string(flag_id)] = val;
+  }
+  return job_conf;
+}
+
+OpInferCacheKey MakeKey(int64_t parallel_id, int64_t parallel_num) {
+  OpInferCacheKey key;
+  key.job_conf_sym = SymbolOf(MakeJobConf({0}));
+  OperatorConf op_conf;
+  op_conf.mutable_user_conf()->set_op_type_name("reshape");
+  key.op_conf_sym = SymbolOf(op_conf);
+  key.dtype_signature_sym = SymbolOf(DTypeSignature());
+  key.parallel_id = parallel_id;
+  key.parallel_num = parallel_num;
+  key.ibn_idx2shape_sym.push_back(SymbolOf(Shape({8, 6})));
+  return key;
+}
+
+}  // namespace
+
+TEST(OpInferCache, job_conf_hash_ignores_map_insertion_order) {
+  std::vector<int64_t> flag_ids;
+  FOR_RANGE(int64_t, i, 0, 64) { flag_ids.push_back(i); }
+  const JobConfigProto forward = MakeJobConf(flag_ids);
+  std::reverse(flag_ids.begin(), flag_ids.end());
+  const JobConfigProto backward = MakeJobConf(flag_ids);
+  ASSERT_EQ(std::hash<JobConfigProto>()(forward), std::hash<JobConfigProto>()(backward));
+  ASSERT_TRUE(SymbolOf(forward) == SymbolOf(backward));
+  ASSERT_NE(std::hash<JobConfigProto>()(forward), std::hash<JobConfigProto>()(MakeJobConf({0})));
+}
+
+TEST(OpInferCache, key_holds_parallel_rank) {
+  ASSERT_TRUE(MakeKey(1, 4) == MakeKey(1, 4));
+  ASSERT_EQ(std::hash<OpInferCacheKey>()(MakeKey(1, 4)),
+            std::hash<OpInferCacheKey>()(MakeKey(1, 4)));
+  ASSERT_TRUE(MakeKey(0, 4) != MakeKey(1, 4));
+  ASSERT_TRUE(MakeKey(0, 1) != MakeKey(0, 4));
+}
+
+}  // namespace test
+
+}  // namespace oneflow
@@ -476,9 +476,9 @@ namespace std {
 
 template<>
 struct hash<oneflow::OperatorConf> final {
-  size_t operator()(const oneflow::OperatorConf& op_conf) {
+  size_t operator()(const oneflow::OperatorConf& op_conf) const {
     std::string serialized;
-    op_conf.SerializeToString(&serialized);
+    oneflow::PbMessage2DeterministicString(op_conf, &serialized);
     return std::hash<std::string>()(serialized);
   }
 };
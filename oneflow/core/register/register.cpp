@@ -37,9 +37,9 @@ Regst::~Regst() {
 }
 
 Blob* Regst::GetBlobByLbi(const LogicalBlobId& lbi) {
-  auto it = lbi2blob_.find(lbi);
-  if (it != lbi2blob_.end()) {
-    return it->second.get();
+  const int64_t index = regst_desc_->GetBlobIndex4Lbi(lbi);
+  if (index != -1) {
+    return sorted_blobs_.at(index).get();
   } else if (lbi.is_packed_id()) {
     return packed_blob_.get();
   } else {
@@ -55,12 +55,12 @@ void Regst::set_regst_desc(const RtRegstDesc* regst_desc) {
 
 Blob* Regst::GetMutSoleBlob() {
   CHECK_EQ(GetBlobSize(), 1);
-  return lbi2blob_.begin()->second.get();
+  return sorted_blobs_.front().get();
 }
 
 const Blob* Regst::GetSoleBlob() const {
   CHECK_EQ(GetBlobSize(), 1);
-  return lbi2blob_.begin()->second.get();
+  return sorted_blobs_.front().get();
 }
 
 }  // namespace oneflow
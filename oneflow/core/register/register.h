@@ -51,8 +51,7 @@ class Regst final {
   Blob* GetBlobByLbi(const LogicalBlobId& lbi);
   const Blob* GetSoleBlob() const;
   Blob* GetMutSoleBlob();
-  int64_t GetBlobSize() const { return lbi2blob_.size(); }
-  const HashMap<LogicalBlobId, std::unique_ptr<Blob>>& lbi2blob() const { return lbi2blob_; }
+  int64_t GetBlobSize() const { return sorted_blobs_.size(); }
   Blob* packed_blob() { return packed_blob_.get(); }
   bool IsMaxCol() const { return col_id() == max_col_id(); }
   void* comm_net_token() const { return comm_net_token_; }
@@ -72,7 +71,8 @@ class Regst final {
   void* comm_net_token_;
   RegstStatus status_;
   const RtRegstDesc* regst_desc_;
-  HashMap<LogicalBlobId, std::unique_ptr<Blob>> lbi2blob_;
+  // in the order of regst_desc_->sorted_lbis()
+  std::vector<std::unique_ptr<Blob>> sorted_blobs_;
   std::unique_ptr<Blob> packed_blob_;
 };
 
@@ -161,7 +161,8 @@ void RegstMgr::NewBlobsInOneRegst(const std::vector<LbiBlobDescPair>& lbis, Regs
                                                       cur_body_pointer + body_offset));
           InitNonPODTypeBlobIfNeed(Global<MemoryAllocator>::Get(), blob_ptr.get());
         }
-        CHECK(regst->lbi2blob_.emplace(lbi.lbi(), std::move(blob_ptr)).second);
+        CHECK_EQ(rt_regst_desc->GetBlobIndex4Lbi(lbi.lbi()), regst->GetBlobSize());
+        regst->sorted_blobs_.push_back(std::move(blob_ptr));
       });
 }
 
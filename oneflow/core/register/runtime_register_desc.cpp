@@ -30,7 +30,9 @@ RtRegstDesc::RtRegstDesc(const RegstDescProto& proto) {
     for (const LbiBlobDescPair& pair : data_regst_desc.lbi2blob_desc()) {
       auto blob_desc = std::make_unique<RtBlobDesc>(pair.blob_desc());
       CHECK(lbi2blob_desc_.emplace(pair.lbi(), std::move(blob_desc)).second);
+      sorted_lbis_.push_back(pair.lbi());
     }
+    std::sort(sorted_lbis_.begin(), sorted_lbis_.end());
     packed_blob_desc_.reset(new RtBlobDesc(data_regst_desc.packed_blob_desc()));
     CHECK(data_regst_desc.has_time_shape());
     data_regst_time_shape_.reset(new Shape(data_regst_desc.time_shape()));
@@ -49,6 +51,12 @@ const RtBlobDesc* RtRegstDesc::GetRtBlobDescFromLbi(const LogicalBlobId& lbi) co
   }
 }
 
+int64_t RtRegstDesc::GetBlobIndex4Lbi(const LogicalBlobId& lbi) const {
+  const auto it = std::lower_bound(sorted_lbis_.begin(), sorted_lbis_.end(), lbi);
+  if (it == sorted_lbis_.end() || !(*it == lbi)) { return -1; }
+  return it - sorted_lbis_.begin();
+}
+
 size_t RtRegstDesc::TotalByteSize4AllRegst() const {
   return packed_blob_desc_->AlignedTotalByteSize() * register_num_;
 }
@@ -38,6 +38,9 @@ class RtRegstDesc {
   const RegstDescTypeProto& regst_desc_type() const { return regst_desc_type_; }
 
   const RtBlobDesc* GetRtBlobDescFromLbi(const LogicalBlobId& lbi) const;
+  // position of lbi in sorted_lbis(), -1 if this regst desc has no such blob
+  int64_t GetBlobIndex4Lbi(const LogicalBlobId& lbi) const;
+  const std::vector<LogicalBlobId>& sorted_lbis() const { return sorted_lbis_; }
   const RtBlobDesc* packed_blob_desc() const { return packed_blob_desc_.get(); }
   size_t TotalByteSize4AllRegst() const;
   size_t TotalMainByteSize4AllRegst() const;
@@ -60,6 +63,7 @@ class RtRegstDesc {
   RegstDescTypeProto regst_desc_type_;
   MemoryCase mem_case_;
   HashMap<LogicalBlobId, std::unique_ptr<RtBlobDesc>> lbi2blob_desc_;
+  std::vector<LogicalBlobId> sorted_lbis_;
   std::unique_ptr<RtBlobDesc> packed_blob_desc_;
   std::unique_ptr<Shape> data_regst_time_shape_;
 };
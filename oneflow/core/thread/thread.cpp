@@ -21,6 +21,19 @@ limitations under the License.
 
 namespace oneflow {
 
+namespace {
+
+bool IsBusyPollThread(const ActorThreadPollConf& poll_conf, int64_t thrd_id) {
+  if (poll_conf.spin_us() <= 0 && poll_conf.yield_us() <= 0) { return false; }
+  if (poll_conf.thrd_id_size() == 0) { return true; }
+  return std::find(poll_conf.thrd_id().begin(), poll_conf.thrd_id().end(), thrd_id)
+         != poll_conf.thrd_id().end();
+}
+
+int64_t NowNs() { return static_cast<int64_t>(GetCurTime()); }
+
+}  // namespace
+
 Thread::~Thread() {
   actor_thread_.join();
   CHECK(id2task_.empty());
@@ -33,24 +46,50 @@ void Thread::AddTask(const TaskProto& task) {
 }
 
 void Thread::EnqueueActorMsg(const ActorMsg& msg) {
-  if (Global<ResourceDesc, ForSession>::Get()->thread_enable_local_message_queue()
-      && std::this_thread::get_id() == actor_thread_.get_id()) {
+  if (IsLocalMsgQueueUsable()) {
     local_msg_queue_.push(msg);
   } else {
+    RecordMsgSendTime();
     msg_channel_.Send(msg);
   }
 }
 
+bool Thread::IsLocalMsgQueueUsable() const {
+  return Global<ResourceDesc, ForSession>::Get()->thread_enable_local_message_queue()
+         && std::this_thread::get_id() == actor_thread_.get_id();
+}
+
+void Thread::RecordMsgSendTime() {
+  if (is_msg_send_time_recorded_.load(std::memory_order_relaxed)) {
+    int64_t expected = 0;
+    first_pending_msg_ns_.compare_exchange_strong(expected, NowNs());
+  }
+}
+
 void Thread::PollMsgChannel(const ThreadCtx& thread_ctx) {
+  const ActorThreadPollConf poll_conf =
+      Global<ResourceDesc, ForSession>::Get()->actor_thread_poll_conf();
+  const bool is_busy_poll = IsBusyPollThread(poll_conf, thrd_id_);
+  const bool enable_metrics = poll_conf.enable_metrics();
+  is_msg_send_time_recorded_.store(enable_metrics);
+  PollMetrics metrics;
+  const int64_t start_ns = NowNs();
   while (true) {
     if (local_msg_queue_.empty()) {
-      CHECK_EQ(msg_channel_.ReceiveMany(&local_msg_queue_), kChannelStatusSuccess);
+      if (is_busy_poll) {
+        CHECK_EQ(BusyPollMsgChannel(poll_conf, &metrics), kChannelStatusSuccess);
+      } else {
+        CHECK_EQ(msg_channel_.ReceiveMany(&local_msg_queue_), kChannelStatusSuccess);
+        metrics.park_cnt += 1;
+      }
+      if (enable_metrics) { RecordWakeup(&metrics); }
     }
     ActorMsg msg = std::move(local_msg_queue_.front());
     local_msg_queue_.pop();
     if (msg.msg_type() == ActorMsgType::kCmdMsg) {
       if (msg.actor_cmd() == ActorCmd::kStopThread) {
         CHECK(id2actor_ptr_.empty());
+        if (enable_metrics) { LogPollMetrics(metrics, NowNs() - start_ns); }
         break;
       } else if (msg.actor_cmd() == ActorCmd::kConstructActor) {
         ConstructActor(msg.dst_actor_id(), thread_ctx);
@@ -73,6 +112,53 @@ void Thread::PollMsgChannel(const ThreadCtx& thread_ctx) {
   }
 }
 
+ChannelStatus Thread::BusyPollMsgChannel(const ActorThreadPollConf& poll_conf,
+                                         PollMetrics* metrics) {
+  const int64_t start_ns = NowNs();
+  const int64_t spin_end_ns = start_ns + poll_conf.spin_us() * 1000;
+  const int64_t yield_end_ns = spin_end_ns + poll_conf.yield_us() * 1000;
+  int64_t now_ns = start_ns;
+  ChannelStatus status = kChannelStatusEmpty;
+  while (now_ns < yield_end_ns) {
+    status = msg_channel_.TryReceiveMany(&local_msg_queue_);
+    if (status != kChannelStatusEmpty) { break; }
+    if (now_ns >= spin_end_ns) { std::this_thread::yield(); }
+    now_ns = NowNs();
+  }
+  metrics->spin_ns += now_ns - start_ns;
+  if (status == kChannelStatusEmpty) {
+    metrics->park_cnt += 1;
+    return msg_channel_.ReceiveMany(&local_msg_queue_);
+  } else {
+    metrics->spin_hit_cnt += 1;
+    return status;
+  }
+}
+
+void Thread::RecordWakeup(PollMetrics* metrics) {
+  const int64_t send_ns = first_pending_msg_ns_.exchange(0);
+  // messages sent before the stamp was switched on, or by this thread itself, carry no time
+  if (send_ns == 0) { return; }
+  const int64_t latency_ns = std::max<int64_t>(NowNs() - send_ns, 0);
+  metrics->wakeup_cnt += 1;
+  metrics->wakeup_latency_ns_sum += latency_ns;
+  metrics->wakeup_latency_ns_max = std::max(metrics->wakeup_latency_ns_max, latency_ns);
+}
+
+void Thread::LogPollMetrics(const PollMetrics& metrics, int64_t wall_ns) const {
+  const double idle_spin_ratio =
+      wall_ns > 0 ? static_cast<double>(metrics.spin_ns) / static_cast<double>(wall_ns) : 0.0;
+  const double avg_latency_us =
+      metrics.wakeup_cnt > 0
+          ? static_cast<double>(metrics.wakeup_latency_ns_sum) / metrics.wakeup_cnt / 1000.0
+          : 0.0;
+  LOG(INFO) << "thread " << thrd_id_ << " poll metrics: spin hits " << metrics.spin_hit_cnt
+            << ", parks " << metrics.park_cnt << ", idle spin ratio " << idle_spin_ratio
+            << ", wakeup latency avg " << avg_latency_us << " us max "
+            << metrics.wakeup_latency_ns_max / 1000.0 << " us over " << metrics.wakeup_cnt
+            << " wakeups";
+}
+
 void Thread::ConstructActor(int64_t actor_id, const ThreadCtx& thread_ctx) {
   LOG(INFO) << "thread " << thrd_id_ << " construct actor " << actor_id;
   std::unique_lock<std::mutex> lck(id2task_mtx_);
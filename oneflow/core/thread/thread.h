@@ -20,6 +20,7 @@ limitations under the License.
 #include "oneflow/core/common/channel.h"
 #include "oneflow/core/common/util.h"
 #include "oneflow/core/job/task.pb.h"
+#include "oneflow/core/job/resource.pb.h"
 #include "oneflow/core/thread/thread_context.h"
 #include "oneflow/core/actor/actor.h"
 
@@ -34,6 +35,8 @@ class Thread {
 
   Channel<ActorMsg>* GetMsgChannelPtr() { return &msg_channel_; }
   void EnqueueActorMsg(const ActorMsg& msg);
+  template<typename InputIt>
+  void EnqueueActorMsg(InputIt first, InputIt last);
 
   void JoinAllActor() { actor_thread_.join(); }
 
@@ -44,7 +47,21 @@ class Thread {
   void set_thrd_id(int64_t val) { thrd_id_ = val; }
 
  private:
+  struct PollMetrics {
+    int64_t spin_hit_cnt = 0;
+    int64_t park_cnt = 0;
+    int64_t spin_ns = 0;
+    int64_t wakeup_cnt = 0;
+    int64_t wakeup_latency_ns_sum = 0;
+    int64_t wakeup_latency_ns_max = 0;
+  };
+
+  bool IsLocalMsgQueueUsable() const;
+  void RecordMsgSendTime();
   void ConstructActor(int64_t actor_id, const ThreadCtx& thread_ctx);
+  ChannelStatus BusyPollMsgChannel(const ActorThreadPollConf& poll_conf, PollMetrics* metrics);
+  void RecordWakeup(PollMetrics* metrics);
+  void LogPollMetrics(const PollMetrics& metrics, int64_t wall_ns) const;
 
   HashMap<int64_t, TaskProto> id2task_;
   std::mutex id2task_mtx_;
@@ -53,10 +70,23 @@ class Thread {
   Channel<ActorMsg> msg_channel_;
   HashMap<int64_t, std::unique_ptr<Actor>> id2actor_ptr_;
   std::queue<ActorMsg> local_msg_queue_;
+  // when enabled, senders stamp the first message the actor thread has not picked up yet
+  std::atomic<bool> is_msg_send_time_recorded_{false};
+  std::atomic<int64_t> first_pending_msg_ns_{0};
 
   int64_t thrd_id_;
 };
 
+template<typename InputIt>
+void Thread::EnqueueActorMsg(InputIt first, InputIt last) {
+  if (IsLocalMsgQueueUsable()) {
+    for (; first != last; ++first) { local_msg_queue_.push(*first); }
+  } else {
+    RecordMsgSendTime();
+    msg_channel_.SendMany(first, last);
+  }
+}
+
 }  // namespace oneflow
 
 #endif  // ONEFLOW_CORE_THREAD_THREAD_H_
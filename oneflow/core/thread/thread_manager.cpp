@@ -70,17 +70,29 @@ void SingleThreadLoop(size_t num, std::function<void(size_t i)> Callback) {
   FOR_RANGE(size_t, i, 0, num) { Callback(i); }
 }
 
-void MultiThreadLoop(size_t num, std::function<void(size_t i)> Callback) {
-  size_t thread_num = Global<ThreadPool>::Get()->thread_num();
-  thread_num = std::min(num, thread_num);
-  BalancedSplitter bs(num, thread_num);
-  BlockingCounter bc(thread_num);
-  FOR_RANGE(size_t, range_id, 0, thread_num) {
-    Global<ThreadPool>::Get()->AddWork([&bc, &bs, range_id, Callback] {
-      FOR_RANGE(size_t, i, bs.At(range_id).begin(), bs.At(range_id).end()) { Callback(i); }
+void MultiThreadLoop(int64_t num, int64_t grain_size,
+                     const std::function<void(int64_t begin, int64_t end)>& Handler) {
+  if (num <= 0) { return; }
+  CHECK_GT(grain_size, 0);
+  int64_t part_num = 1;
+  if (Global<ThreadPool>::Get() != nullptr) {
+    part_num = std::min<int64_t>(Global<ThreadPool>::Get()->thread_num(), num / grain_size);
+  }
+  if (part_num <= 1) {
+    Handler(0, num);
+    return;
+  }
+  const BalancedSplitter bs(num, part_num);
+  BlockingCounter bc(part_num - 1);
+  FOR_RANGE(int64_t, part_id, 1, part_num) {
+    Global<ThreadPool>::Get()->AddWork([&bc, &bs, &Handler, part_id] {
+      const Range range = bs.At(part_id);
+      Handler(range.begin(), range.end());
       bc.Decrease();
     });
   }
+  const Range first_range = bs.At(0);
+  Handler(first_range.begin(), first_range.end());
   bc.WaitUntilCntEqualZero();
 }
 
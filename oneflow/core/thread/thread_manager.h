@@ -43,7 +43,22 @@ class ThreadMgr final {
 };
 
 void SingleThreadLoop(size_t num, std::function<void(size_t i)> Callback);
-void MultiThreadLoop(size_t num, std::function<void(size_t i)> Callback);
+
+// Splits [0, num) into balanced ranges of no fewer than grain_size indices, at most one per thread
+// of the pool, and calls Handler(begin, end) on each of them. The calling thread handles one of the
+// ranges itself. Loops that make a single range, or run without a thread pool, call
+// Handler(0, num) inline.
+void MultiThreadLoop(int64_t num, int64_t grain_size,
+                     const std::function<void(int64_t begin, int64_t end)>& Handler);
+
+// Ranges of a loop are worth handing to the thread pool once they touch this many bytes
+constexpr int64_t kMultiThreadLoopMinRangeBytes = 128 * 1024;
+
+// Grain size for a loop whose indices each touch about bytes_per_index bytes of memory
+inline int64_t MultiThreadLoopGrainSize(int64_t bytes_per_index) {
+  return std::max<int64_t>(kMultiThreadLoopMinRangeBytes / std::max<int64_t>(bytes_per_index, 1),
+                           1);
+}
 
 }  // namespace oneflow
 
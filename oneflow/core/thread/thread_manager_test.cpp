@@ -0,0 +1,86 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "oneflow/core/thread/thread_manager.h"
+#include <gtest/gtest.h>
+
+namespace oneflow {
+
+namespace test {
+
+namespace {
+
+// Runs MultiThreadLoop and returns the ranges it handed out, sorted by begin
+std::vector<std::pair<int64_t, int64_t>> CollectRanges(int64_t num, int64_t grain_size) {
+  std::mutex mutex;
+  std::vector<std::pair<int64_t, int64_t>> ranges;
+  MultiThreadLoop(num, grain_size, [&](int64_t begin, int64_t end) {
+    std::unique_lock<std::mutex> lock(mutex);
+    ranges.emplace_back(begin, end);
+  });
+  std::sort(ranges.begin(), ranges.end());
+  return ranges;
+}
+
+void CheckCover(const std::vector<std::pair<int64_t, int64_t>>& ranges, int64_t num) {
+  int64_t next = 0;
+  for (const auto& range : ranges) {
+    ASSERT_EQ(range.first, next);
+    ASSERT_LT(range.first, range.second);
+    next = range.second;
+  }
+  ASSERT_EQ(next, num);
+}
+
+}  // namespace
+
+TEST(MultiThreadLoop, without_thread_pool) {
+  const auto ranges = CollectRanges(1 << 20, 1);
+  ASSERT_EQ(ranges.size(), 1);
+  CheckCover(ranges, 1 << 20);
+  ASSERT_TRUE(CollectRanges(0, 1).empty());
+}
+
+TEST(MultiThreadLoop, grain_size) {
+  Global<ThreadPool>::New(4);
+  // fewer than two grains stay on the calling thread
+  const std::thread::id caller_id = std::this_thread::get_id();
+  bool is_inline = false;
+  MultiThreadLoop(1000, 600, [&](int64_t begin, int64_t end) {
+    is_inline = (begin == 0 && end == 1000 && std::this_thread::get_id() == caller_id);
+  });
+  ASSERT_TRUE(is_inline);
+  const auto two_ranges = CollectRanges(1000, 500);
+  ASSERT_EQ(two_ranges.size(), 2);
+  CheckCover(two_ranges, 1000);
+  // never more ranges than threads, and every index exactly once
+  const auto ranges = CollectRanges(1000, 1);
+  ASSERT_EQ(ranges.size(), 4);
+  CheckCover(ranges, 1000);
+  const auto per_index = CollectRanges(3, 1);
+  ASSERT_EQ(per_index.size(), 3);
+  CheckCover(per_index, 3);
+  Global<ThreadPool>::Delete();
+}
+
+TEST(MultiThreadLoop, grain_size_of_cost) {
+  ASSERT_EQ(MultiThreadLoopGrainSize(8), kMultiThreadLoopMinRangeBytes / 8);
+  ASSERT_EQ(MultiThreadLoopGrainSize(0), kMultiThreadLoopMinRangeBytes);
+  ASSERT_EQ(MultiThreadLoopGrainSize(kMultiThreadLoopMinRangeBytes * 4), 1);
+}
+
+}  // namespace test
+
+}  // namespace oneflow
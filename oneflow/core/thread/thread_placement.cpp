@@ -0,0 +1,124 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "oneflow/core/thread/thread_placement.h"
+#include "oneflow/core/thread/thread_pool.h"
+#include "oneflow/core/common/blocking_counter.h"
+#include "oneflow/core/common/platform.h"
+#include "oneflow/core/device/cuda_util.h"
+
+namespace oneflow {
+
+namespace {
+
+std::vector<int32_t> GetCurrentThreadCpus() {
+  std::vector<int32_t> cpus;
+#ifdef PLATFORM_POSIX
+  cpu_set_t cpu_set;
+  CHECK_EQ(sched_getaffinity(0, sizeof(cpu_set_t), &cpu_set), 0);
+  FOR_RANGE(int32_t, cpu, 0, CPU_SETSIZE) {
+    if (CPU_ISSET(cpu, &cpu_set)) { cpus.push_back(cpu); }
+  }
+#endif
+  return cpus;
+}
+
+void BindCurrentThread(const std::vector<int32_t>& cpus) {
+  if (cpus.empty()) { return; }
+#ifdef PLATFORM_POSIX
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  for (int32_t cpu : cpus) { CPU_SET(cpu, &cpu_set); }
+  CHECK_EQ(sched_setaffinity(0, sizeof(cpu_set_t), &cpu_set), 0);
+#else
+  UNIMPLEMENTED();
+#endif
+}
+
+}  // namespace
+
+Maybe<void> PartitionThreadPlacementCpus(const std::vector<int32_t>& process_cpus,
+                                         const ThreadPlacementConf& conf,
+                                         ThreadPlacementCpus* cpus) {
+  const int64_t poller_core_num = conf.comm_net_poller_core_num();
+  CHECK_GE_OR_RETURN(poller_core_num, 0);
+  CHECK_LT_OR_RETURN(poller_core_num, static_cast<int64_t>(process_cpus.size()));
+  const auto poller_begin = process_cpus.end() - poller_core_num;
+  cpus->worker_cpus.assign(process_cpus.begin(), poller_begin);
+  cpus->poller_cpus.assign(poller_begin, process_cpus.end());
+  // workers only need pinning when the pollers take cpus away from them
+  const std::vector<int32_t> unrestricted =
+      cpus->poller_cpus.empty() ? std::vector<int32_t>() : cpus->worker_cpus;
+  const int64_t cpu_actor_core_num = conf.cpu_actor_thread_core_num();
+  CHECK_GE_OR_RETURN(cpu_actor_core_num, 0);
+  CHECK_LE_OR_RETURN(cpu_actor_core_num, static_cast<int64_t>(cpus->worker_cpus.size()));
+  if (cpu_actor_core_num > 0) {
+    const auto compute_begin = cpus->worker_cpus.begin() + cpu_actor_core_num;
+    cpus->cpu_actor_cpus.assign(cpus->worker_cpus.begin(), compute_begin);
+    cpus->compute_cpus.assign(compute_begin, cpus->worker_cpus.end());
+    if (cpus->compute_cpus.empty()) { cpus->compute_cpus = cpus->worker_cpus; }
+  } else {
+    cpus->cpu_actor_cpus = unrestricted;
+    cpus->compute_cpus = unrestricted;
+  }
+  return Maybe<void>::Ok();
+}
+
+ThreadPlacement::ThreadPlacement(const ThreadPlacementConf& conf) : conf_(conf) {
+  process_cpus_ = GetCurrentThreadCpus();
+  CHECK_JUST(PartitionThreadPlacementCpus(process_cpus_, conf, &cpus_));
+  BindComputeThreadPool(cpus_.compute_cpus);
+}
+
+ThreadPlacement::~ThreadPlacement() {
+  if (!cpus_.compute_cpus.empty()) { BindComputeThreadPool(process_cpus_); }
+}
+
+void ThreadPlacement::BindComputeThreadPool(const std::vector<int32_t>& cpus) const {
+  ThreadPool* thread_pool = Global<ThreadPool>::Get();
+  if (thread_pool == nullptr || cpus.empty()) { return; }
+  BlockingCounter bc(thread_pool->thread_num());
+  thread_pool->AddWorkToEachThread([&bc, &cpus]() {
+    BindCurrentThread(cpus);
+    bc.Decrease();
+  });
+  bc.WaitUntilCntEqualZero();
+}
+
+void ThreadPlacement::BindCpuActorThread() const { BindCurrentThread(cpus_.cpu_actor_cpus); }
+
+void ThreadPlacement::BindGpuThread(int64_t dev_id) const {
+#if defined(WITH_CUDA) && defined(PLATFORM_POSIX)
+  if (conf_.bind_gpu_threads_to_local_numa_node()) {
+    cpu_set_t local_cpu_set;
+    CudaDeviceGetCpuAffinity(dev_id, &local_cpu_set);
+    std::vector<int32_t> cpus;
+    for (int32_t cpu : cpus_.worker_cpus) {
+      if (CPU_ISSET(cpu, &local_cpu_set)) { cpus.push_back(cpu); }
+    }
+    if (cpus.empty()) {
+      LOG(WARNING) << "no cpu of the numa node of gpu " << dev_id << " is left to its threads";
+      cpus = cpus_.worker_cpus;
+    }
+    BindCurrentThread(cpus);
+    return;
+  }
+#endif
+  if (!cpus_.poller_cpus.empty()) { BindCurrentThread(cpus_.worker_cpus); }
+}
+
+void ThreadPlacement::BindCommNetPollerThread() const { BindCurrentThread(cpus_.poller_cpus); }
+
+}  // namespace oneflow
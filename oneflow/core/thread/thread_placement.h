@@ -0,0 +1,65 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#ifndef ONEFLOW_CORE_THREAD_THREAD_PLACEMENT_H_
+#define ONEFLOW_CORE_THREAD_THREAD_PLACEMENT_H_
+
+#include "oneflow/core/common/util.h"
+#include "oneflow/core/common/maybe.h"
+#include "oneflow/core/job/resource.pb.h"
+
+namespace oneflow {
+
+// An empty set leaves that kind of thread unpinned.
+struct ThreadPlacementCpus {
+  std::vector<int32_t> poller_cpus;
+  // every cpu but the poller ones
+  std::vector<int32_t> worker_cpus;
+  std::vector<int32_t> cpu_actor_cpus;
+  std::vector<int32_t> compute_cpus;
+};
+
+// Splits process_cpus as conf asks. The pollers take the last cpus, the cpu actor threads the
+// first of the remaining ones and the compute threads the rest.
+Maybe<void> PartitionThreadPlacementCpus(const std::vector<int32_t>& process_cpus,
+                                         const ThreadPlacementConf& conf,
+                                         ThreadPlacementCpus* cpus);
+
+// Decides the cpus every kind of runtime thread may run on, out of the cpus the process was
+// started with. The Bind* functions pin the calling thread and leave it alone when the conf does
+// not restrict that kind of thread.
+class ThreadPlacement final {
+ public:
+  OF_DISALLOW_COPY_AND_MOVE(ThreadPlacement);
+  ThreadPlacement() = delete;
+  // the workers of Global<ThreadPool> are pinned as compute threads until destruction
+  explicit ThreadPlacement(const ThreadPlacementConf& conf);
+  ~ThreadPlacement();
+
+  void BindCpuActorThread() const;
+  void BindGpuThread(int64_t dev_id) const;
+  void BindCommNetPollerThread() const;
+
+ private:
+  void BindComputeThreadPool(const std::vector<int32_t>& cpus) const;
+
+  ThreadPlacementConf conf_;
+  std::vector<int32_t> process_cpus_;
+  ThreadPlacementCpus cpus_;
+};
+
+}  // namespace oneflow
+
+#endif  // ONEFLOW_CORE_THREAD_THREAD_PLACEMENT_H_
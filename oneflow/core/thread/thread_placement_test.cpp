@@ -0,0 +1,95 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "oneflow/core/thread/thread_placement.h"
+
+namespace oneflow {
+
+namespace test {
+
+namespace {
+
+ThreadPlacementConf MakeConf(int64_t poller_core_num, int64_t cpu_actor_core_num) {
+  ThreadPlacementConf conf;
+  conf.set_comm_net_poller_core_num(poller_core_num);
+  conf.set_cpu_actor_thread_core_num(cpu_actor_core_num);
+  return conf;
+}
+
+ThreadPlacementCpus Partition(const std::vector<int32_t>& process_cpus,
+                              const ThreadPlacementConf& conf) {
+  ThreadPlacementCpus cpus;
+  CHECK_JUST(PartitionThreadPlacementCpus(process_cpus, conf, &cpus));
+  return cpus;
+}
+
+bool IsPartitionOk(const std::vector<int32_t>& process_cpus, const ThreadPlacementConf& conf) {
+  ThreadPlacementCpus cpus;
+  return PartitionThreadPlacementCpus(process_cpus, conf, &cpus).IsOk();
+}
+
+// not every cpu of the machine, like under taskset
+const std::vector<int32_t> kProcessCpus = {2, 3, 5, 8, 9, 12};
+
+}  // namespace
+
+TEST(ThreadPlacement, default_conf_pins_nothing) {
+  const ThreadPlacementCpus cpus = Partition(kProcessCpus, ThreadPlacementConf());
+  ASSERT_TRUE(cpus.poller_cpus.empty());
+  ASSERT_EQ(cpus.worker_cpus, kProcessCpus);
+  ASSERT_TRUE(cpus.cpu_actor_cpus.empty());
+  ASSERT_TRUE(cpus.compute_cpus.empty());
+}
+
+TEST(ThreadPlacement, pollers_take_the_last_cpus) {
+  const ThreadPlacementCpus cpus = Partition(kProcessCpus, MakeConf(2, 0));
+  ASSERT_EQ(cpus.poller_cpus, std::vector<int32_t>({9, 12}));
+  ASSERT_EQ(cpus.worker_cpus, std::vector<int32_t>({2, 3, 5, 8}));
+  // the other threads are kept off the poller cpus
+  ASSERT_EQ(cpus.cpu_actor_cpus, cpus.worker_cpus);
+  ASSERT_EQ(cpus.compute_cpus, cpus.worker_cpus);
+}
+
+TEST(ThreadPlacement, cpu_actors_take_the_first_worker_cpus) {
+  const ThreadPlacementCpus cpus = Partition(kProcessCpus, MakeConf(1, 2));
+  ASSERT_EQ(cpus.poller_cpus, std::vector<int32_t>({12}));
+  ASSERT_EQ(cpus.worker_cpus, std::vector<int32_t>({2, 3, 5, 8, 9}));
+  ASSERT_EQ(cpus.cpu_actor_cpus, std::vector<int32_t>({2, 3}));
+  ASSERT_EQ(cpus.compute_cpus, std::vector<int32_t>({5, 8, 9}));
+  const ThreadPlacementCpus no_poller_cpus = Partition(kProcessCpus, MakeConf(0, 1));
+  ASSERT_TRUE(no_poller_cpus.poller_cpus.empty());
+  ASSERT_EQ(no_poller_cpus.cpu_actor_cpus, std::vector<int32_t>({2}));
+  ASSERT_EQ(no_poller_cpus.compute_cpus, std::vector<int32_t>({3, 5, 8, 9, 12}));
+}
+
+TEST(ThreadPlacement, compute_shares_cpus_when_cpu_actors_take_them_all) {
+  const ThreadPlacementCpus cpus = Partition(kProcessCpus, MakeConf(2, 4));
+  ASSERT_EQ(cpus.cpu_actor_cpus, std::vector<int32_t>({2, 3, 5, 8}));
+  ASSERT_EQ(cpus.compute_cpus, cpus.worker_cpus);
+}
+
+TEST(ThreadPlacement, core_num_bounds) {
+  ASSERT_TRUE(IsPartitionOk(kProcessCpus, MakeConf(5, 1)));
+  // one cpu is always left to the workers
+  ASSERT_FALSE(IsPartitionOk(kProcessCpus, MakeConf(6, 0)));
+  ASSERT_FALSE(IsPartitionOk(kProcessCpus, MakeConf(-1, 0)));
+  ASSERT_FALSE(IsPartitionOk(kProcessCpus, MakeConf(2, 5)));
+  ASSERT_FALSE(IsPartitionOk(kProcessCpus, MakeConf(0, -1)));
+  ASSERT_FALSE(IsPartitionOk({}, ThreadPlacementConf()));
+}
+
+}  // namespace test
+
+}  // namespace oneflow
@@ -41,4 +41,8 @@ void ThreadPool::AddWork(const std::function<void()>& work) {
   work_chans_.at(cur_chan_idx).Send(work);
 }
 
+void ThreadPool::AddWorkToEachThread(const std::function<void()>& work) {
+  for (auto& work_chan : work_chans_) { work_chan.Send(work); }
+}
+
 }  // namespace oneflow
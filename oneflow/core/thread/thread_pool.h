@@ -30,6 +30,8 @@ class ThreadPool final {
 
   int32_t thread_num() const { return threads_.size(); }
   void AddWork(const std::function<void()>& work);
+  // every thread runs its own copy of work
+  void AddWorkToEachThread(const std::function<void()>& work);
 
  private:
   std::vector<Channel<std::function<void()>>> work_chans_;
@@ -52,7 +52,9 @@ void CpuStreamType::Compute(Instruction* instruction) const {
   {
     const auto& instr_type_id = instruction->mut_instr_msg()->instr_type_id();
     CHECK_EQ(instr_type_id.stream_type_id().interpret_type(), InterpretType::kCompute);
-    instr_type_id.instruction_type().Compute(instruction);
+    instruction->ForEachInstrMsg([&](InstructionMsg* instr_msg) {
+      instr_msg->instr_type_id().instruction_type().Compute(instruction);
+    });
   }
   auto* status_buffer = instruction->mut_status_buffer();
   NaiveInstrStatusQuerier::MutCast(status_buffer->mut_buffer()->mut_data())->set_done();
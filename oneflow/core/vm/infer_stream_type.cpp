@@ -43,7 +43,9 @@ void InferStreamTypeUtil::Infer(Instruction* instruction) {
   {
     const auto& instr_type_id = instruction->mut_instr_msg()->instr_type_id();
     CHECK_EQ(instr_type_id.stream_type_id().interpret_type(), InterpretType::kInfer);
-    instr_type_id.instruction_type().Infer(instruction);
+    instruction->ForEachInstrMsg([&](InstructionMsg* instr_msg) {
+      instr_msg->instr_type_id().instruction_type().Infer(instruction);
+    });
   }
   auto* status_buffer = instruction->mut_status_buffer();
   NaiveInstrStatusQuerier::MutCast(status_buffer->mut_buffer()->mut_data())->set_done();
@@ -76,6 +76,8 @@ OBJECT_MSG_BEGIN(InstructionMsg);
   OBJECT_MSG_DEFINE_STRUCT(InstrTypeId, instr_type_id);
   OBJECT_MSG_DEFINE_OPTIONAL(int64_t, parallel_desc_symbol_id);
   OBJECT_MSG_DEFINE_OPTIONAL(InstructionOperandList, operand_list);
+  // messages fused into this one by VirtualMachine, they run in order before this one
+  OBJECT_MSG_DEFINE_STRUCT(std::vector<ObjectMsgPtr<InstructionMsg>>, fused_instr_msg);
 
   // links
   OBJECT_MSG_DEFINE_LIST_LINK(instr_msg_link);
@@ -117,6 +119,18 @@ OBJECT_MSG_BEGIN(Instruction);
   OF_PUBLIC void __Delete__();
   OF_PUBLIC bool Done() const;
   OF_PUBLIC const StreamType& stream_type() const;
+  // calls DoEach for the fused messages first and then for instr_msg itself, instr_msg() refers
+  // to the message being run so that instruction types need not know about fusion
+  OF_PUBLIC template<typename DoEachT> void ForEachInstrMsg(const DoEachT& DoEach) {
+    if (instr_msg().fused_instr_msg().empty()) { return DoEach(mut_instr_msg()); }
+    ObjectMsgPtr<InstructionMsg> instr_msg_ptr(mut_instr_msg());
+    for (const auto& fused_instr_msg : instr_msg_ptr->fused_instr_msg()) {
+      reset_instr_msg(fused_instr_msg.Get());
+      DoEach(mut_instr_msg());
+    }
+    reset_instr_msg(instr_msg_ptr.Mutable());
+    DoEach(mut_instr_msg());
+  }
 
   OF_PUBLIC template<OperandMemZoneModifier mem_zone_modifier>
       const RwMutexedObject* operand_type(const Operand& operand) const {
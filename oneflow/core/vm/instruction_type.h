@@ -34,6 +34,11 @@ class InstructionType {
   virtual void Compute(Instruction* instruction) const = 0;
   virtual void Infer(Instruction* instruction) const = 0;
 
+  // consecutive instructions of fusible types on the same stream may be scheduled by the virtual
+  // machine as one instruction. Compute and Infer must then only depend on instr_msg() and the
+  // operands it names, and the stream type must run them with Instruction::ForEachInstrMsg
+  virtual bool Fusible() const { return false; }
+
   virtual void Compute(VirtualMachine* vm, InstructionMsg* instr_msg) const {
     LOG(FATAL) << "UNIMPLEMENTED";
   }
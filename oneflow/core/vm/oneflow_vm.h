@@ -16,10 +16,10 @@ limitations under the License.
 #ifndef ONEFLOW_CORE_VM_ONEFLOW_VM_H_
 #define ONEFLOW_CORE_VM_ONEFLOW_VM_H_
 
+#include <thread>
 #include "oneflow/core/vm/interpret_type.h"
 #include "oneflow/core/vm/vm_desc.msg.h"
 #include "oneflow/core/vm/virtual_machine.msg.h"
-#include "oneflow/core/thread/thread_pool.h"
 
 namespace oneflow {
 
@@ -33,14 +33,14 @@ class OneflowVM final {
   OneflowVM(const OneflowVM&) = delete;
   OneflowVM(OneflowVM&&) = delete;
   OneflowVM(const Resource& resource, int64_t this_machine_id);
-  ~OneflowVM() = default;
+  ~OneflowVM();
 
   vm::VirtualMachine* mut_vm() { return vm_.Mutable(); }
-  void TryReceiveAndRun();
 
  private:
   ObjectMsgPtr<vm::VirtualMachine> vm_;
-  HashMap<vm::ThreadCtx*, std::unique_ptr<ThreadPool>> thread_ctx2thread_pool_;
+  // one dispatch thread per ThreadCtx, blocking on its pending instruction list
+  std::vector<std::thread> dispatch_threads_;
 };
 
 }  // namespace oneflow
@@ -27,6 +27,8 @@ namespace vm {
 
 namespace {
 
+const size_t kMaxFusedInstrMsgNum = 32;
+
 bool IsSourceInstruction(const InstructionMsg& instr_msg) {
   for (const auto& instr_operand : instr_msg.operand()) {
     if (instr_operand->has_const_operand()) { return false; }
@@ -41,6 +43,58 @@ bool IsSourceInstruction(const InstructionMsg& instr_msg) {
   return true;
 }
 
+// the operands of the fused messages first, in the order the messages run
+template<typename DoEachT>
+void ForEachInstrOperand(const InstructionMsg& instr_msg, const DoEachT& DoEach) {
+  for (const auto& fused_instr_msg : instr_msg.fused_instr_msg()) {
+    for (const auto& operand : fused_instr_msg->operand()) { DoEach(operand); }
+  }
+  for (const auto& operand : instr_msg.operand()) { DoEach(operand); }
+}
+
+bool IsFusibleInstrMsgPair(const InstructionMsg& infer_instr_msg,
+                           const InstructionMsg& compute_instr_msg) {
+  const auto& stream_type_id = compute_instr_msg.instr_type_id().stream_type_id();
+  if (stream_type_id.interpret_type() != InterpretType::kCompute) { return false; }
+  if (!compute_instr_msg.instr_type_id().instruction_type().Fusible()) { return false; }
+  if (!compute_instr_msg.fused_instr_msg().empty()) { return false; }
+  // compute messages that change the type of an object would have to stay ahead of the infer
+  // messages of the run
+  for (const auto& operand : compute_instr_msg.operand()) {
+    if (operand->has_mut2_operand()) { return false; }
+  }
+  // Receive puts every infer message right before its compute message, sharing the operand list
+  return infer_instr_msg.instr_type_id().stream_type_id() == LookupInferStreamTypeId(stream_type_id)
+         && &infer_instr_msg.operand_list() == &compute_instr_msg.operand_list();
+}
+
+template<typename DoEachT>
+void ForEachMutLogicalObjectId(const InstructionMsg& instr_msg, const DoEachT& DoEach) {
+  for (const auto& operand : instr_msg.operand()) {
+    if (operand->has_mut_operand()) {
+      DoEach(operand->mut_operand().operand().logical_object_id());
+    } else if (operand->has_init_symbol_operand()) {
+      DoEach(operand->init_symbol_operand().operand().logical_object_id());
+    } else {
+      // do nothing
+    }
+  }
+}
+
+template<typename DoEachT>
+void ForEachLogicalObjectId(const InstructionMsg& instr_msg, const DoEachT& DoEach) {
+  ForEachMutLogicalObjectId(instr_msg, DoEach);
+  for (const auto& operand : instr_msg.operand()) {
+    if (operand->has_const_operand()) {
+      DoEach(operand->const_operand().operand().logical_object_id());
+    } else if (operand->has_symbol_operand()) {
+      DoEach(operand->symbol_operand().operand().logical_object_id());
+    } else {
+      // do nothing
+    }
+  }
+}
+
 }  // namespace
 
 void VirtualMachine::ReleaseInstruction(Instruction* instruction,
@@ -55,15 +109,31 @@ void VirtualMachine::ReleaseInstruction(Instruction* instruction,
   TryMoveWaitingToReady(instruction, ready_instruction_list, [](Instruction*) { return true; });
 }
 
-void VirtualMachine::TryReleaseFinishedInstructions(
+void VirtualMachine::TryMoveFinishedInstructions(
     Stream* stream,
-    /*out*/ ReadyInstructionList* ready_instruction_list) {
+    /*out*/ FinishedInstructionList* finished_instruction_list) {
   auto* running_instruction_list = stream->mut_running_instruction_list();
   while (true) {
     auto* instruction_ptr = running_instruction_list->Begin();
     if (instruction_ptr == nullptr || !instruction_ptr->Done()) { break; }
-    ReleaseInstruction(instruction_ptr, /*out*/ ready_instruction_list);
-    stream->DeleteInstruction(running_instruction_list->Erase(instruction_ptr));
+    running_instruction_list->MoveToDstBack(instruction_ptr, finished_instruction_list);
+  }
+}
+
+// Polls every active stream first and releases what has finished in one pass afterwards, so the
+// status queries shared with the stream threads are not interleaved with the bookkeeping below.
+void VirtualMachine::ReleaseFinishedInstructions(
+    /*out*/ ReadyInstructionList* ready_instruction_list) {
+  FinishedInstructionList finished_instruction_list;
+  auto* active_stream_list = mut_active_stream_list();
+  OBJECT_MSG_LIST_FOR_EACH_PTR(active_stream_list, stream) {
+    TryMoveFinishedInstructions(stream, /*out*/ &finished_instruction_list);
+    if (stream->running_instruction_list().empty()) { active_stream_list->Erase(stream); }
+  }
+  OBJECT_MSG_LIST_FOR_EACH_PTR(&finished_instruction_list, instruction) {
+    ReleaseInstruction(instruction, /*out*/ ready_instruction_list);
+    Stream* stream = instruction->mut_stream();
+    stream->DeleteInstruction(finished_instruction_list.Erase(instruction));
   }
 }
 
@@ -78,6 +148,68 @@ void VirtualMachine::FilterAndRunSourceInstructions(TmpPendingInstrMsgList* inst
   }
 }
 
+// Merges runs of consecutive (infer, compute) message pairs of fusible instruction types on the
+// same stream. The last pair of a run keeps its position in the list and carries the earlier
+// ones in fused_instr_msg, so the run gets one dependency analysis and one dispatch per stream.
+// A pair only joins a run if it mutates no object the run already accesses: moving the earlier
+// messages behind the infer message of the new pair must not reorder any conflicting access.
+void VirtualMachine::FuseInstructionMsgs(TmpPendingInstrMsgList* instr_msg_list) {
+  TmpPendingInstrMsgList fused_instr_msg_list;
+  ObjectMsgPtr<InstructionMsg> infer_instr_msg;
+  ObjectMsgPtr<InstructionMsg> compute_instr_msg;
+  HashSet<int64_t> accessed_logical_object_ids;
+  auto FlushRun = [&]() {
+    if (!compute_instr_msg) { return; }
+    fused_instr_msg_list.EmplaceBack(std::move(infer_instr_msg));
+    fused_instr_msg_list.EmplaceBack(std::move(compute_instr_msg));
+    accessed_logical_object_ids.clear();
+  };
+  auto IsFusibleWithRun = [&](const InstructionMsg& instr_msg) {
+    if (!compute_instr_msg) { return false; }
+    if (compute_instr_msg->fused_instr_msg().size() + 1 >= kMaxFusedInstrMsgNum) { return false; }
+    if (instr_msg.instr_type_id().stream_type_id()
+        != compute_instr_msg->instr_type_id().stream_type_id()) {
+      return false;
+    }
+    if (instr_msg.has_parallel_desc_symbol_id() != compute_instr_msg->has_parallel_desc_symbol_id()
+        || instr_msg.parallel_desc_symbol_id() != compute_instr_msg->parallel_desc_symbol_id()) {
+      return false;
+    }
+    bool conflicting = false;
+    ForEachMutLogicalObjectId(instr_msg, [&](int64_t logical_object_id) {
+      conflicting = conflicting || accessed_logical_object_ids.count(logical_object_id) > 0;
+    });
+    return !conflicting;
+  };
+  while (!instr_msg_list->empty()) {
+    ObjectMsgPtr<InstructionMsg> instr_msg = instr_msg_list->PopFront();
+    InstructionMsg* next_instr_msg = instr_msg_list->Begin();
+    if (next_instr_msg == nullptr || !IsFusibleInstrMsgPair(*instr_msg, *next_instr_msg)) {
+      FlushRun();
+      fused_instr_msg_list.EmplaceBack(std::move(instr_msg));
+      continue;
+    }
+    ObjectMsgPtr<InstructionMsg> next_compute_instr_msg = instr_msg_list->PopFront();
+    if (IsFusibleWithRun(next_compute_instr_msg.Get())) {
+      auto* fused_infer_instr_msgs = instr_msg->mut_fused_instr_msg();
+      fused_infer_instr_msgs->swap(*infer_instr_msg->mut_fused_instr_msg());
+      fused_infer_instr_msgs->emplace_back(std::move(infer_instr_msg));
+      auto* fused_compute_instr_msgs = next_compute_instr_msg->mut_fused_instr_msg();
+      fused_compute_instr_msgs->swap(*compute_instr_msg->mut_fused_instr_msg());
+      fused_compute_instr_msgs->emplace_back(std::move(compute_instr_msg));
+    } else {
+      FlushRun();
+    }
+    ForEachLogicalObjectId(next_compute_instr_msg.Get(), [&](int64_t logical_object_id) {
+      accessed_logical_object_ids.insert(logical_object_id);
+    });
+    infer_instr_msg = std::move(instr_msg);
+    compute_instr_msg = std::move(next_compute_instr_msg);
+  }
+  FlushRun();
+  fused_instr_msg_list.MoveTo(instr_msg_list);
+}
+
 void VirtualMachine::MakeInstructions(TmpPendingInstrMsgList* instr_msg_list,
                                       /*out*/ NewInstructionList* new_instruction_list) {
   auto IsStreamInParallelDesc = [](const ParallelDesc* parallel_desc, const Stream& stream) {
@@ -239,8 +371,8 @@ void VirtualMachine::ConsumeMirroredObjects(Id2LogicalObject* id2logical_object,
     auto ConsumeConstMirroredObject = [&](MirroredObject* mirrored_object) {
       ConsumeMirroredObject(kConstOperandAccess, mirrored_object, instruction);
     };
-    const auto& operands = instruction->instr_msg().operand();
-    for (const auto& operand : operands) {
+    const auto& instr_msg = instruction->instr_msg();
+    ForEachInstrOperand(instr_msg, [&](const FlatMsg<InstructionOperand>& operand) {
       if (operand->has_mut_operand()) {
         ForEachMutMirroredObject<kDeviceMemZoneModifier>(interpret_type, id2logical_object,
                                                          operand->mut_operand(), global_device_id,
@@ -258,8 +390,8 @@ void VirtualMachine::ConsumeMirroredObjects(Id2LogicalObject* id2logical_object,
       } else {
         // do nothing
       }
-    }
-    for (const auto& operand : operands) {
+    });
+    ForEachInstrOperand(instr_msg, [&](const FlatMsg<InstructionOperand>& operand) {
       if (operand->has_const_operand()) {
         ForEachConstMirroredObject<kDeviceMemZoneModifier>(
             interpret_type, id2logical_object, operand->const_operand(), global_device_id,
@@ -283,7 +415,7 @@ void VirtualMachine::ConsumeMirroredObjects(Id2LogicalObject* id2logical_object,
       } else {
         // do nothing
       }
-    }
+    });
     auto* rw_mutexed_object_accesses = instruction->mut_mirrored_object_id2access();
     OBJECT_MSG_SKIPLIST_UNSAFE_FOR_EACH_PTR(rw_mutexed_object_accesses, rw_mutexed_object_access) {
       auto* mirrored_object = rw_mutexed_object_access->mut_mirrored_object();
@@ -319,6 +451,14 @@ void VirtualMachine::FilterReadyInstructions(NewInstructionList* new_instruction
 void VirtualMachine::DispatchAndPrescheduleInstructions(
     ReadyInstructionList* ready_instruction_list) {
   PrescheduledInstructionList prescheduled;
+  // consecutive instructions for the same thread are handed over with a single lock and wakeup
+  DispatchedInstructionList dispatched;
+  ThreadCtx* dispatched_thread_ctx = nullptr;
+  auto FlushDispatched = [&]() {
+    if (dispatched_thread_ctx == nullptr) { return; }
+    dispatched_thread_ctx->mut_pending_instruction_list()->MoveFrom(&dispatched);
+    dispatched_thread_ctx = nullptr;
+  };
   auto* active_stream_list = mut_active_stream_list();
   OBJECT_MSG_LIST_FOR_EACH_PTR(ready_instruction_list, instruction) {
     auto* stream = instruction->mut_stream();
@@ -328,11 +468,16 @@ void VirtualMachine::DispatchAndPrescheduleInstructions(
     if (stream_type.SharingVirtualMachineThread()) {
       stream_type.Run(this, instruction);
     } else {
-      stream->mut_thread_ctx()->mut_pending_instruction_list()->PushBack(instruction);
+      if (stream->mut_thread_ctx() != dispatched_thread_ctx) {
+        FlushDispatched();
+        dispatched_thread_ctx = stream->mut_thread_ctx();
+      }
+      dispatched.PushBack(instruction);
     }
     TryMoveWaitingToReady(instruction, &prescheduled,
                           [stream](Instruction* dst) { return &dst->stream() == stream; });
   }
+  FlushDispatched();
   prescheduled.MoveTo(ready_instruction_list);
 }
 
@@ -394,16 +539,15 @@ void VirtualMachine::Receive(ObjectMsgPtr<InstructionMsg>&& compute_instr_msg) {
 
 void VirtualMachine::Schedule() {
   ReadyInstructionList* ready_instruction_list = mut_ready_instruction_list();
-  auto* active_stream_list = mut_active_stream_list();
-  OBJECT_MSG_LIST_FOR_EACH_PTR(active_stream_list, stream) {
-    TryReleaseFinishedInstructions(stream, /*out*/ ready_instruction_list);
-    if (stream->running_instruction_list().empty()) { active_stream_list->Erase(stream); }
-  }
+  ReleaseFinishedInstructions(/*out*/ ready_instruction_list);
   auto* waiting_instruction_list = mut_waiting_instruction_list();
   if (pending_msg_list().size() > 0) {
+    // keep the stream threads busy while the new instructions are analyzed
+    DispatchAndPrescheduleInstructions(ready_instruction_list);
     TmpPendingInstrMsgList tmp_pending_msg_list;
     mut_pending_msg_list()->MoveTo(&tmp_pending_msg_list);
     FilterAndRunSourceInstructions(&tmp_pending_msg_list);
+    FuseInstructionMsgs(&tmp_pending_msg_list);
     NewInstructionList new_instruction_list;
     MakeInstructions(&tmp_pending_msg_list, /*out*/ &new_instruction_list);
     ConsumeMirroredObjects(mut_id2logical_object(), &new_instruction_list);
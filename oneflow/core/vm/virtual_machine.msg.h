@@ -67,6 +67,8 @@ OBJECT_MSG_BEGIN(VirtualMachine);
   using TmpPendingInstrMsgList = OBJECT_MSG_LIST(InstructionMsg, instr_msg_link);
   using NewInstructionList = OBJECT_MSG_LIST(Instruction, instruction_link);
   using PrescheduledInstructionList = OBJECT_MSG_LIST(Instruction, instruction_link);
+  using FinishedInstructionList = OBJECT_MSG_LIST(Instruction, instruction_link);
+  using DispatchedInstructionList = OBJECT_MSG_LIST(Instruction, pending_instruction_link);
   using WaitingInstructionList = VirtualMachine::waiting_instruction_list_ObjectMsgListType;
   using ReadyInstructionList = VirtualMachine::ready_instruction_list_ObjectMsgListType;
   using Id2LogicalObject = VirtualMachine::id2logical_object_ObjectMsgSkipListType;
@@ -74,9 +76,11 @@ OBJECT_MSG_BEGIN(VirtualMachine);
 
   void ReleaseInstruction(Instruction* instruction,
                             /*out*/ ReadyInstructionList* ready_instruction_list);
-  void TryReleaseFinishedInstructions(
-          Stream* stream, /*out*/ ReadyInstructionList* ready_instruction_list);
+  void TryMoveFinishedInstructions(
+          Stream* stream, /*out*/ FinishedInstructionList* finished_instruction_list);
+  void ReleaseFinishedInstructions(/*out*/ ReadyInstructionList* ready_instruction_list);
   void FilterAndRunSourceInstructions(TmpPendingInstrMsgList* instr_msg_list);
+  void FuseInstructionMsgs(TmpPendingInstrMsgList* instr_msg_list);
   void MakeInstructions(TmpPendingInstrMsgList* instr_msg_list,
                          /*out*/ NewInstructionList* ret_instruction_list);
   template<int64_t (*TransformLogicalObjectId)(int64_t), typename DoEachT>
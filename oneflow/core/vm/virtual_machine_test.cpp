@@ -14,6 +14,9 @@ See the License for the specific language governing permissions and
 limitations under the License.
 */
 #include <iostream>
+#include <atomic>
+#include <thread>
+#include <mutex>
 #include "oneflow/core/vm/virtual_machine.msg.h"
 #include "oneflow/core/vm/control_stream_type.h"
 #include "oneflow/core/vm/vm_desc.msg.h"
@@ -22,8 +25,11 @@ limitations under the License.
 #include "oneflow/core/vm/vm_util.h"
 #include "oneflow/core/vm/test_util.h"
 #include "oneflow/core/vm/stream_desc.msg.h"
+#include "oneflow/core/vm/cpu_stream_type.h"
+#include "oneflow/core/vm/instruction.msg.h"
 #include "oneflow/core/object_msg/object_msg_reflection.h"
 #include "oneflow/core/common/util.h"
+#include "oneflow/core/common/benchmark_test_util.h"
 
 namespace oneflow {
 namespace vm {
@@ -47,6 +53,220 @@ TEST(VirtualMachine, ToDot) {
   // std::cout << std::endl;
 }
 
+using InstructionMsgList = OBJECT_MSG_LIST(InstructionMsg, instr_msg_link);
+
+std::atomic<int64_t> fusible_infer_cnt(0);
+std::atomic<int64_t> fusible_compute_cnt(0);
+
+class FusibleTestInstructionType final : public InstructionType {
+ public:
+  FusibleTestInstructionType() = default;
+  ~FusibleTestInstructionType() override = default;
+
+  using stream_type = CpuStreamType;
+
+  bool Fusible() const override { return true; }
+  void Infer(Instruction* instruction) const override { ++fusible_infer_cnt; }
+  void Compute(Instruction* instruction) const override { ++fusible_compute_cnt; }
+};
+COMMAND(RegisterInstructionType<FusibleTestInstructionType>("test.Fusible"));
+
+size_t NumInstructions(VirtualMachine* vm) {
+  size_t num = vm->waiting_instruction_list().size() + vm->ready_instruction_list().size();
+  OBJECT_MSG_LIST_UNSAFE_FOR_EACH_PTR(vm->mut_active_stream_list(), stream) {
+    num += stream->running_instruction_list().size();
+  }
+  return num;
+}
+
+void RunUntilEmpty(VirtualMachine* vm) {
+  while (!vm->Empty()) {
+    vm->Schedule();
+    OBJECT_MSG_LIST_FOR_EACH_PTR(vm->mut_thread_ctx_list(), t) { t->TryReceiveAndRun(); }
+  }
+}
+
+TEST(VirtualMachine, fuse_instructions) {
+  TestResourceDescScope scope(1, 1);
+  auto vm_desc = ObjectMsgPtr<VmDesc>::New(TestUtil::NewVmResourceDesc().Get());
+  TestUtil::AddStreamDescByInstrNames(vm_desc.Mutable(), {"test.Fusible", "NewObject"});
+  auto vm = ObjectMsgPtr<VirtualMachine>::New(vm_desc.Get());
+  InstructionMsgList list;
+  int64_t x = TestUtil::NewObject(&list, "cpu", "0:0");
+  int64_t y = TestUtil::NewObject(&list, "cpu", "0:0");
+  int64_t z = TestUtil::NewObject(&list, "cpu", "0:0");
+  int64_t w = TestUtil::NewObject(&list, "cpu", "0:0");
+  vm->Receive(&list);
+  RunUntilEmpty(vm.Mutable());
+  fusible_infer_cnt = 0;
+  fusible_compute_cnt = 0;
+  // y = f(x); z = g(y); w = h(x, z): a chain reading what it wrote, fused into one pair
+  list.EmplaceBack(NewInstruction("test.Fusible")->add_const_operand(x)->add_mut_operand(y));
+  list.EmplaceBack(NewInstruction("test.Fusible")->add_const_operand(y)->add_mut_operand(z));
+  auto instr_msg = NewInstruction("test.Fusible");
+  instr_msg->add_const_operand(x);
+  instr_msg->add_const_operand(z);
+  instr_msg->add_mut_operand(w);
+  list.EmplaceBack(std::move(instr_msg));
+  vm->Receive(&list);
+  ASSERT_EQ(vm->pending_msg_list().size(), 3 * 2);
+  vm->Schedule();
+  ASSERT_EQ(NumInstructions(vm.Mutable()), 1 * 2);
+  RunUntilEmpty(vm.Mutable());
+  ASSERT_EQ(fusible_infer_cnt, 3);
+  ASSERT_EQ(fusible_compute_cnt, 3);
+  // the second instruction overwrites y which the first one writes, they are not fused
+  list.EmplaceBack(NewInstruction("test.Fusible")->add_const_operand(x)->add_mut_operand(y));
+  list.EmplaceBack(NewInstruction("test.Fusible")->add_const_operand(z)->add_mut_operand(y));
+  vm->Receive(&list);
+  vm->Schedule();
+  ASSERT_EQ(NumInstructions(vm.Mutable()), 2 * 2);
+  RunUntilEmpty(vm.Mutable());
+  ASSERT_EQ(fusible_infer_cnt, 5);
+  ASSERT_EQ(fusible_compute_cnt, 5);
+}
+
+// Runs every ThreadCtx that does not share the scheduler thread on a dedicated dispatch thread,
+// the way OneflowVM does.
+class DispatchThreads final {
+ public:
+  explicit DispatchThreads(VirtualMachine* vm) : vm_(vm) {
+    OBJECT_MSG_LIST_UNSAFE_FOR_EACH_PTR(vm_->mut_thread_ctx_list(), thread_ctx) {
+      if (thread_ctx->stream_rt_desc().stream_type().SharingVirtualMachineThread()) { continue; }
+      threads_.emplace_back(&ThreadCtx::LoopRun, thread_ctx);
+    }
+  }
+  ~DispatchThreads() {
+    OBJECT_MSG_LIST_UNSAFE_FOR_EACH_PTR(vm_->mut_thread_ctx_list(), thread_ctx) {
+      thread_ctx->mut_pending_instruction_list()->Close();
+    }
+    for (auto& thread : threads_) { thread.join(); }
+  }
+
+ private:
+  VirtualMachine* vm_;
+  std::vector<std::thread> threads_;
+};
+
+void ScheduleUntilEmpty(VirtualMachine* vm) {
+  while (!vm->Empty()) { vm->Schedule(); }
+}
+
+std::mutex computed_seqs_mutex;
+HashMap<int64_t, std::vector<int64_t>> global_device_id2computed_seqs;
+
+// clang-format off
+FLAT_MSG_VIEW_BEGIN(RecordTestInstruction);
+  FLAT_MSG_VIEW_DEFINE_PATTERN(MutOperand, object);
+  FLAT_MSG_VIEW_DEFINE_PATTERN(int64_t, seq);
+FLAT_MSG_VIEW_END(RecordTestInstruction);
+// clang-format on
+
+// records the seq operand of every instruction computed, per stream
+class RecordTestInstructionType final : public InstructionType {
+ public:
+  RecordTestInstructionType() = default;
+  ~RecordTestInstructionType() override = default;
+
+  using stream_type = CpuStreamType;
+
+  void Infer(Instruction* instruction) const override {}
+  void Compute(Instruction* instruction) const override {
+    FlatMsgView<RecordTestInstruction> view;
+    CHECK(view.Match(instruction->instr_msg().operand()));
+    std::unique_lock<std::mutex> lock(computed_seqs_mutex);
+    global_device_id2computed_seqs[instruction->stream().global_device_id()].push_back(
+        view->seq());
+  }
+};
+COMMAND(RegisterInstructionType<RecordTestInstructionType>("test.Record"));
+
+TEST(VirtualMachine, dispatch_threads_keep_stream_order) {
+  TestResourceDescScope scope(1, 2);
+  const int64_t parallel_num = 2;
+  auto vm_desc = ObjectMsgPtr<VmDesc>::New(TestUtil::NewVmResourceDesc().Get());
+  TestUtil::AddStreamDescByInstrNames(vm_desc.Mutable(), {"NewObject"});
+  TestUtil::AddStreamDescByInstrNames(vm_desc.Mutable(), parallel_num, {"test.Record"});
+  auto vm = ObjectMsgPtr<VirtualMachine>::New(vm_desc.Get());
+  DispatchThreads dispatch_threads(vm.Mutable());
+  const int64_t num_objects = 4;
+  std::vector<int64_t> object_ids;
+  {
+    InstructionMsgList list;
+    FOR_RANGE(int64_t, i, 0, num_objects) {
+      object_ids.push_back(TestUtil::NewObject(&list, "cpu", "0:0-1"));
+    }
+    vm->Receive(&list);
+    ScheduleUntilEmpty(vm.Mutable());
+  }
+  global_device_id2computed_seqs.clear();
+  // instructions on different objects do not depend on each other, only the stream orders them.
+  // They arrive in batches, so the dispatch threads run while the scheduler still receives.
+  const int64_t num_instructions = 2000;
+  const int64_t batch_size = 100;
+  for (int64_t batch_begin = 0; batch_begin < num_instructions; batch_begin += batch_size) {
+    InstructionMsgList list;
+    FOR_RANGE(int64_t, seq, batch_begin, batch_begin + batch_size) {
+      list.EmplaceBack(NewInstruction("test.Record")
+                           ->add_mut_operand(object_ids.at(seq % num_objects))
+                           ->add_int64_operand(seq));
+    }
+    vm->Receive(&list);
+    vm->Schedule();
+  }
+  ScheduleUntilEmpty(vm.Mutable());
+  std::unique_lock<std::mutex> lock(computed_seqs_mutex);
+  ASSERT_EQ(global_device_id2computed_seqs.size(), parallel_num);
+  for (const auto& pair : global_device_id2computed_seqs) {
+    const std::vector<int64_t>& seqs = pair.second;
+    ASSERT_EQ(seqs.size(), num_instructions);
+    FOR_RANGE(int64_t, seq, 0, num_instructions) { ASSERT_EQ(seqs.at(seq), seq); }
+  }
+}
+
+TEST(VirtualMachine, DISABLED_benchmark) {
+  TestResourceDescScope scope(1, 1);
+  auto vm_desc = ObjectMsgPtr<VmDesc>::New(TestUtil::NewVmResourceDesc().Get());
+  TestUtil::AddStreamDescByInstrNames(vm_desc.Mutable(), {"Nop", "NewObject"});
+  auto vm = ObjectMsgPtr<VirtualMachine>::New(vm_desc.Get());
+  DispatchThreads dispatch_threads(vm.Mutable());
+  const int64_t num_objects = 16;
+  std::vector<int64_t> object_ids;
+  {
+    InstructionMsgList list;
+    FOR_RANGE(int64_t, i, 0, num_objects) {
+      object_ids.push_back(TestUtil::NewObject(&list, "cpu", "0:0"));
+    }
+    vm->Receive(&list);
+    ScheduleUntilEmpty(vm.Mutable());
+  }
+  // throughput: independent chains of small instructions, received in one batch
+  const int64_t num_instructions = 100000;
+  const double throughput_ms = oneflow::test::BenchmarkMilliseconds([&]() {
+    InstructionMsgList list;
+    FOR_RANGE(int64_t, i, 0, num_instructions) {
+      auto instr_msg = NewInstruction("Nop");
+      instr_msg->add_mut_operand(object_ids.at(i % num_objects));
+      list.EmplaceBack(std::move(instr_msg));
+    }
+    vm->Receive(&list);
+    ScheduleUntilEmpty(vm.Mutable());
+  });
+  // latency: one instruction at a time, from Receive until the virtual machine is empty again
+  const int64_t num_rounds = 10000;
+  const double latency_ms = oneflow::test::BenchmarkMilliseconds([&]() {
+    FOR_RANGE(int64_t, i, 0, num_rounds) {
+      auto instr_msg = NewInstruction("Nop");
+      instr_msg->add_mut_operand(object_ids.at(i % num_objects));
+      vm->Receive(std::move(instr_msg));
+      ScheduleUntilEmpty(vm.Mutable());
+    }
+  });
+  ASSERT_TRUE(vm->Empty());
+  LOG(INFO) << "VirtualMachine: " << num_instructions / throughput_ms * 1e3
+            << " instructions/sec, scheduling latency " << latency_ms / num_rounds * 1e3 << " us";
+}
+
 }  // namespace
 
 }  // namespace test
@@ -15,7 +15,6 @@ limitations under the License.
 */
 #include "oneflow/core/framework/framework.h"
 #include "oneflow/core/thread/thread_manager.h"
-#include "oneflow/core/common/balanced_splitter.h"
 
 namespace oneflow {
 
@@ -34,21 +33,13 @@ class CpuArgMaxKernel final : public user_op::OpKernel {
 
     const int32_t instance_size = in->shape().At(in->shape().NumAxes() - 1);
     const int32_t instance_num = in->shape().elem_cnt() / instance_size;
-    const int32_t num_thread = std::min(instance_num, Global<ThreadPool>::Get()->thread_num());
-    const BalancedSplitter bs(instance_num, num_thread);
-    BlockingCounter bc(num_thread);
-    FOR_RANGE(int32_t, thread_id, 0, num_thread) {
-      const Range range = bs.At(thread_id);
-      Global<ThreadPool>::Get()->AddWork([=, &bc]() {
-        FOR_RANGE(int32_t, i, range.begin(), range.end()) {
-          const T* in_ptr_i = in_ptr + i * instance_size;
-          out_ptr[i] =
-              std::distance(in_ptr_i, std::max_element(in_ptr_i, in_ptr_i + instance_size));
-        }
-        bc.Decrease();
-      });
-    }
-    bc.WaitUntilCntEqualZero();
+    const int64_t grain_size = MultiThreadLoopGrainSize(instance_size * sizeof(T));
+    MultiThreadLoop(instance_num, grain_size, [&](int64_t begin, int64_t end) {
+      FOR_RANGE(int64_t, i, begin, end) {
+        const T* in_ptr_i = in_ptr + i * instance_size;
+        out_ptr[i] = std::distance(in_ptr_i, std::max_element(in_ptr_i, in_ptr_i + instance_size));
+      }
+    });
   }
   bool AlwaysComputeWhenAllOutputsEmpty() const override { return false; }
 };
@@ -77,8 +77,10 @@ class ImageDecodeKernel final : public user_op::OpKernel {
     const std::string& color_space = ctx->Attr<std::string>("color_space");
     const DataType data_type = ctx->Attr<DataType>("data_type");
 
-    MultiThreadLoop(in_tensor->shape().elem_cnt(), [&](size_t i) {
-      DecodeImage(in_img_buf[i], out_img_buf + i, color_space, data_type);
+    MultiThreadLoop(in_tensor->shape().elem_cnt(), 1, [&](int64_t begin, int64_t end) {
+      FOR_RANGE(int64_t, i, begin, end) {
+        DecodeImage(in_img_buf[i], out_img_buf + i, color_space, data_type);
+      }
     });
   }
   bool AlwaysComputeWhenAllOutputsEmpty() const override { return false; }
@@ -228,13 +228,15 @@ class ImageFlipKernel final : public user_op::OpKernel {
     int num_images = in_tensor->shape().elem_cnt();
     CHECK_EQ(out_tensor->shape().elem_cnt(), num_images);
 
-    MultiThreadLoop(num_images, [&](size_t i) {
-      const TensorBuffer& in_buffer = in_tensor->dptr<TensorBuffer>()[i];
-      CHECK_EQ(in_buffer.shape().NumAxes(), 3);
-      TensorBuffer* out_buffer = out_tensor->mut_dptr<TensorBuffer>() + i;
-      out_buffer->CopyFrom(in_buffer);
-      FlipCode flip_code = static_cast<FlipCode>(flip_code_tensor->dptr<int8_t>()[i]);
-      if (flip_code != FlipCode::kNonFlip) { FlipImage(out_buffer, flip_code); }
+    MultiThreadLoop(num_images, 1, [&](int64_t begin, int64_t end) {
+      FOR_RANGE(int64_t, i, begin, end) {
+        const TensorBuffer& in_buffer = in_tensor->dptr<TensorBuffer>()[i];
+        CHECK_EQ(in_buffer.shape().NumAxes(), 3);
+        TensorBuffer* out_buffer = out_tensor->mut_dptr<TensorBuffer>() + i;
+        out_buffer->CopyFrom(in_buffer);
+        FlipCode flip_code = static_cast<FlipCode>(flip_code_tensor->dptr<int8_t>()[i]);
+        if (flip_code != FlipCode::kNonFlip) { FlipImage(out_buffer, flip_code); }
+      }
     });
   }
   bool AlwaysComputeWhenAllOutputsEmpty() const override { return false; }
@@ -258,17 +260,19 @@ class ObjectBboxFlipKernel final : public user_op::OpKernel {
     CHECK_EQ(image_size_tensor->shape().At(0), num_images);
     CHECK_EQ(flip_code_tensor->shape().elem_cnt(), num_images);
 
-    MultiThreadLoop(num_images, [&](size_t i) {
-      const TensorBuffer& bbox_buffer = bbox_tensor->dptr<TensorBuffer>()[i];
-      CHECK_EQ(bbox_buffer.shape().NumAxes(), 2);
-      CHECK_EQ(bbox_buffer.shape().At(1), 4);
-      TensorBuffer* out_bbox_buffer = out_tensor->mut_dptr<TensorBuffer>() + i;
-      out_bbox_buffer->CopyFrom(bbox_buffer);
-      int32_t image_height = image_size_tensor->dptr<int32_t>()[i * 2 + 0];
-      int32_t image_width = image_size_tensor->dptr<int32_t>()[i * 2 + 1];
-      FlipCode flip_code = static_cast<FlipCode>(flip_code_tensor->dptr<int8_t>()[i]);
-      SwitchFlipBoxes(SwitchCase(out_bbox_buffer->data_type()), out_bbox_buffer, image_height,
-                      image_width, flip_code);
+    MultiThreadLoop(num_images, 1, [&](int64_t begin, int64_t end) {
+      FOR_RANGE(int64_t, i, begin, end) {
+        const TensorBuffer& bbox_buffer = bbox_tensor->dptr<TensorBuffer>()[i];
+        CHECK_EQ(bbox_buffer.shape().NumAxes(), 2);
+        CHECK_EQ(bbox_buffer.shape().At(1), 4);
+        TensorBuffer* out_bbox_buffer = out_tensor->mut_dptr<TensorBuffer>() + i;
+        out_bbox_buffer->CopyFrom(bbox_buffer);
+        int32_t image_height = image_size_tensor->dptr<int32_t>()[i * 2 + 0];
+        int32_t image_width = image_size_tensor->dptr<int32_t>()[i * 2 + 1];
+        FlipCode flip_code = static_cast<FlipCode>(flip_code_tensor->dptr<int8_t>()[i]);
+        SwitchFlipBoxes(SwitchCase(out_bbox_buffer->data_type()), out_bbox_buffer, image_height,
+                        image_width, flip_code);
+      }
     });
   }
   bool AlwaysComputeWhenAllOutputsEmpty() const override { return false; }
@@ -290,15 +294,18 @@ class ObjectBboxScaleKernel final : public user_op::OpKernel {
     CHECK_EQ(scale_tensor->shape().At(0), num_images);
     CHECK_EQ(out_tensor->shape().elem_cnt(), num_images);
 
-    MultiThreadLoop(num_images, [&](size_t i) {
-      const TensorBuffer& bbox_buffer = bbox_tensor->dptr<TensorBuffer>()[i];
-      CHECK_EQ(bbox_buffer.shape().NumAxes(), 2);
-      CHECK_EQ(bbox_buffer.shape().At(1), 4);
-      TensorBuffer* out_bbox_buffer = out_tensor->mut_dptr<TensorBuffer>() + i;
-      out_bbox_buffer->CopyFrom(bbox_buffer);
-      float scale_h = scale_tensor->dptr<float>()[i * 2 + 0];
-      float scale_w = scale_tensor->dptr<float>()[i * 2 + 1];
-      SwitchScaleBoxes(SwitchCase(out_bbox_buffer->data_type()), out_bbox_buffer, scale_h, scale_w);
+    MultiThreadLoop(num_images, 1, [&](int64_t begin, int64_t end) {
+      FOR_RANGE(int64_t, i, begin, end) {
+        const TensorBuffer& bbox_buffer = bbox_tensor->dptr<TensorBuffer>()[i];
+        CHECK_EQ(bbox_buffer.shape().NumAxes(), 2);
+        CHECK_EQ(bbox_buffer.shape().At(1), 4);
+        TensorBuffer* out_bbox_buffer = out_tensor->mut_dptr<TensorBuffer>() + i;
+        out_bbox_buffer->CopyFrom(bbox_buffer);
+        float scale_h = scale_tensor->dptr<float>()[i * 2 + 0];
+        float scale_w = scale_tensor->dptr<float>()[i * 2 + 1];
+        SwitchScaleBoxes(SwitchCase(out_bbox_buffer->data_type()), out_bbox_buffer, scale_h,
+                         scale_w);
+      }
     });
   }
   bool AlwaysComputeWhenAllOutputsEmpty() const override { return false; }
@@ -322,17 +329,19 @@ class ObjectSegmentationPolygonFlipKernel final : public user_op::OpKernel {
     CHECK_EQ(image_size_tensor->shape().At(0), num_images);
     CHECK_EQ(flip_code_tensor->shape().elem_cnt(), num_images);
 
-    MultiThreadLoop(num_images, [&](size_t i) {
-      const TensorBuffer& polygons_buffer = polygon_tensor->dptr<TensorBuffer>()[i];
-      CHECK_EQ(polygons_buffer.shape().NumAxes(), 2);
-      CHECK_EQ(polygons_buffer.shape().At(1), 2);
-      TensorBuffer* out_polygons_buffer = out_tensor->mut_dptr<TensorBuffer>() + i;
-      out_polygons_buffer->CopyFrom(polygons_buffer);
-      int32_t image_height = image_size_tensor->dptr<int32_t>()[i * 2 + 0];
-      int32_t image_width = image_size_tensor->dptr<int32_t>()[i * 2 + 1];
-      FlipCode flip_code = static_cast<FlipCode>(flip_code_tensor->dptr<int8_t>()[i]);
-      SwitchFlipPolygons(SwitchCase(out_polygons_buffer->data_type()), out_polygons_buffer,
-                         image_height, image_width, flip_code);
+    MultiThreadLoop(num_images, 1, [&](int64_t begin, int64_t end) {
+      FOR_RANGE(int64_t, i, begin, end) {
+        const TensorBuffer& polygons_buffer = polygon_tensor->dptr<TensorBuffer>()[i];
+        CHECK_EQ(polygons_buffer.shape().NumAxes(), 2);
+        CHECK_EQ(polygons_buffer.shape().At(1), 2);
+        TensorBuffer* out_polygons_buffer = out_tensor->mut_dptr<TensorBuffer>() + i;
+        out_polygons_buffer->CopyFrom(polygons_buffer);
+        int32_t image_height = image_size_tensor->dptr<int32_t>()[i * 2 + 0];
+        int32_t image_width = image_size_tensor->dptr<int32_t>()[i * 2 + 1];
+        FlipCode flip_code = static_cast<FlipCode>(flip_code_tensor->dptr<int8_t>()[i]);
+        SwitchFlipPolygons(SwitchCase(out_polygons_buffer->data_type()), out_polygons_buffer,
+                           image_height, image_width, flip_code);
+      }
     });
   }
   bool AlwaysComputeWhenAllOutputsEmpty() const override { return false; }
@@ -354,16 +363,18 @@ class ObjectSegmentationPolygonScaleKernel final : public user_op::OpKernel {
     CHECK_EQ(scale_tensor->shape().At(0), num_images);
     CHECK_EQ(out_tensor->shape().elem_cnt(), num_images);
 
-    MultiThreadLoop(num_images, [&](size_t i) {
-      const TensorBuffer& poly_buffer = poly_tensor->dptr<TensorBuffer>()[i];
-      CHECK_EQ(poly_buffer.shape().NumAxes(), 2);
-      CHECK_EQ(poly_buffer.shape().At(1), 2);
-      TensorBuffer* out_poly_buffer = out_tensor->mut_dptr<TensorBuffer>() + i;
-      out_poly_buffer->CopyFrom(poly_buffer);
-      float scale_h = scale_tensor->dptr<float>()[i * 2 + 0];
-      float scale_w = scale_tensor->dptr<float>()[i * 2 + 1];
-      SwitchScalePolygons(SwitchCase(out_poly_buffer->data_type()), out_poly_buffer, scale_h,
-                          scale_w);
+    MultiThreadLoop(num_images, 1, [&](int64_t begin, int64_t end) {
+      FOR_RANGE(int64_t, i, begin, end) {
+        const TensorBuffer& poly_buffer = poly_tensor->dptr<TensorBuffer>()[i];
+        CHECK_EQ(poly_buffer.shape().NumAxes(), 2);
+        CHECK_EQ(poly_buffer.shape().At(1), 2);
+        TensorBuffer* out_poly_buffer = out_tensor->mut_dptr<TensorBuffer>() + i;
+        out_poly_buffer->CopyFrom(poly_buffer);
+        float scale_h = scale_tensor->dptr<float>()[i * 2 + 0];
+        float scale_w = scale_tensor->dptr<float>()[i * 2 + 1];
+        SwitchScalePolygons(SwitchCase(out_poly_buffer->data_type()), out_poly_buffer, scale_h,
+                            scale_w);
+      }
     });
   }
   bool AlwaysComputeWhenAllOutputsEmpty() const override { return false; }
@@ -383,13 +394,15 @@ class ImageNormalize final : public user_op::OpKernel {
     const auto& std_vec = ctx->Attr<std::vector<float>>("std");
     const auto& mean_vec = ctx->Attr<std::vector<float>>("mean");
 
-    MultiThreadLoop(num_images, [&](size_t i) {
-      const TensorBuffer& in_buffer = in_tensor->dptr<TensorBuffer>()[i];
-      CHECK_EQ(in_buffer.shape().NumAxes(), 3);
-      TensorBuffer* out_buffer = out_tensor->mut_dptr<TensorBuffer>() + i;
-      out_buffer->CopyFrom(in_buffer);
-      SwitchImageNormalizeByChannel(SwitchCase(out_buffer->data_type()), out_buffer, std_vec,
-                                    mean_vec);
+    MultiThreadLoop(num_images, 1, [&](int64_t begin, int64_t end) {
+      FOR_RANGE(int64_t, i, begin, end) {
+        const TensorBuffer& in_buffer = in_tensor->dptr<TensorBuffer>()[i];
+        CHECK_EQ(in_buffer.shape().NumAxes(), 3);
+        TensorBuffer* out_buffer = out_tensor->mut_dptr<TensorBuffer>() + i;
+        out_buffer->CopyFrom(in_buffer);
+        SwitchImageNormalizeByChannel(SwitchCase(out_buffer->data_type()), out_buffer, std_vec,
+                                      mean_vec);
+      }
     });
   }
   bool AlwaysComputeWhenAllOutputsEmpty() const override { return false; }
@@ -413,14 +426,17 @@ class ObjectSegmentationPolygonToMask final : public user_op::OpKernel {
     CHECK_EQ(image_size_tensor->shape().At(0), num_images);
     CHECK_EQ(mask_tensor->shape().elem_cnt(), num_images);
 
-    MultiThreadLoop(num_images, [&](size_t i) {
-      const TensorBuffer& poly_buffer = poly_tensor->dptr<TensorBuffer>()[i];
-      const TensorBuffer& poly_index_buffer = poly_index_tensor->dptr<TensorBuffer>()[i];
-      int32_t image_height = image_size_tensor->dptr<int32_t>()[i * 2 + 0];
-      int32_t image_width = image_size_tensor->dptr<int32_t>()[i * 2 + 1];
-      TensorBuffer* mask_buffer = mask_tensor->mut_dptr<TensorBuffer>() + i;
-      SwitchPolygonsToMask(SwitchCase(poly_buffer.data_type(), poly_index_buffer.data_type()),
-                           poly_buffer, poly_index_buffer, mask_buffer, image_height, image_width);
+    MultiThreadLoop(num_images, 1, [&](int64_t begin, int64_t end) {
+      FOR_RANGE(int64_t, i, begin, end) {
+        const TensorBuffer& poly_buffer = poly_tensor->dptr<TensorBuffer>()[i];
+        const TensorBuffer& poly_index_buffer = poly_index_tensor->dptr<TensorBuffer>()[i];
+        int32_t image_height = image_size_tensor->dptr<int32_t>()[i * 2 + 0];
+        int32_t image_width = image_size_tensor->dptr<int32_t>()[i * 2 + 1];
+        TensorBuffer* mask_buffer = mask_tensor->mut_dptr<TensorBuffer>() + i;
+        SwitchPolygonsToMask(SwitchCase(poly_buffer.data_type(), poly_index_buffer.data_type()),
+                             poly_buffer, poly_index_buffer, mask_buffer, image_height,
+                             image_width);
+      }
     });
   }
   bool AlwaysComputeWhenAllOutputsEmpty() const override { return false; }
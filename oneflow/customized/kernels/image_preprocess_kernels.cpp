@@ -66,17 +66,19 @@ class ResizeToStaticShapeKernel final : public user_op::OpKernel {
     int64_t one_sample_elem_cnt = rsz_h * rsz_w * C;
     int opencv_inter_type = GetOpencvInterp(interp_type);
 
-    MultiThreadLoop(record_num, [&](size_t i) {
-      const TensorBuffer* buffer = buffers + i;
-      uint8_t* dptr = out_dptr + one_sample_elem_cnt * i;
-      const Shape& in_shape = buffer->shape();
-      CHECK(in_shape.NumAxes() == 3);  // {H, W, C}
-      int H = in_shape.At(0);
-      int W = in_shape.At(1);
-      CHECK_EQ(C, in_shape.At(2));
-      const cv::Mat image = CreateMatWithPtr(H, W, channel_flag, buffer->data<uint8_t>());
-      cv::Mat rsz_image = CreateMatWithPtr(rsz_h, rsz_w, channel_flag, dptr);
-      cv::resize(image, rsz_image, cv::Size(rsz_w, rsz_h), 0, 0, opencv_inter_type);
+    MultiThreadLoop(record_num, 1, [&](int64_t begin, int64_t end) {
+      FOR_RANGE(int64_t, i, begin, end) {
+        const TensorBuffer* buffer = buffers + i;
+        uint8_t* dptr = out_dptr + one_sample_elem_cnt * i;
+        const Shape& in_shape = buffer->shape();
+        CHECK(in_shape.NumAxes() == 3);  // {H, W, C}
+        int H = in_shape.At(0);
+        int W = in_shape.At(1);
+        CHECK_EQ(C, in_shape.At(2));
+        const cv::Mat image = CreateMatWithPtr(H, W, channel_flag, buffer->data<uint8_t>());
+        cv::Mat rsz_image = CreateMatWithPtr(rsz_h, rsz_w, channel_flag, dptr);
+        cv::resize(image, rsz_image, cv::Size(rsz_w, rsz_h), 0, 0, opencv_inter_type);
+      }
     });
   }
   bool AlwaysComputeWhenAllOutputsEmpty() const override { return false; }
@@ -104,31 +106,34 @@ class ResizeShorterToTensorBufferKernel final : public user_op::OpKernel {
     TensorBuffer* out_buffers = out_blob->mut_dptr<TensorBuffer>();
     int64_t resize_shorter = ctx->Attr<int64_t>("resize_shorter");
 
-    MultiThreadLoop(record_num, [&](size_t i) {
-      const TensorBuffer* in_buffer = in_buffers + i;
-      TensorBuffer* out_buffer = out_buffers + i;
-      const Shape& in_shape = in_buffer->shape();
-      CHECK_EQ(in_shape.NumAxes(), 3);  // {H, W, C}
-      int64_t H = in_shape.At(0);
-      int64_t W = in_shape.At(1);
-      int64_t C = in_shape.At(2);
-      CHECK(C == 3 || C == 1);
-      int64_t rsz_h = resize_shorter;
-      int64_t rsz_w = resize_shorter;
-      if (H < W) {
-        rsz_w = resize_shorter * (static_cast<float>(W) / static_cast<float>(H));
-      } else {
-        rsz_h = resize_shorter * (static_cast<float>(H) / static_cast<float>(W));
+    MultiThreadLoop(record_num, 1, [&](int64_t begin, int64_t end) {
+      FOR_RANGE(int64_t, i, begin, end) {
+        const TensorBuffer* in_buffer = in_buffers + i;
+        TensorBuffer* out_buffer = out_buffers + i;
+        const Shape& in_shape = in_buffer->shape();
+        CHECK_EQ(in_shape.NumAxes(), 3);  // {H, W, C}
+        int64_t H = in_shape.At(0);
+        int64_t W = in_shape.At(1);
+        int64_t C = in_shape.At(2);
+        CHECK(C == 3 || C == 1);
+        int64_t rsz_h = resize_shorter;
+        int64_t rsz_w = resize_shorter;
+        if (H < W) {
+          rsz_w = resize_shorter * (static_cast<float>(W) / static_cast<float>(H));
+        } else {
+          rsz_h = resize_shorter * (static_cast<float>(H) / static_cast<float>(W));
+        }
+        Shape out_shape({rsz_h, rsz_w, C});
+        out_buffer->Resize(out_shape, DataType::kUInt8);
+        int channel_flag = C == 3 ? CV_8UC3 : CV_8UC1;
+        const std::string& interp_type = ctx->Attr<std::string>("interp_type");
+        int opencv_inter_type = GetOpencvInterp(interp_type);
+
+        const cv::Mat image = CreateMatWithPtr(H, W, channel_flag, in_buffer->data<uint8_t>());
+        cv::Mat rsz_image =
+            CreateMatWithPtr(rsz_h, rsz_w, channel_flag, out_buffer->data<uint8_t>());
+        cv::resize(image, rsz_image, cv::Size(rsz_w, rsz_h), 0, 0, opencv_inter_type);
       }
-      Shape out_shape({rsz_h, rsz_w, C});
-      out_buffer->Resize(out_shape, DataType::kUInt8);
-      int channel_flag = C == 3 ? CV_8UC3 : CV_8UC1;
-      const std::string& interp_type = ctx->Attr<std::string>("interp_type");
-      int opencv_inter_type = GetOpencvInterp(interp_type);
-
-      const cv::Mat image = CreateMatWithPtr(H, W, channel_flag, in_buffer->data<uint8_t>());
-      cv::Mat rsz_image = CreateMatWithPtr(rsz_h, rsz_w, channel_flag, out_buffer->data<uint8_t>());
-      cv::resize(image, rsz_image, cv::Size(rsz_w, rsz_h), 0, 0, opencv_inter_type);
     });
   }
   bool AlwaysComputeWhenAllOutputsEmpty() const override { return false; }
@@ -277,15 +282,19 @@ class CropMirrorNormalizeFromStaticShapeToFloatKernel final : public user_op::Op
       int64_t out_H = out_shape.At(2);
       int64_t out_W = out_shape.At(3);
       int64_t out_image_elem_cnt = C * out_H * out_W;
-      MultiThreadLoop(record_num, [&](size_t i) {
-        if (mirror.at(i)) {
-          CMN1Sample<TensorLayout::kNCHW, true>(
-              C, in_H, in_W, out_H, out_W, crop_pos_y, crop_pos_x, in_dptr + in_image_elem_cnt * i,
-              out_dptr + out_image_elem_cnt * i, mean_vec, inv_std_vec);
-        } else {
-          CMN1Sample<TensorLayout::kNCHW, false>(
-              C, in_H, in_W, out_H, out_W, crop_pos_y, crop_pos_x, in_dptr + in_image_elem_cnt * i,
-              out_dptr + out_image_elem_cnt * i, mean_vec, inv_std_vec);
+      MultiThreadLoop(record_num, 1, [&](int64_t begin, int64_t end) {
+        FOR_RANGE(int64_t, i, begin, end) {
+          if (mirror.at(i)) {
+            CMN1Sample<TensorLayout::kNCHW, true>(
+                C, in_H, in_W, out_H, out_W, crop_pos_y, crop_pos_x,
+                in_dptr + in_image_elem_cnt * i, out_dptr + out_image_elem_cnt * i, mean_vec,
+                inv_std_vec);
+          } else {
+            CMN1Sample<TensorLayout::kNCHW, false>(
+                C, in_H, in_W, out_H, out_W, crop_pos_y, crop_pos_x,
+                in_dptr + in_image_elem_cnt * i, out_dptr + out_image_elem_cnt * i, mean_vec,
+                inv_std_vec);
+          }
         }
       });
     } else if (output_layout == "NHWC") {
@@ -293,15 +302,19 @@ class CropMirrorNormalizeFromStaticShapeToFloatKernel final : public user_op::Op
       int64_t out_H = out_shape.At(1);
       int64_t out_W = out_shape.At(2);
       int64_t out_image_elem_cnt = C * out_H * out_W;
-      MultiThreadLoop(record_num, [&](size_t i) {
-        if (mirror.at(i)) {
-          CMN1Sample<TensorLayout::kNHWC, true>(
-              C, in_H, in_W, out_H, out_W, crop_pos_y, crop_pos_x, in_dptr + in_image_elem_cnt * i,
-              out_dptr + out_image_elem_cnt * i, mean_vec, inv_std_vec);
-        } else {
-          CMN1Sample<TensorLayout::kNHWC, false>(
-              C, in_H, in_W, out_H, out_W, crop_pos_y, crop_pos_x, in_dptr + in_image_elem_cnt * i,
-              out_dptr + out_image_elem_cnt * i, mean_vec, inv_std_vec);
+      MultiThreadLoop(record_num, 1, [&](int64_t begin, int64_t end) {
+        FOR_RANGE(int64_t, i, begin, end) {
+          if (mirror.at(i)) {
+            CMN1Sample<TensorLayout::kNHWC, true>(
+                C, in_H, in_W, out_H, out_W, crop_pos_y, crop_pos_x,
+                in_dptr + in_image_elem_cnt * i, out_dptr + out_image_elem_cnt * i, mean_vec,
+                inv_std_vec);
+          } else {
+            CMN1Sample<TensorLayout::kNHWC, false>(
+                C, in_H, in_W, out_H, out_W, crop_pos_y, crop_pos_x,
+                in_dptr + in_image_elem_cnt * i, out_dptr + out_image_elem_cnt * i, mean_vec,
+                inv_std_vec);
+          }
         }
       });
     } else {
@@ -355,21 +368,23 @@ class CropMirrorNormalizeFromTensorBufferToFloatKernel final : public user_op::O
       int64_t out_H = out_shape.At(2);
       int64_t out_W = out_shape.At(3);
       int64_t out_image_elem_cnt = C * out_H * out_W;
-      MultiThreadLoop(record_num, [&](size_t i) {
-        const TensorBuffer* in_buffer = in_buffers + i;
-        const Shape& in_shape = in_buffer->shape();
-        CHECK_EQ(in_shape.NumAxes(), 3);  // H, W, C
-        int64_t in_H = in_shape.At(0);
-        int64_t in_W = in_shape.At(1);
-        CHECK_EQ(C, in_shape.At(2));
-        if (mirror.at(i)) {
-          CMN1Sample<TensorLayout::kNCHW, true>(
-              C, in_H, in_W, out_H, out_W, crop_pos_y, crop_pos_x, in_buffer->data<uint8_t>(),
-              out_dptr + out_image_elem_cnt * i, mean_vec, inv_std_vec);
-        } else {
-          CMN1Sample<TensorLayout::kNCHW, false>(
-              C, in_H, in_W, out_H, out_W, crop_pos_y, crop_pos_x, in_buffer->data<uint8_t>(),
-              out_dptr + out_image_elem_cnt * i, mean_vec, inv_std_vec);
+      MultiThreadLoop(record_num, 1, [&](int64_t begin, int64_t end) {
+        FOR_RANGE(int64_t, i, begin, end) {
+          const TensorBuffer* in_buffer = in_buffers + i;
+          const Shape& in_shape = in_buffer->shape();
+          CHECK_EQ(in_shape.NumAxes(), 3);  // H, W, C
+          int64_t in_H = in_shape.At(0);
+          int64_t in_W = in_shape.At(1);
+          CHECK_EQ(C, in_shape.At(2));
+          if (mirror.at(i)) {
+            CMN1Sample<TensorLayout::kNCHW, true>(
+                C, in_H, in_W, out_H, out_W, crop_pos_y, crop_pos_x, in_buffer->data<uint8_t>(),
+                out_dptr + out_image_elem_cnt * i, mean_vec, inv_std_vec);
+          } else {
+            CMN1Sample<TensorLayout::kNCHW, false>(
+                C, in_H, in_W, out_H, out_W, crop_pos_y, crop_pos_x, in_buffer->data<uint8_t>(),
+                out_dptr + out_image_elem_cnt * i, mean_vec, inv_std_vec);
+          }
         }
       });
     } else if (output_layout == "NHWC") {
@@ -377,21 +392,23 @@ class CropMirrorNormalizeFromTensorBufferToFloatKernel final : public user_op::O
       int64_t out_H = out_shape.At(1);
       int64_t out_W = out_shape.At(2);
       int64_t out_image_elem_cnt = C * out_H * out_W;
-      MultiThreadLoop(record_num, [&](size_t i) {
-        const TensorBuffer* in_buffer = in_buffers + i;
-        const Shape& in_shape = in_buffer->shape();
-        CHECK_EQ(in_shape.NumAxes(), 3);  // H, W, C
-        int64_t in_H = in_shape.At(0);
-        int64_t in_W = in_shape.At(1);
-        CHECK_EQ(C, in_shape.At(2));
-        if (mirror.at(i)) {
-          CMN1Sample<TensorLayout::kNHWC, true>(
-              C, in_H, in_W, out_H, out_W, crop_pos_y, crop_pos_x, in_buffer->data<uint8_t>(),
-              out_dptr + out_image_elem_cnt * i, mean_vec, inv_std_vec);
-        } else {
-          CMN1Sample<TensorLayout::kNHWC, false>(
-              C, in_H, in_W, out_H, out_W, crop_pos_y, crop_pos_x, in_buffer->data<uint8_t>(),
-              out_dptr + out_image_elem_cnt * i, mean_vec, inv_std_vec);
+      MultiThreadLoop(record_num, 1, [&](int64_t begin, int64_t end) {
+        FOR_RANGE(int64_t, i, begin, end) {
+          const TensorBuffer* in_buffer = in_buffers + i;
+          const Shape& in_shape = in_buffer->shape();
+          CHECK_EQ(in_shape.NumAxes(), 3);  // H, W, C
+          int64_t in_H = in_shape.At(0);
+          int64_t in_W = in_shape.At(1);
+          CHECK_EQ(C, in_shape.At(2));
+          if (mirror.at(i)) {
+            CMN1Sample<TensorLayout::kNHWC, true>(
+                C, in_H, in_W, out_H, out_W, crop_pos_y, crop_pos_x, in_buffer->data<uint8_t>(),
+                out_dptr + out_image_elem_cnt * i, mean_vec, inv_std_vec);
+          } else {
+            CMN1Sample<TensorLayout::kNHWC, false>(
+                C, in_H, in_W, out_H, out_W, crop_pos_y, crop_pos_x, in_buffer->data<uint8_t>(),
+                out_dptr + out_image_elem_cnt * i, mean_vec, inv_std_vec);
+          }
         }
       });
     } else {
@@ -102,17 +102,19 @@ class ImageTargetResizeKernel final : public user_op::OpKernel {
     const int32_t target_size = ctx->Attr<int32_t>("target_size");
     const int32_t max_size = ctx->Attr<int32_t>("max_size");
 
-    MultiThreadLoop(in_tensor->shape().elem_cnt(), [&](size_t i) {
-      ImageTargetResize(in_img_buf[i], out_img_buf + i, target_size, max_size);
-      if (size_ptr != nullptr) {
-        size_ptr[i * 2 + 0] = out_img_buf[i].shape().At(0);
-        size_ptr[i * 2 + 1] = out_img_buf[i].shape().At(1);
-      }
-      if (scale_ptr != nullptr) {
-        scale_ptr[i * 2 + 0] = static_cast<float>(out_img_buf[i].shape().At(0))
-                               / static_cast<float>(in_img_buf[i].shape().At(0));
-        scale_ptr[i * 2 + 1] = static_cast<float>(out_img_buf[i].shape().At(1))
-                               / static_cast<float>(in_img_buf[i].shape().At(1));
+    MultiThreadLoop(in_tensor->shape().elem_cnt(), 1, [&](int64_t begin, int64_t end) {
+      FOR_RANGE(int64_t, i, begin, end) {
+        ImageTargetResize(in_img_buf[i], out_img_buf + i, target_size, max_size);
+        if (size_ptr != nullptr) {
+          size_ptr[i * 2 + 0] = out_img_buf[i].shape().At(0);
+          size_ptr[i * 2 + 1] = out_img_buf[i].shape().At(1);
+        }
+        if (scale_ptr != nullptr) {
+          scale_ptr[i * 2 + 0] = static_cast<float>(out_img_buf[i].shape().At(0))
+                                 / static_cast<float>(in_img_buf[i].shape().At(0));
+          scale_ptr[i * 2 + 1] = static_cast<float>(out_img_buf[i].shape().At(1))
+                                 / static_cast<float>(in_img_buf[i].shape().At(1));
+        }
       }
     });
   }
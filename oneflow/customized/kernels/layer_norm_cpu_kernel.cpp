@@ -14,9 +14,73 @@ See the License for the specific language governing permissions and
 limitations under the License.
 */
 #include "oneflow/core/framework/framework.h"
+#include "oneflow/core/thread/thread_manager.h"
+#include "oneflow/core/common/balanced_splitter.h"
 
 namespace oneflow {
 
+namespace {
+
+// number of independent welford accumulators, wide enough for the compiler to map them onto
+// one avx-512 (float) or two avx2 registers
+constexpr int32_t kWelfordLaneNum = 16;
+
+// Single pass mean/variance of one row. Each lane runs its own welford recurrence over a strided
+// subsequence, so the hot loop has no loop-carried dependency across lanes and vectorizes; the
+// lanes are merged with Chan's parallel formula at the end.
+template<typename T>
+void WelfordRow(const T* x, int64_t size, T* mean, T* variance) {
+  T lane_mean[kWelfordLaneNum] = {0};
+  T lane_m2[kWelfordLaneNum] = {0};
+  const int64_t step_num = size / kWelfordLaneNum;
+  FOR_RANGE(int64_t, step, 0, step_num) {
+    const T* x_step = x + step * kWelfordLaneNum;
+    const T inv_cnt = static_cast<T>(1) / static_cast<T>(step + 1);
+    for (int32_t lane = 0; lane < kWelfordLaneNum; ++lane) {
+      const T delta = x_step[lane] - lane_mean[lane];
+      lane_mean[lane] += delta * inv_cnt;
+      lane_m2[lane] += delta * (x_step[lane] - lane_mean[lane]);
+    }
+  }
+  T row_mean = 0;
+  T row_m2 = 0;
+  int64_t cnt = 0;
+  if (step_num > 0) {
+    for (int32_t lane = 0; lane < kWelfordLaneNum; ++lane) { row_mean += lane_mean[lane]; }
+    row_mean /= static_cast<T>(kWelfordLaneNum);
+    for (int32_t lane = 0; lane < kWelfordLaneNum; ++lane) {
+      const T delta = lane_mean[lane] - row_mean;
+      row_m2 += lane_m2[lane] + delta * delta * static_cast<T>(step_num);
+    }
+    cnt = step_num * kWelfordLaneNum;
+  }
+  FOR_RANGE(int64_t, i, cnt, size) {
+    cnt += 1;
+    const T delta = x[i] - row_mean;
+    row_mean += delta / static_cast<T>(cnt);
+    row_m2 += delta * (x[i] - row_mean);
+  }
+  *mean = row_mean;
+  *variance = row_m2 / static_cast<T>(size);
+}
+
+// Splits [row_offset, row_offset + row_size) into segments that are contiguous in the parameter
+// tensor of size param_size, calling Handler(elem_offset_in_row, param_offset, segment_size).
+template<typename F>
+void ForEachParamSegment(int64_t row_offset, int64_t row_size, int64_t param_size,
+                         const F& Handler) {
+  int64_t param_offset = row_offset % param_size;
+  int64_t elem_offset = 0;
+  while (elem_offset < row_size) {
+    const int64_t segment_size = std::min(row_size - elem_offset, param_size - param_offset);
+    Handler(elem_offset, param_offset, segment_size);
+    elem_offset += segment_size;
+    param_offset = 0;
+  }
+}
+
+}  // namespace
+
 template<typename T>
 class LayerNormCpuKernel final : public user_op::OpKernel {
  public:
@@ -25,7 +89,89 @@ class LayerNormCpuKernel final : public user_op::OpKernel {
 
  private:
   bool AlwaysComputeWhenAllOutputsEmpty() const override { return false; }
-  void Compute(user_op::KernelComputeContext* ctx) const override { TODO(); };
+  void Compute(user_op::KernelComputeContext* ctx) const override {
+    const user_op::Tensor* x = ctx->Tensor4ArgNameAndIndex("x", 0);
+    user_op::Tensor* y = ctx->Tensor4ArgNameAndIndex("y", 0);
+    user_op::Tensor* mean = ctx->Tensor4ArgNameAndIndex("mean", 0);
+    user_op::Tensor* inv_variance = ctx->Tensor4ArgNameAndIndex("inv_variance", 0);
+    const bool scale = ctx->Attr<bool>("scale");
+    const bool center = ctx->Attr<bool>("center");
+    const T epsilon = static_cast<T>(ctx->Attr<double>("epsilon"));
+    const int64_t row_num = mean->shape().elem_cnt();
+    const int64_t elem_cnt = x->shape().elem_cnt();
+    if (row_num == 0 || elem_cnt == 0) { return; }
+    CHECK_EQ(elem_cnt % row_num, 0);
+    const int64_t row_size = elem_cnt / row_num;
+    const T* gamma_ptr = nullptr;
+    T* normalized_ptr = nullptr;
+    int64_t param_size = row_size;
+    if (scale) {
+      const user_op::Tensor* gamma = ctx->Tensor4ArgNameAndIndex("gamma", 0);
+      gamma_ptr = gamma->dptr<T>();
+      param_size = gamma->shape().elem_cnt();
+      normalized_ptr = ctx->Tensor4ArgNameAndIndex("normalized", 0)->mut_dptr<T>();
+    }
+    const T* beta_ptr = nullptr;
+    if (center) {
+      const user_op::Tensor* beta = ctx->Tensor4ArgNameAndIndex("beta", 0);
+      beta_ptr = beta->dptr<T>();
+      param_size = beta->shape().elem_cnt();
+    }
+    CHECK_EQ(elem_cnt % param_size, 0);
+    const T* x_ptr = x->dptr<T>();
+    T* y_ptr = y->mut_dptr<T>();
+    T* mean_ptr = mean->mut_dptr<T>();
+    T* inv_variance_ptr = inv_variance->mut_dptr<T>();
+    const int64_t grain_size = MultiThreadLoopGrainSize(2 * row_size * sizeof(T));
+    MultiThreadLoop(row_num, grain_size, [&](int64_t begin, int64_t end) {
+      FOR_RANGE(int64_t, row, begin, end) {
+        const int64_t row_offset = row * row_size;
+        const T* x_row = x_ptr + row_offset;
+        T* y_row = y_ptr + row_offset;
+        T row_mean;
+        T row_variance;
+        WelfordRow(x_row, row_size, &row_mean, &row_variance);
+        const T row_inv_variance = static_cast<T>(1) / std::sqrt(row_variance + epsilon);
+        mean_ptr[row] = row_mean;
+        inv_variance_ptr[row] = row_inv_variance;
+        if (!scale && !center) {
+          FOR_RANGE(int64_t, i, 0, row_size) {
+            y_row[i] = (x_row[i] - row_mean) * row_inv_variance;
+          }
+          continue;
+        }
+        T* normalized_row = scale ? normalized_ptr + row_offset : nullptr;
+        ForEachParamSegment(
+            row_offset, row_size, param_size, [&](int64_t offset, int64_t param_offset, int64_t n) {
+              const T* x_seg = x_row + offset;
+              T* y_seg = y_row + offset;
+              if (scale && center) {
+                T* normalized_seg = normalized_row + offset;
+                const T* gamma_seg = gamma_ptr + param_offset;
+                const T* beta_seg = beta_ptr + param_offset;
+                FOR_RANGE(int64_t, i, 0, n) {
+                  const T normalized_val = (x_seg[i] - row_mean) * row_inv_variance;
+                  normalized_seg[i] = normalized_val;
+                  y_seg[i] = normalized_val * gamma_seg[i] + beta_seg[i];
+                }
+              } else if (scale) {
+                T* normalized_seg = normalized_row + offset;
+                const T* gamma_seg = gamma_ptr + param_offset;
+                FOR_RANGE(int64_t, i, 0, n) {
+                  const T normalized_val = (x_seg[i] - row_mean) * row_inv_variance;
+                  normalized_seg[i] = normalized_val;
+                  y_seg[i] = normalized_val * gamma_seg[i];
+                }
+              } else {
+                const T* beta_seg = beta_ptr + param_offset;
+                FOR_RANGE(int64_t, i, 0, n) {
+                  y_seg[i] = (x_seg[i] - row_mean) * row_inv_variance + beta_seg[i];
+                }
+              }
+            });
+      }
+    });
+  };
 };
 
 #define REGISTER_LAYER_NORM_CPU_KERNEL(dtype)                         \
@@ -45,7 +191,49 @@ class LayerNormGradCpuKernel final : public user_op::OpKernel {
 
  private:
   bool AlwaysComputeWhenAllOutputsEmpty() const override { return false; }
-  void Compute(user_op::KernelComputeContext* ctx) const override { TODO(); };
+  void Compute(user_op::KernelComputeContext* ctx) const override {
+    const user_op::Tensor* dy = ctx->Tensor4ArgNameAndIndex("dy", 0);
+    const user_op::Tensor* x = ctx->Tensor4ArgNameAndIndex("x", 0);
+    const user_op::Tensor* mean = ctx->Tensor4ArgNameAndIndex("mean", 0);
+    const user_op::Tensor* inv_variance = ctx->Tensor4ArgNameAndIndex("inv_variance", 0);
+    user_op::Tensor* dx = ctx->Tensor4ArgNameAndIndex("dx", 0);
+    const int64_t row_num = mean->shape().elem_cnt();
+    const int64_t elem_cnt = x->shape().elem_cnt();
+    if (row_num == 0 || elem_cnt == 0) { return; }
+    CHECK_EQ(elem_cnt % row_num, 0);
+    const int64_t row_size = elem_cnt / row_num;
+    const T inv_row_size = static_cast<T>(1) / static_cast<T>(row_size);
+    const T* dy_ptr = dy->dptr<T>();
+    const T* x_ptr = x->dptr<T>();
+    const T* mean_ptr = mean->dptr<T>();
+    const T* inv_variance_ptr = inv_variance->dptr<T>();
+    T* dx_ptr = dx->mut_dptr<T>();
+    const int64_t grain_size = MultiThreadLoopGrainSize(3 * row_size * sizeof(T));
+    MultiThreadLoop(row_num, grain_size, [&](int64_t begin, int64_t end) {
+      FOR_RANGE(int64_t, row, begin, end) {
+        const int64_t row_offset = row * row_size;
+        const T* dy_row = dy_ptr + row_offset;
+        const T* x_row = x_ptr + row_offset;
+        T* dx_row = dx_ptr + row_offset;
+        const T row_mean = mean_ptr[row];
+        const T row_inv_variance = inv_variance_ptr[row];
+        T sum_dy = 0;
+        T sum_dy_normalized = 0;
+        FOR_RANGE(int64_t, i, 0, row_size) {
+          sum_dy += dy_row[i];
+          sum_dy_normalized += dy_row[i] * (x_row[i] - row_mean) * row_inv_variance;
+        }
+        // dx = inv_variance * (dy - mean(dy) - normalized * mean(dy * normalized))
+        const T mean_dy = sum_dy * inv_row_size;
+        const T mean_dy_normalized = sum_dy_normalized * inv_row_size;
+        FOR_RANGE(int64_t, i, 0, row_size) {
+          const T normalized_val = (x_row[i] - row_mean) * row_inv_variance;
+          dx_row[i] =
+              row_inv_variance * (dy_row[i] - mean_dy - normalized_val * mean_dy_normalized);
+        }
+      }
+    });
+  };
 };
 
 #define REGISTER_LAYER_NORM_GRAD_CPU_KERNEL(dtype)                    \
@@ -65,7 +253,98 @@ class LayerNormParamGradCpuKernel final : public user_op::OpKernel {
 
  private:
   bool AlwaysComputeWhenAllOutputsEmpty() const override { return false; }
-  void Compute(user_op::KernelComputeContext* ctx) const override { TODO(); };
+  void Compute(user_op::KernelComputeContext* ctx) const override {
+    const user_op::Tensor* dy = ctx->Tensor4ArgNameAndIndex("dy", 0);
+    user_op::Tensor* beta_diff = ctx->Tensor4ArgNameAndIndex("beta_diff", 0);
+    user_op::Tensor* gamma_diff = ctx->Tensor4ArgNameAndIndex("gamma_diff", 0);
+    user_op::Tensor* normalized_diff = ctx->Tensor4ArgNameAndIndex("normalized_diff", 0);
+    const user_op::Tensor* gamma = ctx->Tensor4ArgNameAndIndex("gamma", 0);
+    const user_op::Tensor* normalized =
+        gamma_diff != nullptr ? ctx->Tensor4ArgNameAndIndex("normalized", 0) : nullptr;
+    const int64_t elem_cnt = dy->shape().elem_cnt();
+    if (elem_cnt == 0) { return; }
+    int64_t m = 0;
+    if (beta_diff != nullptr) {
+      m = beta_diff->shape().elem_cnt();
+    } else if (gamma_diff != nullptr) {
+      m = gamma_diff->shape().elem_cnt();
+    } else if (gamma != nullptr) {
+      m = gamma->shape().elem_cnt();
+    } else {
+      m = elem_cnt;
+    }
+    CHECK_EQ(elem_cnt % m, 0);
+    const int64_t n = elem_cnt / m;
+    const T* dy_ptr = dy->dptr<T>();
+    const T* normalized_ptr = normalized != nullptr ? normalized->dptr<T>() : nullptr;
+    const T* gamma_ptr = gamma != nullptr ? gamma->dptr<T>() : nullptr;
+    T* normalized_diff_ptr = normalized_diff != nullptr ? normalized_diff->mut_dptr<T>() : nullptr;
+
+    // beta_diff, gamma_diff and normalized_diff are produced in one sweep over dy. Rows are split
+    // across threads and every part reduces into its own partial sums, kept in reduce_buf, which
+    // are summed up column-wise afterwards.
+    const int64_t acc_num = (beta_diff != nullptr ? 1 : 0) + (gamma_diff != nullptr ? 1 : 0);
+    int64_t part_num = std::min<int64_t>(n, Global<ThreadPool>::Get()->thread_num());
+    if (acc_num > 0) { part_num = std::max<int64_t>(1, std::min(part_num, n / acc_num)); }
+    T* partial_ptr = nullptr;
+    if (acc_num > 0 && part_num > 1) {
+      partial_ptr = ctx->Tensor4ArgNameAndIndex("reduce_buf", 0)->mut_dptr<T>();
+    }
+    auto PartialBetaDiff = [&](int64_t part_id) -> T* {
+      if (beta_diff == nullptr) { return nullptr; }
+      if (partial_ptr == nullptr) { return beta_diff->mut_dptr<T>(); }
+      return partial_ptr + part_id * m;
+    };
+    auto PartialGammaDiff = [&](int64_t part_id) -> T* {
+      if (gamma_diff == nullptr) { return nullptr; }
+      if (partial_ptr == nullptr) { return gamma_diff->mut_dptr<T>(); }
+      return partial_ptr + ((beta_diff != nullptr ? part_num : 0) + part_id) * m;
+    };
+    const BalancedSplitter row_splitter(n, part_num);
+    MultiThreadLoop(part_num, 1, [&](int64_t part_id_begin, int64_t part_id_end) {
+      FOR_RANGE(int64_t, part_id, part_id_begin, part_id_end) {
+        const Range range = row_splitter.At(part_id);
+        T* beta_acc = PartialBetaDiff(part_id);
+        T* gamma_acc = PartialGammaDiff(part_id);
+        if (beta_acc != nullptr) { std::fill(beta_acc, beta_acc + m, static_cast<T>(0)); }
+        if (gamma_acc != nullptr) { std::fill(gamma_acc, gamma_acc + m, static_cast<T>(0)); }
+        FOR_RANGE(int64_t, row, range.begin(), range.end()) {
+          const int64_t row_offset = row * m;
+          const T* dy_row = dy_ptr + row_offset;
+          if (beta_acc != nullptr) {
+            FOR_RANGE(int64_t, i, 0, m) { beta_acc[i] += dy_row[i]; }
+          }
+          if (gamma_acc != nullptr) {
+            const T* normalized_row = normalized_ptr + row_offset;
+            FOR_RANGE(int64_t, i, 0, m) { gamma_acc[i] += dy_row[i] * normalized_row[i]; }
+          }
+          if (normalized_diff_ptr != nullptr) {
+            T* normalized_diff_row = normalized_diff_ptr + row_offset;
+            if (gamma_ptr != nullptr) {
+              FOR_RANGE(int64_t, i, 0, m) { normalized_diff_row[i] = dy_row[i] * gamma_ptr[i]; }
+            } else {
+              std::copy(dy_row, dy_row + m, normalized_diff_row);
+            }
+          }
+        }
+      }
+    });
+    if (partial_ptr == nullptr) { return; }
+    const int64_t reduce_grain_size = MultiThreadLoopGrainSize((part_num + 1) * sizeof(T));
+    MultiThreadLoop(m, reduce_grain_size, [&](int64_t begin, int64_t end) {
+      auto ReducePartials = [&](const T* partials, T* out) {
+        std::copy(partials + begin, partials + end, out + begin);
+        FOR_RANGE(int64_t, part_id, 1, part_num) {
+          const T* partial = partials + part_id * m;
+          FOR_RANGE(int64_t, i, begin, end) { out[i] += partial[i]; }
+        }
+      };
+      if (beta_diff != nullptr) { ReducePartials(PartialBetaDiff(0), beta_diff->mut_dptr<T>()); }
+      if (gamma_diff != nullptr) {
+        ReducePartials(PartialGammaDiff(0), gamma_diff->mut_dptr<T>());
+      }
+    });
+  };
 };
 
 #define REGISTER_LAYER_NORM_PARAM_GRAD_CPU_KERNEL(dtype)              \
@@ -14,10 +14,41 @@ See the License for the specific language governing permissions and
 limitations under the License.
 */
 #include "oneflow/core/framework/framework.h"
+#include "oneflow/core/kernel/util/host_vec_math.h"
+#include "oneflow/core/thread/thread_manager.h"
 #include "oneflow/customized/kernels/math_unary_elementwise_func.h"
 
 namespace oneflow {
 
+namespace {
+
+// y = UnaryFunctor<T>::Forward(x) over n elements. Functors with a simd implementation in
+// host_vec_math.h are specialized below.
+template<template<typename> class UnaryFunctor, typename T>
+struct MathUnaryElementwiseForward {
+  static void Invoke(int64_t n, const T* x, T* y) {
+    FOR_RANGE(int64_t, i, 0, n) { y[i] = UnaryFunctor<T>::Forward(x[i]); }
+  }
+};
+
+#define SPECIALIZE_VEC_MATH_UNARY_FORWARD(functor, vec_func) \
+  template<typename T>                                       \
+  struct MathUnaryElementwiseForward<functor, T> {           \
+    static void Invoke(int64_t n, const T* x, T* y) {        \
+      vec_func<T>(n, x, y);                                  \
+    }                                                        \
+  };
+
+SPECIALIZE_VEC_MATH_UNARY_FORWARD(ExpFunctor, HostVecExp)
+SPECIALIZE_VEC_MATH_UNARY_FORWARD(LogFunctor, HostVecLog)
+SPECIALIZE_VEC_MATH_UNARY_FORWARD(TanhFunctor, HostVecTanh)
+SPECIALIZE_VEC_MATH_UNARY_FORWARD(SigmoidFunctor, HostVecSigmoid)
+SPECIALIZE_VEC_MATH_UNARY_FORWARD(ErfFunctor, HostVecErf)
+
+#undef SPECIALIZE_VEC_MATH_UNARY_FORWARD
+
+}  // namespace
+
 template<template<typename> class UnaryFunctor, typename T>
 class MathUnaryElementwiseCpuKernel final : public user_op::OpKernel {
  public:
@@ -32,7 +63,9 @@ class MathUnaryElementwiseCpuKernel final : public user_op::OpKernel {
     T* y = tensor_y->mut_dptr<T>();
     int64_t n = tensor_x->shape().elem_cnt();
     CHECK_LE(n, GetMaxVal<int32_t>() / 2);
-    for (int32_t i = 0; i < n; ++i) { y[i] = UnaryFunctor<T>::Forward(x[i]); }
+    MultiThreadLoop(n, MultiThreadLoopGrainSize(2 * sizeof(T)), [&](int64_t begin, int64_t end) {
+      MathUnaryElementwiseForward<UnaryFunctor, T>::Invoke(end - begin, x + begin, y + begin);
+    });
   }
   bool AlwaysComputeWhenAllOutputsEmpty() const override { return false; }
 };
@@ -54,7 +87,9 @@ class MathUnaryElementwiseGradCpuKernel final : public user_op::OpKernel {
     T* dx = tensor_dx->mut_dptr<T>();
     int64_t n = tensor_x->shape().elem_cnt();
     CHECK_LE(n, GetMaxVal<int32_t>() / 2);
-    for (int32_t i = 0; i < n; ++i) { dx[i] = UnaryFunctor<T>::Backward(x[i], dy[i]); }
+    MultiThreadLoop(n, MultiThreadLoopGrainSize(3 * sizeof(T)), [&](int64_t begin, int64_t end) {
+      FOR_RANGE(int64_t, i, begin, end) { dx[i] = UnaryFunctor<T>::Backward(x[i], dy[i]); }
+    });
   }
   bool AlwaysComputeWhenAllOutputsEmpty() const override { return false; }
 };
@@ -90,13 +90,16 @@ class OFRecordRawDecoderKernel final : public user_op::OpKernel {
     bool auto_zero_padding = ctx->Attr<bool>("auto_zero_padding");
     bool dim1_varying_length = ctx->Attr<bool>("dim1_varying_length");
 
-    MultiThreadLoop(record_num, [&](size_t i) {
-      const OFRecord& record = *(records + i);
-      T* dptr = out_dptr + i * sample_elem_cnt;
-      CHECK(record.feature().find(name) != record.feature().end())
-          << "Field " << name << " not found";
-      const Feature& feature = record.feature().at(name);
-      DecodeOneRawOFRecord(feature, dptr, sample_elem_cnt, auto_zero_padding, dim1_varying_length);
+    MultiThreadLoop(record_num, 1, [&](int64_t begin, int64_t end) {
+      FOR_RANGE(int64_t, i, begin, end) {
+        const OFRecord& record = *(records + i);
+        T* dptr = out_dptr + i * sample_elem_cnt;
+        CHECK(record.feature().find(name) != record.feature().end())
+            << "Field " << name << " not found";
+        const Feature& feature = record.feature().at(name);
+        DecodeOneRawOFRecord(feature, dptr, sample_elem_cnt, auto_zero_padding,
+                             dim1_varying_length);
+      }
     });
   }
   bool AlwaysComputeWhenAllOutputsEmpty() const override { return false; }
@@ -239,11 +242,13 @@ class OFRecordImageDecoderRandomCropKernel final : public user_op::OpKernel {
     const std::string& name = ctx->Attr<std::string>("name");
     const std::string& color_space = ctx->Attr<std::string>("color_space");
 
-    MultiThreadLoop(record_num, [&](size_t i) {
-      const OFRecord& record = *(records + i);
-      TensorBuffer* buffer = buffers + i;
-      RandomCropGenerator* gen = crop_window_generators->Get(i);
-      DecodeRandomCropImageFromOneRecord(record, buffer, name, color_space, gen);
+    MultiThreadLoop(record_num, 1, [&](int64_t begin, int64_t end) {
+      FOR_RANGE(int64_t, i, begin, end) {
+        const OFRecord& record = *(records + i);
+        TensorBuffer* buffer = buffers + i;
+        RandomCropGenerator* gen = crop_window_generators->Get(i);
+        DecodeRandomCropImageFromOneRecord(record, buffer, name, color_space, gen);
+      }
     });
   }
   bool AlwaysComputeWhenAllOutputsEmpty() const override { return false; }
@@ -272,10 +277,12 @@ class OFRecordImageDecoderKernel final : public user_op::OpKernel {
     const std::string& name = ctx->Attr<std::string>("name");
     const std::string& color_space = ctx->Attr<std::string>("color_space");
 
-    MultiThreadLoop(record_num, [&](size_t i) {
-      const OFRecord& record = *(records + i);
-      TensorBuffer* buffer = buffers + i;
-      DecodeRandomCropImageFromOneRecord(record, buffer, name, color_space, nullptr);
+    MultiThreadLoop(record_num, 1, [&](int64_t begin, int64_t end) {
+      FOR_RANGE(int64_t, i, begin, end) {
+        const OFRecord& record = *(records + i);
+        TensorBuffer* buffer = buffers + i;
+        DecodeRandomCropImageFromOneRecord(record, buffer, name, color_space, nullptr);
+      }
     });
   }
   bool AlwaysComputeWhenAllOutputsEmpty() const override { return false; }
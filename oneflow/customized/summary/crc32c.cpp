@@ -0,0 +1,129 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "oneflow/customized/summary/crc32c.h"
+#include "oneflow/core/common/platform.h"
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#define OF_CRC32C_SSE42
+#include <nmmintrin.h>
+#elif defined(__aarch64__) && defined(__GNUC__) && defined(__linux__)
+#define OF_CRC32C_ARMV8
+#include <arm_acle.h>
+#include <sys/auxv.h>
+#include <asm/hwcap.h>
+#endif
+
+namespace oneflow {
+
+namespace summary {
+
+namespace {
+
+constexpr uint32_t kCrc32cPolynomial = 0x82f63b78u;
+
+// tables[0] is the classic byte-wise table, tables[k][i] is the crc of byte i followed by k zero
+// bytes, which lets the portable path fold 8 input bytes per iteration.
+struct Crc32cTables {
+  Crc32cTables() {
+    FOR_RANGE(uint32_t, i, 0, 256) {
+      uint32_t crc = i;
+      FOR_RANGE(int32_t, bit, 0, 8) { crc = (crc & 1) ? (crc >> 1) ^ kCrc32cPolynomial : crc >> 1; }
+      tables[0][i] = crc;
+    }
+    FOR_RANGE(uint32_t, i, 0, 256) {
+      FOR_RANGE(int32_t, k, 1, 8) {
+        tables[k][i] = (tables[k - 1][i] >> 8) ^ tables[0][tables[k - 1][i] & 0xff];
+      }
+    }
+  }
+
+  uint32_t tables[8][256];
+};
+
+uint32_t ExtendRawCrc32Portable(uint32_t crc, const uint8_t *buf, size_t size) {
+  static const Crc32cTables crc32c_tables;
+  const auto &t = crc32c_tables.tables;
+  for (; size >= 8; buf += 8, size -= 8) {
+    const uint32_t lo = crc ^ (static_cast<uint32_t>(buf[0]) | static_cast<uint32_t>(buf[1]) << 8
+                               | static_cast<uint32_t>(buf[2]) << 16
+                               | static_cast<uint32_t>(buf[3]) << 24);
+    crc = t[7][lo & 0xff] ^ t[6][(lo >> 8) & 0xff] ^ t[5][(lo >> 16) & 0xff] ^ t[4][lo >> 24]
+          ^ t[3][buf[4]] ^ t[2][buf[5]] ^ t[1][buf[6]] ^ t[0][buf[7]];
+  }
+  for (; size > 0; ++buf, --size) { crc = t[0][(crc ^ *buf) & 0xff] ^ (crc >> 8); }
+  return crc;
+}
+
+#ifdef OF_CRC32C_SSE42
+
+__attribute__((target("sse4.2"))) uint32_t ExtendCrc32Sse42(uint32_t crc, const uint8_t *buf,
+                                                            size_t size) {
+  for (; size > 0 && reinterpret_cast<uintptr_t>(buf) % 8 != 0; ++buf, --size) {
+    crc = _mm_crc32_u8(crc, *buf);
+  }
+  uint64_t crc64 = crc;
+  for (; size >= 8; buf += 8, size -= 8) {
+    crc64 = _mm_crc32_u64(crc64, *reinterpret_cast<const uint64_t *>(buf));
+  }
+  crc = static_cast<uint32_t>(crc64);
+  for (; size > 0; ++buf, --size) { crc = _mm_crc32_u8(crc, *buf); }
+  return crc;
+}
+
+#endif  // OF_CRC32C_SSE42
+
+#ifdef OF_CRC32C_ARMV8
+
+__attribute__((target("+crc"))) uint32_t ExtendCrc32Armv8(uint32_t crc, const uint8_t *buf,
+                                                          size_t size) {
+  for (; size > 0 && reinterpret_cast<uintptr_t>(buf) % 8 != 0; ++buf, --size) {
+    crc = __crc32cb(crc, *buf);
+  }
+  for (; size >= 8; buf += 8, size -= 8) {
+    crc = __crc32cd(crc, *reinterpret_cast<const uint64_t *>(buf));
+  }
+  for (; size > 0; ++buf, --size) { crc = __crc32cb(crc, *buf); }
+  return crc;
+}
+
+#endif  // OF_CRC32C_ARMV8
+
+using ExtendCrc32Func = uint32_t (*)(uint32_t, const uint8_t *, size_t);
+
+ExtendCrc32Func SelectExtendCrc32Func() {
+#if defined(OF_CRC32C_SSE42)
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("sse4.2")) { return &ExtendCrc32Sse42; }
+#elif defined(OF_CRC32C_ARMV8)
+  if (getauxval(AT_HWCAP) & HWCAP_CRC32) { return &ExtendCrc32Armv8; }
+#endif
+  return &ExtendRawCrc32Portable;
+}
+
+}  // namespace
+
+uint32_t ExtendCrc32(uint32_t init_crc, const char *buf, size_t size) {
+  static const ExtendCrc32Func extend_crc32_func = SelectExtendCrc32Func();
+  return ~extend_crc32_func(~init_crc, reinterpret_cast<const uint8_t *>(buf), size);
+}
+
+uint32_t ExtendCrc32Portable(uint32_t init_crc, const char *buf, size_t size) {
+  return ~ExtendRawCrc32Portable(~init_crc, reinterpret_cast<const uint8_t *>(buf), size);
+}
+
+}  // namespace summary
+
+}  // namespace oneflow
@@ -0,0 +1,79 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "oneflow/customized/summary/crc32c.h"
+#include <gtest/gtest.h>
+
+namespace oneflow {
+
+namespace summary {
+
+namespace test {
+
+namespace {
+
+uint32_t BitwiseCrc32(const char *buf, size_t size) {
+  uint32_t crc = 0xffffffffu;
+  FOR_RANGE(size_t, i, 0, size) {
+    crc ^= static_cast<uint8_t>(buf[i]);
+    FOR_RANGE(int32_t, bit, 0, 8) { crc = (crc & 1) ? (crc >> 1) ^ 0x82f63b78u : crc >> 1; }
+  }
+  return crc ^ 0xffffffffu;
+}
+
+}  // namespace
+
+using ExtendCrc32Func = uint32_t (*)(uint32_t, const char *, size_t);
+
+// the dispatched one, which is the hardware path on most cpus, and the table one
+const std::vector<ExtendCrc32Func> kExtendCrc32Funcs = {&ExtendCrc32, &ExtendCrc32Portable};
+
+TEST(Crc32c, standard_results) {
+  for (ExtendCrc32Func Extend : kExtendCrc32Funcs) {
+    // Test vectors from rfc 3720, section b.4.
+    std::string buf(32, '\0');
+    ASSERT_EQ(Extend(0, buf.data(), buf.size()), 0x8a9136aau);
+    buf.assign(32, '\xff');
+    ASSERT_EQ(Extend(0, buf.data(), buf.size()), 0x62a8ab43u);
+    FOR_RANGE(int32_t, i, 0, 32) { buf[i] = static_cast<char>(i); }
+    ASSERT_EQ(Extend(0, buf.data(), buf.size()), 0x46dd794eu);
+    FOR_RANGE(int32_t, i, 0, 32) { buf[i] = static_cast<char>(31 - i); }
+    ASSERT_EQ(Extend(0, buf.data(), buf.size()), 0x113fdb5cu);
+    ASSERT_EQ(Extend(0, "123456789", 9), 0xe3069283u);
+  }
+  ASSERT_EQ(GetCrc32("123456789", 9), 0xe3069283u);
+}
+
+TEST(Crc32c, unaligned_and_extend) {
+  std::string buf(4096 + 16, '\0');
+  FOR_RANGE(size_t, i, 0, buf.size()) { buf[i] = static_cast<char>(i * 131 + 7); }
+  for (ExtendCrc32Func Extend : kExtendCrc32Funcs) {
+    for (size_t offset = 0; offset < 16; ++offset) {
+      for (size_t size : {0, 1, 7, 8, 9, 63, 64, 65, 1000, 4096}) {
+        const char *data = buf.data() + offset;
+        const uint32_t expected = BitwiseCrc32(data, size);
+        ASSERT_EQ(Extend(0, data, size), expected);
+        const size_t split = size / 3;
+        ASSERT_EQ(Extend(Extend(0, data, split), data + split, size - split), expected);
+      }
+    }
+  }
+}
+
+}  // namespace test
+
+}  // namespace summary
+
+}  // namespace oneflow
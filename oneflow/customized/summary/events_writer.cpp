@@ -21,17 +21,18 @@ namespace oneflow {
 
 namespace summary {
 
-EventsWriter::EventsWriter() : is_inited_(false) {}
+EventsWriter::EventsWriter()
+    : is_inited_(false), num_appended_events_(0), num_written_events_(0), shutdown_(false) {}
 
 EventsWriter::~EventsWriter() { Close(); }
 
 Maybe<void> EventsWriter::Init(const std::string& logdir) {
+  std::unique_lock<std::mutex> lock(file_mutex_);
   file_system_ = std::make_unique<fs::PosixFileSystem>();
   log_dir_ = logdir + "/event";
   file_system_->RecursivelyCreateDirIfNotExist(log_dir_);
   TryToInit();
   is_inited_ = true;
-  last_flush_time_ = CurrentMircoTime();
   return Maybe<void>::Ok();
 }
 
@@ -55,33 +56,74 @@ Maybe<void> EventsWriter::TryToInit() {
     Event event;
     event.set_wall_time(current_time);
     event.set_file_version(FILE_VERSION);
-    WriteEvent(event);
-    Flush();
+    std::string buffer;
+    AppendRecord(event, &buffer);
+    writable_file_->Append(buffer.data(), buffer.size());
+    writable_file_->Flush();
   }
   return Maybe<void>::Ok();
 }
 
 void EventsWriter::AppendQueue(std::unique_ptr<Event> event) {
-  queue_mutex.lock();
-  event_queue_.emplace_back(std::move(event));
-  queue_mutex.unlock();
-  if (event_queue_.size() > MAX_QUEUE_NUM || CurrentMircoTime() - last_flush_time_ > FLUSH_TIME) {
-    Flush();
+  {
+    std::unique_lock<std::mutex> lock(queue_mutex_);
+    queue_cond_.wait(lock,
+                     [this]() { return event_queue_.size() < kMaxPendingEvents || shutdown_; });
+    if (shutdown_) {
+      LOG(WARNING) << "Event dropped because events writer is closed.";
+      return;
+    }
+    // Runtimes that never write a summary never start the thread.
+    if (!writer_thread_.joinable()) { writer_thread_ = std::thread([this]() { PollQueue(); }); }
+    event_queue_.emplace_back(std::move(event));
+    num_appended_events_ += 1;
   }
+  queue_cond_.notify_all();
 }
 
 void EventsWriter::Flush() {
-  queue_mutex.lock();
-  for (const std::unique_ptr<Event>& e : event_queue_) { WriteEvent(*e); }
-  event_queue_.clear();
-  queue_mutex.unlock();
+  {
+    std::unique_lock<std::mutex> lock(queue_mutex_);
+    const int64_t num_events_to_write = num_appended_events_;
+    queue_cond_.wait(lock, [&]() { return num_written_events_ >= num_events_to_write; });
+  }
   FileFlush();
-  last_flush_time_ = CurrentMircoTime();
+}
+
+void EventsWriter::PollQueue() {
+  while (true) {
+    std::vector<std::unique_ptr<Event>> events;
+    {
+      std::unique_lock<std::mutex> lock(queue_mutex_);
+      queue_cond_.wait(lock, [this]() { return !event_queue_.empty() || shutdown_; });
+      if (event_queue_.empty()) { break; }
+      events.swap(event_queue_);
+    }
+    // Wake up producers waiting for room in the queue while the batch is written.
+    queue_cond_.notify_all();
+    std::string buffer;
+    for (const std::unique_ptr<Event>& e : events) { AppendRecord(*e, &buffer); }
+    WriteBuffer(buffer);
+    {
+      std::unique_lock<std::mutex> lock(queue_mutex_);
+      num_written_events_ += events.size();
+    }
+    queue_cond_.notify_all();
+  }
 }
 
 void EventsWriter::WriteEvent(const Event& event) {
-  std::string event_str;
-  event.AppendToString(&event_str);
+  std::string buffer;
+  AppendRecord(event, &buffer);
+  WriteBuffer(buffer);
+}
+
+void EventsWriter::WriteBuffer(const std::string& buffer) {
+  std::unique_lock<std::mutex> lock(file_mutex_);
+  if (!is_inited_) {
+    LOG(ERROR) << "Write failed because events writer is not initialized.";
+    return;
+  }
   if (!TryToInit().IsOk()) {
     LOG(ERROR) << "Write failed because file could not be opened.";
     return;
@@ -90,26 +132,38 @@ void EventsWriter::WriteEvent(const Event& event) {
     LOG(WARNING) << "Log file is closed!";
     return;
   }
+  writable_file_->Append(buffer.data(), buffer.size());
+  writable_file_->Flush();
+}
 
+void EventsWriter::AppendRecord(const Event& event, std::string* buffer) {
+  std::string event_str;
+  event.AppendToString(&event_str);
   char head[kHeadSize];
   char tail[kTailSize];
   EncodeHead(head, event_str.size());
   EncodeTail(tail, event_str.data(), event_str.size());
-  writable_file_->Append(head, sizeof(head));
-  writable_file_->Append(event_str.data(), event_str.size());
-  writable_file_->Append(tail, sizeof(tail));
-  FileFlush();
+  buffer->append(head, sizeof(head));
+  buffer->append(event_str);
+  buffer->append(tail, sizeof(tail));
 }
 
 void EventsWriter::FileFlush() {
+  std::unique_lock<std::mutex> lock(file_mutex_);
   if (writable_file_ == nullptr) { return; }
   writable_file_->Flush();
 }
 
 void EventsWriter::Close() {
-  if (!is_inited_) { return; }
-  queue_mutex.unlock();
-  Flush();
+  {
+    std::unique_lock<std::mutex> lock(queue_mutex_);
+    if (shutdown_) { return; }
+    shutdown_ = true;
+  }
+  queue_cond_.notify_all();
+  // The writer thread drains the queue before it exits.
+  if (writer_thread_.joinable()) { writer_thread_.join(); }
+  std::unique_lock<std::mutex> lock(file_mutex_);
   if (writable_file_ != nullptr) {
     writable_file_->Close();
     writable_file_.reset(nullptr);
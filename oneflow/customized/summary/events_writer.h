@@ -23,17 +23,23 @@ limitations under the License.
 
 #include <time.h>
 #include <mutex>
+#include <condition_variable>
+#include <thread>
 
 namespace oneflow {
 
 namespace summary {
 
-#define MAX_QUEUE_NUM 10
-#define FLUSH_TIME 3 * 60 * 1000 * 1000
 #define FILE_VERSION "brain.Event:3"
 const size_t kHeadSize = sizeof(uint64_t) + sizeof(uint32_t);
 const size_t kTailSize = sizeof(uint32_t);
+// AppendQueue blocks once this many events wait for the writer thread.
+const size_t kMaxPendingEvents = 1024;
 
+// Events appended with AppendQueue are serialized and written by a background thread, which
+// drains everything pending into one buffer and appends it to the file in a single call, so the
+// training step that produced an event never waits for the file system. The thread starts with
+// the first AppendQueue.
 class EventsWriter {
  public:
   EventsWriter();
@@ -41,6 +47,7 @@ class EventsWriter {
 
   Maybe<void> Init(const std::string& logdir);
   void WriteEvent(const Event& event);
+  // Blocks until every event appended before the call is written and the file is flushed.
   void Flush();
   void Close();
 
@@ -49,6 +56,9 @@ class EventsWriter {
 
  private:
   Maybe<void> TryToInit();
+  void WriteBuffer(const std::string& buffer);
+  void PollQueue();
+  static void AppendRecord(const Event& event, std::string* buffer);
   inline static void EncodeHead(char* head, size_t size);
   inline static void EncodeTail(char* tail, const char* data, size_t size);
 
@@ -57,9 +67,14 @@ class EventsWriter {
   std::string filename_;
   std::unique_ptr<fs::FileSystem> file_system_;
   std::unique_ptr<fs::WritableFile> writable_file_;
-  uint64_t last_flush_time_;
+  std::mutex file_mutex_;
   std::vector<std::unique_ptr<Event>> event_queue_;
-  std::mutex queue_mutex;
+  int64_t num_appended_events_;
+  int64_t num_written_events_;
+  bool shutdown_;
+  std::mutex queue_mutex_;
+  std::condition_variable queue_cond_;
+  std::thread writer_thread_;
   OF_DISALLOW_COPY(EventsWriter);
 };
 
@@ -279,6 +279,150 @@ def enable_debug_mode(val):
     sess.config_proto.resource.enable_debug_mode = val
 
 
+@oneflow_export("config.kernel_infer_cache_max_size")
+def api_kernel_infer_cache_max_size(val: int) -> None:
+    r"""Set the max number of runtime shape inference results cached for user op kernels.
+    The cache is shared by all kernels and sessions of the process.
+
+    Args:
+        val (int): number of cached results
+    """
+    return enable_if.unique([kernel_infer_cache_max_size, do_nothing])(val)
+
+
+@enable_if.condition(hob.in_normal_mode & ~hob.session_initialized)
+def kernel_infer_cache_max_size(val):
+    sess = session_ctx.GetDefaultSession()
+    assert type(val) is int
+    sess.config_proto.resource.kernel_infer_cache_max_size = val
+
+
+@oneflow_export("config.thread_placement.bind_gpu_threads_to_local_numa_node")
+def api_bind_gpu_threads_to_local_numa_node(val: bool = True) -> None:
+    r"""Whether or not pin the actor threads of every gpu to the cpus of its numa node.
+    The pinned host memory of the gpu is allocated on that node as well.
+
+    Args:
+        val (bool, optional): True or False. Defaults to True.
+    """
+    return enable_if.unique([bind_gpu_threads_to_local_numa_node, do_nothing])(val=val)
+
+
+@enable_if.condition(hob.in_normal_mode & ~hob.session_initialized)
+def bind_gpu_threads_to_local_numa_node(val=True):
+    sess = session_ctx.GetDefaultSession()
+    assert type(val) is bool
+    sess.config_proto.resource.thread_placement_conf.bind_gpu_threads_to_local_numa_node = (
+        val
+    )
+
+
+@oneflow_export("config.thread_placement.comm_net_poller_core_num")
+def api_comm_net_poller_core_num(val: int) -> None:
+    r"""Set up the number of cpus kept for the comm net poller threads only.
+
+    Args:
+        val (int): number of cpus, 0 means the pollers are not isolated
+    """
+    return enable_if.unique([comm_net_poller_core_num, do_nothing])(val)
+
+
+@enable_if.condition(hob.in_normal_mode & ~hob.session_initialized)
+def comm_net_poller_core_num(val):
+    sess = session_ctx.GetDefaultSession()
+    assert type(val) is int
+    sess.config_proto.resource.thread_placement_conf.comm_net_poller_core_num = val
+
+
+@oneflow_export("config.thread_placement.cpu_actor_thread_core_num")
+def api_cpu_actor_thread_core_num(val: int) -> None:
+    r"""Set up the number of cpus shared by all cpu actor threads.
+    The compute thread pool runs on the remaining cpus.
+
+    Args:
+        val (int): number of cpus, 0 means the cpu actor threads are not pinned
+    """
+    return enable_if.unique([cpu_actor_thread_core_num, do_nothing])(val)
+
+
+@enable_if.condition(hob.in_normal_mode & ~hob.session_initialized)
+def cpu_actor_thread_core_num(val):
+    sess = session_ctx.GetDefaultSession()
+    assert type(val) is int
+    sess.config_proto.resource.thread_placement_conf.cpu_actor_thread_core_num = val
+
+
+@oneflow_export("config.actor_thread_poll.spin_us")
+def api_actor_thread_poll_spin_us(val: int) -> None:
+    r"""Set up how long an idle actor thread spins on its message channel before yielding.
+
+    Args:
+        val (int): spin time in microseconds, 0 means no spinning
+    """
+    return enable_if.unique([actor_thread_poll_spin_us, do_nothing])(val)
+
+
+@enable_if.condition(hob.in_normal_mode & ~hob.session_initialized)
+def actor_thread_poll_spin_us(val):
+    sess = session_ctx.GetDefaultSession()
+    assert type(val) is int
+    sess.config_proto.resource.actor_thread_poll_conf.spin_us = val
+
+
+@oneflow_export("config.actor_thread_poll.yield_us")
+def api_actor_thread_poll_yield_us(val: int) -> None:
+    r"""Set up how long an idle actor thread keeps yielding after spinning and before sleeping.
+
+    Args:
+        val (int): yield time in microseconds, 0 means no yielding
+    """
+    return enable_if.unique([actor_thread_poll_yield_us, do_nothing])(val)
+
+
+@enable_if.condition(hob.in_normal_mode & ~hob.session_initialized)
+def actor_thread_poll_yield_us(val):
+    sess = session_ctx.GetDefaultSession()
+    assert type(val) is int
+    sess.config_proto.resource.actor_thread_poll_conf.yield_us = val
+
+
+@oneflow_export("config.actor_thread_poll.thrd_ids")
+def api_actor_thread_poll_thrd_ids(val: list) -> None:
+    r"""Set up the actor threads that spin and yield before sleeping.
+
+    Args:
+        val (list): thread ids, empty means all actor threads
+    """
+    return enable_if.unique([actor_thread_poll_thrd_ids, do_nothing])(val)
+
+
+@enable_if.condition(hob.in_normal_mode & ~hob.session_initialized)
+def actor_thread_poll_thrd_ids(val):
+    sess = session_ctx.GetDefaultSession()
+    assert type(val) is list
+    sess.config_proto.resource.actor_thread_poll_conf.ClearField("thrd_id")
+    for thrd_id in val:
+        assert type(thrd_id) is int
+        sess.config_proto.resource.actor_thread_poll_conf.thrd_id.append(thrd_id)
+
+
+@oneflow_export("config.actor_thread_poll.enable_metrics")
+def api_actor_thread_poll_enable_metrics(val: bool = True) -> None:
+    r"""Whether or not every actor thread logs its wakeup latency and idle spin ratio when it stops.
+
+    Args:
+        val (bool, optional): True or False. Defaults to True.
+    """
+    return enable_if.unique([actor_thread_poll_enable_metrics, do_nothing])(val=val)
+
+
+@enable_if.condition(hob.in_normal_mode & ~hob.session_initialized)
+def actor_thread_poll_enable_metrics(val=True):
+    sess = session_ctx.GetDefaultSession()
+    assert type(val) is bool
+    sess.config_proto.resource.actor_thread_poll_conf.enable_metrics = val
+
+
 @oneflow_export("config.save_downloaded_file_to_local_fs")
 def api_save_downloaded_file_to_local_fs(val: bool = True) -> None:
     r"""Whether or not save downloaded file to local file system.
@@ -524,3 +668,71 @@ def nccl_fusion_broadcast(val):
 def do_nothing(*args, **kwargs):
     print("Nothing happened because the session is running")
     return False
+
+
+@oneflow_export("config.collective_boxing.enable_cpu_backend")
+def api_enable_cpu_backend(val: bool) -> None:
+    r"""Whether or not use the shared memory cpu backend for boxing between cpu devices
+
+    Args:
+        val (bool): True or False
+    """
+    return enable_if.unique([enable_cpu_backend, do_nothing])(val)
+
+
+@enable_if.condition(hob.in_normal_mode & ~hob.session_initialized)
+def enable_cpu_backend(val):
+    sess = session_ctx.GetDefaultSession()
+    assert type(val) is bool
+    sess.config_proto.resource.collective_boxing_conf.enable_cpu_backend = val
+
+
+@oneflow_export("config.collective_boxing.cpu_num_threads")
+def api_cpu_num_threads(val: int) -> None:
+    r"""Set up the number of worker threads of the cpu boxing backend
+
+    Args:
+        val (int): number of threads
+    """
+    return enable_if.unique([cpu_num_threads, do_nothing])(val)
+
+
+@enable_if.condition(hob.in_normal_mode & ~hob.session_initialized)
+def cpu_num_threads(val):
+    sess = session_ctx.GetDefaultSession()
+    assert type(val) is int
+    sess.config_proto.resource.collective_boxing_conf.cpu_num_threads = val
+
+
+@oneflow_export("config.collective_boxing.cpu_fusion_threshold_mb")
+def api_cpu_fusion_threshold_mb(val: int) -> None:
+    r"""Set up threshold for operators fusion of the cpu boxing backend
+
+    Args:
+        val (int): int number, e.g. 10(mb)
+    """
+    return enable_if.unique([cpu_fusion_threshold_mb, do_nothing])(val)
+
+
+@enable_if.condition(hob.in_normal_mode & ~hob.session_initialized)
+def cpu_fusion_threshold_mb(val):
+    sess = session_ctx.GetDefaultSession()
+    assert type(val) is int
+    sess.config_proto.resource.collective_boxing_conf.cpu_fusion_threshold_mb = val
+
+
+@oneflow_export("config.collective_boxing.cpu_chunk_size_kb")
+def api_cpu_chunk_size_kb(val: int) -> None:
+    r"""Set up the size of chunks the cpu boxing backend splits every request into
+
+    Args:
+        val (int): int number, e.g. 256(kb)
+    """
+    return enable_if.unique([cpu_chunk_size_kb, do_nothing])(val)
+
+
+@enable_if.condition(hob.in_normal_mode & ~hob.session_initialized)
+def cpu_chunk_size_kb(val):
+    sess = session_ctx.GetDefaultSession()
+    assert type(val) is int
+    sess.config_proto.resource.collective_boxing_conf.cpu_chunk_size_kb = val